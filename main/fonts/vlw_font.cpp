@@ -1,6 +1,8 @@
 #include "fonts/vlw_font.h"
 
 #include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <limits>
 
 namespace {
@@ -17,6 +19,9 @@ int32_t abs_i32(int32_t value)
     return value < 0 ? -value : value;
 }
 
+/** @brief Source of `VlwFont::serial()` values; 0 is never handed out. */
+std::atomic<uint32_t> g_next_font_serial{1};
+
 /** @brief Write a plain parse error string when the caller requested one. */
 bool assign_error(std::string *out_error, const char *message)
 {
@@ -44,16 +49,48 @@ std::shared_ptr<VlwFont> VlwFont::CreateCopy(const uint8_t *ptr, size_t len, con
         assign_error(out_error, "font bytes pointer is null");
         return nullptr;
     }
-    if (len < 24) {
-        assign_error(out_error, "font too small for VLW header");
+
+    auto font = std::make_shared<VlwFont>();
+    font->bytes_.assign(ptr, ptr + len);
+    if (!font->Parse(font->bytes_.data(), len, debug_name, out_error)) {
+        return nullptr;
+    }
+    return font;
+}
+
+/** @brief Parse a VLW payload in place, keeping only the glyph tables and a pointer to the bytes. */
+std::shared_ptr<VlwFont> VlwFont::CreateBorrowed(
+    const uint8_t *ptr,
+    size_t len,
+    const char *debug_name,
+    std::shared_ptr<const void> owner,
+    std::string *out_error)
+{
+    if (!ptr) {
+        assign_error(out_error, "font bytes pointer is null");
         return nullptr;
     }
 
     auto font = std::make_shared<VlwFont>();
-    font->debug_name_ = debug_name ? debug_name : "vlw";
-    font->bytes_.assign(ptr, ptr + len);
+    font->owner_ = std::move(owner);
+    if (!font->Parse(ptr, len, debug_name, out_error)) {
+        return nullptr;
+    }
+    return font;
+}
+
+/** @brief Validate the VLW payload at `bytes` and build the metrics and glyph tables over it. */
+bool VlwFont::Parse(const uint8_t *bytes, size_t len, const char *debug_name, std::string *out_error)
+{
+    if (len < 24) {
+        assign_error(out_error, "font too small for VLW header");
+        return false;
+    }
+
+    debug_name_ = debug_name ? debug_name : "vlw";
+    data_ = bytes;
+    size_ = len;
 
-    const uint8_t *bytes = font->bytes_.data();
     const uint32_t glyph_count_u32 = read_be32(bytes + 0);
     const uint32_t y_advance_u32 = read_be32(bytes + 8);
     const int32_t ascent_i32 = (int32_t)read_be32(bytes + 16);
@@ -61,34 +98,33 @@ std::shared_ptr<VlwFont> VlwFont::CreateCopy(const uint8_t *ptr, size_t len, con
 
     if (glyph_count_u32 == 0 || glyph_count_u32 > (uint32_t)std::numeric_limits<uint16_t>::max()) {
         assign_error(out_error, "invalid VLW glyph count");
-        return nullptr;
+        return false;
     }
     if (y_advance_u32 > (uint32_t)std::numeric_limits<int16_t>::max()) {
         assign_error(out_error, "invalid VLW line height");
-        return nullptr;
+        return false;
     }
 
     const size_t glyph_count = (size_t)glyph_count_u32;
     const size_t table_bytes = glyph_count * 28u;
     if (table_bytes / 28u != glyph_count || 24u + table_bytes > len) {
         assign_error(out_error, "VLW glyph table exceeds font length");
-        return nullptr;
+        return false;
     }
 
     const int16_t ascent = (int16_t)std::min<int32_t>(abs_i32(ascent_i32), std::numeric_limits<int16_t>::max());
     const int16_t descent = (int16_t)std::min<int32_t>(abs_i32(descent_i32), std::numeric_limits<int16_t>::max());
     int32_t computed_y_advance = std::max<int32_t>((int32_t)y_advance_u32, (int32_t)ascent + (int32_t)descent);
 
-    font->metrics_.glyph_count = (uint16_t)glyph_count_u32;
-    font->metrics_.ascent = ascent;
-    font->metrics_.descent = descent;
-    font->metrics_.max_ascent = ascent;
-    font->metrics_.max_descent = descent;
-    font->metrics_.space_width = (uint16_t)std::max<int32_t>(0, computed_y_advance * 2 / 7);
-    font->metrics_.line_height = (int16_t)std::min<int32_t>(computed_y_advance, std::numeric_limits<int16_t>::max());
+    metrics_.glyph_count = (uint16_t)glyph_count_u32;
+    metrics_.ascent = ascent;
+    metrics_.descent = descent;
+    metrics_.max_ascent = ascent;
+    metrics_.max_descent = descent;
+    metrics_.space_width = (uint16_t)std::max<int32_t>(0, computed_y_advance * 2 / 7);
+    metrics_.line_height = (int16_t)std::min<int32_t>(computed_y_advance, std::numeric_limits<int16_t>::max());
 
-    font->glyphs_.reserve(glyph_count);
-    font->glyph_lookup_.reserve(glyph_count);
+    glyphs_.reserve(glyph_count);
 
     uint32_t bitmap_offset = (uint32_t)(24u + table_bytes);
     for (size_t i = 0; i < glyph_count; ++i) {
@@ -103,30 +139,30 @@ std::shared_ptr<VlwFont> VlwFont::CreateCopy(const uint8_t *ptr, size_t len, con
 
         if (unicode_u32 > 0xFFFFu) {
             assign_errorf(out_error, "VLW glyph unicode exceeds BMP at glyph index " + std::to_string(i));
-            return nullptr;
+            return false;
         }
         if (width_u32 > (uint32_t)std::numeric_limits<uint16_t>::max()
             || height_u32 > (uint32_t)std::numeric_limits<uint16_t>::max()
             || x_advance_raw > (uint32_t)std::numeric_limits<uint16_t>::max()) {
             assign_errorf(out_error, "VLW glyph dimensions overflow at glyph index " + std::to_string(i));
-            return nullptr;
+            return false;
         }
         if (y_delta_i32 < (int32_t)std::numeric_limits<int16_t>::min()
             || y_delta_i32 > (int32_t)std::numeric_limits<int16_t>::max()
             || x_delta_i32 < (int32_t)std::numeric_limits<int8_t>::min()
             || x_delta_i32 > (int32_t)std::numeric_limits<int8_t>::max()) {
             assign_errorf(out_error, "VLW glyph deltas overflow at glyph index " + std::to_string(i));
-            return nullptr;
+            return false;
         }
 
         const uint64_t glyph_bytes = (uint64_t)width_u32 * (uint64_t)height_u32;
         if (glyph_bytes > (uint64_t)std::numeric_limits<uint32_t>::max()) {
             assign_errorf(out_error, "VLW glyph bitmap is too large at glyph index " + std::to_string(i));
-            return nullptr;
+            return false;
         }
         if ((uint64_t)bitmap_offset + glyph_bytes > (uint64_t)len) {
             assign_errorf(out_error, "VLW glyph bitmap exceeds font length at glyph index " + std::to_string(i));
-            return nullptr;
+            return false;
         }
 
         VlwGlyph glyph = {};
@@ -138,23 +174,24 @@ std::shared_ptr<VlwFont> VlwFont::CreateCopy(const uint8_t *ptr, size_t len, con
         glyph.x_delta = (int8_t)x_delta_i32;
         glyph.bitmap_offset = bitmap_offset;
 
-        font->glyph_lookup_[glyph.codepoint] = font->glyphs_.size();
-        font->glyphs_.push_back(glyph);
+        glyphs_.push_back(glyph);
         bitmap_offset += (uint32_t)glyph_bytes;
 
         if ((glyph.codepoint > 0xFFu || ((glyph.codepoint > 0x20u) && (glyph.codepoint < 0xA0u) && (glyph.codepoint != 0x7Fu)))
             && glyph.codepoint != 0x3000u) {
-            font->metrics_.max_ascent = std::max<int16_t>(font->metrics_.max_ascent, glyph.y_delta);
-            font->metrics_.max_descent =
-                std::max<int16_t>(font->metrics_.max_descent, (int16_t)((int32_t)glyph.height - (int32_t)glyph.y_delta));
+            metrics_.max_ascent = std::max<int16_t>(metrics_.max_ascent, glyph.y_delta);
+            metrics_.max_descent =
+                std::max<int16_t>(metrics_.max_descent, (int16_t)((int32_t)glyph.height - (int32_t)glyph.y_delta));
         }
     }
 
-    font->metrics_.line_height = (int16_t)std::min<int32_t>(
-        (int32_t)font->metrics_.max_ascent + (int32_t)font->metrics_.max_descent,
+    metrics_.line_height = (int16_t)std::min<int32_t>(
+        (int32_t)metrics_.max_ascent + (int32_t)metrics_.max_descent,
         std::numeric_limits<int16_t>::max());
-    font->valid_ = true;
-    return font;
+    BuildLookup();
+    serial_ = g_next_font_serial.fetch_add(1, std::memory_order_relaxed);
+    valid_ = true;
+    return true;
 }
 
 /** @brief Return the precomputed aggregate metrics for this font. */
@@ -163,23 +200,67 @@ const VlwMetrics &VlwFont::metrics() const
     return metrics_;
 }
 
+/** @brief Sort the parsed glyphs by codepoint and build the tables `FindGlyph()` reads. */
+void VlwFont::BuildLookup()
+{
+    std::stable_sort(glyphs_.begin(), glyphs_.end(), [](const VlwGlyph &a, const VlwGlyph &b) {
+        return a.codepoint < b.codepoint;
+    });
+    // A codepoint listed twice resolves to its last entry in file order, which the stable sort
+    // leaves last in its run.
+    size_t kept = 0;
+    for (size_t i = 0; i < glyphs_.size(); ++i) {
+        if (i + 1 < glyphs_.size() && glyphs_[i + 1].codepoint == glyphs_[i].codepoint) {
+            continue;
+        }
+        glyphs_[kept++] = glyphs_[i];
+    }
+    glyphs_.resize(kept);
+    glyphs_.shrink_to_fit();
+
+    codepoints_.resize(glyphs_.size());
+    std::fill(std::begin(latin1_glyphs_), std::end(latin1_glyphs_), kNoGlyph);
+    first_non_latin1_ = glyphs_.size();
+    for (size_t i = 0; i < glyphs_.size(); ++i) {
+        const uint16_t codepoint = glyphs_[i].codepoint;
+        codepoints_[i] = codepoint;
+        if (codepoint < 256u) {
+            latin1_glyphs_[codepoint] = (uint16_t)i;
+        } else if (first_non_latin1_ == glyphs_.size()) {
+            first_non_latin1_ = i;
+        }
+    }
+}
+
 /** @brief Find a glyph record by its Unicode codepoint. */
 const VlwGlyph *VlwFont::FindGlyph(uint16_t codepoint) const
 {
-    auto it = glyph_lookup_.find(codepoint);
-    if (it == glyph_lookup_.end()) {
+    if (codepoint < 256u) {
+        const uint16_t index = latin1_glyphs_[codepoint];
+        return index == kNoGlyph ? nullptr : &glyphs_[index];
+    }
+
+    // Branchless binary search: `base` ends on the last codepoint <= `codepoint`, if any.
+    size_t n = codepoints_.size() - first_non_latin1_;
+    if (n == 0) {
         return nullptr;
     }
-    return &glyphs_[it->second];
+    const uint16_t *base = codepoints_.data() + first_non_latin1_;
+    while (n > 1) {
+        const size_t half = n >> 1;
+        base = base[half] <= codepoint ? base + half : base;
+        n -= half;
+    }
+    return *base == codepoint ? &glyphs_[(size_t)(base - codepoints_.data())] : nullptr;
 }
 
-/** @brief Return the start of a glyph's bitmap inside the copied VLW payload. */
+/** @brief Return the start of a glyph's bitmap inside the VLW payload. */
 const uint8_t *VlwFont::GlyphBitmap(const VlwGlyph &glyph) const
 {
-    if (glyph.bitmap_offset >= bytes_.size()) {
+    if (glyph.bitmap_offset >= size_) {
         return nullptr;
     }
-    return bytes_.data() + glyph.bitmap_offset;
+    return data_ + glyph.bitmap_offset;
 }
 
 /** @brief Report whether the font finished parsing successfully. */
@@ -193,3 +274,9 @@ const char *VlwFont::debug_name() const
 {
     return debug_name_.c_str();
 }
+
+/** @brief Return the process-unique id assigned when this font was parsed. */
+uint32_t VlwFont::serial() const
+{
+    return serial_;
+}
@@ -4,7 +4,6 @@
 #include <cstdint>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 /** @brief Metadata for one glyph entry parsed from a VLW font. */
@@ -21,7 +20,7 @@ struct VlwGlyph {
     int16_t y_delta = 0;
     /** Horizontal bitmap offset relative to the text cursor. */
     int8_t x_delta = 0;
-    /** Byte offset of the glyph bitmap inside the copied VLW payload. */
+    /** Byte offset of the glyph bitmap inside the VLW payload. */
     uint32_t bitmap_offset = 0;
 };
 
@@ -43,7 +42,7 @@ struct VlwMetrics {
     uint16_t space_width = 0;
 };
 
-/** @brief Parsed VLW font data with immutable glyph and bitmap lookup tables. */
+/** @brief Parsed VLW font data with immutable glyph and bitmap lookup tables, over a copied or borrowed payload. */
 class VlwFont {
 public:
     /**
@@ -60,22 +59,64 @@ public:
         const char *debug_name,
         std::string *out_error = nullptr);
 
+    /**
+     * @brief Validate a VLW payload and reference it in place instead of copying it.
+     *
+     * Only the glyph tables are built; bitmaps are read from @p ptr for the life of the font.
+     * Use it for bytes that outlive every user of the font: firmware rodata (pass a null
+     * @p owner), or a pinned buffer whose owner is handed over in @p owner and released
+     * together with the font.
+     * @param ptr Source VLW bytes; must stay valid and unchanged while the font exists.
+     * @param len Length of @p ptr in bytes.
+     * @param debug_name Human-readable name used in logs and errors.
+     * @param owner Optional keep-alive for the memory behind @p ptr.
+     * @param out_error Optional parse error output.
+     * @return Parsed font on success, otherwise `nullptr`.
+     */
+    static std::shared_ptr<VlwFont> CreateBorrowed(
+        const uint8_t *ptr,
+        size_t len,
+        const char *debug_name,
+        std::shared_ptr<const void> owner = nullptr,
+        std::string *out_error = nullptr);
+
     /** @brief Return aggregate metrics for the parsed font. */
     const VlwMetrics &metrics() const;
     /** @brief Look up a glyph by Unicode codepoint. */
     const VlwGlyph *FindGlyph(uint16_t codepoint) const;
-    /** @brief Return a pointer to the copied bitmap data for a glyph. */
+    /** @brief Return a pointer to the bitmap data for a glyph. */
     const uint8_t *GlyphBitmap(const VlwGlyph &glyph) const;
     /** @brief True when parsing succeeded and the font data is internally consistent. */
     bool IsValid() const;
     /** @brief Human-readable font name used for diagnostics. */
     const char *debug_name() const;
+    /** @brief Process-unique id of this font, never reused; keys glyph caches that outlive the font. */
+    uint32_t serial() const;
 
 private:
+    bool Parse(const uint8_t *bytes, size_t len, const char *debug_name, std::string *out_error);
+    void BuildLookup();
+
     VlwMetrics metrics_ = {};
     std::string debug_name_;
+    /** Private copy of the payload for `CreateCopy()`; empty for borrowed fonts. */
     std::vector<uint8_t> bytes_;
+    /** Keeps the memory behind a borrowed payload alive, if it has an owner. */
+    std::shared_ptr<const void> owner_;
+    /** The payload: `bytes_.data()` or the borrowed bytes. */
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    /** Marks a Latin-1 codepoint without a glyph in `latin1_glyphs_`. */
+    static constexpr uint16_t kNoGlyph = 0xFFFF;
+
+    /** Glyphs sorted by codepoint, one per codepoint. */
     std::vector<VlwGlyph> glyphs_;
-    std::unordered_map<uint16_t, size_t> glyph_lookup_;
+    /** `glyphs_[i].codepoint`, packed densely for the binary search in `FindGlyph()`. */
+    std::vector<uint16_t> codepoints_;
+    /** Index into `glyphs_` for each codepoint below 256, or `kNoGlyph`. */
+    uint16_t latin1_glyphs_[256] = {};
+    /** Index of the first glyph at or above U+0100. */
+    size_t first_non_latin1_ = 0;
+    uint32_t serial_ = 0;
     bool valid_ = false;
 };
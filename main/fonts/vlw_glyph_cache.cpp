@@ -0,0 +1,89 @@
+#include "fonts/vlw_glyph_cache.h"
+
+#include <algorithm>
+#include <new>
+
+/** @brief Mix the key fields into one hash value. */
+size_t VlwGlyphCache::KeyHash::operator()(const Key &key) const
+{
+    uint32_t h = key.font_serial * 0x9E3779B1u;
+    h ^= (uint32_t)key.codepoint + 0x7F4A7C15u + (h << 6) + (h >> 2);
+    h ^= (uint32_t)key.scale_x + 0x7F4A7C15u + (h << 6) + (h >> 2);
+    h ^= (uint32_t)key.scale_y + 0x7F4A7C15u + (h << 6) + (h >> 2);
+    return h;
+}
+
+/** @brief Return the scaled glyph for the key, scaling and inserting it on a miss. */
+const VlwScaledGlyph *VlwGlyphCache::Get(
+    uint32_t font_serial,
+    uint16_t codepoint,
+    int32_t scale_x,
+    int32_t scale_y,
+    const uint8_t *bitmap,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t scaled_w,
+    int32_t scaled_h)
+{
+    const Key key = {font_serial, codepoint, scale_x, scale_y};
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, found->second);
+        return &found->second->glyph;
+    }
+
+    if (!bitmap || src_w <= 0 || src_h <= 0 || scaled_w <= 0 || scaled_h <= 0) {
+        return nullptr;
+    }
+    const size_t size = (size_t)scaled_w * (size_t)scaled_h;
+    if (size > kBudgetBytes) {
+        return nullptr;
+    }
+    while (!lru_.empty() && bytes_ + size > kBudgetBytes) {
+        bytes_ -= (size_t)lru_.back().glyph.width * (size_t)lru_.back().glyph.height;
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+
+    std::unique_ptr<uint8_t[]> coverage(new (std::nothrow) uint8_t[size]);
+    if (!coverage) {
+        return nullptr;
+    }
+    ScaleCoverage(bitmap, src_w, src_h, scaled_w, scaled_h, coverage.get());
+
+    lru_.emplace_front();
+    Entry &entry = lru_.front();
+    entry.key = key;
+    entry.glyph.width = scaled_w;
+    entry.glyph.height = scaled_h;
+    entry.glyph.coverage = std::move(coverage);
+    index_[key] = lru_.begin();
+    bytes_ += size;
+    return &entry.glyph;
+}
+
+/** @brief Sample a coverage bitmap at the scaled size. */
+void VlwGlyphCache::ScaleCoverage(
+    const uint8_t *bitmap,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t scaled_w,
+    int32_t scaled_h,
+    uint8_t *out)
+{
+    for (int32_t dy = 0; dy < scaled_h; ++dy) {
+        const int32_t src_y = std::min<int32_t>((dy * src_h) / scaled_h, src_h - 1);
+        const uint8_t *src_row = bitmap + (size_t)src_y * (size_t)src_w;
+        for (int32_t dx = 0; dx < scaled_w; ++dx) {
+            *out++ = src_row[std::min<int32_t>((dx * src_w) / scaled_w, src_w - 1)];
+        }
+    }
+}
+
+/** @brief Drop every cached glyph and return its memory. */
+void VlwGlyphCache::Clear()
+{
+    index_.clear();
+    lru_.clear();
+    bytes_ = 0;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+/** @brief Coverage bitmap of one glyph at one text scale, ready to blend row by row. */
+struct VlwScaledGlyph {
+    /** Scaled width in pixels; also the bitmap stride. */
+    int32_t width = 0;
+    /** Scaled height in pixels. */
+    int32_t height = 0;
+    /** `width * height` coverage values (0 = transparent, 255 = solid). */
+    std::unique_ptr<uint8_t[]> coverage;
+};
+
+/**
+ * @brief LRU of nearest-neighbor scaled VLW glyph bitmaps keyed by (font, codepoint, scale).
+ *
+ * Unscaled text reads the font's own bitmaps and never lands here; scaled text would otherwise
+ * redo the per-pixel source lookups for every glyph drawn. Entries are charged by bitmap size
+ * against a byte budget and the least recently used ones are dropped first. Fonts are keyed by
+ * `VlwFont::serial()`, so entries of a freed font simply age out.
+ */
+class VlwGlyphCache {
+public:
+    /** Byte budget for coverage bitmaps: a few hundred glyphs of body text at 2x. */
+    static constexpr size_t kBudgetBytes = 96 * 1024;
+
+    /**
+     * @brief Scaled bitmap of a glyph, built from @p bitmap on a miss and marked most recently used.
+     * @param font_serial `VlwFont::serial()` of the glyph's font.
+     * @param scale_x Horizontal scale in 16.16 fixed point, as used by the renderer.
+     * @param bitmap Source `src_w x src_h` coverage bitmap.
+     * @param scaled_w Width to scale to (at least 1).
+     * @param scaled_h Height to scale to (at least 1).
+     * @return The cached glyph, or null if it is larger than the budget or memory runs out.
+     */
+    const VlwScaledGlyph *Get(
+        uint32_t font_serial,
+        uint16_t codepoint,
+        int32_t scale_x,
+        int32_t scale_y,
+        const uint8_t *bitmap,
+        int32_t src_w,
+        int32_t src_h,
+        int32_t scaled_w,
+        int32_t scaled_h);
+    /**
+     * @brief Nearest-neighbor scale a `src_w x src_h` coverage bitmap into `scaled_w x scaled_h` bytes at @p out.
+     *
+     * Source column/row `d * src / scaled`, clamped to the last one, as the renderer samples.
+     */
+    static void ScaleCoverage(
+        const uint8_t *bitmap,
+        int32_t src_w,
+        int32_t src_h,
+        int32_t scaled_w,
+        int32_t scaled_h,
+        uint8_t *out);
+    /** @brief Free every cached bitmap. */
+    void Clear();
+
+    /** @brief Coverage bytes currently held. */
+    size_t bytes() const { return bytes_; }
+
+private:
+    struct Key {
+        uint32_t font_serial;
+        uint16_t codepoint;
+        int32_t scale_x;
+        int32_t scale_y;
+
+        bool operator==(const Key &other) const
+        {
+            return font_serial == other.font_serial && codepoint == other.codepoint && scale_x == other.scale_x
+                && scale_y == other.scale_y;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    struct Entry {
+        Key key;
+        VlwScaledGlyph glyph;
+    };
+
+    std::list<Entry> lru_; ///< Most recently used first.
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    size_t bytes_ = 0;
+};
@@ -99,7 +99,8 @@ std::shared_ptr<VlwFont> GetSystemVlwFont(int32_t font_id, std::string *out_erro
             break;
         }
 
-        slot.font = VlwFont::CreateCopy(font_ptr, font_len, font_name, &slot.error);
+        // The payload is firmware rodata, so the font can read its bitmaps in place.
+        slot.font = VlwFont::CreateBorrowed(font_ptr, font_len, font_name, nullptr, &slot.error);
         if (!slot.font && slot.error.empty()) {
             slot.error = "failed to parse embedded VLW font";
         }
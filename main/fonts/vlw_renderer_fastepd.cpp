@@ -1,9 +1,14 @@
 #include "fonts/vlw_renderer_fastepd.h"
 
 #include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <vector>
 
+#include "other/fastepd_native_utils.h"
 #include "wasm/api/errors.h"
 
 namespace {
@@ -26,8 +31,8 @@ struct PreparedText {
     int32_t width = 0;
 };
 
-/** @brief Decode one UTF-8 code unit sequence into a BMP codepoint. */
-uint16_t decode_utf8_char(const char **cursor)
+/** @brief Decode one UTF-8 code unit sequence ending before `end` into a BMP codepoint. */
+uint16_t decode_utf8_char(const char **cursor, const char *end)
 {
     const uint8_t c0 = (uint8_t)**cursor;
     if ((c0 & 0x80u) == 0) {
@@ -35,13 +40,14 @@ uint16_t decode_utf8_char(const char **cursor)
         return c0;
     }
 
-    if ((c0 & 0xE0u) == 0xC0u && (uint8_t)(*cursor)[1] != 0) {
+    const ptrdiff_t avail = end - *cursor;
+    if ((c0 & 0xE0u) == 0xC0u && avail >= 2 && (uint8_t)(*cursor)[1] != 0) {
         const uint16_t code = (uint16_t)(((c0 & 0x1Fu) << 6) | ((uint8_t)(*cursor)[1] & 0x3Fu));
         *cursor += 2;
         return code;
     }
 
-    if ((c0 & 0xF0u) == 0xE0u && (uint8_t)(*cursor)[1] != 0 && (uint8_t)(*cursor)[2] != 0) {
+    if ((c0 & 0xF0u) == 0xE0u && avail >= 3 && (uint8_t)(*cursor)[1] != 0 && (uint8_t)(*cursor)[2] != 0) {
         const uint16_t code = (uint16_t)(((c0 & 0x0Fu) << 12) | (((uint8_t)(*cursor)[1] & 0x3Fu) << 6)
             | ((uint8_t)(*cursor)[2] & 0x3Fu));
         *cursor += 3;
@@ -53,10 +59,10 @@ uint16_t decode_utf8_char(const char **cursor)
 }
 
 /** @brief Decode the next codepoint using the active UTF-8 or CP437 text mode. */
-uint16_t decode_next_codepoint(const char **cursor, const FastEpdVlwTextState &state)
+uint16_t decode_next_codepoint(const char **cursor, const char *end, const FastEpdVlwTextState &state)
 {
     if (state.utf8_enabled) {
-        return decode_utf8_char(cursor);
+        return decode_utf8_char(cursor, end);
     }
 
     uint16_t codepoint = (uint8_t)**cursor;
@@ -115,27 +121,31 @@ PreparedGlyph prepare_glyph(const VlwFont &font, uint16_t codepoint)
     return prepared;
 }
 
-/** @brief Decode text and precompute glyph positions needed for measure and draw. */
-PreparedText prepare_text(const VlwFont &font, const FastEpdVlwTextState &state, const char *text)
-{
-    PreparedText prepared = {};
-    if (!text || text[0] == '\0') {
-        return prepared;
-    }
-
-    const int32_t sx = scale_fixed(state.size_x);
+/**
+ * @brief Running extent of a glyph run: the pen position and the rightmost pixel so far.
+ *
+ * A first glyph that hangs left of the pen (negative `x_delta`) shifts the whole run right
+ * by `initial_offset` so its ink starts at the run origin.
+ */
+struct RunMeasure {
     int32_t left = 0;
     int32_t right = 0;
+    int32_t initial_offset = 0;
 
-    const char *cursor = text;
-    while (*cursor) {
-        const PreparedGlyph glyph = prepare_glyph(font, decode_next_codepoint(&cursor, state));
-        prepared.glyphs.push_back(glyph);
+    /** @brief Extent after appending `glyph`, without changing the run. */
+    int32_t RightAfter(const PreparedGlyph &glyph, int32_t sx) const
+    {
+        RunMeasure next = *this;
+        next.Add(glyph, sx);
+        return next.right;
+    }
 
+    void Add(const PreparedGlyph &glyph, int32_t sx)
+    {
         const int32_t scaled_offset = ((int32_t)glyph.x_delta * sx) >> 16;
         if (left == 0 && right == 0 && glyph.x_delta < 0) {
             left = right = -scaled_offset;
-            prepared.initial_offset = -scaled_offset;
+            initial_offset = -scaled_offset;
         }
 
         const int32_t scaled_advance = scale_dim(glyph.x_advance, sx);
@@ -143,8 +153,30 @@ PreparedText prepare_text(const VlwFont &font, const FastEpdVlwTextState &state,
         right = left + std::max<int32_t>(scaled_advance, scaled_width + scaled_offset);
         left += scaled_advance;
     }
+};
 
-    prepared.width = right;
+/** @brief Decode text and precompute glyph positions needed for measure and draw. */
+PreparedText prepare_text(const VlwFont &font, const FastEpdVlwTextState &state, const char *text, size_t len)
+{
+    PreparedText prepared = {};
+    if (!text || len == 0 || text[0] == '\0') {
+        return prepared;
+    }
+
+    const int32_t sx = scale_fixed(state.size_x);
+    RunMeasure run;
+
+    // Like a C string, the run ends at the first NUL even inside `len`.
+    const char *cursor = text;
+    const char *end = text + len;
+    while (cursor < end && *cursor) {
+        const PreparedGlyph glyph = prepare_glyph(font, decode_next_codepoint(&cursor, end, state));
+        prepared.glyphs.push_back(glyph);
+        run.Add(glyph, sx);
+    }
+
+    prepared.initial_offset = run.initial_offset;
+    prepared.width = run.right;
     return prepared;
 }
 
@@ -183,123 +215,131 @@ uint8_t epd_color_to_gray8(uint8_t color, int32_t mode)
     return (uint8_t)(color * 17u);
 }
 
-/** @brief Normalize the reported panel rotation to the four logical orientations. */
-int32_t logical_rotation(FASTEPD &epd)
+/**
+ * @brief Per-string tables turning glyph coverage into raw native pixel values.
+ *
+ * Built once per `DrawString()` so the blend loop is table lookups plus one multiply-add per
+ * pixel instead of the rotation math and per-pixel quantization of a `drawPixelFast()` call.
+ */
+struct GlyphBlend {
+    fastepd_native_utils::NativeLayout layout = {};
+    bool use_bg = false;
+    uint8_t fg_gray = 0;
+    /** Gray8 -> raw native value for the target mode. */
+    uint8_t quantize[256] = {};
+    /** Coverage -> raw native value over the background color (`use_bg` only). */
+    uint8_t over_bg[256] = {};
+    /** Raw native value -> gray8, for blending over what the framebuffer holds. */
+    uint8_t raw_gray[16] = {};
+};
+
+/** @brief `(x + 127) / 255` for the blend sums below; exact for every sum of two 8-bit products. */
+inline uint8_t div255_round(uint32_t x)
 {
-    const int rotation = epd.getRotation();
-    switch (rotation) {
-    case 0:
-    case 90:
-    case 180:
-    case 270:
-        return rotation;
-    default:
-        return 0;
-    }
+    x += 127u;
+    return (uint8_t)((x + 1u + (x >> 8)) >> 8);
 }
 
-/** @brief Read the existing framebuffer pixel so glyph alpha can blend over it. */
-uint8_t read_epd_pixel(FASTEPD &epd, int32_t x, int32_t y)
+/** @brief Fill `blend` for drawing `state`'s colors into `epd`; `false` if its buffer cannot be addressed. */
+bool prepare_glyph_blend(FASTEPD &epd, const FastEpdVlwTextState &state, GlyphBlend *blend)
 {
-    if (x < 0 || y < 0 || x >= epd.width() || y >= epd.height()) {
-        return 0;
+    if (!fastepd_native_utils::describeNativeLayout(epd, &blend->layout)) {
+        return false;
     }
-
-    uint8_t *buffer = epd.currentBuffer();
-    if (!buffer) {
-        return 0;
-    }
-
     const int32_t mode = epd.getMode();
-    const int32_t rotation = logical_rotation(epd);
-    const int32_t logical_width = epd.width();
-    const int32_t logical_height = epd.height();
-    const int32_t native_width = (rotation == 0 || rotation == 180) ? logical_width : logical_height;
-
-    if (mode == BB_MODE_1BPP) {
-        const int32_t pitch = (native_width + 7) >> 3;
-        int32_t index = 0;
-        uint8_t mask = 0;
-        switch (rotation) {
-        case 0:
-            index = (x >> 3) + (y * pitch);
-            mask = (uint8_t)(0x80u >> (x & 7));
-            break;
-        case 90:
-            index = (y >> 3) + ((logical_width - 1 - x) * pitch);
-            mask = (uint8_t)(0x80u >> (y & 7));
-            break;
-        case 180:
-            index = ((logical_width - 1 - x) >> 3) + ((logical_height - 1 - y) * pitch);
-            mask = (uint8_t)(1u << (x & 7));
-            break;
-        default:
-            index = ((logical_height - 1 - y) >> 3) + (x * pitch);
-            mask = (uint8_t)(1u << (y & 7));
-            break;
+    const int32_t bpp = blend->layout.bpp;
+    for (uint32_t gray = 0; gray < 256u; ++gray) {
+        blend->quantize[gray] = fastepd_native_utils::nativePixelValue(bpp, gray8_to_epd_color((uint8_t)gray, mode));
+    }
+    for (uint32_t raw = 0; raw < (1u << bpp); ++raw) {
+        const uint8_t color = bpp == 1 ? (raw ? (uint8_t)BBEP_WHITE : (uint8_t)BBEP_BLACK) : (uint8_t)raw;
+        blend->raw_gray[raw] = epd_color_to_gray8(color, mode);
+    }
+    blend->use_bg = state.use_bg;
+    blend->fg_gray = rgb888_to_gray8(state.fg_rgb888);
+    if (state.use_bg) {
+        const uint32_t bg_gray = rgb888_to_gray8(state.bg_rgb888);
+        for (uint32_t alpha = 0; alpha < 256u; ++alpha) {
+            blend->over_bg[alpha] = blend->quantize[div255_round(bg_gray * (255u - alpha) + blend->fg_gray * alpha)];
         }
-        return (buffer[index] & mask) ? (uint8_t)BBEP_WHITE : (uint8_t)BBEP_BLACK;
     }
+    return true;
+}
 
-    if (mode == BB_MODE_2BPP) {
-        const int32_t pitch = native_width >> 2;
-        int32_t index = 0;
-        int shift = 0;
-        switch (rotation) {
-        case 0:
-            index = (x >> 2) + (y * pitch);
-            shift = (3 - (x & 3)) * 2;
-            break;
-        case 90:
-            index = (y >> 2) + ((logical_width - 1 - x) * pitch);
-            shift = (3 - (y & 3)) * 2;
-            break;
-        case 180:
-            index = ((logical_width - 1 - x) >> 2) + ((logical_height - 1 - y) * pitch);
-            shift = (x & 3) * 2;
-            break;
-        default:
-            index = ((logical_height - 1 - y) >> 2) + (x * pitch);
-            shift = (y & 3) * 2;
-            break;
+/**
+ * @brief Blend a `nw x nh` native rect of coverage from `src` (logical order, `src_stride` per row).
+ *
+ * Walks native rows so every destination byte is merged once per row by `packRawSpan()`;
+ * transparent pixels keep their value.
+ */
+template <int BPP>
+void blend_coverage_native(
+    const GlyphBlend &blend,
+    int32_t nx0,
+    int32_t ny0,
+    int32_t nw,
+    int32_t nh,
+    const uint8_t *src,
+    int32_t src_stride)
+{
+    constexpr int32_t kPerByte = 8 / BPP;
+    constexpr uint32_t kPixelMask = (1u << BPP) - 1u;
+    const fastepd_native_utils::NativeLayout &layout = blend.layout;
+    uint8_t values[fastepd_native_utils::kBlitChunkPixels];
+    uint8_t opaque[fastepd_native_utils::kBlitChunkPixels];
+    for (int32_t r = 0; r < nh; ++r) {
+        uint8_t *row = layout.buffer + (size_t)(ny0 + r) * (size_t)layout.pitch;
+        ptrdiff_t step = 1;
+        const uint8_t *origin = fastepd_native_utils::nativeRowSource(layout, src, src_stride, nw, nh, r, &step);
+        for (int32_t c0 = 0; c0 < nw; c0 += fastepd_native_utils::kBlitChunkPixels) {
+            const int32_t n = std::min<int32_t>(nw - c0, fastepd_native_utils::kBlitChunkPixels);
+            const uint8_t *coverage = origin + (ptrdiff_t)c0 * step;
+            for (int32_t i = 0; i < n; ++i, coverage += step) {
+                const uint32_t alpha = *coverage;
+                opaque[i] = (uint8_t)(alpha != 0u);
+                if (alpha == 0u) {
+                    values[i] = 0;
+                } else if (blend.use_bg) {
+                    values[i] = blend.over_bg[alpha];
+                } else {
+                    const int32_t nx = nx0 + c0 + i;
+                    const uint32_t raw = (row[nx / kPerByte] >> (8 - BPP * (nx % kPerByte + 1))) & kPixelMask;
+                    const uint32_t base_gray = blend.raw_gray[raw];
+                    values[i] = blend.quantize[div255_round(base_gray * (255u - alpha) + blend.fg_gray * alpha)];
+                }
+            }
+            fastepd_native_utils::packRawSpan<BPP>(row, nx0 + c0, n, values, opaque);
         }
-        return (uint8_t)((buffer[index] >> shift) & 0x03u);
     }
+}
 
-    const int32_t pitch = native_width >> 1;
-    int32_t index = 0;
-    bool low_nibble = false;
-    switch (rotation) {
-    case 0:
-        index = (x >> 1) + (y * pitch);
-        low_nibble = (x & 1) != 0;
-        break;
-    case 90:
-        index = (y >> 1) + ((logical_width - 1 - x) * pitch);
-        low_nibble = (y & 1) != 0;
-        break;
-    case 180:
-        index = ((logical_width - 1 - x) >> 1) + ((logical_height - 1 - y) * pitch);
-        low_nibble = (x & 1) == 0;
-        break;
-    default:
-        index = ((logical_height - 1 - y) >> 1) + (x * pitch);
-        low_nibble = (y & 1) == 0;
-        break;
+/** @brief Grow `bounds` to include the `w x h` box at `(x, y)`; an empty bounds adopts the box. */
+void extend_bounds(BB_RECT *bounds, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    if (!bounds || w <= 0 || h <= 0) {
+        return;
     }
-
-    const uint8_t value = buffer[index];
-    return low_nibble ? (uint8_t)(value & 0x0Fu) : (uint8_t)((value >> 4) & 0x0Fu);
+    if (bounds->w <= 0 || bounds->h <= 0) {
+        *bounds = BB_RECT{x, y, w, h};
+        return;
+    }
+    const int32_t x0 = std::min<int32_t>(bounds->x, x);
+    const int32_t y0 = std::min<int32_t>(bounds->y, y);
+    const int32_t x1 = std::max<int32_t>(bounds->x + bounds->w, x + w);
+    const int32_t y1 = std::max<int32_t>(bounds->y + bounds->h, y + h);
+    *bounds = BB_RECT{x0, y0, x1 - x0, y1 - y0};
 }
 
 /** @brief Rasterize one glyph bitmap into the framebuffer with grayscale blending. */
 void blend_glyph(
-    FASTEPD &epd,
+    const GlyphBlend &blend,
     const PreparedGlyph &glyph,
     const VlwFont &font,
     const FastEpdVlwTextState &state,
     int32_t cursor_x,
-    int32_t line_top_y)
+    int32_t line_top_y,
+    BB_RECT *bounds,
+    VlwGlyphCache *glyph_cache)
 {
     if (!glyph.bitmap || glyph.width == 0 || glyph.height == 0) {
         return;
@@ -311,50 +351,281 @@ void blend_glyph(
     const int32_t scaled_height = scale_dim(glyph.height, sy);
     const int32_t draw_x = cursor_x + (((int32_t)glyph.x_delta * sx) >> 16);
     const int32_t draw_y = line_top_y + (((int32_t)font.metrics().max_ascent - (int32_t)glyph.y_delta) * sy >> 16);
-    const int32_t mode = epd.getMode();
-    const uint8_t fg_gray = rgb888_to_gray8(state.fg_rgb888);
-    const uint8_t bg_gray = rgb888_to_gray8(state.bg_rgb888);
+    extend_bounds(bounds, draw_x, draw_y, scaled_width, scaled_height);
+
+    const fastepd_native_utils::NativeLayout &layout = blend.layout;
+    const int32_t x0 = std::max<int32_t>(draw_x, 0);
+    const int32_t y0 = std::max<int32_t>(draw_y, 0);
+    const int32_t x1 = std::min<int32_t>(draw_x + scaled_width, layout.logical_w);
+    const int32_t y1 = std::min<int32_t>(draw_y + scaled_height, layout.logical_h);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    // Unscaled glyphs blend straight from the font; scaled ones come from the cache, or from a
+    // scratch copy when there is no cache or it cannot hold the glyph.
+    const uint8_t *coverage = glyph.bitmap;
+    std::unique_ptr<uint8_t[]> scratch;
+    if (scaled_width != glyph.width || scaled_height != glyph.height) {
+        const VlwScaledGlyph *scaled = glyph_cache
+            ? glyph_cache->Get(font.serial(), glyph.codepoint, sx, sy, glyph.bitmap, glyph.width, glyph.height,
+                  scaled_width, scaled_height)
+            : nullptr;
+        if (scaled) {
+            coverage = scaled->coverage.get();
+        } else {
+            scratch.reset(new (std::nothrow) uint8_t[(size_t)scaled_width * (size_t)scaled_height]);
+            if (!scratch) {
+                return;
+            }
+            VlwGlyphCache::ScaleCoverage(glyph.bitmap, glyph.width, glyph.height, scaled_width, scaled_height, scratch.get());
+            coverage = scratch.get();
+        }
+    }
+
+    const uint8_t *src = coverage + (size_t)(y0 - draw_y) * (size_t)scaled_width + (size_t)(x0 - draw_x);
+    int32_t nx = 0;
+    int32_t ny = 0;
+    int32_t nw = 0;
+    int32_t nh = 0;
+    fastepd_native_utils::logicalRectToNative(layout, x0, y0, x1 - x0, y1 - y0, &nx, &ny, &nw, &nh);
+    switch (layout.bpp) {
+    case 1:
+        blend_coverage_native<1>(blend, nx, ny, nw, nh, src, scaled_width);
+        break;
+    case 2:
+        blend_coverage_native<2>(blend, nx, ny, nw, nh, src, scaled_width);
+        break;
+    default:
+        blend_coverage_native<4>(blend, nx, ny, nw, nh, src, scaled_width);
+        break;
+    }
+}
+
+/** @brief Paint the background box (when enabled) and the glyphs of one run with its origin at `(x, y)`. */
+void draw_run(
+    FASTEPD &epd,
+    const GlyphBlend *blend,
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const PreparedGlyph *glyphs,
+    size_t count,
+    int32_t initial_offset,
+    int32_t width,
+    int32_t x,
+    int32_t y,
+    int32_t cheight,
+    BB_RECT *bounds,
+    VlwGlyphCache *glyph_cache)
+{
+    if (state.use_bg && width > 0 && cheight > 0) {
+        epd.fillRect(x, y, width, cheight, gray8_to_epd_color(rgb888_to_gray8(state.bg_rgb888), epd.getMode()));
+        extend_bounds(bounds, x, y, width, cheight);
+    }
+    if (!blend) {
+        return;
+    }
+
+    const int32_t sx = scale_fixed(state.size_x);
+    int32_t cursor_x = x + initial_offset;
+    for (size_t i = 0; i < count; ++i) {
+        blend_glyph(*blend, glyphs[i], font, state, cursor_x, y, bounds, glyph_cache);
+        cursor_x += scale_dim(glyphs[i].x_advance, sx);
+    }
+}
+
+/** @brief One laid-out paragraph line; the vectors are reused from line to line. */
+struct ParagraphLine {
+    /** Glyphs of the line, trailing spaces dropped. */
+    std::vector<PreparedGlyph> glyphs;
+    /** Byte offset of each glyph in the text. */
+    std::vector<size_t> offsets;
+    /** Extent of `glyphs`. */
+    RunMeasure run;
+    /** Byte offset where the next line starts. */
+    size_t next = 0;
+};
+
+/**
+ * @brief Lay out the line starting at byte `pos` of `text`.
+ *
+ * The line ends at a newline, at the end of the text, or before the first glyph that would
+ * cross `box.w`. By default it then backs up to the start of the last word, a word starting
+ * after a space or a hyphen; a line holding a single word, or `break_anywhere`, breaks between
+ * characters instead. Spaces never cause a break: they may hang past the edge and are dropped
+ * from the end of the line. A line always keeps at least one glyph, so layout always advances.
+ */
+void layout_line(
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    size_t len,
+    size_t pos,
+    const FastEpdVlwParagraph &box,
+    ParagraphLine *line)
+{
+    line->glyphs.clear();
+    line->offsets.clear();
+    line->next = len;
 
-    for (int32_t dy = 0; dy < scaled_height; ++dy) {
-        const int32_t py = draw_y + dy;
-        if (py < 0 || py >= epd.height()) {
+    const int32_t sx = scale_fixed(state.size_x);
+    const char *const end = text + len;
+    const char *cursor = text + pos;
+    RunMeasure run;
+    size_t word_start = 0;
+    bool after_break_char = false;
+    while (cursor < end) {
+        const char *at = cursor;
+        const uint16_t codepoint = decode_next_codepoint(&cursor, end, state);
+        if (codepoint == '\n') {
+            line->next = (size_t)(cursor - text);
+            break;
+        }
+        if (codepoint == '\r') {
             continue;
         }
-        const int32_t src_y = std::min<int32_t>((dy * (int32_t)glyph.height) / scaled_height, (int32_t)glyph.height - 1);
-        for (int32_t dx = 0; dx < scaled_width; ++dx) {
-            const int32_t px = draw_x + dx;
-            if (px < 0 || px >= epd.width()) {
-                continue;
-            }
 
-            const int32_t src_x = std::min<int32_t>((dx * (int32_t)glyph.width) / scaled_width, (int32_t)glyph.width - 1);
-            const uint8_t alpha = glyph.bitmap[src_y * glyph.width + src_x];
-            if (alpha == 0u) {
-                continue;
+        const PreparedGlyph glyph = prepare_glyph(font, codepoint);
+        if (box.w > 0 && codepoint != ' ' && !line->glyphs.empty() && run.RightAfter(glyph, sx) > box.w) {
+            if (!box.break_anywhere && word_start > 0) {
+                line->next = line->offsets[word_start];
+                line->glyphs.resize(word_start);
+            } else {
+                line->next = (size_t)(at - text);
             }
+            break;
+        }
+        if (after_break_char && codepoint != ' ') {
+            word_start = line->glyphs.size();
+        }
+        after_break_char = codepoint == ' ' || codepoint == '-';
+        line->glyphs.push_back(glyph);
+        line->offsets.push_back((size_t)(at - text));
+        run.Add(glyph, sx);
+    }
 
-            uint8_t base_gray = bg_gray;
-            if (!state.use_bg) {
-                base_gray = epd_color_to_gray8(read_epd_pixel(epd, px, py), mode);
-            }
+    while (!line->glyphs.empty() && line->glyphs.back().codepoint == ' ') {
+        line->glyphs.pop_back();
+    }
+    line->run = RunMeasure{};
+    for (const PreparedGlyph &glyph : line->glyphs) {
+        line->run.Add(glyph, sx);
+    }
+}
 
-            const uint16_t blended = (uint16_t)base_gray * (uint16_t)(255u - alpha) + (uint16_t)fg_gray * (uint16_t)alpha;
-            const uint8_t gray = (uint8_t)((blended + 127u) / 255u);
-            epd.drawPixelFast(px, py, gray8_to_epd_color(gray, mode));
+/** @brief Scaled measuring metrics of one glyph, matching `RunMeasure::Add()`. */
+VlwAdvanceTable::Entry advance_entry(const PreparedGlyph &glyph, int32_t sx)
+{
+    VlwAdvanceTable::Entry entry;
+    entry.advance = scale_dim(glyph.x_advance, sx);
+    entry.offset = ((int32_t)glyph.x_delta * sx) >> 16;
+    entry.extent = std::max<int32_t>(entry.advance, scale_dim(glyph.width, sx) + entry.offset);
+    entry.hangs_left = glyph.x_delta < 0;
+    return entry;
+}
+
+/** @brief Entries for codepoints 0..255 of `font` at scale `sx`, rebuilding `advances` if it is stale. */
+const VlwAdvanceTable::Entry *latin1_advances(const VlwFont &font, int32_t sx, VlwAdvanceTable *advances)
+{
+    if (!advances) {
+        return nullptr;
+    }
+    if (advances->font_serial != font.serial() || advances->scale_x != sx) {
+        for (uint32_t codepoint = 0; codepoint < 256; ++codepoint) {
+            advances->latin1[codepoint] = advance_entry(prepare_glyph(font, (uint16_t)codepoint), sx);
+        }
+        advances->font_serial = font.serial();
+        advances->scale_x = sx;
+    }
+    return advances->latin1;
+}
+
+/**
+ * @brief Width of the text in `[text, end)`, stopping early at a NUL, without preparing glyphs.
+ *
+ * Same result as `prepare_text()`'s width; codepoints outside `latin1` (or all of them when it
+ * is null) are resolved one at a time.
+ */
+int32_t measure_span(
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const VlwAdvanceTable::Entry *latin1,
+    int32_t sx,
+    const char *text,
+    const char *end)
+{
+    int32_t left = 0;
+    int32_t right = 0;
+    const char *cursor = text;
+    while (cursor < end && *cursor) {
+        const uint16_t codepoint = decode_next_codepoint(&cursor, end, state);
+        const VlwAdvanceTable::Entry entry =
+            (latin1 && codepoint < 256u) ? latin1[codepoint] : advance_entry(prepare_glyph(font, codepoint), sx);
+        if (left == 0 && right == 0 && entry.hangs_left) {
+            left = right = -entry.offset;
         }
+        right = left + entry.extent;
+        left += entry.advance;
     }
+    return right;
 }
 
 } // namespace
 
 /** @brief Measure the rendered width of a text run using VLW metrics. */
-int32_t MeasureTextWidth(const VlwFont &font, const FastEpdVlwTextState &state, const char *text, int32_t *out_width)
+int32_t MeasureTextWidth(
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    int32_t *out_width,
+    VlwAdvanceTable *advances)
 {
     if (!out_width) {
         return kWasmErrInternal;
     }
+    if (!text) {
+        *out_width = 0;
+        return kWasmOk;
+    }
 
-    *out_width = prepare_text(font, state, text).width;
+    const int32_t sx = scale_fixed(state.size_x);
+    *out_width = measure_span(font, state, latin1_advances(font, sx, advances), sx, text, text + strlen(text));
+    return kWasmOk;
+}
+
+/** @brief Measure each NUL-separated string of a buffer. */
+int32_t MeasureTextWidths(
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *texts,
+    size_t len,
+    int32_t *out_widths,
+    size_t out_cap,
+    size_t *out_count,
+    VlwAdvanceTable *advances)
+{
+    if (!out_count || (!texts && len != 0) || (!out_widths && out_cap != 0)) {
+        return kWasmErrInternal;
+    }
+
+    const int32_t sx = scale_fixed(state.size_x);
+    const VlwAdvanceTable::Entry *latin1 = latin1_advances(font, sx, advances);
+    const char *cursor = texts;
+    const char *const end = texts + len;
+    size_t count = 0;
+    while (cursor < end && count < out_cap) {
+        const char *stop = (const char *)memchr(cursor, 0, (size_t)(end - cursor));
+        if (!stop) {
+            stop = end;
+        }
+        out_widths[count++] = measure_span(font, state, latin1, sx, cursor, stop);
+        if (stop == end) {
+            break;
+        }
+        cursor = stop + 1;
+    }
+
+    *out_count = count;
     return kWasmOk;
 }
 
@@ -377,13 +648,34 @@ int32_t DrawString(
     const char *text,
     int32_t x,
     int32_t y,
-    int32_t *out_width)
+    int32_t *out_width,
+    BB_RECT *out_bounds,
+    VlwGlyphCache *glyph_cache)
+{
+    return DrawString(epd, font, state, text, text ? strlen(text) : 0, x, y, out_width, out_bounds, glyph_cache);
+}
+
+/** @brief Draw a text span at the requested datum using VLW glyph bitmaps. */
+int32_t DrawString(
+    FASTEPD &epd,
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t *out_width,
+    BB_RECT *out_bounds,
+    VlwGlyphCache *glyph_cache)
 {
     if (!out_width) {
         return kWasmErrInternal;
     }
+    if (out_bounds) {
+        *out_bounds = BB_RECT{0, 0, 0, 0};
+    }
 
-    const PreparedText prepared = prepare_text(font, state, text);
+    const PreparedText prepared = prepare_text(font, state, text, len);
     const int32_t sy = scale_fixed(state.size_y);
     const int32_t cheight = scale_dim((uint16_t)font.metrics().line_height, sy);
     const int32_t baseline = scale_dim((uint16_t)font.metrics().max_ascent, sy);
@@ -404,16 +696,75 @@ int32_t DrawString(
         draw_x -= prepared.width;
     }
 
-    if (state.use_bg && prepared.width > 0 && cheight > 0) {
-        epd.fillRect(draw_x, draw_y, prepared.width, cheight, gray8_to_epd_color(rgb888_to_gray8(state.bg_rgb888), epd.getMode()));
+    GlyphBlend blend;
+    const bool can_blend = prepare_glyph_blend(epd, state, &blend);
+    draw_run(epd, can_blend ? &blend : nullptr, font, state, prepared.glyphs.data(), prepared.glyphs.size(),
+        prepared.initial_offset, prepared.width, draw_x, draw_y, cheight, out_bounds, glyph_cache);
+
+    *out_width = prepared.width;
+    return kWasmOk;
+}
+
+/** @brief Lay out a paragraph into a box line by line, drawing each line as it is placed. */
+int32_t DrawParagraph(
+    FASTEPD &epd,
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    size_t len,
+    const FastEpdVlwParagraph &box,
+    int32_t *line_starts,
+    size_t line_starts_cap,
+    int32_t *out_lines,
+    BB_RECT *out_bounds,
+    VlwGlyphCache *glyph_cache)
+{
+    if (!out_lines || (!text && len != 0) || (!line_starts && line_starts_cap != 0)) {
+        return kWasmErrInternal;
+    }
+    *out_lines = 0;
+    if (out_bounds) {
+        *out_bounds = BB_RECT{0, 0, 0, 0};
+    }
+
+    const int32_t cheight = scale_dim((uint16_t)font.metrics().line_height, scale_fixed(state.size_y));
+    const int64_t advance = (int64_t)cheight + box.line_spacing;
+    if (advance <= 0) {
+        return kWasmErrInvalidArgument;
     }
 
-    int32_t cursor_x = draw_x + prepared.initial_offset;
-    for (const PreparedGlyph &glyph : prepared.glyphs) {
-        blend_glyph(epd, glyph, font, state, cursor_x, draw_y);
-        cursor_x += scale_dim(glyph.x_advance, scale_fixed(state.size_x));
+    GlyphBlend blend;
+    const bool can_blend = !box.measure_only && prepare_glyph_blend(epd, state, &blend);
+    ParagraphLine line;
+    size_t pos = 0;
+    int32_t lines = 0;
+    while (pos < len) {
+        const int64_t top = (int64_t)box.y + (int64_t)lines * advance;
+        if ((box.h > 0 && top + cheight > (int64_t)box.y + box.h) || top > INT32_MAX) {
+            break;
+        }
+        layout_line(font, state, text, len, pos, box, &line);
+        if ((size_t)lines < line_starts_cap) {
+            line_starts[lines] = (int32_t)pos;
+        }
+        if (!box.measure_only) {
+            const int32_t width = line.run.right;
+            int32_t x = box.x;
+            if (box.w > 0 && box.align == 1) {
+                x += (box.w - width) >> 1;
+            } else if (box.w > 0 && box.align == 2) {
+                x += box.w - width;
+            }
+            draw_run(epd, can_blend ? &blend : nullptr, font, state, line.glyphs.data(), line.glyphs.size(),
+                line.run.initial_offset, width, x, (int32_t)top, cheight, out_bounds, glyph_cache);
+        }
+        ++lines;
+        pos = line.next;
+    }
+    if ((size_t)lines < line_starts_cap) {
+        line_starts[lines] = (int32_t)pos;
     }
 
-    *out_width = prepared.width;
+    *out_lines = lines;
     return kWasmOk;
 }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include <FastEPD.h>
 
 #include "fonts/vlw_font.h"
+#include "fonts/vlw_glyph_cache.h"
 
 /** @brief App-visible text attributes consumed by the FastEPD VLW renderer. */
 struct FastEpdVlwTextState {
@@ -32,15 +34,87 @@ struct FastEpdVlwTextState {
     bool use_bg = false;
 };
 
+/** @brief Box, alignment and break rules for `DrawParagraph()`. */
+struct FastEpdVlwParagraph {
+    /** Left edge of the box in logical pixels. */
+    int32_t x = 0;
+    /** Top of the first line in logical pixels. */
+    int32_t y = 0;
+    /** Wrap width; 0 or less breaks at newlines only. */
+    int32_t w = 0;
+    /** Box height; lines reaching below it are not laid out. 0 or less lays out every line. */
+    int32_t h = 0;
+    /** 0 = left, 1 = centered, 2 = right within `w` (ignored without a wrap width). */
+    int32_t align = 0;
+    /** Pixels added to the font height between line tops; may be negative. */
+    int32_t line_spacing = 0;
+    /** Break between any two characters instead of before words. */
+    bool break_anywhere = false;
+    /** Only lay out and report line starts; leave the framebuffer alone. */
+    bool measure_only = false;
+};
+
+/**
+ * @brief Scaled horizontal metrics of one font's codepoints 0..255 at one horizontal text scale.
+ *
+ * Measuring reads these instead of resolving and scaling every glyph again. The table is
+ * rebuilt on first use whenever the font or `size_x` differs from the one it was built for.
+ */
+struct VlwAdvanceTable {
+    /** Per-codepoint values in logical pixels, as the renderer's run measurement uses them. */
+    struct Entry {
+        /** Scaled pen advance. */
+        int32_t advance = 0;
+        /** Scaled `x_delta` of the bitmap. */
+        int32_t offset = 0;
+        /** Right edge relative to the pen: the larger of the advance and the bitmap's right edge. */
+        int32_t extent = 0;
+        /** Whether the bitmap starts left of the pen (`x_delta < 0`). */
+        bool hangs_left = false;
+    };
+
+    /** `VlwFont::serial()` the table was built for; 0 = not built. */
+    uint32_t font_serial = 0;
+    /** 16.16 horizontal scale the table was built for. */
+    int32_t scale_x = 0;
+    Entry latin1[256];
+
+    /** @brief Force a rebuild on next use. */
+    void Invalidate() { font_serial = 0; }
+};
+
 /**
  * @brief Measure the rendered width of a string using the active VLW text state.
  * @param font Parsed VLW font.
  * @param state FastEPD text state to apply.
  * @param text UTF-8 or single-byte input string.
  * @param out_width Output width in logical pixels.
+ * @param advances Optional table of scaled advances, (re)built for @p font and @p state as needed.
  * @return `kWasmOk` on success.
  */
-int32_t MeasureTextWidth(const VlwFont &font, const FastEpdVlwTextState &state, const char *text, int32_t *out_width);
+int32_t MeasureTextWidth(
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    int32_t *out_width,
+    VlwAdvanceTable *advances = nullptr);
+/**
+ * @brief Measure a buffer of NUL-separated strings, as `MeasureTextWidth()` would measure each.
+ *
+ * A NUL at the very end of the buffer does not start another (empty) string.
+ * @param out_widths Receives one width per string, at most @p out_cap of them.
+ * @param out_count Number of widths written.
+ * @return `kWasmOk` on success.
+ */
+int32_t MeasureTextWidths(
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *texts,
+    size_t len,
+    int32_t *out_widths,
+    size_t out_cap,
+    size_t *out_count,
+    VlwAdvanceTable *advances = nullptr);
 /**
  * @brief Compute the current scaled line height for a VLW font.
  * @param font Parsed VLW font.
@@ -58,6 +132,10 @@ int32_t CurrentFontHeight(const VlwFont &font, const FastEpdVlwTextState &state,
  * @param x Logical X coordinate interpreted according to `state.datum`.
  * @param y Logical Y coordinate interpreted according to `state.datum`.
  * @param out_width Optional rendered width output in logical pixels.
+ * @param out_bounds Optional output receiving the logical box of every pixel written
+ *        (background fill plus glyph ink); zero-sized when nothing was drawn.
+ * @param glyph_cache Optional cache of scaled glyph bitmaps; without one, scaled glyphs are
+ *        resampled on every draw.
  * @return `kWasmOk` on success.
  */
 int32_t DrawString(
@@ -67,4 +145,49 @@ int32_t DrawString(
     const char *text,
     int32_t x,
     int32_t y,
-    int32_t *out_width);
+    int32_t *out_width,
+    BB_RECT *out_bounds = nullptr,
+    VlwGlyphCache *glyph_cache = nullptr);
+/**
+ * @brief Like `DrawString()` above for @p len bytes of @p text that need not be NUL-terminated.
+ *
+ * A NUL inside the span still ends the string, as it would in a C string.
+ */
+int32_t DrawString(
+    FASTEPD &epd,
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t *out_width,
+    BB_RECT *out_bounds = nullptr,
+    VlwGlyphCache *glyph_cache = nullptr);
+/**
+ * @brief Wrap a text buffer into a box and render it line by line using VLW glyph bitmaps.
+ *
+ * Text is decoded like `DrawString()` (UTF-8 or single-byte per @p state) but need not be
+ * NUL-terminated. Lines break at `\n`, and before a word (after a space or a hyphen) that would
+ * cross `box.w`. Each line is drawn with its top at `box.y + i * (font height + line_spacing)`;
+ * `state.datum` is not used. Layout stops at the first line that does not fit `box.h`.
+ * @param line_starts Receives the byte offset of each laid-out line, followed by the offset
+ *        where layout stopped (`len` when everything fit); at most @p line_starts_cap entries
+ *        are written.
+ * @param out_lines Number of lines laid out.
+ * @param out_bounds Optional box of every pixel written.
+ * @param glyph_cache Optional cache of scaled glyph bitmaps.
+ * @return `kWasmOk` on success, `kWasmErrInvalidArgument` if the line advance is not positive.
+ */
+int32_t DrawParagraph(
+    FASTEPD &epd,
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    size_t len,
+    const FastEpdVlwParagraph &box,
+    int32_t *line_starts,
+    size_t line_starts_cap,
+    int32_t *out_lines,
+    BB_RECT *out_bounds = nullptr,
+    VlwGlyphCache *glyph_cache = nullptr);
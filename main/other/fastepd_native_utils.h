@@ -0,0 +1,732 @@
+/**
+ * @file fastepd_native_utils.h
+ * @brief Geometry helpers for addressing FastEPD's native (unrotated) framebuffer directly.
+ *
+ * FastEPD stores pixels in panel order regardless of the logical rotation: native rows run
+ * along the panel's long edge and pixels are packed MSB-first (1bpp: bit 7 is the leftmost
+ * pixel, 2bpp: bits 7..6, 4bpp: high nibble). A logical rotation only changes how logical
+ * `(x, y)` maps onto native `(nx, ny)`:
+ *
+ * | rotation | nx            | ny            |
+ * |----------|---------------|---------------|
+ * | 0        | x             | y             |
+ * | 90       | y             | W - 1 - x     |
+ * | 180      | W - 1 - x     | H - 1 - y     |
+ * | 270      | H - 1 - y     | x             |
+ *
+ * where `W`/`H` are the logical width/height. Working in native space lets kernels touch
+ * whole bytes and words instead of going through per-pixel rotation math.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <FastEPD.h>
+
+#include "fastepd_pixel_kernels.h"
+
+namespace fastepd_native_utils {
+
+/**
+ * @brief Snapshot of the framebuffer geometry needed to address native pixels.
+ */
+struct NativeLayout {
+    uint8_t* buffer = nullptr; ///< FastEPD current buffer (native layout).
+    int32_t bpp = 0; ///< Bits per pixel: 1, 2 or 4.
+    int32_t rotation = 0; ///< Logical rotation in degrees: 0, 90, 180 or 270.
+    int32_t logical_w = 0; ///< Logical width (as reported by `FASTEPD::width()`).
+    int32_t logical_h = 0; ///< Logical height (as reported by `FASTEPD::height()`).
+    int32_t native_w = 0; ///< Pixels per native row.
+    int32_t native_h = 0; ///< Number of native rows.
+    int32_t pitch = 0; ///< Bytes per native row.
+};
+
+/**
+ * @brief Map a FastEPD `BB_MODE_*` value to bits per pixel.
+ * @return 1, 2 or 4, or 0 for unsupported modes.
+ */
+static inline int32_t bppForMode(int32_t mode) {
+    switch (mode) {
+    case BB_MODE_1BPP:
+        return 1;
+    case BB_MODE_2BPP:
+        return 2;
+    case BB_MODE_4BPP:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Capture the native geometry of a FastEPD instance.
+ * @param epd Initialized FastEPD instance.
+ * @param out Output layout.
+ * @return `false` if the buffer is missing or the mode/rotation is unsupported.
+ */
+static inline bool describeNativeLayout(FASTEPD& epd, NativeLayout* out) {
+    if (!out) {
+        return false;
+    }
+    uint8_t* buffer = epd.currentBuffer();
+    const int32_t bpp = bppForMode(epd.getMode());
+    const int32_t rotation = epd.getRotation();
+    if (!buffer || bpp == 0 || (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270)) {
+        return false;
+    }
+    const int32_t w = epd.width();
+    const int32_t h = epd.height();
+    if (w <= 0 || h <= 0) {
+        return false;
+    }
+    out->buffer = buffer;
+    out->bpp = bpp;
+    out->rotation = rotation;
+    out->logical_w = w;
+    out->logical_h = h;
+    out->native_w = (rotation == 0 || rotation == 180) ? w : h;
+    out->native_h = (rotation == 0 || rotation == 180) ? h : w;
+    out->pitch = (out->native_w * bpp + 7) >> 3;
+    return true;
+}
+
+/**
+ * @brief Total framebuffer size in bytes for a layout.
+ */
+static inline size_t frameBytes(const NativeLayout& layout) {
+    return static_cast<size_t>(layout.pitch) * static_cast<size_t>(layout.native_h);
+}
+
+/**
+ * @brief Convert a clipped logical rectangle to the native rectangle covering the same pixels.
+ *
+ * Inputs must already be clipped to the logical screen. Outputs are half-open.
+ */
+static inline void logicalRectToNative(
+    const NativeLayout& layout,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    int32_t* nx,
+    int32_t* ny,
+    int32_t* nw,
+    int32_t* nh) {
+    const int32_t W = layout.logical_w;
+    const int32_t H = layout.logical_h;
+    switch (layout.rotation) {
+    case 90:
+        *nx = y;
+        *ny = W - (x + w);
+        *nw = h;
+        *nh = w;
+        break;
+    case 180:
+        *nx = W - (x + w);
+        *ny = H - (y + h);
+        *nw = w;
+        *nh = h;
+        break;
+    case 270:
+        *nx = H - (y + h);
+        *ny = x;
+        *nw = h;
+        *nh = w;
+        break;
+    default:
+        *nx = x;
+        *ny = y;
+        *nw = w;
+        *nh = h;
+        break;
+    }
+}
+
+/**
+ * @brief Convert a native rectangle back into the logical rectangle covering the same pixels.
+ */
+static inline void nativeRectToLogical(
+    const NativeLayout& layout,
+    int32_t nx,
+    int32_t ny,
+    int32_t nw,
+    int32_t nh,
+    int32_t* x,
+    int32_t* y,
+    int32_t* w,
+    int32_t* h) {
+    const int32_t W = layout.logical_w;
+    const int32_t H = layout.logical_h;
+    switch (layout.rotation) {
+    case 90:
+        *x = W - (ny + nh);
+        *y = nx;
+        *w = nh;
+        *h = nw;
+        break;
+    case 180:
+        *x = W - (nx + nw);
+        *y = H - (ny + nh);
+        *w = nw;
+        *h = nh;
+        break;
+    case 270:
+        *x = ny;
+        *y = H - (nx + nw);
+        *w = nh;
+        *h = nw;
+        break;
+    default:
+        *x = nx;
+        *y = ny;
+        *w = nw;
+        *h = nh;
+        break;
+    }
+}
+
+/**
+ * @brief Replicate a FastEPD color value across a packed byte.
+ * @param bpp Bits per pixel of the layout.
+ * @param color Color as passed to FastEPD drawing calls (`BBEP_WHITE`/`BBEP_BLACK` at 1bpp).
+ * @return Byte holding the color in every pixel slot.
+ */
+static inline uint8_t packedPattern(int32_t bpp, uint8_t color) {
+    switch (bpp) {
+    case 1:
+        return color == BBEP_WHITE ? 0xFF : 0x00;
+    case 2:
+        return static_cast<uint8_t>((color & 0x3) * 0x55);
+    default:
+        return static_cast<uint8_t>((color & 0xF) * 0x11);
+    }
+}
+
+/**
+ * @brief Fill a native rectangle with a packed byte pattern.
+ *
+ * Each native row is one contiguous bit span: the edge bytes are merged under a mask and the
+ * interior is written with `memset`. Inputs must be inside the native buffer.
+ */
+static inline void fillNativeRect(
+    const NativeLayout& layout,
+    int32_t nx,
+    int32_t ny,
+    int32_t nw,
+    int32_t nh,
+    uint8_t pattern) {
+    if (nw <= 0 || nh <= 0) {
+        return;
+    }
+    const int32_t bit0 = nx * layout.bpp;
+    const int32_t bit1 = (nx + nw) * layout.bpp;
+    const int32_t byte0 = bit0 >> 3;
+    const int32_t byte1 = (bit1 - 1) >> 3;
+    uint8_t head_mask = static_cast<uint8_t>(0xFF >> (bit0 & 7));
+    const uint8_t tail_mask = static_cast<uint8_t>(0xFF << ((8 - (bit1 & 7)) & 7));
+    if (byte0 == byte1) {
+        head_mask &= tail_mask;
+    }
+    const int32_t inner0 = (bit0 & 7) ? byte0 + 1 : byte0;
+    const int32_t inner1 = (bit1 & 7) ? byte1 : byte1 + 1;
+
+    uint8_t* row = layout.buffer + static_cast<size_t>(ny) * static_cast<size_t>(layout.pitch);
+    for (int32_t r = 0; r < nh; ++r, row += layout.pitch) {
+        if (byte0 == byte1) {
+            row[byte0] = static_cast<uint8_t>((row[byte0] & ~head_mask) | (pattern & head_mask));
+            continue;
+        }
+        if (bit0 & 7) {
+            row[byte0] = static_cast<uint8_t>((row[byte0] & ~head_mask) | (pattern & head_mask));
+        }
+        if (inner1 > inner0) {
+            memset(row + inner0, pattern, static_cast<size_t>(inner1 - inner0));
+        }
+        if (bit1 & 7) {
+            row[byte1] = static_cast<uint8_t>((row[byte1] & ~tail_mask) | (pattern & tail_mask));
+        }
+    }
+}
+
+/**
+ * @brief Clip a logical rectangle to the screen and fill it with a FastEPD color.
+ * @return `false` if nothing was left after clipping.
+ */
+static inline bool fillLogicalRect(
+    const NativeLayout& layout,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    uint8_t color) {
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = static_cast<int64_t>(x) + w;
+    int64_t y1 = static_cast<int64_t>(y) + h;
+    if (x1 > layout.logical_w) {
+        x1 = layout.logical_w;
+    }
+    if (y1 > layout.logical_h) {
+        y1 = layout.logical_h;
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+    int32_t nx = 0;
+    int32_t ny = 0;
+    int32_t nw = 0;
+    int32_t nh = 0;
+    logicalRectToNative(
+        layout,
+        static_cast<int32_t>(x0),
+        static_cast<int32_t>(y0),
+        static_cast<int32_t>(x1 - x0),
+        static_cast<int32_t>(y1 - y0),
+        &nx,
+        &ny,
+        &nw,
+        &nh);
+    fillNativeRect(layout, nx, ny, nw, nh, packedPattern(layout.bpp, color));
+    return true;
+}
+
+/**
+ * @brief Convert a FastEPD color into the raw pixel value stored in the framebuffer.
+ *
+ * 2bpp/4bpp colors are stored as-is; at 1bpp FastEPD takes `BBEP_WHITE`/`BBEP_BLACK`, which
+ * are stored as bit 1/0.
+ */
+static inline uint8_t nativePixelValue(int32_t bpp, uint8_t color) {
+    if (bpp == 1) {
+        return color == BBEP_WHITE ? 1 : 0;
+    }
+    return static_cast<uint8_t>(color & ((1u << bpp) - 1u));
+}
+
+/// @brief Native pixels handled per column chunk by `blitGray8`.
+constexpr int32_t kBlitChunkPixels = 64;
+/// @brief Native rows handled together by `blitGray8`, so rotated sources are read a cache line at a time.
+constexpr int32_t kBlitBandRows = 8;
+
+/**
+ * @brief Pack `n` source pixels into one native row starting at native pixel `nx`.
+ *
+ * Source pixels are read from `src`, advancing by `step` bytes per native pixel, and mapped
+ * through `lut` (gray8 -> raw pixel value). Partial bytes at either end are merged; full bytes
+ * are assembled in a register and stored once, by `packGray8Bytes()` for contiguous sources.
+ */
+template <int BPP>
+static inline void packGray8Span(uint8_t* row, int32_t nx, int32_t n, const uint8_t* src, ptrdiff_t step, const uint8_t* lut) {
+    constexpr int32_t kPerByte = 8 / BPP;
+    uint8_t* dst = row + (nx / kPerByte);
+    int32_t slot = nx % kPerByte;
+
+    if (slot != 0) {
+        uint8_t byte = *dst;
+        for (; slot < kPerByte && n > 0; ++slot, --n, src += step) {
+            const int shift = 8 - BPP * (slot + 1);
+            byte = static_cast<uint8_t>((byte & ~(((1u << BPP) - 1u) << shift)) | (lut[*src] << shift));
+        }
+        *dst++ = byte;
+    }
+
+    if (step == 1 && n >= kPerByte) {
+        const int32_t whole = n / kPerByte;
+        fastepd_pixel_kernels::packGray8Bytes<BPP>(dst, src, static_cast<size_t>(whole), lut);
+        dst += whole;
+        src += whole * kPerByte;
+        n -= whole * kPerByte;
+    }
+    for (; n >= kPerByte; n -= kPerByte) {
+        uint32_t acc = 0;
+        for (int32_t k = 0; k < kPerByte; ++k, src += step) {
+            acc = (acc << BPP) | lut[*src];
+        }
+        *dst++ = static_cast<uint8_t>(acc);
+    }
+
+    if (n > 0) {
+        uint8_t byte = *dst;
+        for (int32_t s = 0; s < n; ++s, src += step) {
+            const int shift = 8 - BPP * (s + 1);
+            byte = static_cast<uint8_t>((byte & ~(((1u << BPP) - 1u) << shift)) | (lut[*src] << shift));
+        }
+        *dst = byte;
+    }
+}
+
+/**
+ * @brief Start and step of native row `r` of a `nw x nh` native rect in its logical-order source.
+ *
+ * `src` holds the rect's pixels in logical order (`src_stride` bytes per logical row, top-left
+ * first). Native pixel `(nx0 + c, ny0 + r)` is then read from `origin + c * *step`; derived from
+ * the table at the top of this file.
+ */
+static inline const uint8_t* nativeRowSource(
+    const NativeLayout& layout,
+    const uint8_t* src,
+    int32_t src_stride,
+    int32_t nw,
+    int32_t nh,
+    int32_t r,
+    ptrdiff_t* step) {
+    switch (layout.rotation) {
+    case 90:
+        *step = src_stride;
+        return src + (nh - 1 - r);
+    case 180:
+        *step = -1;
+        return src + static_cast<ptrdiff_t>(nh - 1 - r) * src_stride + (nw - 1);
+    case 270:
+        *step = -static_cast<ptrdiff_t>(src_stride);
+        return src + r + static_cast<ptrdiff_t>(nw - 1) * src_stride;
+    default:
+        *step = 1;
+        return src + static_cast<ptrdiff_t>(r) * src_stride;
+    }
+}
+
+template <int BPP>
+static inline void blitGray8Native(
+    const NativeLayout& layout,
+    int32_t nx0,
+    int32_t ny0,
+    int32_t nw,
+    int32_t nh,
+    const uint8_t* src,
+    int32_t src_stride,
+    const uint8_t* lut) {
+    const int32_t nx1 = nx0 + nw;
+    for (int32_t band = 0; band < nh; band += kBlitBandRows) {
+        const int32_t band_rows = (nh - band) < kBlitBandRows ? (nh - band) : kBlitBandRows;
+        for (int32_t cx0 = nx0; cx0 < nx1;) {
+            int32_t cx1 = (cx0 / kBlitChunkPixels + 1) * kBlitChunkPixels;
+            if (cx1 > nx1) {
+                cx1 = nx1;
+            }
+            for (int32_t r = band; r < band + band_rows; ++r) {
+                uint8_t* row = layout.buffer + static_cast<size_t>(ny0 + r) * static_cast<size_t>(layout.pitch);
+                ptrdiff_t step = 1;
+                const uint8_t* origin = nativeRowSource(layout, src, src_stride, nw, nh, r, &step);
+                packGray8Span<BPP>(row, cx0, cx1 - cx0, origin + (cx0 - nx0) * step, step, lut);
+            }
+            cx0 = cx1;
+        }
+    }
+}
+
+/**
+ * @brief Blit an 8-bit grayscale image into the native framebuffer.
+ *
+ * The destination rect is clipped once; the source is then streamed through `lut` and written
+ * as whole native bytes. Rows are processed in bands of `kBlitBandRows` and chunks of
+ * `kBlitChunkPixels` so rotated (column-order) sources touch each cache line once per band.
+ *
+ * @param src Top-left source pixel of the unclipped image.
+ * @param src_stride Source bytes per row.
+ * @param lut Gray8 -> raw native pixel value for the layout's bpp (see `nativePixelValue`).
+ * @return `false` if the image is entirely off-screen.
+ */
+static inline bool blitGray8(
+    const NativeLayout& layout,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    const uint8_t* src,
+    int32_t src_stride,
+    const uint8_t* lut) {
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = static_cast<int64_t>(x) + w;
+    int64_t y1 = static_cast<int64_t>(y) + h;
+    if (x1 > layout.logical_w) {
+        x1 = layout.logical_w;
+    }
+    if (y1 > layout.logical_h) {
+        y1 = layout.logical_h;
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+    const uint8_t* clipped = src + static_cast<size_t>(y0 - y) * static_cast<size_t>(src_stride) + static_cast<size_t>(x0 - x);
+    int32_t nx = 0;
+    int32_t ny = 0;
+    int32_t nw = 0;
+    int32_t nh = 0;
+    logicalRectToNative(
+        layout,
+        static_cast<int32_t>(x0),
+        static_cast<int32_t>(y0),
+        static_cast<int32_t>(x1 - x0),
+        static_cast<int32_t>(y1 - y0),
+        &nx,
+        &ny,
+        &nw,
+        &nh);
+    switch (layout.bpp) {
+    case 1:
+        blitGray8Native<1>(layout, nx, ny, nw, nh, clipped, src_stride, lut);
+        break;
+    case 2:
+        blitGray8Native<2>(layout, nx, ny, nw, nh, clipped, src_stride, lut);
+        break;
+    default:
+        blitGray8Native<4>(layout, nx, ny, nw, nh, clipped, src_stride, lut);
+        break;
+    }
+    return true;
+}
+
+/**
+ * @brief Read one logical row of raw native pixel values (see `nativePixelValue`).
+ *
+ * The row must lie inside the logical screen. Rotations 0/180 walk a native row; 90/270 walk a
+ * native column, one pitch per pixel.
+ */
+static inline void readLogicalRow(const NativeLayout& layout, int32_t x, int32_t y, int32_t w, uint8_t* out) {
+    int32_t nx = x;
+    int32_t ny = y;
+    int32_t dnx = 1;
+    int32_t dny = 0;
+    switch (layout.rotation) {
+    case 90:
+        nx = y;
+        ny = layout.logical_w - 1 - x;
+        dnx = 0;
+        dny = -1;
+        break;
+    case 180:
+        nx = layout.logical_w - 1 - x;
+        ny = layout.logical_h - 1 - y;
+        dnx = -1;
+        break;
+    case 270:
+        nx = layout.logical_h - 1 - y;
+        ny = x;
+        dnx = 0;
+        dny = 1;
+        break;
+    default:
+        break;
+    }
+    const int32_t per_byte = 8 / layout.bpp;
+    const uint32_t mask = (1u << layout.bpp) - 1u;
+    for (int32_t i = 0; i < w; ++i, nx += dnx, ny += dny) {
+        const uint8_t byte = layout.buffer[static_cast<size_t>(ny) * static_cast<size_t>(layout.pitch) + static_cast<size_t>(nx / per_byte)];
+        const int shift = 8 - layout.bpp * (nx % per_byte + 1);
+        out[i] = static_cast<uint8_t>((byte >> shift) & mask);
+    }
+}
+
+/**
+ * @brief Map a logical pixel to its native coordinates (see the table at the top of this file).
+ */
+static inline void logicalToNative(const NativeLayout& layout, int32_t x, int32_t y, int32_t* nx, int32_t* ny) {
+    switch (layout.rotation) {
+    case 90:
+        *nx = y;
+        *ny = layout.logical_w - 1 - x;
+        break;
+    case 180:
+        *nx = layout.logical_w - 1 - x;
+        *ny = layout.logical_h - 1 - y;
+        break;
+    case 270:
+        *nx = layout.logical_h - 1 - y;
+        *ny = x;
+        break;
+    default:
+        *nx = x;
+        *ny = y;
+        break;
+    }
+}
+
+/**
+ * @brief Inverse of `logicalToNative`.
+ */
+static inline void nativeToLogical(const NativeLayout& layout, int32_t nx, int32_t ny, int32_t* x, int32_t* y) {
+    switch (layout.rotation) {
+    case 90:
+        *x = layout.logical_w - 1 - ny;
+        *y = nx;
+        break;
+    case 180:
+        *x = layout.logical_w - 1 - nx;
+        *y = layout.logical_h - 1 - ny;
+        break;
+    case 270:
+        *x = ny;
+        *y = layout.logical_h - 1 - nx;
+        break;
+    default:
+        *x = nx;
+        *y = ny;
+        break;
+    }
+}
+
+/**
+ * @brief Write `n` raw pixel values into one native row starting at native pixel `nx`.
+ *
+ * Pixels whose `opaque` entry is zero keep the destination value; pass `nullptr` to write all.
+ * Each destination byte is assembled in a register and merged under a mask once.
+ */
+template <int BPP>
+static inline void packRawSpan(uint8_t* row, int32_t nx, int32_t n, const uint8_t* values, const uint8_t* opaque) {
+    constexpr int32_t kPerByte = 8 / BPP;
+    constexpr uint32_t kPixelMask = (1u << BPP) - 1u;
+    uint8_t* dst = row + (nx / kPerByte);
+    int32_t slot = nx % kPerByte;
+    uint32_t acc = 0;
+    uint32_t mask = 0;
+    for (int32_t i = 0; i < n; ++i) {
+        const int shift = 8 - BPP * (slot + 1);
+        if (!opaque || opaque[i]) {
+            acc |= (values[i] & kPixelMask) << shift;
+            mask |= kPixelMask << shift;
+        }
+        if (++slot == kPerByte || i == n - 1) {
+            if (mask == 0xFF) {
+                *dst = static_cast<uint8_t>(acc);
+            } else if (mask != 0) {
+                *dst = static_cast<uint8_t>((*dst & ~mask) | acc);
+            }
+            ++dst;
+            slot = 0;
+            acc = 0;
+            mask = 0;
+        }
+    }
+}
+
+/**
+ * @brief Composite a whole source surface into `dst` with its top-left corner at logical `(x, y)`.
+ *
+ * The source is turned clockwise by `quarter_turns * 90` degrees before it is placed, and the
+ * destination rect is clipped to `dst`. For every destination native row the matching source
+ * pixels lie on a straight line, so they are gathered with a constant native step, mapped
+ * through `lut` (source raw value -> destination raw value) and written with `packRawSpan`.
+ *
+ * @param key Source raw value treated as transparent, or -1 for an opaque copy.
+ * @return `false` if nothing is visible.
+ */
+static inline bool compositeLayout(
+    const NativeLayout& dst,
+    const NativeLayout& src,
+    int32_t x,
+    int32_t y,
+    int32_t quarter_turns,
+    int32_t key,
+    const uint8_t* lut) {
+    const int32_t turns = quarter_turns & 3;
+    const int32_t sw = src.logical_w;
+    const int32_t sh = src.logical_h;
+    const int32_t placed_w = (turns & 1) ? sh : sw;
+    const int32_t placed_h = (turns & 1) ? sw : sh;
+
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = static_cast<int64_t>(x) + placed_w;
+    int64_t y1 = static_cast<int64_t>(y) + placed_h;
+    if (x1 > dst.logical_w) {
+        x1 = dst.logical_w;
+    }
+    if (y1 > dst.logical_h) {
+        y1 = dst.logical_h;
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+    int32_t nx = 0;
+    int32_t ny = 0;
+    int32_t nw = 0;
+    int32_t nh = 0;
+    logicalRectToNative(
+        dst,
+        static_cast<int32_t>(x0),
+        static_cast<int32_t>(y0),
+        static_cast<int32_t>(x1 - x0),
+        static_cast<int32_t>(y1 - y0),
+        &nx,
+        &ny,
+        &nw,
+        &nh);
+
+    // Destination native pixel -> source native pixel.
+    auto source_native = [&](int32_t dnx, int32_t dny, int32_t* snx, int32_t* sny) {
+        int32_t lx = 0;
+        int32_t ly = 0;
+        nativeToLogical(dst, dnx, dny, &lx, &ly);
+        const int32_t u = lx - x;
+        const int32_t v = ly - y;
+        int32_t sx = u;
+        int32_t sy = v;
+        switch (turns) {
+        case 1:
+            sx = v;
+            sy = sh - 1 - u;
+            break;
+        case 2:
+            sx = sw - 1 - u;
+            sy = sh - 1 - v;
+            break;
+        case 3:
+            sx = sw - 1 - v;
+            sy = u;
+            break;
+        default:
+            break;
+        }
+        logicalToNative(src, sx, sy, snx, sny);
+    };
+
+    const int32_t src_per_byte = 8 / src.bpp;
+    const uint32_t src_mask = (1u << src.bpp) - 1u;
+    uint8_t values[kBlitChunkPixels];
+    uint8_t opaque[kBlitChunkPixels];
+    for (int32_t r = ny; r < ny + nh; ++r) {
+        int32_t snx = 0;
+        int32_t sny = 0;
+        source_native(nx, r, &snx, &sny);
+        int32_t step_x = 0;
+        int32_t step_y = 0;
+        if (nw > 1) {
+            source_native(nx + 1, r, &step_x, &step_y);
+            step_x -= snx;
+            step_y -= sny;
+        }
+        uint8_t* row = dst.buffer + static_cast<size_t>(r) * static_cast<size_t>(dst.pitch);
+        for (int32_t c0 = 0; c0 < nw; c0 += kBlitChunkPixels) {
+            const int32_t n = (nw - c0) < kBlitChunkPixels ? (nw - c0) : kBlitChunkPixels;
+            bool any_transparent = false;
+            for (int32_t i = 0; i < n; ++i) {
+                const int32_t px = snx + (c0 + i) * step_x;
+                const int32_t py = sny + (c0 + i) * step_y;
+                const uint8_t byte = src.buffer[static_cast<size_t>(py) * static_cast<size_t>(src.pitch) + static_cast<size_t>(px / src_per_byte)];
+                const uint8_t raw = static_cast<uint8_t>((byte >> (8 - src.bpp * (px % src_per_byte + 1))) & src_mask);
+                opaque[i] = static_cast<uint8_t>(raw != key);
+                any_transparent |= (raw == key);
+                values[i] = lut[raw];
+            }
+            const uint8_t* keep = any_transparent ? opaque : nullptr;
+            switch (dst.bpp) {
+            case 1:
+                packRawSpan<1>(row, nx + c0, n, values, keep);
+                break;
+            case 2:
+                packRawSpan<2>(row, nx + c0, n, values, keep);
+                break;
+            default:
+                packRawSpan<4>(row, nx + c0, n, values, keep);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace fastepd_native_utils
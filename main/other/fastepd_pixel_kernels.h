@@ -0,0 +1,229 @@
+/**
+ * @file fastepd_pixel_kernels.h
+ * @brief Row kernels shared by the FastEPD image paths: unpacking, gray conversion and packing.
+ *
+ * Every kernel works on a contiguous run of pixels and has no per-pixel branches beyond the
+ * loop itself, so each one is the single place to speed up when a format gets hot. Results are
+ * bit-exact with the per-pixel formulas documented on each kernel (and used for the tails),
+ * which the callers relied on before these were factored out.
+ *
+ * On the ESP32-S3, `unpackGray4()` also has a PIE (128-bit vector) path for aligned runs. It
+ * stays off until `selfTestPie()` has matched it against the scalar loop on the running chip,
+ * and has not been exercised on hardware yet. The gray8 packing and the RGB565/ARGB gray
+ * conversions are scalar only.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__XTENSA__) && __has_include("sdkconfig.h")
+#include "sdkconfig.h"
+#endif
+
+#if defined(__XTENSA__) && defined(CONFIG_IDF_TARGET_ESP32S3) && CONFIG_IDF_TARGET_ESP32S3
+#define FASTEPD_PIXEL_KERNELS_PIE 1
+#else
+#define FASTEPD_PIXEL_KERNELS_PIE 0
+#endif
+
+namespace fastepd_pixel_kernels {
+
+#if FASTEPD_PIXEL_KERNELS_PIE
+/** Set by `selfTestPie()`; the PIE paths are skipped until it passed. */
+inline bool g_pie_verified = false;
+
+/**
+ * @brief Unpack `nbytes` (a multiple of 16) bytes of 4-bit pixels into `2 * nbytes` gray8 values.
+ *
+ * `src` and `out` must be 16-byte aligned: the 128-bit loads and stores ignore the low address
+ * bits. Per 16 source bytes: shift and mask the high and low nibbles into two vectors, interleave
+ * them into pixel order, then turn each nibble `v` into `v * 0x11` as `v | (v << 4)`. The 32-bit
+ * lane shifts cannot carry across bytes because the nibbles are masked first.
+ */
+static inline void unpackGray4Pie(const uint8_t* src, size_t nbytes, uint8_t* out) {
+    static const uint8_t kLowNibble = 0x0F;
+    for (size_t i = 0; i < nbytes; i += 16) {
+        asm volatile(
+            "ssai 4\n"
+            "ee.vldbc.8 q7, %[mask]\n"
+            "ee.vld.128.ip q0, %[src], 16\n"
+            "ee.vsr.32 q1, q0\n"
+            "ee.andq q1, q1, q7\n"
+            "ee.andq q2, q0, q7\n"
+            "ee.vzip.8 q1, q2\n"
+            "ee.vsl.32 q3, q1\n"
+            "ee.orq q1, q1, q3\n"
+            "ee.vsl.32 q4, q2\n"
+            "ee.orq q2, q2, q4\n"
+            "ee.vst.128.ip q1, %[out], 16\n"
+            "ee.vst.128.ip q2, %[out], 16\n"
+            : [src] "+r"(src), [out] "+r"(out)
+            : [mask] "r"(&kLowNibble)
+            : "memory");
+    }
+}
+#endif
+
+/**
+ * @brief Luma of an RGB888 pixel, the weights used everywhere in the FastEPD driver.
+ */
+static inline uint8_t lumaRgb8(uint32_t r, uint32_t g, uint32_t b) {
+    return static_cast<uint8_t>((r * 77u + g * 150u + b * 29u + 128u) >> 8);
+}
+
+/**
+ * @brief Unpack `n` 4-bit gray pixels (high nibble first) starting at pixel `first` of `src`.
+ *
+ * Each nibble `v` becomes the gray8 value `v * 0x11`, so `out[i] >> 4` gives the nibble back.
+ * Whole source bytes are handled two at a time: both are spread into 16-bit lanes of one
+ * word, the nibbles swapped into byte order and scaled with a single multiply.
+ */
+static inline void unpackGray4(const uint8_t* src, size_t first, size_t n, uint8_t* out) {
+    src += first >> 1;
+    if ((first & 1) && n > 0) {
+        *out++ = static_cast<uint8_t>((*src++ & 0x0F) * 0x11);
+        --n;
+    }
+#if FASTEPD_PIXEL_KERNELS_PIE
+    if (n >= 32 && g_pie_verified && ((reinterpret_cast<uintptr_t>(src) | reinterpret_cast<uintptr_t>(out)) & 15u) == 0) {
+        const size_t nbytes = (n >> 5) << 4;
+        unpackGray4Pie(src, nbytes, out);
+        src += nbytes;
+        out += nbytes * 2;
+        n -= nbytes * 2;
+    }
+#endif
+    for (; n >= 4; n -= 4, src += 2, out += 4) {
+        const uint32_t t = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 16);
+        const uint32_t v = (((t >> 4) & 0x000F000Fu) | ((t & 0x000F000Fu) << 8)) * 0x11u;
+        out[0] = static_cast<uint8_t>(v);
+        out[1] = static_cast<uint8_t>(v >> 8);
+        out[2] = static_cast<uint8_t>(v >> 16);
+        out[3] = static_cast<uint8_t>(v >> 24);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t packed = src[i >> 1];
+        out[i] = static_cast<uint8_t>(((i & 1) ? (packed & 0x0F) : (packed >> 4)) * 0x11);
+    }
+}
+
+/**
+ * @brief Luma of one ARGB8888 pixel (bytes A, R, G, B) composited over white.
+ */
+static inline uint8_t argbToGray8(const uint8_t* argb) {
+    const uint32_t gray = lumaRgb8(argb[1], argb[2], argb[3]);
+    const uint32_t a = argb[0];
+    if (a == 255) {
+        return static_cast<uint8_t>(gray);
+    }
+    // Rounded (gray * a + 255 * (255 - a)) / 255; `(t + (t >> 8)) >> 8` is exact for t < 65536.
+    const uint32_t t = gray * a + 255u * (255u - a) + 128u;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+/**
+ * @brief Convert `n` ARGB8888 pixels with `argbToGray8()`, writing every `out_step`-th byte of `out`.
+ *
+ * Runs of four opaque pixels, the common case for photos, skip the blend entirely.
+ */
+static inline void argbRowToGray8(const uint8_t* argb, size_t n, uint8_t* out, ptrdiff_t out_step) {
+    for (; n >= 4; n -= 4, argb += 16) {
+        if ((argb[0] & argb[4] & argb[8] & argb[12]) == 255) {
+            for (int k = 0; k < 4; ++k, out += out_step) {
+                *out = lumaRgb8(argb[4 * k + 1], argb[4 * k + 2], argb[4 * k + 3]);
+            }
+        } else {
+            for (int k = 0; k < 4; ++k, out += out_step) {
+                *out = argbToGray8(argb + 4 * k);
+            }
+        }
+    }
+    for (; n > 0; --n, argb += 4, out += out_step) {
+        *out = argbToGray8(argb);
+    }
+}
+
+/**
+ * @brief Per-byte halves of the RGB565 luma sum (scaled by 256, rounding folded into `hi`).
+ *
+ * With G6 split into its top (`gh`) and bottom (`gl`) three bits, the expanded G8 is
+ * `(gh << 5) | (gl << 2) | (gh >> 1)`, so every channel depends on one byte only.
+ */
+struct Rgb565LumaTables {
+    uint16_t hi[256];
+    uint16_t lo[256];
+};
+
+/** @brief Fill `tables` for `rgb565RowToGray8()`. */
+static inline void buildRgb565LumaTables(Rgb565LumaTables* tables) {
+    for (uint32_t v = 0; v < 256; ++v) {
+        const uint32_t r5 = v >> 3;
+        const uint32_t b5 = v & 31u;
+        const uint32_t gh = v & 7u;
+        tables->hi[v] = static_cast<uint16_t>(((r5 << 3) | (r5 >> 2)) * 77u + ((gh << 5) + (gh >> 1)) * 150u + 128u);
+        tables->lo[v] = static_cast<uint16_t>(((v >> 5) << 2) * 150u + ((b5 << 3) | (b5 >> 2)) * 29u);
+    }
+}
+
+/**
+ * @brief Convert `n` RGB565 pixels to gray8; equals `lumaRgb8()` of the channels expanded to 8 bits.
+ * @param big_endian `true` if the high byte (red and the top of green) comes first.
+ */
+static inline void rgb565RowToGray8(const Rgb565LumaTables& tables, const uint8_t* src, size_t n, bool big_endian, uint8_t* out) {
+    const int hi = big_endian ? 0 : 1;
+    for (; n >= 2; n -= 2, src += 4, out += 2) {
+        out[0] = static_cast<uint8_t>((static_cast<uint32_t>(tables.hi[src[hi]]) + tables.lo[src[hi ^ 1]]) >> 8);
+        out[1] = static_cast<uint8_t>((static_cast<uint32_t>(tables.hi[src[2 + hi]]) + tables.lo[src[2 + (hi ^ 1)]]) >> 8);
+    }
+    if (n > 0) {
+        out[0] = static_cast<uint8_t>((static_cast<uint32_t>(tables.hi[src[hi]]) + tables.lo[src[hi ^ 1]]) >> 8);
+    }
+}
+
+/**
+ * @brief Map `nbytes * (8 / BPP)` contiguous gray8 pixels through `lut` and pack them MSB-first.
+ *
+ * `lut` maps gray8 to a raw pixel value below `1 << BPP`. The shifts are compile-time constants,
+ * so each output byte is built from one unrolled group of table lookups.
+ */
+template <int BPP>
+static inline void packGray8Bytes(uint8_t* dst, const uint8_t* src, size_t nbytes, const uint8_t* lut) {
+    constexpr int kPerByte = 8 / BPP;
+    for (size_t i = 0; i < nbytes; ++i, src += kPerByte) {
+        uint32_t acc = 0;
+        for (int k = 0; k < kPerByte; ++k) {
+            acc |= static_cast<uint32_t>(lut[src[k]]) << (8 - BPP * (k + 1));
+        }
+        dst[i] = static_cast<uint8_t>(acc);
+    }
+}
+
+/**
+ * @brief Enable the PIE kernels if they reproduce the scalar ones bit for bit on this chip.
+ *
+ * Runs `unpackGray4Pie()` over every byte value and compares it with the scalar loop, so an
+ * instruction that behaves differently than assumed disables the vector path instead of
+ * corrupting images. Call once before drawing; until then the scalar kernels are used.
+ * @return Whether the PIE kernels are in use (always `false` on targets without PIE).
+ */
+static inline bool selfTestPie() {
+#if FASTEPD_PIXEL_KERNELS_PIE
+    alignas(16) static uint8_t src[256];
+    alignas(16) static uint8_t vec[512];
+    static uint8_t ref[512];
+    g_pie_verified = false;
+    for (size_t i = 0; i < sizeof(src); ++i) {
+        src[i] = static_cast<uint8_t>(i);
+    }
+    unpackGray4Pie(src, sizeof(src), vec);
+    unpackGray4(src, 0, sizeof(ref), ref);
+    g_pie_verified = std::memcmp(vec, ref, sizeof(ref)) == 0;
+    return g_pie_verified;
+#else
+    return false;
+#endif
+}
+
+} // namespace fastepd_pixel_kernels
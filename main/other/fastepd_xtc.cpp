@@ -6,10 +6,12 @@
 #include "fastepd_xtc.h"
 #include "fastepd_xtc_utils.h"
 #include "esp_log.h"
+#include "esp_rom_md5.h"
 #include "esp_timer.h"
 #include <inttypes.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <FastEPD.h>
 
@@ -20,29 +22,40 @@ using namespace fastepd_xtc_utils;
 /// @brief ESP_LOG tag for this translation unit.
 static const char* TAG = "fastepd_draw_xtc";
 
-void drawXth(FASTEPD* epd, const uint8_t* data, size_t size, bool fast) {
-    if (!epd || !data) {
-        ESP_LOGE(TAG, "drawXth: null epd=%p data=%p", epd, data);
-        return;
-    }
+/// @brief Rows of an XTG decoded per blit when streaming (a multiple of 8, as the 90/270 kernels need).
+static constexpr int kXtgBandRows = 32;
+/// @brief Columns of an XTH decoded per blit when streaming (a multiple of 8, as the 0/180 kernels need).
+static constexpr int kXthBandCols = 32;
+/// @brief Encoded bytes buffered between `XtxReadFn` calls.
+static constexpr size_t kReadChunkBytes = 512;
 
-    const int32_t mode = epd->getMode();
-    const int64_t start_us = esp_timer_get_time();
+/**
+ * @brief Destination geometry shared by the XTG/XTH blits of one draw call.
+ */
+struct XtxTarget {
+    uint8_t* fb; ///< `epd->currentBuffer()`.
+    int rot; ///< Rotation normalized to 0/90/180/270.
+    int logical_w;
+    int logical_h;
+    int dst_pitch; ///< Native pitch in bytes.
+    int native_h; ///< Native rows.
+    int copy_w; ///< Visible image width (image clipped to the screen).
+    int copy_h; ///< Visible image height.
+};
 
-    XtxImageHeader hdr = {};
-    const uint8_t* payload = nullptr;
-    if (!parseXthHeader(data, size, &hdr, &payload)) {
-        ESP_LOGE(TAG, "drawXth: invalid XTH header (size=%zu)", size);
-        return;
-    }
-    if (hdr.color_mode != 0 || hdr.compression != 0) {
-        ESP_LOGE(TAG, "drawXth: unsupported XTH header: colorMode=%u compression=%u", hdr.color_mode, hdr.compression);
-        return;
+/**
+ * @brief Validate the header against @p epd and fill @p t.
+ * @param bpp 1 for XTG, 2 for XTH.
+ */
+static bool describeTarget(FASTEPD* epd, const char* fn, const XtxImageHeader& hdr, int bpp, XtxTarget* t) {
+    if (hdr.color_mode != 0 || (hdr.compression != kXtxCompressionNone && hdr.compression != kXtxCompressionRle)) {
+        ESP_LOGE(TAG, "%s: unsupported header: colorMode=%u compression=%u", fn, hdr.color_mode, hdr.compression);
+        return false;
     }
-
-    if (mode != BB_MODE_2BPP) {
-        ESP_LOGE(TAG, "drawXth: requires BB_MODE_2BPP (mode=%d)", static_cast<int>(mode));
-        return;
+    const int32_t mode = epd->getMode();
+    if (mode != (bpp == 2 ? BB_MODE_2BPP : BB_MODE_1BPP)) {
+        ESP_LOGE(TAG, "%s: requires BB_MODE_%dBPP (mode=%d)", fn, bpp, static_cast<int>(mode));
+        return false;
     }
 
     int rot = epd->getRotation();
@@ -51,147 +64,375 @@ void drawXth(FASTEPD* epd, const uint8_t* data, size_t size, bool fast) {
         rot += 360;
     }
     if (rot != 0 && rot != 90 && rot != 180 && rot != 270) {
-        ESP_LOGE(TAG, "drawXth: unsupported rotation=%d (expected 0/90/180/270)", rot);
-        return;
+        ESP_LOGE(TAG, "%s: unsupported rotation=%d (expected 0/90/180/270)", fn, rot);
+        return false;
     }
 
     const int logical_w = epd->width();
     const int logical_h = epd->height();
     if (hdr.width == 0 || hdr.height == 0 || logical_w <= 0 || logical_h <= 0) {
-        ESP_LOGE(TAG, "drawXth: invalid dimensions: xth=%ux%u epd=%dx%d", hdr.width, hdr.height, logical_w, logical_h);
-        return;
+        ESP_LOGE(TAG, "%s: invalid dimensions: image=%ux%u epd=%dx%d", fn, hdr.width, hdr.height, logical_w, logical_h);
+        return false;
     }
 
-    const int src_w = static_cast<int>(hdr.width);
-    const int src_h = static_cast<int>(hdr.height);
-    const size_t plane_bytes = static_cast<size_t>(src_w) * static_cast<size_t>((src_h + 7) >> 3);
-    const size_t expected_bytes = plane_bytes * 2u;
-    if (hdr.data_size != expected_bytes) {
-        ESP_LOGE(TAG, "drawXth: dataSize mismatch: hdr=%" PRIu32 " expected=%zu", hdr.data_size, expected_bytes);
-        return;
-    }
-    if (kXtxHeaderSize + expected_bytes > size) {
-        ESP_LOGE(TAG, "drawXth: truncated payload: size=%zu need=%zu", size, kXtxHeaderSize + expected_bytes);
-        return;
+    // Rotation 90/270 => native_w == logical_h, native_h == logical_w.
+    const bool swapped = (rot == 90 || rot == 270);
+    const int native_w = swapped ? logical_h : logical_w;
+    const int native_h = swapped ? logical_w : logical_h;
+    if (bpp == 2 && (native_w & 3) != 0) {
+        ESP_LOGE(TAG, "%s: rotation=%d requires native width multiple of 4 (native_w=%d)", fn, rot, native_w);
+        return false;
     }
 
-    const uint8_t* plane1 = payload;
-    const uint8_t* plane2 = payload + plane_bytes;
-
     uint8_t* fb = epd->currentBuffer();
     if (!fb) {
-        ESP_LOGE(TAG, "drawXth: epd.currentBuffer() returned null");
-        return;
+        ESP_LOGE(TAG, "%s: epd.currentBuffer() returned null", fn);
+        return false;
     }
 
-    const int copy_w = (src_w < logical_w) ? src_w : logical_w;
-    const int copy_h = (src_h < logical_h) ? src_h : logical_h;
-    const bool covers_fullscreen = (copy_w == logical_w) && (copy_h == logical_h);
+    t->fb = fb;
+    t->rot = rot;
+    t->logical_w = logical_w;
+    t->logical_h = logical_h;
+    t->dst_pitch = (bpp == 2) ? (native_w >> 2) : ((native_w + 7) >> 3);
+    t->native_h = native_h;
+    t->copy_w = (hdr.width < logical_w) ? hdr.width : logical_w;
+    t->copy_h = (hdr.height < logical_h) ? hdr.height : logical_h;
+    return true;
+}
 
-    if (rot == 0) {
-        const int native_w = logical_w;
-        const int native_h = logical_h;
-        if ((native_w & 3) != 0) {
-            ESP_LOGE(TAG, "drawXth: rotation=0 requires width multiple of 4 (w=%d)", native_w);
-            return;
+/**
+ * @brief `describeTarget()` for full-screen draws; clears to white if the image does not cover the screen.
+ */
+static bool prepareTarget(FASTEPD* epd, const char* fn, const XtxImageHeader& hdr, int bpp, XtxTarget* t) {
+    if (!describeTarget(epd, fn, hdr, bpp, t)) {
+        return false;
+    }
+    if (t->copy_w != t->logical_w || t->copy_h != t->logical_h) {
+        if (bpp == 2) {
+            clearNativeWhite2bpp(t->fb, t->dst_pitch, t->native_h);
+        } else {
+            clearNativeWhite1bpp(t->fb, t->dst_pitch, t->native_h);
         }
-        const int dst_pitch = native_w >> 2;
-        if (!covers_fullscreen) {
-            clearNativeWhite2bpp(fb, dst_pitch, native_h);
+    }
+    return true;
+}
+
+/**
+ * @brief Blit XTH planes whose leftmost column lands on logical column @p x0.
+ *
+ * @p x0 must be a multiple of 8 and @p copy_w at most `copy_w - x0` of the target.
+ */
+static void blitXthColumns(
+    const XtxTarget& t,
+    const uint8_t* plane1,
+    const uint8_t* plane2,
+    int src_w,
+    int src_h,
+    int x0,
+    int copy_w) {
+    if (t.rot == 0) {
+        xthBlitRot0TopLeftClipped2bpp(t.fb + (x0 >> 2), t.dst_pitch, plane1, plane2, src_w, src_h, copy_w, t.copy_h);
+    } else if (t.rot == 90) {
+        xthBlitRot90TopLeftClipped2bpp(
+            t.fb, t.dst_pitch, t.logical_w - x0, plane1, plane2, src_w, src_h, copy_w, t.copy_h);
+    } else if (t.rot == 180) {
+        xthBlitRot180TopLeftClipped2bpp(
+            t.fb, t.dst_pitch, t.logical_w - x0, t.logical_h, plane1, plane2, src_w, src_h, copy_w, t.copy_h);
+    } else {
+        xthBlitRot270TopLeftClipped2bpp(t.fb + static_cast<size_t>(x0) * static_cast<size_t>(t.dst_pitch),
+            t.dst_pitch, t.logical_h, plane1, plane2, src_w, src_h, copy_w, t.copy_h);
+    }
+}
+
+/**
+ * @brief Blit XTG rows whose first row lands on logical row @p y0 (a multiple of 8).
+ */
+static void blitXtgRows(const XtxTarget& t, const uint8_t* rows, int src_pitch, int src_w, int y0, int copy_h) {
+    if (t.rot == 0) {
+        xtgBlitRot0TopLeftClipped1bpp(
+            t.fb + static_cast<size_t>(y0) * static_cast<size_t>(t.dst_pitch), t.dst_pitch, rows, src_pitch, t.copy_w, copy_h);
+    } else if (t.rot == 90) {
+        xtgBlitRot90TopLeftClipped1bpp(
+            t.fb + (y0 >> 3), t.dst_pitch, t.logical_w, rows, src_pitch, src_w, t.copy_w, copy_h);
+    } else if (t.rot == 180) {
+        xtgBlitRot180TopLeftClipped1bpp(
+            t.fb, t.dst_pitch, t.logical_w, t.logical_h - y0, rows, src_pitch, src_w, t.copy_w, copy_h);
+    } else {
+        xtgBlitRot270TopLeftClipped1bpp(
+            t.fb, t.dst_pitch, t.logical_h - y0, rows, src_pitch, src_w, t.copy_w, copy_h);
+    }
+}
+
+/** @brief Ensure padding bits in the rotation=0 destination width are white. */
+static void padXtgRot0(const XtxTarget& t) {
+    const int r = t.logical_w & 7;
+    if (t.rot != 0 || r == 0) {
+        return;
+    }
+    const uint8_t pad_mask = static_cast<uint8_t>((1u << (8 - r)) - 1u);
+    uint8_t* row = t.fb + (t.dst_pitch - 1);
+    for (int y = 0; y < t.logical_h; y++) {
+        row[static_cast<size_t>(y) * static_cast<size_t>(t.dst_pitch)] |= pad_mask;
+    }
+}
+
+/** @brief Log how long a blit took; the panel refresh is up to the caller. */
+static void logDrawTime(FASTEPD* epd, const char* fn, int64_t start_us, int rot) {
+    const int64_t draw_us = esp_timer_get_time() - start_us;
+    ESP_LOGI(TAG, "%s: draw=%lld us rot=%d mode=%d", fn, static_cast<long long>(draw_us), rot,
+        static_cast<int>(epd->getMode()));
+}
+
+/**
+ * @brief Payload bytes of an XTG/XTH file in decoded order, pulled from an `XtxReadFn`.
+ *
+ * Stored payloads are copied through; `kXtxCompressionRle` payloads are expanded run by run
+ * out of a small input buffer, so nothing larger than one caller band is ever resident.
+ */
+class PayloadReader {
+public:
+    PayloadReader(XtxReadFn read, void* user, uint8_t compression, uint32_t data_size)
+        : read_(read), user_(user), rle_(compression == kXtxCompressionRle), in_left_(data_size) {}
+
+    /** @brief Produce exactly @p len decoded bytes; `false` on truncated or corrupt data. */
+    bool read(uint8_t* out, size_t len) {
+        while (len > 0) {
+            if (!rle_) {
+                const size_t n = takeInput(out, len);
+                if (n == 0) {
+                    return false;
+                }
+                out += n;
+                len -= n;
+                continue;
+            }
+            if (run_left_ == 0) {
+                uint8_t ctl = 0;
+                if (takeInput(&ctl, 1) != 1) {
+                    return false;
+                }
+                if (ctl == 0x80) {
+                    continue;
+                }
+                literal_ = ctl < 0x80;
+                run_left_ = literal_ ? (ctl + 1u) : (257u - ctl);
+                if (!literal_ && takeInput(&run_byte_, 1) != 1) {
+                    return false;
+                }
+            }
+            size_t n = (len < run_left_) ? len : run_left_;
+            if (literal_) {
+                n = takeInput(out, n);
+                if (n == 0) {
+                    return false;
+                }
+            } else {
+                memset(out, run_byte_, n);
+            }
+            out += n;
+            len -= n;
+            run_left_ -= n;
         }
-        xthBlitRot0TopLeftClipped2bpp(fb, dst_pitch, plane1, plane2, src_w, src_h, copy_w, copy_h);
-    } else if (rot == 90) {
-        // Rotation=90 => native_w==logical_h, native_h==logical_w
-        const int native_w = logical_h;
-        const int native_h = logical_w;
-        if ((native_w & 3) != 0) {
-            ESP_LOGE(TAG, "drawXth: rotation=90 requires native width multiple of 4 (native_w=%d)", native_w);
-            return;
+        return true;
+    }
+
+private:
+    /** @brief Copy up to @p len stored bytes; 0 once the payload (or the source) is exhausted. */
+    size_t takeInput(uint8_t* out, size_t len) {
+        if (in_pos_ == in_len_) {
+            if (in_left_ == 0) {
+                return 0;
+            }
+            const int32_t want = static_cast<int32_t>((in_left_ < kReadChunkBytes) ? in_left_ : kReadChunkBytes);
+            const int32_t got = read_(user_, in_, want);
+            if (got <= 0) {
+                return 0;
+            }
+            in_pos_ = 0;
+            in_len_ = static_cast<size_t>(got);
+            in_left_ -= static_cast<uint32_t>(got);
         }
-        const int dst_pitch = native_w >> 2;
-        if (!covers_fullscreen) {
-            clearNativeWhite2bpp(fb, dst_pitch, native_h);
+        const size_t avail = in_len_ - in_pos_;
+        const size_t n = (len < avail) ? len : avail;
+        memcpy(out, in_ + in_pos_, n);
+        in_pos_ += n;
+        return n;
+    }
+
+    XtxReadFn read_;
+    void* user_;
+    bool rle_;
+    uint32_t in_left_; ///< Stored payload bytes not yet pulled from the source.
+    uint8_t in_[kReadChunkBytes];
+    size_t in_pos_ = 0;
+    size_t in_len_ = 0;
+    bool literal_ = false;
+    uint8_t run_byte_ = 0;
+    size_t run_left_ = 0; ///< Bytes left in the current literal or repeat run.
+};
+
+/** @brief Read exactly @p len bytes from @p read. */
+static bool readExact(XtxReadFn read, void* user, uint8_t* buf, size_t len) {
+    while (len > 0) {
+        const int32_t got = read(user, buf, static_cast<int32_t>(len));
+        if (got <= 0) {
+            return false;
         }
-        xthBlitRot90TopLeftClipped2bpp(fb, dst_pitch, logical_w, plane1, plane2, src_w, src_h, copy_w, copy_h);
-    } else if (rot == 180) {
-        const int native_w = logical_w;
-        const int native_h = logical_h;
-        if ((native_w & 3) != 0) {
-            ESP_LOGE(TAG, "drawXth: rotation=180 requires width multiple of 4 (w=%d)", native_w);
-            return;
+        buf += got;
+        len -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+/** @brief In-memory `XtxReadFn` source. */
+struct MemSource {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+};
+
+static int32_t memRead(void* user, uint8_t* buf, int32_t len) {
+    MemSource* src = static_cast<MemSource*>(user);
+    const size_t remaining = src->size - src->pos;
+    const size_t n = (static_cast<size_t>(len) < remaining) ? static_cast<size_t>(len) : remaining;
+    memcpy(buf, src->data + src->pos, n);
+    src->pos += n;
+    return static_cast<int32_t>(n);
+}
+
+/**
+ * @brief Decode an RLE XTH payload a band of stored columns at a time and blit each band.
+ *
+ * Stored columns run right to left. The first band takes `src_w % kXthBandCols` columns (or a full
+ * band), so every band starts on a logical column that is a multiple of `kXthBandCols` and partial
+ * 8-pixel blocks only ever fall past the image's right edge.
+ */
+static bool streamXthBands(const XtxTarget& t, PayloadReader& payload, int src_w, int src_h) {
+    const size_t col_bytes = static_cast<size_t>((src_h + 7) >> 3);
+    const size_t band_bytes = static_cast<size_t>(kXthBandCols) * col_bytes;
+    uint8_t* band = static_cast<uint8_t*>(malloc(band_bytes * 2u));
+    if (!band) {
+        ESP_LOGE(TAG, "drawXth: band alloc failed (%zu bytes)", band_bytes * 2u);
+        return false;
+    }
+    uint8_t* plane1 = band;
+    uint8_t* plane2 = band + band_bytes;
+
+    bool ok = true;
+    int first = 0;
+    int n = src_w % kXthBandCols;
+    if (n == 0) {
+        n = kXthBandCols;
+    }
+    while (first < src_w) {
+        // Bands right of the screen are decoded all the same, to reach the ones after them.
+        const int x0 = src_w - first - n;
+        for (int c = 0; c < n && ok; c++) {
+            ok = payload.read(plane1 + static_cast<size_t>(c) * col_bytes, col_bytes) &&
+                payload.read(plane2 + static_cast<size_t>(c) * col_bytes, col_bytes);
         }
-        const int dst_pitch = native_w >> 2;
-        if (!covers_fullscreen) {
-            clearNativeWhite2bpp(fb, dst_pitch, native_h);
+        if (!ok) {
+            break;
         }
-        xthBlitRot180TopLeftClipped2bpp(
-            fb, dst_pitch, logical_w, logical_h, plane1, plane2, src_w, src_h, copy_w, copy_h);
-    } else { // 270
-        // Rotation=270 => native_w==logical_h, native_h==logical_w
-        const int native_w = logical_h;
-        const int native_h = logical_w;
-        if ((native_w & 3) != 0) {
-            ESP_LOGE(TAG, "drawXth: rotation=270 requires native width multiple of 4 (native_w=%d)", native_w);
-            return;
+        if (x0 < t.copy_w) {
+            const int copy_w = (t.copy_w - x0 < n) ? (t.copy_w - x0) : n;
+            blitXthColumns(t, plane1, plane2, n, src_h, x0, copy_w);
         }
-        const int dst_pitch = native_w >> 2;
-        if (!covers_fullscreen) {
-            clearNativeWhite2bpp(fb, dst_pitch, native_h);
+        first += n;
+        n = kXthBandCols;
+    }
+    free(band);
+    return ok;
+}
+
+/**
+ * @brief Decode an XTG payload a band of rows at a time and blit each band; stops after the last visible row.
+ */
+static bool streamXtgBands(const XtxTarget& t, PayloadReader& payload, int src_w) {
+    const size_t src_pitch = static_cast<size_t>((src_w + 7) >> 3);
+    uint8_t* band = static_cast<uint8_t*>(malloc(src_pitch * kXtgBandRows));
+    if (!band) {
+        ESP_LOGE(TAG, "drawXtg: band alloc failed (%zu bytes)", src_pitch * kXtgBandRows);
+        return false;
+    }
+    bool ok = true;
+    for (int y0 = 0; y0 < t.copy_h; y0 += kXtgBandRows) {
+        const int rows = (t.copy_h - y0 < kXtgBandRows) ? (t.copy_h - y0) : kXtgBandRows;
+        if (!payload.read(band, src_pitch * static_cast<size_t>(rows))) {
+            ok = false;
+            break;
         }
-        xthBlitRot270TopLeftClipped2bpp(
-            fb, dst_pitch, logical_h, plane1, plane2, src_w, src_h, copy_w, copy_h);
+        blitXtgRows(t, band, static_cast<int>(src_pitch), src_w, y0, rows);
     }
+    free(band);
+    return ok;
+}
 
-    const int64_t draw_done_us = esp_timer_get_time();
-    if (fast) {
-        epd->smoothUpdate(true, BBEP_WHITE);
-    } else {
-        epd->fullUpdate(CLEAR_EXTRA_WHITE, true);
-    }
-    const int64_t end_us = esp_timer_get_time();
-
-    const int64_t draw_us = draw_done_us - start_us;
-    const int64_t update_us = end_us - draw_done_us;
-    const int64_t total_us = end_us - start_us;
-    ESP_LOGI(TAG,
-        "drawXth: draw=%lld us update=%lld us total=%lld us rot=%d mode=%d",
-        static_cast<long long>(draw_us),
-        static_cast<long long>(update_us),
-        static_cast<long long>(total_us),
-        rot,
-        static_cast<int>(mode));
+bool drawXth(FASTEPD* epd, const uint8_t* data, size_t size) {
+    if (!epd || !data) {
+        ESP_LOGE(TAG, "drawXth: null epd=%p data=%p", epd, data);
+        return false;
+    }
+
+    const int64_t start_us = esp_timer_get_time();
+
+    XtxImageHeader hdr = {};
+    const uint8_t* payload = nullptr;
+    if (!parseXthHeader(data, size, &hdr, &payload)) {
+        ESP_LOGE(TAG, "drawXth: invalid XTH header (size=%zu)", size);
+        return false;
+    }
+    if (hdr.compression != kXtxCompressionNone) {
+        MemSource src = {data, size, 0};
+        return drawXthStream(epd, memRead, &src);
+    }
+
+    XtxTarget t = {};
+    if (!prepareTarget(epd, "drawXth", hdr, 2, &t)) {
+        return false;
+    }
+
+    const int src_w = static_cast<int>(hdr.width);
+    const int src_h = static_cast<int>(hdr.height);
+    const size_t plane_bytes = static_cast<size_t>(src_w) * static_cast<size_t>((src_h + 7) >> 3);
+    const size_t expected_bytes = plane_bytes * 2u;
+    if (hdr.data_size != expected_bytes) {
+        ESP_LOGE(TAG, "drawXth: dataSize mismatch: hdr=%" PRIu32 " expected=%zu", hdr.data_size, expected_bytes);
+        return false;
+    }
+    if (kXtxHeaderSize + expected_bytes > size) {
+        ESP_LOGE(TAG, "drawXth: truncated payload: size=%zu need=%zu", size, kXtxHeaderSize + expected_bytes);
+        return false;
+    }
+
+    blitXthColumns(t, payload, payload + plane_bytes, src_w, src_h, 0, t.copy_w);
+    logDrawTime(epd, "drawXth", start_us, t.rot);
+    return true;
 }
 
-void drawXtg(FASTEPD* epd, const uint8_t* data, size_t size, bool fast) {
+bool drawXtg(FASTEPD* epd, const uint8_t* data, size_t size) {
     if (!epd || !data) {
         ESP_LOGE(TAG, "drawXtg: null epd=%p data=%p", epd, data);
-        return;
+        return false;
     }
 
-    int32_t mode = epd->getMode();
     const int64_t start_us = esp_timer_get_time();
 
     XtxImageHeader hdr = {};
     const uint8_t* payload = nullptr;
     if (!parseXtgHeader(data, size, &hdr, &payload)) {
         ESP_LOGE(TAG, "drawXtg: invalid XTG header (size=%zu)", size);
-        return;
+        return false;
     }
-    if (hdr.color_mode != 0 || hdr.compression != 0) {
-        ESP_LOGE(TAG, "drawXtg: unsupported XTG header: colorMode=%u compression=%u", hdr.color_mode, hdr.compression);
-        return;
+    if (hdr.compression != kXtxCompressionNone) {
+        MemSource src = {data, size, 0};
+        return drawXtgStream(epd, memRead, &src);
     }
 
-    const int logical_w = epd->width();
-    const int logical_h = epd->height();
-    if (hdr.width == 0 || hdr.height == 0 || logical_w <= 0 || logical_h <= 0) {
-        ESP_LOGE(TAG, "drawXtg: invalid dimensions: xtg=%ux%u epd=%dx%d", hdr.width, hdr.height, logical_w, logical_h);
-        return;
-    }
-
-    if (mode != BB_MODE_1BPP) {
-        ESP_LOGE(TAG, "drawXtg: requires BB_MODE_1BPP (mode=%d)", static_cast<int>(mode));
-        return;
+    XtxTarget t = {};
+    if (!prepareTarget(epd, "drawXtg", hdr, 1, &t)) {
+        return false;
     }
 
     const int src_w = static_cast<int>(hdr.width);
@@ -200,91 +441,476 @@ void drawXtg(FASTEPD* epd, const uint8_t* data, size_t size, bool fast) {
     const size_t expected_bytes = static_cast<size_t>(src_pitch) * static_cast<size_t>(src_h);
     if (hdr.data_size != expected_bytes) {
         ESP_LOGE(TAG, "drawXtg: dataSize mismatch: hdr=%" PRIu32 " expected=%zu", hdr.data_size, expected_bytes);
-        return;
+        return false;
     }
     if (kXtxHeaderSize + expected_bytes > size) {
         ESP_LOGE(TAG, "drawXtg: truncated payload: size=%zu need=%zu", size, kXtxHeaderSize + expected_bytes);
-        return;
+        return false;
     }
 
-    uint8_t* fb = epd->currentBuffer();
-    if (!fb) {
-        ESP_LOGE(TAG, "drawXtg: epd.currentBuffer() returned null");
-        return;
+    if (t.rot == 0 && src_w == t.logical_w && src_h == t.logical_h) {
+        xtgBlitRot0Fullscreen1bpp(t.fb, payload, t.logical_w, t.logical_h);
+    } else {
+        blitXtgRows(t, payload, src_pitch, src_w, 0, t.copy_h);
+        padXtgRot0(t);
     }
+    logDrawTime(epd, "drawXtg", start_us, t.rot);
+    return true;
+}
 
-    int rot = epd->getRotation();
-    rot %= 360;
-    if (rot < 0) {
-        rot += 360;
+/**
+ * @brief Payload of an in-memory file in stored layout (XTH: plane 1 then plane 2).
+ *
+ * Stored payloads are used in place; run-length encoded ones are decoded into `*owned`,
+ * which the caller frees.
+ */
+static bool loadPayload(
+    const char* fn,
+    const uint8_t* data,
+    size_t size,
+    const XtxImageHeader& hdr,
+    int bpp,
+    const uint8_t** out,
+    uint8_t** owned) {
+    *owned = nullptr;
+    const size_t col_bytes = static_cast<size_t>((hdr.height + 7) >> 3);
+    const size_t expected_bytes = (bpp == 2) ? static_cast<size_t>(hdr.width) * col_bytes * 2u
+                                             : static_cast<size_t>((hdr.width + 7) >> 3) * static_cast<size_t>(hdr.height);
+    if (hdr.compression == kXtxCompressionNone) {
+        if (hdr.data_size != expected_bytes || kXtxHeaderSize + expected_bytes > size) {
+            ESP_LOGE(TAG, "%s: dataSize mismatch or truncated: hdr=%" PRIu32 " expected=%zu size=%zu", fn, hdr.data_size,
+                expected_bytes, size);
+            return false;
+        }
+        *out = data + kXtxHeaderSize;
+        return true;
+    }
+
+    uint8_t* buf = static_cast<uint8_t*>(malloc(expected_bytes));
+    if (!buf) {
+        ESP_LOGE(TAG, "%s: payload alloc failed (%zu bytes)", fn, expected_bytes);
+        return false;
+    }
+    MemSource src = {data + kXtxHeaderSize, size - kXtxHeaderSize, 0};
+    PayloadReader payload(memRead, &src, hdr.compression, hdr.data_size);
+    bool ok = true;
+    if (bpp == 2) {
+        // Planes are interleaved per column in the encoded stream.
+        uint8_t* plane2 = buf + expected_bytes / 2u;
+        for (size_t c = 0; c < hdr.width && ok; c++) {
+            ok = payload.read(buf + c * col_bytes, col_bytes) && payload.read(plane2 + c * col_bytes, col_bytes);
+        }
+    } else {
+        ok = payload.read(buf, expected_bytes);
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "%s: truncated or corrupt payload", fn);
+        free(buf);
+        return false;
+    }
+    *out = buf;
+    *owned = buf;
+    return true;
+}
+
+/**
+ * @brief Clip a placed source rect against the image, @p clip and the target.
+ *
+ * @param s Receives the visible source rect.
+ * @param d Receives the logical destination rect (same size as @p s).
+ * @return `false` if nothing is visible.
+ */
+static bool clipPlacement(
+    const XtxTarget& t,
+    const XtxImageHeader& hdr,
+    int x,
+    int y,
+    const XtxRect* src,
+    const XtxRect* clip,
+    XtxRect* s,
+    XtxRect* d) {
+    int64_t sx0 = src ? src->x : 0;
+    int64_t sy0 = src ? src->y : 0;
+    int64_t sx1 = src ? sx0 + src->w : hdr.width;
+    int64_t sy1 = src ? sy0 + src->h : hdr.height;
+    // Source pixel (sx, sy) lands on (sx + ox, sy + oy).
+    const int64_t ox = static_cast<int64_t>(x) - sx0;
+    const int64_t oy = static_cast<int64_t>(y) - sy0;
+
+    int64_t dx0 = (sx0 < 0 ? 0 : sx0) + ox;
+    int64_t dy0 = (sy0 < 0 ? 0 : sy0) + oy;
+    int64_t dx1 = (sx1 > hdr.width ? hdr.width : sx1) + ox;
+    int64_t dy1 = (sy1 > hdr.height ? hdr.height : sy1) + oy;
+    int64_t cx0 = 0;
+    int64_t cy0 = 0;
+    int64_t cx1 = t.logical_w;
+    int64_t cy1 = t.logical_h;
+    if (clip) {
+        cx0 = clip->x > cx0 ? clip->x : cx0;
+        cy0 = clip->y > cy0 ? clip->y : cy0;
+        cx1 = static_cast<int64_t>(clip->x) + clip->w < cx1 ? static_cast<int64_t>(clip->x) + clip->w : cx1;
+        cy1 = static_cast<int64_t>(clip->y) + clip->h < cy1 ? static_cast<int64_t>(clip->y) + clip->h : cy1;
+    }
+    dx0 = dx0 > cx0 ? dx0 : cx0;
+    dy0 = dy0 > cy0 ? dy0 : cy0;
+    dx1 = dx1 < cx1 ? dx1 : cx1;
+    dy1 = dy1 < cy1 ? dy1 : cy1;
+    if (dx0 >= dx1 || dy0 >= dy1) {
+        return false;
+    }
+    d->x = static_cast<int>(dx0);
+    d->y = static_cast<int>(dy0);
+    d->w = static_cast<int>(dx1 - dx0);
+    d->h = static_cast<int>(dy1 - dy0);
+    s->x = static_cast<int>(dx0 - ox);
+    s->y = static_cast<int>(dy0 - oy);
+    s->w = d->w;
+    s->h = d->h;
+    return true;
+}
+
+/** @brief Shared body of `drawXthAt()`/`drawXtgAt()`. */
+static bool drawXtxAt(
+    FASTEPD* epd,
+    bool xth,
+    const uint8_t* data,
+    size_t size,
+    int x,
+    int y,
+    const XtxRect* src,
+    const XtxRect* clip,
+    XtxRect* drawn) {
+    const char* fn = xth ? "drawXthAt" : "drawXtgAt";
+    if (drawn) {
+        *drawn = XtxRect{x, y, 0, 0};
+    }
+    if (!epd || !data) {
+        ESP_LOGE(TAG, "%s: null epd=%p data=%p", fn, epd, data);
+        return false;
+    }
+
+    XtxImageHeader hdr = {};
+    const uint8_t* unused = nullptr;
+    const bool parsed =
+        xth ? parseXthHeader(data, size, &hdr, &unused) : parseXtgHeader(data, size, &hdr, &unused);
+    if (!parsed) {
+        ESP_LOGE(TAG, "%s: invalid header (size=%zu)", fn, size);
+        return false;
+    }
+    XtxTarget t = {};
+    if (!describeTarget(epd, fn, hdr, xth ? 2 : 1, &t)) {
+        return false;
+    }
+    XtxRect s = {};
+    XtxRect d = {};
+    if (!clipPlacement(t, hdr, x, y, src, clip, &s, &d)) {
+        return true;
+    }
+
+    const uint8_t* payload = nullptr;
+    uint8_t* owned = nullptr;
+    if (!loadPayload(fn, data, size, hdr, xth ? 2 : 1, &payload, &owned)) {
+        return false;
+    }
+    if (xth) {
+        const size_t plane_bytes = static_cast<size_t>(hdr.width) * static_cast<size_t>((hdr.height + 7) >> 3);
+        xthBlitRect2bpp(t.fb, t.dst_pitch, t.rot, t.logical_w, t.logical_h, payload, payload + plane_bytes, hdr.width,
+            hdr.height, s.x, s.y, s.w, s.h, d.x, d.y);
+    } else {
+        xtgBlitRect1bpp(t.fb, t.dst_pitch, t.rot, t.logical_w, t.logical_h, payload, (hdr.width + 7) >> 3, s.x, s.y, s.w,
+            s.h, d.x, d.y);
+    }
+    free(owned);
+    if (drawn) {
+        *drawn = d;
+    }
+    return true;
+}
+
+bool drawXthAt(FASTEPD* epd, const uint8_t* data, size_t size, int x, int y, const XtxRect* src, const XtxRect* clip,
+    XtxRect* drawn) {
+    return drawXtxAt(epd, true, data, size, x, y, src, clip, drawn);
+}
+
+bool drawXtgAt(FASTEPD* epd, const uint8_t* data, size_t size, int x, int y, const XtxRect* src, const XtxRect* clip,
+    XtxRect* drawn) {
+    return drawXtxAt(epd, false, data, size, x, y, src, clip, drawn);
+}
+
+bool drawXthStream(FASTEPD* epd, XtxReadFn read, void* user, const uint8_t* expect_md5_8) {
+    if (!epd || !read) {
+        ESP_LOGE(TAG, "drawXthStream: null epd=%p read=%p", epd, read);
+        return false;
+    }
+
+    const int64_t start_us = esp_timer_get_time();
+
+    uint8_t head[kXtxHeaderSize];
+    XtxImageHeader hdr = {};
+    const uint8_t* unused = nullptr;
+    if (!readExact(read, user, head, sizeof(head)) || !parseXthHeader(head, sizeof(head), &hdr, &unused)) {
+        ESP_LOGE(TAG, "drawXthStream: invalid XTH header");
+        return false;
+    }
+    if (expect_md5_8 && std::memcmp(hdr.md5_8, expect_md5_8, sizeof(hdr.md5_8)) != 0) {
+        ESP_LOGE(TAG, "drawXthStream: header md5_8 does not match the page index entry");
+        return false;
+    }
+    XtxTarget t = {};
+    if (!prepareTarget(epd, "drawXthStream", hdr, 2, &t)) {
+        return false;
+    }
+
+    const int src_w = static_cast<int>(hdr.width);
+    const int src_h = static_cast<int>(hdr.height);
+    const size_t plane_bytes = static_cast<size_t>(src_w) * static_cast<size_t>((src_h + 7) >> 3);
+    PayloadReader payload(read, user, hdr.compression, hdr.data_size);
+    bool ok;
+    if (hdr.compression == kXtxCompressionRle) {
+        ok = streamXthBands(t, payload, src_w, src_h);
+    } else {
+        if (hdr.data_size != plane_bytes * 2u) {
+            ESP_LOGE(TAG, "drawXthStream: dataSize mismatch: hdr=%" PRIu32 " expected=%zu", hdr.data_size,
+                plane_bytes * 2u);
+            return false;
+        }
+        uint8_t* planes = static_cast<uint8_t*>(malloc(plane_bytes * 2u));
+        if (!planes) {
+            ESP_LOGE(TAG, "drawXthStream: payload alloc failed (%zu bytes)", plane_bytes * 2u);
+            return false;
+        }
+        ok = payload.read(planes, plane_bytes * 2u);
+        if (ok) {
+            blitXthColumns(t, planes, planes + plane_bytes, src_w, src_h, 0, t.copy_w);
+        }
+        free(planes);
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "drawXthStream: truncated or corrupt payload");
+        return false;
+    }
+    logDrawTime(epd, "drawXthStream", start_us, t.rot);
+    return true;
+}
+
+bool drawXtgStream(FASTEPD* epd, XtxReadFn read, void* user, const uint8_t* expect_md5_8) {
+    if (!epd || !read) {
+        ESP_LOGE(TAG, "drawXtgStream: null epd=%p read=%p", epd, read);
+        return false;
+    }
+
+    const int64_t start_us = esp_timer_get_time();
+
+    uint8_t head[kXtxHeaderSize];
+    XtxImageHeader hdr = {};
+    const uint8_t* unused = nullptr;
+    if (!readExact(read, user, head, sizeof(head)) || !parseXtgHeader(head, sizeof(head), &hdr, &unused)) {
+        ESP_LOGE(TAG, "drawXtgStream: invalid XTG header");
+        return false;
+    }
+    if (expect_md5_8 && std::memcmp(hdr.md5_8, expect_md5_8, sizeof(hdr.md5_8)) != 0) {
+        ESP_LOGE(TAG, "drawXtgStream: header md5_8 does not match the page index entry");
+        return false;
+    }
+    XtxTarget t = {};
+    if (!prepareTarget(epd, "drawXtgStream", hdr, 1, &t)) {
+        return false;
     }
 
-    const int copy_w = (src_w < logical_w) ? src_w : logical_w;
-    const int copy_h = (src_h < logical_h) ? src_h : logical_h;
-    const bool covers_fullscreen = (copy_w == logical_w) && (copy_h == logical_h);
-    const bool exact_match = (src_w == logical_w) && (src_h == logical_h);
+    const int src_w = static_cast<int>(hdr.width);
+    const size_t expected_bytes = static_cast<size_t>((src_w + 7) >> 3) * static_cast<size_t>(hdr.height);
+    if (hdr.compression == kXtxCompressionNone && hdr.data_size != expected_bytes) {
+        ESP_LOGE(TAG, "drawXtgStream: dataSize mismatch: hdr=%" PRIu32 " expected=%zu", hdr.data_size, expected_bytes);
+        return false;
+    }
+    PayloadReader payload(read, user, hdr.compression, hdr.data_size);
+    if (!streamXtgBands(t, payload, src_w)) {
+        ESP_LOGE(TAG, "drawXtgStream: truncated or corrupt payload");
+        return false;
+    }
+    padXtgRot0(t);
+    logDrawTime(epd, "drawXtgStream", start_us, t.rot);
+    return true;
+}
 
-    if (rot == 0) {
-        const int dst_pitch = (logical_w + 7) >> 3;
-        if (!covers_fullscreen) {
-            clearNativeWhite1bpp(fb, dst_pitch, logical_h);
+/**
+ * @brief Streaming PackBits encoder (`kXtxCompressionRle`) into a fixed-size buffer.
+ *
+ * Runs of three or more equal bytes become repeat packets, everything else literal packets.
+ * `overflow()` turns true once the output would exceed the buffer, so callers can fall back
+ * to storing the payload as is.
+ */
+class PackBitsWriter {
+public:
+    PackBitsWriter(uint8_t* out, size_t cap) : out_(out), cap_(cap) {}
+
+    void put(uint8_t b) {
+        if (run_n_ > 0 && b == run_byte_ && run_n_ < 128) {
+            run_n_++;
+            return;
         }
-        if (exact_match) {
-            xtgBlitRot0Fullscreen1bpp(fb, payload, logical_w, logical_h);
+        flushRun();
+        run_byte_ = b;
+        run_n_ = 1;
+    }
+
+    void put(const uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            put(data[i]);
+        }
+    }
+
+    /** @return Encoded length. */
+    size_t finish() {
+        flushRun();
+        flushLiteral();
+        return len_;
+    }
+
+    bool overflow() const { return overflow_; }
+
+private:
+    void emit(uint8_t b) {
+        if (len_ < cap_) {
+            out_[len_++] = b;
         } else {
-            xtgBlitRot0TopLeftClipped1bpp(fb, dst_pitch, payload, src_pitch, copy_w, copy_h);
-            // Ensure padding bits in the destination width are white.
-            const int r = logical_w & 7;
-            if (r != 0) {
-                const uint8_t pad_mask = static_cast<uint8_t>((1u << (8 - r)) - 1u);
-                uint8_t* row = fb + (dst_pitch - 1);
-                for (int y = 0; y < logical_h; y++) {
-                    row[static_cast<size_t>(y) * static_cast<size_t>(dst_pitch)] |= pad_mask;
+            overflow_ = true;
+        }
+    }
+
+    void flushLiteral() {
+        if (lit_n_ == 0) {
+            return;
+        }
+        emit(static_cast<uint8_t>(lit_n_ - 1));
+        for (int i = 0; i < lit_n_; i++) {
+            emit(lit_[i]);
+        }
+        lit_n_ = 0;
+    }
+
+    void flushRun() {
+        if (run_n_ >= 3) {
+            flushLiteral();
+            emit(static_cast<uint8_t>(257 - run_n_));
+            emit(run_byte_);
+        } else {
+            for (int i = 0; i < run_n_; i++) {
+                if (lit_n_ == static_cast<int>(sizeof(lit_))) {
+                    flushLiteral();
                 }
+                lit_[lit_n_++] = run_byte_;
             }
         }
-    } else if (rot == 90) {
-        const int dst_pitch = (logical_h + 7) >> 3; // native_w == logical_h for rot=90
-        if (!covers_fullscreen) {
-            clearNativeWhite1bpp(fb, dst_pitch, logical_w); // native_h == logical_w for rot=90
+        run_n_ = 0;
+    }
+
+    uint8_t* out_;
+    size_t cap_;
+    size_t len_ = 0;
+    bool overflow_ = false;
+    uint8_t lit_[128];
+    int lit_n_ = 0;
+    uint8_t run_byte_ = 0;
+    int run_n_ = 0;
+};
+
+/** @brief Write the XTG/XTH header for a payload already in place after it. */
+static void writeXtxHeader(uint8_t* file, bool xth, int w, int h, uint8_t compression, uint32_t data_size) {
+    const uint32_t magic = xth ? kXthMagic : kXtgMagic;
+    for (int i = 0; i < 4; i++) {
+        file[i] = static_cast<uint8_t>(magic >> (8 * i));
+        file[10 + i] = static_cast<uint8_t>(data_size >> (8 * i));
+    }
+    file[4] = static_cast<uint8_t>(w);
+    file[5] = static_cast<uint8_t>(w >> 8);
+    file[6] = static_cast<uint8_t>(h);
+    file[7] = static_cast<uint8_t>(h >> 8);
+    file[8] = 0;
+    file[9] = compression;
+
+    uint8_t digest[16];
+    md5_context_t md5;
+    esp_rom_md5_init(&md5);
+    esp_rom_md5_update(&md5, file + kXtxHeaderSize, data_size);
+    esp_rom_md5_final(digest, &md5);
+    std::memcpy(file + 14, digest, 8);
+}
+
+uint8_t* encodeXtx(FASTEPD* epd, size_t* size) {
+    if (!epd || !size) {
+        return nullptr;
+    }
+    const int32_t mode = epd->getMode();
+    const bool xth = (mode == BB_MODE_2BPP);
+    const int w = epd->width();
+    const int h = epd->height();
+    uint8_t* fb = epd->currentBuffer();
+    if ((mode != BB_MODE_1BPP && !xth) || epd->getRotation() != 0 || !fb || w <= 0 || h <= 0 || w > 0xFFFF ||
+        h > 0xFFFF) {
+        ESP_LOGE(TAG, "encodeXtx: unsupported source: mode=%d rot=%d %dx%d", static_cast<int>(mode),
+            static_cast<int>(epd->getRotation()), w, h);
+        return nullptr;
+    }
+
+    // Source pitch as FastEPD packs rows; XTG rows use the same packing.
+    const size_t pitch = static_cast<size_t>((w * (xth ? 2 : 1) + 7) >> 3);
+    const size_t col_bytes = static_cast<size_t>((h + 7) >> 3);
+    const size_t raw_bytes = xth ? static_cast<size_t>(w) * col_bytes * 2u : pitch * static_cast<size_t>(h);
+    uint8_t* file = static_cast<uint8_t*>(malloc(kXtxHeaderSize + raw_bytes));
+    if (!file) {
+        ESP_LOGE(TAG, "encodeXtx: alloc failed (%zu bytes)", kXtxHeaderSize + raw_bytes);
+        return nullptr;
+    }
+    uint8_t* payload = file + kXtxHeaderSize;
+
+    uint8_t* planes = nullptr;
+    if (xth) {
+        planes = static_cast<uint8_t*>(calloc(raw_bytes, 1));
+        if (!planes) {
+            ESP_LOGE(TAG, "encodeXtx: plane alloc failed (%zu bytes)", raw_bytes);
+            free(file);
+            return nullptr;
         }
-        xtgBlitRot90TopLeftClipped1bpp(fb, dst_pitch, logical_w, payload, src_pitch, src_w, copy_w, copy_h);
-    } else if (rot == 180) {
-        const int dst_pitch = (logical_w + 7) >> 3;
-        if (!covers_fullscreen) {
-            clearNativeWhite1bpp(fb, dst_pitch, logical_h);
+        // XTH stores columns right to left, 8 rows per byte (MSB on top), 0 = white.
+        uint8_t* plane2 = planes + raw_bytes / 2u;
+        for (int y = 0; y < h; y++) {
+            const uint8_t* row = fb + static_cast<size_t>(y) * pitch;
+            const uint8_t bit = static_cast<uint8_t>(0x80u >> (y & 7));
+            for (int x = 0; x < w; x++) {
+                const uint8_t xth_val = static_cast<uint8_t>(3u - ((row[x >> 2] >> (6 - 2 * (x & 3))) & 3u));
+                const size_t at = static_cast<size_t>(w - 1 - x) * col_bytes + static_cast<size_t>(y >> 3);
+                if (xth_val & 2u) {
+                    planes[at] |= bit;
+                }
+                if (xth_val & 1u) {
+                    plane2[at] |= bit;
+                }
+            }
         }
-        xtgBlitRot180TopLeftClipped1bpp(
-            fb, dst_pitch, logical_w, logical_h, payload, src_pitch, src_w, copy_w, copy_h);
-    } else if (rot == 270) {
-        const int dst_pitch = (logical_h + 7) >> 3; // native_w == logical_h for rot=270
-        if (!covers_fullscreen) {
-            clearNativeWhite1bpp(fb, dst_pitch, logical_w); // native_h == logical_w for rot=270
+    }
+
+    // Prefer run-length encoding whenever it is smaller; XTH interleaves its planes per column.
+    PackBitsWriter rle(payload, raw_bytes - 1);
+    if (xth) {
+        for (int c = 0; c < w && !rle.overflow(); c++) {
+            rle.put(planes + static_cast<size_t>(c) * col_bytes, col_bytes);
+            rle.put(planes + raw_bytes / 2u + static_cast<size_t>(c) * col_bytes, col_bytes);
         }
-        xtgBlitRot270TopLeftClipped1bpp(fb, dst_pitch, logical_h, payload, src_pitch, src_w, copy_w, copy_h);
     } else {
-        ESP_LOGE(TAG, "drawXtg: unsupported rotation=%d (expected 0/90/180/270)", rot);
-        return;
+        rle.put(fb, raw_bytes);
     }
-
-    const int64_t draw_done_us = esp_timer_get_time();
-    if (fast) {
-        epd->smoothUpdate(true, BBEP_WHITE);
-        } else {
-        epd->fullUpdate(CLEAR_EXTRA_WHITE, true);
-     }
-    const int64_t end_us = esp_timer_get_time();
-
-    const int64_t draw_us = draw_done_us - start_us;
-    const int64_t update_us = end_us - draw_done_us;
-    const int64_t total_us = end_us - start_us;
-    ESP_LOGI(TAG,
-        "drawXtg: draw=%lld us update=%lld us total=%lld us rot=%d mode=%d",
-        static_cast<long long>(draw_us),
-        static_cast<long long>(update_us),
-        static_cast<long long>(total_us),
-        rot,
-        static_cast<int>(mode));
+    const size_t rle_bytes = rle.finish();
+    if (!rle.overflow()) {
+        writeXtxHeader(file, xth, w, h, kXtxCompressionRle, static_cast<uint32_t>(rle_bytes));
+        *size = kXtxHeaderSize + rle_bytes;
+    } else {
+        std::memcpy(payload, xth ? planes : fb, raw_bytes);
+        writeXtxHeader(file, xth, w, h, kXtxCompressionNone, static_cast<uint32_t>(raw_bytes));
+        *size = kXtxHeaderSize + raw_bytes;
+    }
+    free(planes);
+    return file;
 }
 
 }
@@ -2,9 +2,11 @@
  * @file fastepd_draw_xtc.h
  * @brief Draw XTG/XTH images into a FastEPD back buffer.
  *
- * These helpers take an in-memory XTG (1bpp) or XTH (2bpp) payload (including
- * header) and blit it into the `FASTEPD::currentBuffer()` using the current
- * rotation and mode expected by FastEPD.
+ * These helpers take an XTG (1bpp) or XTH (2bpp) file (including header), either in memory
+ * or pulled from a reader, and blit it into the `FASTEPD::currentBuffer()` using the current
+ * rotation and mode expected by FastEPD. Payloads may be stored as is or run-length encoded
+ * (`fastepd_xtc_utils::kXtxCompressionRle`). `encodeXtx()` goes the other way, turning a 1/2bpp
+ * buffer into such a file.
  */
 #pragma once
 
@@ -12,38 +14,115 @@
 
 namespace fastepd_xtc {
 
+/**
+ * @brief Source of XTG/XTH file bytes for the stream variants.
+ * @return Number of bytes copied into @p buf (short only at end of data), or negative on error.
+ */
+typedef int32_t (*XtxReadFn)(void* user, uint8_t* buf, int32_t len);
+
+/**
+ * @brief Rectangle in pixels, used for source sub-rects and clip rects of `drawXthAt()`/`drawXtgAt()`.
+ */
+struct XtxRect {
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
 /**
  * @brief Draw an XTH (2bpp) image buffer to the EPD.
  *
  * The XTH payload is stored as two 1bpp bitplanes in a column-major,
  * 8-rows-per-byte format. This function converts it into FastEPD's native
- * 2bpp back buffer layout for the current rotation, then triggers a full update.
+ * 2bpp back buffer layout for the current rotation. It does not refresh the panel; the
+ * caller does that once the blit succeeded. Run-length encoded payloads are decoded a band
+ * of columns at a time.
  *
  * @param epd FastEPD instance (must be non-null).
  * @param data Pointer to the start of the XTH file in memory (must be non-null).
  * @param size Total size of @p data in bytes.
- * @param fast Controls speed of updating the display; true means that a faster update is done.
+ * @return `false` if the file is invalid or cannot be drawn in the current mode/rotation.
  *
  * @note Requires `epd->getMode() == BB_MODE_2BPP`.
  * @note Supports rotations 0/90/180/270 (via `epd->getRotation()`).
  */
-void drawXth(FASTEPD* epd, const uint8_t* data, size_t size, bool fast);
+bool drawXth(FASTEPD* epd, const uint8_t* data, size_t size);
 
 /**
  * @brief Draw an XTG (1bpp) image buffer to the EPD.
  *
  * The XTG payload is a packed 1bpp bitmap (MSB-first within each byte). This
  * function blits it into FastEPD's native 1bpp back buffer layout for the
- * current rotation, then triggers a full update.
+ * current rotation, without refreshing the panel. Run-length encoded payloads
+ * are decoded a band of rows at a time.
  *
  * @param epd FastEPD instance (must be non-null).
  * @param data Pointer to the start of the XTG file in memory (must be non-null).
  * @param size Total size of @p data in bytes.
- * @param fast Controls speed of updating the display; true means that a faster update is done.
+ * @return `false` if the file is invalid or cannot be drawn in the current mode/rotation.
  *
  * @note Requires `epd->getMode() == BB_MODE_1BPP`.
  * @note Supports rotations 0/90/180/270 (via `epd->getRotation()`).
  */
-void drawXtg(FASTEPD* epd, const uint8_t* data, size_t size, bool fast);
+bool drawXtg(FASTEPD* epd, const uint8_t* data, size_t size);
+
+/**
+ * @brief Draw part of an XTH image at logical `(x, y)` without refreshing the display.
+ *
+ * The source rectangle's top-left corner lands on `(x, y)`; any offset is allowed, pixels are
+ * shifted into place by `xthBlitRect2bpp()` and everything outside the drawn rectangle keeps
+ * its value. Works on any 2bpp FastEPD instance, including sprites. Run-length encoded files
+ * are decoded into a temporary buffer first.
+ *
+ * @param src Source sub-rect, or null for the whole image; clipped to the image.
+ * @param clip Logical clip rect, or null; the target bounds always clip.
+ * @param drawn Receives the logical rect actually written (`w`/`h` 0 if nothing is visible).
+ * @return `false` if the file is invalid or the mode/rotation is unsupported.
+ */
+bool drawXthAt(FASTEPD* epd, const uint8_t* data, size_t size, int x, int y, const XtxRect* src, const XtxRect* clip,
+    XtxRect* drawn);
+
+/**
+ * @brief Draw part of an XTG image at logical `(x, y)` without refreshing the display.
+ *
+ * Same contract as `drawXthAt()` for 1bpp targets, using `xtgBlitRect1bpp()`.
+ */
+bool drawXtgAt(FASTEPD* epd, const uint8_t* data, size_t size, int x, int y, const XtxRect* src, const XtxRect* clip,
+    XtxRect* drawn);
+
+/**
+ * @brief Serialize a rotation-0 1bpp/2bpp FastEPD buffer (typically a sprite) as an XTG/XTH file.
+ *
+ * 1bpp buffers become XTG and 2bpp buffers XTH, so the file draws back exactly the pixels the
+ * buffer holds. The payload is run-length encoded when that is smaller, and `md5_8` is taken
+ * over the payload as stored.
+ *
+ * @param size Receives the file size in bytes.
+ * @return `malloc()`ed file bytes for the caller to `free()`, or null if the buffer is unsupported
+ *         or memory runs out.
+ */
+uint8_t* encodeXtx(FASTEPD* epd, size_t* size);
+
+/**
+ * @brief Like `drawXth()`, pulling the file sequentially from @p read.
+ *
+ * Run-length encoded payloads are never held whole: only one band of decoded columns is
+ * resident. Uncompressed payloads keep their two planes apart, so they are read into one
+ * temporary buffer first.
+ *
+ * @param expect_md5_8 If non-null, the file is rejected unless its header carries this `md5_8`
+ *        (XTC books use it to catch an index that no longer matches its pages). This is an
+ *        identity check on the header field only; the payload itself is not hashed.
+ */
+bool drawXthStream(FASTEPD* epd, XtxReadFn read, void* user, const uint8_t* expect_md5_8 = nullptr);
+
+/**
+ * @brief Like `drawXtg()`, pulling the file sequentially from @p read.
+ *
+ * Only one band of rows is resident, whether or not the payload is compressed.
+ * @p expect_md5_8 is checked as in `drawXthStream()`.
+ */
+bool drawXtgStream(FASTEPD* epd, XtxReadFn read, void* user, const uint8_t* expect_md5_8 = nullptr);
 
 }
@@ -23,6 +23,19 @@ constexpr uint32_t kXtgMagic = 0x00475458; // "XTG\0" as little-endian u32
 /// @brief Magic value for an XTH header (`"XTH\\0"` interpreted as little-endian u32).
 constexpr uint32_t kXthMagic = 0x00485458; // "XTH\0" as little-endian u32
 
+/// @brief `XtxImageHeader::compression`: payload stored as is.
+constexpr uint8_t kXtxCompressionNone = 0;
+/**
+ * @brief `XtxImageHeader::compression`: payload is PackBits run-length encoded.
+ *
+ * Control byte `n` in 0..127 is followed by `n + 1` literal bytes; `n` in 129..255 by one byte
+ * repeated `257 - n` times; 128 is a no-op. `data_size` counts the encoded bytes. XTG encodes the
+ * usual row-major bitmap. XTH encodes its planes interleaved per column (stored column order:
+ * plane 1 bytes of the column, then its plane 2 bytes) so a band of columns can be blitted as
+ * soon as it is decoded.
+ */
+constexpr uint8_t kXtxCompressionRle = 1;
+
 /**
  * @brief Parsed XTG/XTH header fields.
  *
@@ -32,8 +45,8 @@ struct XtxImageHeader {
     uint16_t width; ///< Image width in pixels.
     uint16_t height; ///< Image height in pixels.
     uint8_t color_mode; ///< Color mode (currently only `0` supported by callers).
-    uint8_t compression; ///< Compression mode (currently only `0` supported by callers).
-    uint32_t data_size; ///< Payload size in bytes (excluding the header).
+    uint8_t compression; ///< `kXtxCompressionNone` or `kXtxCompressionRle`.
+    uint32_t data_size; ///< Payload size in bytes as stored (excluding the header).
     uint8_t md5_8[8]; ///< First 8 bytes of an MD5 checksum (as stored in the file).
 };
 
@@ -119,6 +132,79 @@ static inline bool parseXthHeader(const uint8_t* data, size_t size, XtxImageHead
     return parseXtxHeader(data, size, kXthMagic, out, payload);
 }
 
+/**
+ * @brief XTC container magic for books of XTG pages (`"XTC\\0"` as little-endian u32).
+ *
+ * An XTC file is a `kXtcHeaderSize` header, a page index of `page_count` entries of
+ * `kXtcIndexEntrySize` bytes at `index_offset`, and the pages themselves: complete XTG/XTH
+ * files (header included) stored back to back anywhere else in the file.
+ */
+constexpr uint32_t kXtcMagic = 0x00435458; // "XTC\0" as little-endian u32
+/// @brief XTC container magic for books of XTH pages (`"XTCH"` as little-endian u32).
+constexpr uint32_t kXtchMagic = 0x48435458; // "XTCH" as little-endian u32
+/// @brief Container format version written by our tools and accepted by `parseXtcHeader()`.
+constexpr uint16_t kXtcVersion = 1;
+/// @brief Size in bytes of the XTC container header.
+constexpr size_t kXtcHeaderSize = 16;
+/// @brief Size in bytes of one XTC page index entry.
+constexpr size_t kXtcIndexEntrySize = 16;
+
+/**
+ * @brief Parsed XTC container header.
+ *
+ * Layout (little-endian): magic u32, version u16, page_count u16, index_offset u32, reserved u32.
+ */
+struct XtcHeader {
+    bool xth; ///< Pages are XTH (`kXtchMagic`) rather than XTG (`kXtcMagic`).
+    uint16_t version; ///< Container version (`kXtcVersion`).
+    uint16_t page_count; ///< Number of index entries.
+    uint32_t index_offset; ///< File offset of the first index entry.
+};
+
+/**
+ * @brief Parsed XTC page index entry.
+ *
+ * Layout (little-endian): offset u32, size u32, md5_8[8].
+ */
+struct XtcPageEntry {
+    uint32_t offset; ///< File offset of the page's XTG/XTH header.
+    uint32_t size; ///< Page size in bytes, header included.
+    uint8_t md5_8[8]; ///< Copy of the page header's `md5_8`, used to catch a stale index.
+};
+
+/**
+ * @brief Parse an XTC container header.
+ * @param data Start of the file.
+ * @param size Number of bytes available at @p data.
+ * @param out Output struct to populate on success.
+ * @return `false` if the magic/version is unknown or the buffer is truncated.
+ */
+static inline bool parseXtcHeader(const uint8_t* data, size_t size, XtcHeader* out) {
+    if (!data || !out || size < kXtcHeaderSize) {
+        return false;
+    }
+    const uint32_t magic = loadLeU32(data);
+    if (magic != kXtcMagic && magic != kXtchMagic) {
+        return false;
+    }
+    out->xth = (magic == kXtchMagic);
+    out->version = loadLeU16(data + 4);
+    out->page_count = loadLeU16(data + 6);
+    out->index_offset = loadLeU32(data + 8);
+    return out->version == kXtcVersion;
+}
+
+/**
+ * @brief Parse one XTC page index entry.
+ * @param data Start of the entry (at least `kXtcIndexEntrySize` bytes).
+ * @param out Output struct to populate.
+ */
+static inline void parseXtcPageEntry(const uint8_t* data, XtcPageEntry* out) {
+    out->offset = loadLeU32(data);
+    out->size = loadLeU32(data + 4);
+    std::memcpy(out->md5_8, data + 8, sizeof(out->md5_8));
+}
+
 /**
  * @brief Reverse bit order within a byte.
  * @param b Byte to reverse.
@@ -988,4 +1074,277 @@ static inline void xtgBlitRot270TopLeftClipped1bpp(
     }
 }
 
+/**
+ * @brief Transpose an 8x8 bit matrix of MSB-first bytes.
+ *
+ * `in[r]` bit `7 - c` becomes `out[c]` bit `7 - r`, so rows of pixels (leftmost in the MSB)
+ * become columns of pixels (topmost in the MSB) and back.
+ */
+static inline void transpose8x8Msb(const uint8_t in[8], uint8_t out[8]) {
+    uint64_t x = 0;
+    for (int i = 0; i < 8; i++) {
+        x |= static_cast<uint64_t>(reverse8(in[i])) << (i * 8);
+    }
+    x = transpose8x8Lsb(x);
+    for (int i = 0; i < 8; i++) {
+        out[i] = reverse8(static_cast<uint8_t>(x >> (i * 8)));
+    }
+}
+
+/**
+ * @brief Widen an 8-pixel mask (MSB = first pixel) into the matching 16-bit 2bpp mask.
+ */
+static inline uint16_t spreadMask2bpp(uint8_t m) {
+    uint16_t out = 0;
+    for (int i = 0; i < 8; i++) {
+        if (m & (0x80u >> i)) {
+            out = static_cast<uint16_t>(out | (0xC000u >> (i * 2)));
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Merge @p nbits MSB-first bits into a native row at any bit offset.
+ *
+ * Only bits set in @p mask are written, so neighbouring pixels in the partially covered bytes
+ * keep their values. A negative @p bit drops the leading bits, which must be masked out.
+ *
+ * @param row Start of the native row.
+ * @param bit Bit offset of the first value bit within the row (native pixel * bpp).
+ * @param value Bits to store, right-aligned in the low @p nbits.
+ * @param mask Bits of @p value to store.
+ * @param nbits 8 (1bpp line) or 16 (2bpp line).
+ */
+static inline void storeNativeBits(uint8_t* row, int bit, uint32_t value, uint32_t mask, int nbits) {
+    uint32_t v = value << (32 - nbits);
+    uint32_t m = mask << (32 - nbits);
+    if (bit < 0) {
+        v <<= -bit;
+        m <<= -bit;
+        bit = 0;
+    }
+    const int shift = bit & 7;
+    v >>= shift;
+    m >>= shift;
+    uint8_t* d = row + (bit >> 3);
+    for (int k = 0; k < 4 && m != 0; k++) {
+        const uint8_t mb = static_cast<uint8_t>(m >> 24);
+        if (mb == 0xFF) {
+            d[k] = static_cast<uint8_t>(v >> 24);
+        } else if (mb != 0) {
+            d[k] = static_cast<uint8_t>((d[k] & ~mb) | ((v >> 24) & mb));
+        }
+        v <<= 8;
+        m <<= 8;
+    }
+}
+
+/**
+ * @brief Store one 8x8 block of XTG/XTH pixels at logical `(lx, ly)` in any rotation.
+ *
+ * The block is given either as rows (`columns == false`: `a[r]` bit `7 - c` is pixel `(c, r)`)
+ * or as columns (`columns == true`: `a[c]` bit `7 - r`), whichever the source format yields
+ * for free; it is transposed only when the rotation walks native rows the other way. Rotations
+ * 0/180 write rows and 90/270 write columns, each as an 8-pixel line merged at an arbitrary
+ * native bit offset by `storeNativeBits()`. Pixels cleared in @p valid are left untouched.
+ *
+ * @tparam BPP 1 (XTG: @p a holds native 1bpp values, @p b unused) or 2 (XTH: @p a / @p b are
+ *     planes 1 / 2, converted through `kXthLut4`).
+ * @param dst_w Destination logical width.
+ * @param dst_h Destination logical height.
+ */
+template <int BPP>
+static inline void xtxStoreBlock(
+    uint8_t* dst,
+    int dst_pitch,
+    int rot,
+    int dst_w,
+    int dst_h,
+    const uint8_t a[8],
+    const uint8_t b[8],
+    const uint8_t valid[8],
+    bool columns,
+    int lx,
+    int ly) {
+    const bool want_columns = (rot == 90 || rot == 270);
+    uint8_t ta[8];
+    uint8_t tb[8];
+    uint8_t tv[8];
+    if (columns != want_columns) {
+        transpose8x8Msb(a, ta);
+        if (BPP == 2) {
+            transpose8x8Msb(b, tb);
+        }
+        transpose8x8Msb(valid, tv);
+        a = ta;
+        b = tb;
+        valid = tv;
+    }
+
+    const bool reversed = (rot == 180 || rot == 270);
+    for (int i = 0; i < 8; i++) {
+        uint8_t m = valid[i];
+        if (m == 0) {
+            continue;
+        }
+        uint8_t la = a[i];
+        uint8_t lb = (BPP == 2) ? b[i] : 0;
+        if (reversed) {
+            m = reverse8(m);
+            la = reverse8(la);
+            lb = reverse8(lb);
+        }
+
+        // Native row and first native pixel of line i (see the rotation table in fastepd_native_utils.h).
+        int ny;
+        int nx;
+        switch (rot) {
+        case 90:
+            ny = dst_w - 1 - (lx + i);
+            nx = ly;
+            break;
+        case 180:
+            ny = dst_h - 1 - (ly + i);
+            nx = dst_w - 1 - (lx + 7);
+            break;
+        case 270:
+            ny = lx + i;
+            nx = dst_h - 1 - (ly + 7);
+            break;
+        default:
+            ny = ly + i;
+            nx = lx;
+            break;
+        }
+        uint8_t* row = dst + static_cast<size_t>(ny) * static_cast<size_t>(dst_pitch);
+        if (BPP == 1) {
+            storeNativeBits(row, nx, la, m, 8);
+        } else {
+            const uint32_t v = (static_cast<uint32_t>(kXthLut4[static_cast<size_t>((la & 0xF0) | (lb >> 4))]) << 8) |
+                kXthLut4[static_cast<size_t>(((la & 0x0F) << 4) | (lb & 0x0F))];
+            storeNativeBits(row, nx * 2, v, spreadMask2bpp(m), 16);
+        }
+    }
+}
+
+/**
+ * @brief Blit a source rectangle of an XTG (1bpp) bitmap to any logical position (any rotation).
+ *
+ * Unlike the `*TopLeftClipped*` kernels the destination need not start on a byte boundary:
+ * 8x8 blocks are read on the source byte grid and each 8-pixel line is shifted into place, so
+ * pixels outside the rectangle keep their values. The rectangle must already be clipped to
+ * both the source and the destination.
+ *
+ * @param dst Destination native 1bpp buffer.
+ * @param dst_pitch Destination native pitch in bytes.
+ * @param rot Destination rotation (0/90/180/270).
+ * @param dst_w Destination logical width.
+ * @param dst_h Destination logical height.
+ * @param src Source packed 1bpp bitmap (MSB-first within each byte).
+ * @param src_pitch Source pitch in bytes (`(src_w + 7) / 8`).
+ * @param sx Left source column of the rectangle.
+ * @param sy Top source row of the rectangle.
+ * @param w Rectangle width in pixels.
+ * @param h Rectangle height in pixels.
+ * @param dx Logical destination column of the rectangle's left edge.
+ * @param dy Logical destination row of the rectangle's top edge.
+ */
+static inline void xtgBlitRect1bpp(
+    uint8_t* dst,
+    int dst_pitch,
+    int rot,
+    int dst_w,
+    int dst_h,
+    const uint8_t* src,
+    int src_pitch,
+    int sx,
+    int sy,
+    int w,
+    int h,
+    int dx,
+    int dy) {
+    const int sx1 = sx + w;
+    const int sy1 = sy + h;
+    const uint8_t none[8] = {};
+    for (int by = sy; by < sy1; by += 8) {
+        const int rows = (sy1 - by < 8) ? (sy1 - by) : 8;
+        for (int bx = sx & ~7; bx < sx1; bx += 8) {
+            const int lo = (sx > bx) ? (sx - bx) : 0;
+            const int hi = (sx1 - bx < 8) ? (sx1 - bx) : 8;
+            const uint8_t col_mask = static_cast<uint8_t>((0xFFu >> lo) & (0xFFu << (8 - hi)));
+            uint8_t r8[8];
+            uint8_t v8[8];
+            for (int r = 0; r < 8; r++) {
+                if (r < rows) {
+                    r8[r] = src[static_cast<size_t>(by + r) * static_cast<size_t>(src_pitch) + static_cast<size_t>(bx >> 3)];
+                    v8[r] = col_mask;
+                } else {
+                    r8[r] = 0xFF;
+                    v8[r] = 0x00;
+                }
+            }
+            xtxStoreBlock<1>(dst, dst_pitch, rot, dst_w, dst_h, r8, none, v8, false, bx - sx + dx, by - sy + dy);
+        }
+    }
+}
+
+/**
+ * @brief Blit a source rectangle of an XTH (2-plane) image to any logical position (any rotation).
+ *
+ * The XTH counterpart of `xtgBlitRect1bpp()`: blocks are 8 source columns by one plane byte
+ * (8 rows, aligned to the source byte grid), so the columns can start anywhere and the rows
+ * are masked to the rectangle. The destination is a native 2bpp buffer.
+ *
+ * @param src_plane1 First XTH bitplane (column-major, 8 rows per byte, columns right to left).
+ * @param src_plane2 Second XTH bitplane.
+ * @param src_w Source width in pixels.
+ * @param src_h Source height in pixels.
+ */
+static inline void xthBlitRect2bpp(
+    uint8_t* dst,
+    int dst_pitch,
+    int rot,
+    int dst_w,
+    int dst_h,
+    const uint8_t* src_plane1,
+    const uint8_t* src_plane2,
+    int src_w,
+    int src_h,
+    int sx,
+    int sy,
+    int w,
+    int h,
+    int dx,
+    int dy) {
+    const int src_col_bytes = (src_h + 7) >> 3;
+    const int sx1 = sx + w;
+    const int sy1 = sy + h;
+    for (int by = sy & ~7; by < sy1; by += 8) {
+        const int lo = (sy > by) ? (sy - by) : 0;
+        const int hi = (sy1 - by < 8) ? (sy1 - by) : 8;
+        const uint8_t row_mask = static_cast<uint8_t>((0xFFu >> lo) & (0xFFu << (8 - hi)));
+        const size_t y_byte = static_cast<size_t>(by >> 3);
+        for (int bx = sx; bx < sx1; bx += 8) {
+            const int cols = (sx1 - bx < 8) ? (sx1 - bx) : 8;
+            uint8_t c1[8];
+            uint8_t c2[8];
+            uint8_t v8[8];
+            for (int c = 0; c < 8; c++) {
+                if (c < cols) {
+                    const size_t idx = static_cast<size_t>(src_w - 1 - (bx + c)) * static_cast<size_t>(src_col_bytes) + y_byte;
+                    c1[c] = src_plane1[idx];
+                    c2[c] = src_plane2[idx];
+                    v8[c] = row_mask;
+                } else {
+                    c1[c] = 0x00;
+                    c2[c] = 0x00;
+                    v8[c] = 0x00;
+                }
+            }
+            xtxStoreBlock<2>(dst, dst_pitch, rot, dst_w, dst_h, c1, c2, v8, true, bx - sx + dx, by - sy + dy);
+        }
+    }
+}
+
 }
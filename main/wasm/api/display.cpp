@@ -63,6 +63,240 @@ void Display::setCurrent(PaperDisplayDriver driver) {
     }
 }
 
+int32_t Display::setDitherMode(wasm_exec_env_t exec_env, int32_t mode)
+{
+    (void)exec_env;
+    if (mode < (int32_t)DisplayDitherMode::none || mode > (int32_t)DisplayDitherMode::diffusion) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "setDitherMode: invalid mode");
+        return kWasmErrInvalidArgument;
+    }
+    return kWasmOk;
+}
+
+int32_t Display::textWidths(
+    wasm_exec_env_t exec_env,
+    const uint8_t *texts,
+    size_t texts_len,
+    uint8_t *out,
+    size_t out_len)
+{
+    (void)exec_env;
+    (void)texts;
+    (void)texts_len;
+    (void)out;
+    (void)out_len;
+    wasm_api_set_last_error(kWasmErrInternal, "textWidths: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::drawTextBox(
+    wasm_exec_env_t exec_env,
+    const uint8_t *text,
+    size_t text_len,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    int32_t align,
+    int32_t line_spacing,
+    int32_t flags,
+    uint8_t *breaks,
+    size_t breaks_len)
+{
+    (void)exec_env;
+    (void)text;
+    (void)text_len;
+    (void)x;
+    (void)y;
+    (void)w;
+    (void)h;
+    (void)align;
+    (void)line_spacing;
+    (void)flags;
+    (void)breaks;
+    (void)breaks_len;
+    wasm_api_set_last_error(kWasmErrInternal, "drawTextBox: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::drawXthFile(wasm_exec_env_t exec_env, const char *path, bool fast)
+{
+    (void)exec_env;
+    (void)path;
+    (void)fast;
+    wasm_api_set_last_error(kWasmErrInternal, "drawXthFile: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::drawXtgFile(wasm_exec_env_t exec_env, const char *path, bool fast)
+{
+    (void)exec_env;
+    (void)path;
+    (void)fast;
+    wasm_api_set_last_error(kWasmErrInternal, "drawXtgFile: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::convertJpgFile(
+    wasm_exec_env_t exec_env,
+    const char *path,
+    int32_t mode,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    (void)path;
+    (void)mode;
+    (void)max_w;
+    (void)max_h;
+    wasm_api_set_last_error(kWasmErrInternal, "convertJpgFile: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::convertPngFile(
+    wasm_exec_env_t exec_env,
+    const char *path,
+    int32_t mode,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    (void)path;
+    (void)mode;
+    (void)max_w;
+    (void)max_h;
+    wasm_api_set_last_error(kWasmErrInternal, "convertPngFile: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::convertStatus(wasm_exec_env_t exec_env)
+{
+    (void)exec_env;
+    wasm_api_set_last_error(kWasmErrInternal, "convertStatus: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::drawXtcPage(wasm_exec_env_t exec_env, const char *path, int32_t page, bool fast)
+{
+    (void)exec_env;
+    (void)path;
+    (void)page;
+    (void)fast;
+    wasm_api_set_last_error(kWasmErrInternal, "drawXtcPage: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::drawXthAt(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t src_x,
+    int32_t src_y,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t clip_x,
+    int32_t clip_y,
+    int32_t clip_w,
+    int32_t clip_h)
+{
+    (void)exec_env;
+    (void)ptr;
+    (void)len;
+    (void)x;
+    (void)y;
+    (void)src_x;
+    (void)src_y;
+    (void)src_w;
+    (void)src_h;
+    (void)clip_x;
+    (void)clip_y;
+    (void)clip_w;
+    (void)clip_h;
+    wasm_api_set_last_error(kWasmErrInternal, "drawXthAt: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::drawXtgAt(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t src_x,
+    int32_t src_y,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t clip_x,
+    int32_t clip_y,
+    int32_t clip_w,
+    int32_t clip_h)
+{
+    (void)exec_env;
+    (void)ptr;
+    (void)len;
+    (void)x;
+    (void)y;
+    (void)src_x;
+    (void)src_y;
+    (void)src_w;
+    (void)src_h;
+    (void)clip_x;
+    (void)clip_y;
+    (void)clip_w;
+    (void)clip_h;
+    wasm_api_set_last_error(kWasmErrInternal, "drawXtgAt: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::canvasCreate(wasm_exec_env_t exec_env, int32_t w, int32_t h)
+{
+    (void)exec_env;
+    (void)w;
+    (void)h;
+    wasm_api_set_last_error(kWasmErrInternal, "canvasCreate: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::canvasDestroy(wasm_exec_env_t exec_env, int32_t handle)
+{
+    (void)exec_env;
+    (void)handle;
+    wasm_api_set_last_error(kWasmErrInternal, "canvasDestroy: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::canvasSelect(wasm_exec_env_t exec_env, int32_t handle)
+{
+    (void)exec_env;
+    if (handle == 0) {
+        return kWasmOk;
+    }
+    wasm_api_set_last_error(kWasmErrInternal, "canvasSelect: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
+int32_t Display::canvasPush(
+    wasm_exec_env_t exec_env,
+    int32_t handle,
+    int32_t x,
+    int32_t y,
+    int32_t rotation,
+    int32_t transparent_rgb888,
+    int32_t use_transparent)
+{
+    (void)exec_env;
+    (void)handle;
+    (void)x;
+    (void)y;
+    (void)rotation;
+    (void)transparent_rgb888;
+    (void)use_transparent;
+    wasm_api_set_last_error(kWasmErrInternal, "canvasPush: not supported by this display driver");
+    return kWasmErrInternal;
+}
+
 namespace {
 
 int32_t width(wasm_exec_env_t exec_env)
@@ -110,6 +344,21 @@ int32_t displayRect(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t w, i
     return Display::current()->displayRect(exec_env, x, y, w, h);
 }
 
+int32_t displayDirty(wasm_exec_env_t exec_env)
+{
+    return Display::current()->displayDirty(exec_env);
+}
+
+int32_t displayDiff(wasm_exec_env_t exec_env)
+{
+    return Display::current()->displayDiff(exec_env);
+}
+
+int32_t setDitherMode(wasm_exec_env_t exec_env, int32_t mode)
+{
+    return Display::current()->setDitherMode(exec_env, mode);
+}
+
 int32_t waitDisplay(wasm_exec_env_t exec_env)
 {
     return Display::current()->waitDisplay(exec_env);
@@ -159,7 +408,10 @@ static NativeSymbol g_display_native_symbols[] = {
     REG_NATIVE_FUNC(fillScreen, "(i)i"),
     REG_NATIVE_FUNC(display, "()i"),
     REG_NATIVE_FUNC(displayRect, "(iiii)i"),
+    REG_NATIVE_FUNC(displayDirty, "()i"),
+    REG_NATIVE_FUNC(displayDiff, "()i"),
     REG_NATIVE_FUNC(waitDisplay, "()i"),
+    REG_NATIVE_FUNC(setDitherMode, "(i)i"),
     REG_NATIVE_FUNC(startWrite, "()i"),
     REG_NATIVE_FUNC(endWrite, "()i"),
     REG_NATIVE_FUNC(setBrightness, "(i)i"),
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "display_commands.h"
 #include "wasm_export.h"
 
 enum class PaperDisplayDriver : int32_t {
@@ -20,6 +21,14 @@ enum class PaperIcon : int32_t {
     count = 4,
 };
 
+/** @brief How gray levels between the panel's quantization steps are rendered. */
+enum class DisplayDitherMode : int32_t {
+    none = 0, ///< Threshold each pixel to the nearest level.
+    bayer = 1, ///< Ordered 8x8 Bayer matrix.
+    blueNoise = 2, ///< Ordered 16x16 blue-noise tile.
+    diffusion = 3, ///< Floyd-Steinberg error diffusion (images); solid fills use Bayer.
+};
+
 constexpr int32_t kVlwSystemFontInter = 0;
 constexpr int32_t kVlwSystemFontMontserrat = 1;
 
@@ -44,11 +53,35 @@ public:
     virtual int32_t fillScreen(wasm_exec_env_t exec_env, int32_t rgb888) = 0;
     virtual int32_t display(wasm_exec_env_t exec_env) = 0;
     virtual int32_t displayRect(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t w, int32_t h) = 0;
+    /**
+     * @brief Refresh only what was drawn since the last refresh.
+     * @return Number of rectangles pushed to the panel (0 when nothing changed), or a negative error.
+     * Drivers without dirty tracking fall back to a full `display()`.
+     */
+    virtual int32_t displayDirty(wasm_exec_env_t exec_env)
+    {
+        const int32_t rc = this->display(exec_env);
+        return rc < 0 ? rc : 1;
+    }
+    /**
+     * @brief Refresh only the pixels that differ from what the panel last showed.
+     * @return Number of rectangles pushed to the panel (0 when the framebuffer is unchanged), or a negative error.
+     * Drivers without a shadow framebuffer fall back to `displayDirty()`.
+     */
+    virtual int32_t displayDiff(wasm_exec_env_t exec_env)
+    {
+        return this->displayDirty(exec_env);
+    }
     virtual int32_t fullUpdateSlow(wasm_exec_env_t exec_env)
     {
         return this->display(exec_env);
     }
     virtual int32_t waitDisplay(wasm_exec_env_t exec_env) = 0;
+    /**
+     * @brief Select the dither mode (`DisplayDitherMode`) used by later fills and gray image pushes.
+     * Drivers that dither in their own pipeline validate and ignore it.
+     */
+    virtual int32_t setDitherMode(wasm_exec_env_t exec_env, int32_t mode);
     virtual int32_t startWrite(wasm_exec_env_t exec_env) = 0;
     virtual int32_t endWrite(wasm_exec_env_t exec_env) = 0;
     virtual int32_t setBrightness(wasm_exec_env_t exec_env, int32_t v) = 0;
@@ -67,12 +100,46 @@ public:
     virtual int32_t setTextEncoding(wasm_exec_env_t exec_env, int32_t utf8_enable, int32_t cp437_enable) = 0;
     virtual int32_t drawString(wasm_exec_env_t exec_env, const char *s, int32_t x, int32_t y) = 0;
     virtual int32_t textWidth(wasm_exec_env_t exec_env, const char *s) = 0;
+    /**
+     * @brief Measure every NUL-separated string in `texts` as `textWidth()` would, writing one int32 width
+     * per string to `out` (4-byte aligned) until it is full. A NUL ending the buffer does not start another string.
+     * @return Number of widths written, or a negative error. Drivers without batch measuring report `kWasmErrInternal`.
+     */
+    virtual int32_t textWidths(
+        wasm_exec_env_t exec_env,
+        const uint8_t *texts,
+        size_t texts_len,
+        uint8_t *out,
+        size_t out_len);
     virtual int32_t fontHeight(wasm_exec_env_t exec_env) = 0;
     virtual int32_t vlwRegister(wasm_exec_env_t exec_env, const uint8_t *ptr, size_t len) = 0;
     virtual int32_t vlwUse(wasm_exec_env_t exec_env, int32_t handle) = 0;
     virtual int32_t vlwUseSystem(wasm_exec_env_t exec_env, int32_t font_id, int32_t font_size) = 0;
     virtual int32_t vlwUnload(wasm_exec_env_t exec_env) = 0;
     virtual int32_t vlwClearAll(wasm_exec_env_t exec_env) = 0;
+    /**
+     * @brief Wrap `text_len` bytes of text into the box at `(x, y)` and draw it with the active VLW font.
+     *
+     * Lines break at `\n` and before words that would cross `w` (0 = no wrapping); lines that would
+     * reach below `h` (0 = unlimited) are not laid out. `align` is 0 left, 1 center, 2 right, and
+     * `line_spacing` is added to the font height between lines.
+     * `flags`: 1 = break between any characters, 2 = measure only (draw nothing).
+     * @param breaks Optional int32 array receiving each line's byte offset, then the offset where layout stopped.
+     * @return Number of lines laid out, or a negative error. Drivers without VLW text report `kWasmErrInternal`.
+     */
+    virtual int32_t drawTextBox(
+        wasm_exec_env_t exec_env,
+        const uint8_t *text,
+        size_t text_len,
+        int32_t x,
+        int32_t y,
+        int32_t w,
+        int32_t h,
+        int32_t align,
+        int32_t line_spacing,
+        int32_t flags,
+        uint8_t *breaks,
+        size_t breaks_len);
 
     // display_images.cpp
     virtual int32_t pushImageRgb565(
@@ -143,6 +210,94 @@ public:
         int32_t y,
         int32_t max_w,
         int32_t max_h) = 0;
+    /**
+     * @brief Stream an XTH/XTG file (stored or run-length encoded) from `path` to the screen and refresh it.
+     * Drivers without streaming support report `kWasmErrInternal`.
+     */
+    virtual int32_t drawXthFile(wasm_exec_env_t exec_env, const char *path, bool fast);
+    virtual int32_t drawXtgFile(wasm_exec_env_t exec_env, const char *path, bool fast);
+    /**
+     * @brief Pre-dither the image at `path` for `mode` (0 = 1-bpp, 1 = 2-bpp) and a `max_w` x `max_h` fit box,
+     * saving it next to the file as `<path>.xtg`/`<path>.xth`. The file is written in the background;
+     * `drawJpgFile()`/`drawPngFile()` use it while it is newer than the image.
+     * Drivers without conversion support report `kWasmErrInternal`.
+     */
+    virtual int32_t convertJpgFile(
+        wasm_exec_env_t exec_env,
+        const char *path,
+        int32_t mode,
+        int32_t max_w,
+        int32_t max_h);
+    virtual int32_t convertPngFile(
+        wasm_exec_env_t exec_env,
+        const char *path,
+        int32_t mode,
+        int32_t max_w,
+        int32_t max_h);
+    /** @brief 1 while a conversion is being written, 0 after success, or the last write's negative error. */
+    virtual int32_t convertStatus(wasm_exec_env_t exec_env);
+    /**
+     * @brief Stream page `page` of the XTC book at `path` to the screen and refresh it.
+     * Drivers without XTC support report `kWasmErrInternal`.
+     */
+    virtual int32_t drawXtcPage(wasm_exec_env_t exec_env, const char *path, int32_t page, bool fast);
+    /**
+     * @brief Draw the `src_*` part of an in-memory XTH/XTG file with its top-left at `(x, y)`, without refreshing.
+     * `src_w`/`src_h` <= 0 take the rest of the image; `clip_w`/`clip_h` <= 0 disable the clip rect.
+     * Drivers without positioned XTH/XTG support report `kWasmErrInternal`.
+     */
+    virtual int32_t drawXthAt(
+        wasm_exec_env_t exec_env,
+        const uint8_t *ptr,
+        size_t len,
+        int32_t x,
+        int32_t y,
+        int32_t src_x,
+        int32_t src_y,
+        int32_t src_w,
+        int32_t src_h,
+        int32_t clip_x,
+        int32_t clip_y,
+        int32_t clip_w,
+        int32_t clip_h);
+    virtual int32_t drawXtgAt(
+        wasm_exec_env_t exec_env,
+        const uint8_t *ptr,
+        size_t len,
+        int32_t x,
+        int32_t y,
+        int32_t src_x,
+        int32_t src_y,
+        int32_t src_w,
+        int32_t src_h,
+        int32_t clip_x,
+        int32_t clip_y,
+        int32_t clip_w,
+        int32_t clip_h);
+    /**
+     * @brief Allocate an off-screen `w` x `h` canvas in the current display mode, filled with white.
+     * @return Canvas handle (> 0), or a negative error. Drivers without canvases report `kWasmErrInternal`.
+     */
+    virtual int32_t canvasCreate(wasm_exec_env_t exec_env, int32_t w, int32_t h);
+    virtual int32_t canvasDestroy(wasm_exec_env_t exec_env, int32_t handle);
+    /**
+     * @brief Send later drawing calls to canvas `handle`, or back to the screen when `handle` is 0.
+     * Refresh, rotation, mode and geometry calls always act on the screen.
+     */
+    virtual int32_t canvasSelect(wasm_exec_env_t exec_env, int32_t handle);
+    /**
+     * @brief Composite canvas `handle` into the current draw target (normally the screen) at `(x, y)`.
+     * @param rotation Clockwise quarter turns (0..3) applied to the canvas.
+     * @param use_transparent Skip canvas pixels whose color matches `transparent_rgb888`.
+     */
+    virtual int32_t canvasPush(
+        wasm_exec_env_t exec_env,
+        int32_t handle,
+        int32_t x,
+        int32_t y,
+        int32_t rotation,
+        int32_t transparent_rgb888,
+        int32_t use_transparent);
 
     // display_primitives.cpp
     virtual int32_t drawPixel(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t rgb888) = 0;
@@ -198,6 +353,20 @@ public:
         int32_t x2,
         int32_t y2,
         int32_t rgb888) = 0;
+    /**
+     * @brief Validate a whole `DisplayCommandOp` buffer, then execute it in one native call.
+     * @param out_dirty Grown to cover everything drawn; may be null.
+     * @param out_executed Receives the number of commands that completed, also when a command
+     *        fails part way through the list (the commands before it stay drawn); may be null.
+     * @return Number of commands executed, or a negative error (nothing is drawn if validation fails).
+     * The default runs each command through the virtuals above; drivers may override with a tighter loop.
+     */
+    virtual int32_t submitCommands(
+        wasm_exec_env_t exec_env,
+        const uint8_t *ptr,
+        size_t len,
+        DisplayCommandRect *out_dirty,
+        int32_t *out_executed);
 
     private:
         static std::unique_ptr<Display> _current;
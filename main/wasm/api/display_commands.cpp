@@ -0,0 +1,373 @@
+#include "display_commands.h"
+
+#include <string.h>
+#include <string>
+
+#include "display.h"
+#include "errors.h"
+
+namespace {
+
+constexpr size_t kWordBytes = 4;
+
+/** @brief Number of fixed int32 arguments following the header, or -1 for an unknown opcode. */
+int fixed_arg_count(uint32_t op)
+{
+    switch ((DisplayCommandOp)op) {
+        case DisplayCommandOp::pixel:
+            return 3;
+        case DisplayCommandOp::line:
+            return 5;
+        case DisplayCommandOp::fastVline:
+        case DisplayCommandOp::fastHline:
+            return 4;
+        case DisplayCommandOp::rect:
+        case DisplayCommandOp::fillRect:
+            return 5;
+        case DisplayCommandOp::roundRect:
+        case DisplayCommandOp::fillRoundRect:
+            return 6;
+        case DisplayCommandOp::circle:
+        case DisplayCommandOp::fillCircle:
+            return 4;
+        case DisplayCommandOp::fillArc:
+            return 7;
+        case DisplayCommandOp::ellipse:
+        case DisplayCommandOp::fillEllipse:
+            return 5;
+        case DisplayCommandOp::triangle:
+        case DisplayCommandOp::fillTriangle:
+            return 7;
+        case DisplayCommandOp::textColor:
+            return 3;
+        case DisplayCommandOp::text:
+            return 3;
+    }
+    return -1;
+}
+
+uint32_t load_word(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+float word_to_float(int32_t v)
+{
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+/** @brief Bounding box of a non-text command in unclipped 64-bit coordinates. */
+bool command_bounds(const DisplayCommand &cmd, int64_t *x, int64_t *y, int64_t *w, int64_t *h)
+{
+    const int32_t *a = cmd.args;
+    switch (cmd.op) {
+        case DisplayCommandOp::pixel:
+            *x = a[0];
+            *y = a[1];
+            *w = 1;
+            *h = 1;
+            return true;
+        case DisplayCommandOp::line: {
+            const int64_t x0 = a[0] < a[2] ? a[0] : a[2];
+            const int64_t y0 = a[1] < a[3] ? a[1] : a[3];
+            *x = x0;
+            *y = y0;
+            *w = (int64_t)(a[0] < a[2] ? a[2] : a[0]) - x0 + 1;
+            *h = (int64_t)(a[1] < a[3] ? a[3] : a[1]) - y0 + 1;
+            return true;
+        }
+        case DisplayCommandOp::fastVline:
+            *x = a[0];
+            *y = a[1];
+            *w = 1;
+            *h = a[2];
+            return true;
+        case DisplayCommandOp::fastHline:
+            *x = a[0];
+            *y = a[1];
+            *w = a[2];
+            *h = 1;
+            return true;
+        case DisplayCommandOp::rect:
+        case DisplayCommandOp::fillRect:
+        case DisplayCommandOp::roundRect:
+        case DisplayCommandOp::fillRoundRect:
+            *x = a[0];
+            *y = a[1];
+            *w = a[2];
+            *h = a[3];
+            return true;
+        case DisplayCommandOp::circle:
+        case DisplayCommandOp::fillCircle:
+        case DisplayCommandOp::fillArc:
+            *x = (int64_t)a[0] - a[2];
+            *y = (int64_t)a[1] - a[2];
+            *w = (int64_t)a[2] * 2 + 1;
+            *h = *w;
+            return true;
+        case DisplayCommandOp::ellipse:
+        case DisplayCommandOp::fillEllipse:
+            *x = (int64_t)a[0] - a[2];
+            *y = (int64_t)a[1] - a[3];
+            *w = (int64_t)a[2] * 2 + 1;
+            *h = (int64_t)a[3] * 2 + 1;
+            return true;
+        case DisplayCommandOp::triangle:
+        case DisplayCommandOp::fillTriangle: {
+            int64_t min_x = a[0];
+            int64_t max_x = a[0];
+            int64_t min_y = a[1];
+            int64_t max_y = a[1];
+            for (int i = 2; i < 6; i += 2) {
+                min_x = a[i] < min_x ? a[i] : min_x;
+                max_x = a[i] > max_x ? a[i] : max_x;
+                min_y = a[i + 1] < min_y ? a[i + 1] : min_y;
+                max_y = a[i + 1] > max_y ? a[i + 1] : max_y;
+            }
+            *x = min_x;
+            *y = min_y;
+            *w = max_x - min_x + 1;
+            *h = max_y - min_y + 1;
+            return true;
+        }
+        case DisplayCommandOp::textColor:
+        case DisplayCommandOp::text:
+            return false;
+    }
+    return false;
+}
+
+} // namespace
+
+bool DisplayCommandReader::next(DisplayCommand *out)
+{
+    if (pos_ + kWordBytes > len_) {
+        return false;
+    }
+    const uint32_t op = load_word(ptr_ + pos_);
+    pos_ += kWordBytes;
+    const int argc = fixed_arg_count(op);
+    out->op = (DisplayCommandOp)op;
+    for (int i = 0; i < argc; ++i) {
+        out->args[i] = (int32_t)load_word(ptr_ + pos_);
+        pos_ += kWordBytes;
+    }
+    out->text = nullptr;
+    out->text_len = 0;
+    if (out->op == DisplayCommandOp::text) {
+        out->text_len = (uint32_t)out->args[2];
+        out->text = (const char *)(ptr_ + pos_);
+        pos_ += ((size_t)out->text_len + kWordBytes - 1) & ~(kWordBytes - 1);
+    }
+    return true;
+}
+
+int32_t display_commands_validate(const uint8_t *ptr, size_t len, uint32_t *out_count)
+{
+    if (!ptr && len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: ptr is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (len > kDisplayCommandMaxBytes) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: buffer too large");
+        return kWasmErrInvalidArgument;
+    }
+    if ((len % kWordBytes) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: len must be a multiple of 4");
+        return kWasmErrInvalidArgument;
+    }
+
+    uint32_t count = 0;
+    size_t pos = 0;
+    while (pos < len) {
+        const uint32_t op = load_word(ptr + pos);
+        const int argc = fixed_arg_count(op);
+        if (argc < 0) {
+            wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: unknown opcode");
+            return kWasmErrInvalidArgument;
+        }
+        const size_t body = kWordBytes * (size_t)(1 + argc);
+        if (len - pos < body) {
+            wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: truncated command");
+            return kWasmErrInvalidArgument;
+        }
+        if ((DisplayCommandOp)op == DisplayCommandOp::text) {
+            const uint32_t text_len = load_word(ptr + pos + kWordBytes * 3);
+            if (text_len > kDisplayCommandMaxTextBytes) {
+                wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: text too long");
+                return kWasmErrInvalidArgument;
+            }
+            const size_t padded = ((size_t)text_len + kWordBytes - 1) & ~(kWordBytes - 1);
+            if (len - pos - body < padded) {
+                wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: truncated text");
+                return kWasmErrInvalidArgument;
+            }
+            pos += padded;
+        }
+        pos += body;
+        ++count;
+    }
+    if (out_count) {
+        *out_count = count;
+    }
+    return kWasmOk;
+}
+
+int display_commands_color_index(DisplayCommandOp op)
+{
+    if (op == DisplayCommandOp::textColor || op == DisplayCommandOp::text) {
+        return -1;
+    }
+    // The color is always the last fixed argument of a drawing command.
+    return fixed_arg_count((uint32_t)op) - 1;
+}
+
+void display_commands_rect_add(
+    DisplayCommandRect *acc,
+    int64_t x,
+    int64_t y,
+    int64_t w,
+    int64_t h,
+    int32_t bound_w,
+    int32_t bound_h)
+{
+    if (!acc || w <= 0 || h <= 0) {
+        return;
+    }
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = x + w;
+    int64_t y1 = y + h;
+    if (x1 > bound_w) x1 = bound_w;
+    if (y1 > bound_h) y1 = bound_h;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    if (acc->w > 0 && acc->h > 0) {
+        const int64_t ax1 = (int64_t)acc->x + acc->w;
+        const int64_t ay1 = (int64_t)acc->y + acc->h;
+        x0 = acc->x < x0 ? acc->x : x0;
+        y0 = acc->y < y0 ? acc->y : y0;
+        x1 = ax1 > x1 ? ax1 : x1;
+        y1 = ay1 > y1 ? ay1 : y1;
+    }
+    *acc = DisplayCommandRect{(int32_t)x0, (int32_t)y0, (int32_t)(x1 - x0), (int32_t)(y1 - y0)};
+}
+
+int32_t display_commands_execute_generic(
+    Display &display,
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    DisplayCommandRect *out_dirty,
+    int32_t *out_executed)
+{
+    if (out_executed) {
+        *out_executed = 0;
+    }
+    const int32_t bound_w = display.width(exec_env);
+    const int32_t bound_h = display.height(exec_env);
+    std::string text;
+    DisplayCommandReader reader(ptr, len);
+    DisplayCommand cmd;
+    int32_t executed = 0;
+    while (reader.next(&cmd)) {
+        const int32_t *a = cmd.args;
+        int32_t rc = kWasmOk;
+        switch (cmd.op) {
+            case DisplayCommandOp::pixel:
+                rc = display.drawPixel(exec_env, a[0], a[1], a[2]);
+                break;
+            case DisplayCommandOp::line:
+                rc = display.drawLine(exec_env, a[0], a[1], a[2], a[3], a[4]);
+                break;
+            case DisplayCommandOp::fastVline:
+                rc = display.drawFastVline(exec_env, a[0], a[1], a[2], a[3]);
+                break;
+            case DisplayCommandOp::fastHline:
+                rc = display.drawFastHline(exec_env, a[0], a[1], a[2], a[3]);
+                break;
+            case DisplayCommandOp::rect:
+                rc = display.drawRect(exec_env, a[0], a[1], a[2], a[3], a[4]);
+                break;
+            case DisplayCommandOp::fillRect:
+                rc = display.fillRect(exec_env, a[0], a[1], a[2], a[3], a[4]);
+                break;
+            case DisplayCommandOp::roundRect:
+                rc = display.drawRoundRect(exec_env, a[0], a[1], a[2], a[3], a[4], a[5]);
+                break;
+            case DisplayCommandOp::fillRoundRect:
+                rc = display.fillRoundRect(exec_env, a[0], a[1], a[2], a[3], a[4], a[5]);
+                break;
+            case DisplayCommandOp::circle:
+                rc = display.drawCircle(exec_env, a[0], a[1], a[2], a[3]);
+                break;
+            case DisplayCommandOp::fillCircle:
+                rc = display.fillCircle(exec_env, a[0], a[1], a[2], a[3]);
+                break;
+            case DisplayCommandOp::fillArc:
+                rc = display.fillArc(exec_env, a[0], a[1], a[2], a[3], word_to_float(a[4]), word_to_float(a[5]), a[6]);
+                break;
+            case DisplayCommandOp::ellipse:
+                rc = display.drawEllipse(exec_env, a[0], a[1], a[2], a[3], a[4]);
+                break;
+            case DisplayCommandOp::fillEllipse:
+                rc = display.fillEllipse(exec_env, a[0], a[1], a[2], a[3], a[4]);
+                break;
+            case DisplayCommandOp::triangle:
+                rc = display.drawTriangle(exec_env, a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+                break;
+            case DisplayCommandOp::fillTriangle:
+                rc = display.fillTriangle(exec_env, a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+                break;
+            case DisplayCommandOp::textColor:
+                rc = display.setTextColor(exec_env, a[0], a[1], a[2]);
+                break;
+            case DisplayCommandOp::text: {
+                text.assign(cmd.text, cmd.text_len);
+                rc = display.drawString(exec_env, text.c_str(), a[0], a[1]);
+                if (rc > 0) {
+                    const int32_t font_h = display.fontHeight(exec_env);
+                    display_commands_rect_add(out_dirty, a[0], a[1], rc, font_h, bound_w, bound_h);
+                }
+                break;
+            }
+        }
+        if (rc < 0) {
+            return rc;
+        }
+        int64_t x = 0;
+        int64_t y = 0;
+        int64_t w = 0;
+        int64_t h = 0;
+        if (command_bounds(cmd, &x, &y, &w, &h)) {
+            display_commands_rect_add(out_dirty, x, y, w, h, bound_w, bound_h);
+        }
+        ++executed;
+        if (out_executed) {
+            *out_executed = executed;
+        }
+    }
+    return executed;
+}
+
+int32_t Display::submitCommands(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    DisplayCommandRect *out_dirty,
+    int32_t *out_executed)
+{
+    if (out_executed) {
+        *out_executed = 0;
+    }
+    const int32_t rc = display_commands_validate(ptr, len, nullptr);
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    return display_commands_execute_generic(*this, exec_env, ptr, len, out_dirty, out_executed);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "wasm_export.h"
+
+class Display;
+
+/**
+ * @brief Opcodes of the `displaySubmitCommands()` command buffer.
+ *
+ * A command buffer is a sequence of little-endian 32-bit words. Every command starts with a
+ * header word holding its opcode followed by the fixed int32 arguments listed per opcode
+ * (colors are RGB888, angles are IEEE-754 float bit patterns). `text` additionally carries
+ * `byte_len` bytes of UTF-8 (not NUL-terminated) padded with zeros to the next word boundary.
+ */
+enum class DisplayCommandOp : uint32_t {
+    pixel = 1, ///< x, y, rgb888
+    line = 2, ///< x0, y0, x1, y1, rgb888
+    fastVline = 3, ///< x, y, h, rgb888
+    fastHline = 4, ///< x, y, w, rgb888
+    rect = 5, ///< x, y, w, h, rgb888
+    fillRect = 6, ///< x, y, w, h, rgb888
+    roundRect = 7, ///< x, y, w, h, r, rgb888
+    fillRoundRect = 8, ///< x, y, w, h, r, rgb888
+    circle = 9, ///< x, y, r, rgb888
+    fillCircle = 10, ///< x, y, r, rgb888
+    fillArc = 11, ///< x, y, r0, r1, angle0 (f32), angle1 (f32), rgb888
+    ellipse = 12, ///< x, y, rx, ry, rgb888
+    fillEllipse = 13, ///< x, y, rx, ry, rgb888
+    triangle = 14, ///< x0, y0, x1, y1, x2, y2, rgb888
+    fillTriangle = 15, ///< x0, y0, x1, y1, x2, y2, rgb888
+    textColor = 16, ///< fg_rgb888, bg_rgb888, use_bg
+    text = 17, ///< x, y, byte_len, bytes...
+};
+
+/** Upper bound on fixed arguments of any command. */
+constexpr int kDisplayCommandMaxArgs = 7;
+/** Upper bound on the size of a command buffer accepted by `displaySubmitCommands()`. */
+constexpr size_t kDisplayCommandMaxBytes = 256 * 1024;
+/** Upper bound on the text payload of a single `text` command. */
+constexpr uint32_t kDisplayCommandMaxTextBytes = 1024;
+
+/** @brief One decoded command; `text` points into the caller's buffer and is not NUL-terminated. */
+struct DisplayCommand {
+    DisplayCommandOp op;
+    int32_t args[kDisplayCommandMaxArgs];
+    const char *text;
+    uint32_t text_len;
+};
+
+/** @brief Logical rectangle covering everything a command list drew (empty when `w == 0`). */
+struct DisplayCommandRect {
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+};
+
+/**
+ * @brief Sequential decoder over a command buffer that already passed `display_commands_validate()`.
+ */
+class DisplayCommandReader {
+public:
+    DisplayCommandReader(const uint8_t *ptr, size_t len) : ptr_(ptr), len_(len) {}
+
+    /** @brief Decode the next command; returns `false` at the end of the buffer. */
+    bool next(DisplayCommand *out);
+
+private:
+    const uint8_t *ptr_;
+    size_t len_;
+    size_t pos_ = 0;
+};
+
+/**
+ * @brief Check a whole command buffer before anything is drawn.
+ * @param out_count Number of commands in the buffer.
+ * @return `kWasmOk`, or `kWasmErrInvalidArgument` with the last error set.
+ */
+int32_t display_commands_validate(const uint8_t *ptr, size_t len, uint32_t *out_count);
+
+/** @brief Index of the RGB888 argument of a drawing command, or -1 for state/text commands. */
+int display_commands_color_index(DisplayCommandOp op);
+
+/** @brief Grow `acc` to cover `(x, y, w, h)` clipped to `bound_w` x `bound_h`. */
+void display_commands_rect_add(
+    DisplayCommandRect *acc,
+    int64_t x,
+    int64_t y,
+    int64_t w,
+    int64_t h,
+    int32_t bound_w,
+    int32_t bound_h);
+
+/**
+ * @brief Run a validated command list through `Display` virtuals, one call per command.
+ *
+ * This is the portable fallback used by drivers without a native batch path. The dirty rect
+ * is the geometric bounding box of each command; text uses `drawString()`'s width and
+ * `fontHeight()` at the anchor point.
+ * @param out_executed Receives the number of commands that completed, even on error; may be null.
+ * @return Number of commands executed, or the first negative error returned by a command.
+ */
+int32_t display_commands_execute_generic(
+    Display &display,
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    DisplayCommandRect *out_dirty,
+    int32_t *out_executed);
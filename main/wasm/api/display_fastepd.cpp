@@ -2,17 +2,35 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <memory>
+#include <new>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
 #include <string.h>
+#include <sys/stat.h>
 #include <FastEPD.h>
 #include <JPEGDEC.h>
 #include "fonts/vlw_registry.h"
 #include "fonts/vlw_renderer_fastepd.h"
 #include "lgfx/utility/lgfx_pngle.h"
 #include "display_fastepd.h"
+#include "display_commands.h"
 #include "display_fastepd_arc.h"
+#include "display_fastepd_canvas.h"
+#include "display_fastepd_diff.h"
+#include "display_fastepd_dither.h"
+#include "display_fastepd_file_stream.h"
+#include "display_fastepd_file_writer.h"
+#include "display_fastepd_dirty.h"
+#include "display_fastepd_image.h"
+#include "display_fastepd_image_cache.h"
+#include "display_fastepd_parallel.h"
+#include "display_fastepd_png.h"
+#include "display_fastepd_refresh.h"
+#include "display_fastepd_resample.h"
+#include "display_fastepd_xtc_book.h"
+#include "../../other/fastepd_native_utils.h"
+#include "../../other/fastepd_pixel_kernels.h"
 #include "../..//other/fastepd_xtc.h"
 #include "esp_log.h"
 #include "../api.h"
@@ -20,18 +38,6 @@
 
 extern void hold_pwroff_pulse_low();
 
-extern "C" {
-int JPEG_openRAM(JPEGIMAGE *pJPEG, uint8_t *pData, int iDataSize, JPEG_DRAW_CALLBACK *pfnDraw);
-int JPEG_getWidth(JPEGIMAGE *pJPEG);
-int JPEG_getHeight(JPEGIMAGE *pJPEG);
-int JPEG_getSubSample(JPEGIMAGE *pJPEG);
-void JPEG_setPixelType(JPEGIMAGE *pJPEG, int iType);
-int JPEG_decode(JPEGIMAGE *pJPEG, int x, int y, int iOptions);
-int JPEG_decodeDither(JPEGIMAGE *pJPEG, uint8_t *pDither, int iOptions);
-int JPEG_getLastError(JPEGIMAGE *pJPEG);
-void JPEG_close(JPEGIMAGE *pJPEG);
-}
-
 void paper_touch_set_rotation(uint_fast8_t rot);
 
 namespace {
@@ -51,6 +57,16 @@ extern const uint8_t _binary_sleepimage_jpg_end[] asm("_binary_sleepimage_jpg_en
 static FASTEPD g_epd;
 /** @brief Tracks whether the shared FastEPD instance has been initialized. */
 static bool g_epd_inited = false;
+/** @brief Off-screen canvases created by the current app. */
+static FastEpdCanvasPool g_canvases;
+/** @brief Target of drawing calls: `g_epd`, or the canvas chosen by `canvasSelect()`. */
+static FASTEPD *g_draw = &g_epd;
+/** @brief Decoded `drawJpgFile()`/`drawPngFile()` results, kept across apps until the driver is released. */
+static FastEpdImageCache g_image_cache;
+/** @brief Book last opened by `drawXtcPage()`, kept open until another book is opened or the app unloads. */
+static std::unique_ptr<FastEpdXtcBook> g_xtc_book;
+/** @brief Background SD writer of `convertJpgFile()`/`convertPngFile()` results; outlives apps. */
+static FastEpdFileWriter g_convert_writer;
 /** @brief Cached brightness value exposed through the display API. */
 static uint8_t g_brightness = 0;
 /** @brief Active public display mode, defaulting to FastEPD 4bpp grayscale. */
@@ -62,11 +78,122 @@ struct FastEpdVlwRuntime {
     std::shared_ptr<VlwFont> active_font;
     bool active_font_is_system = false;
     FastEpdVlwTextState text_state = {};
+    VlwGlyphCache glyph_cache; ///< Scaled glyph bitmaps of the app's fonts.
+    VlwAdvanceTable advances; ///< Scaled advances of the active font at the current text size.
 };
 
 /** @brief Current app's FastEPD VLW state, cleared when the app unloads. */
 FastEpdVlwRuntime g_vlw_runtime;
 
+/** @brief Bitmap-font attributes set by the app, replayed onto each newly selected draw target. */
+struct FastEpdLegacyTextState {
+    int32_t font_id = -1; ///< -1 until `setTextFont()` is called.
+    bool color_set = false; ///< Colors live in `g_vlw_runtime.text_state`.
+    bool wrap_set = false;
+    bool wrap = false;
+};
+
+/** @brief Current app's bitmap-font attributes, cleared when the app unloads. */
+FastEpdLegacyTextState g_legacy_text;
+
+/** @brief Framebuffer regions drawn since the last refresh, consumed by `displayDirty()`. */
+FastEpdDirtyTracker g_dirty;
+
+/** @brief Bounds accumulator of the `submitCommands()` batch in progress, if any. */
+DisplayCommandRect *g_batch_bounds = nullptr;
+
+/** @brief App-selected dither mode for fills and gray image pushes. */
+DisplayDitherMode g_dither_mode = DisplayDitherMode::none;
+
+/** @brief Threshold tables for `g_dither_mode`, reconfigured lazily per framebuffer depth. */
+FastEpdDither g_dither;
+
+/** @brief Record a logical rectangle touched by a drawing call (canvas draws leave the panel clean). */
+void mark_dirty(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    if (g_draw == &g_epd) {
+        g_dirty.mark(x, y, w, h, g_epd.width(), g_epd.height());
+    }
+    if (g_batch_bounds) {
+        display_commands_rect_add(g_batch_bounds, x, y, w, h, g_draw->width(), g_draw->height());
+    }
+}
+
+/** @brief Record an inclusive box given in 64-bit coordinates so callers cannot overflow. */
+void mark_dirty_box(int64_t x0, int64_t y0, int64_t x1, int64_t y1)
+{
+    if (x1 < 0 || y1 < 0 || x0 > x1 || y0 > y1) {
+        return;
+    }
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > INT32_MAX - 1) x1 = INT32_MAX - 1;
+    if (y1 > INT32_MAX - 1) y1 = INT32_MAX - 1;
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+    mark_dirty((int32_t)x0, (int32_t)y0, (int32_t)(x1 - x0 + 1), (int32_t)(y1 - y0 + 1));
+}
+
+/** @brief Record the bounding box of a segment's endpoints. */
+void mark_dirty_points(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    mark_dirty_box(x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, x0 > x1 ? x0 : x1, y0 > y1 ? y0 : y1);
+}
+
+/** @brief Record the bounding box of a triangle's vertices. */
+void mark_dirty_points(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    const int32_t min_x = x0 < x1 ? (x0 < x2 ? x0 : x2) : (x1 < x2 ? x1 : x2);
+    const int32_t max_x = x0 > x1 ? (x0 > x2 ? x0 : x2) : (x1 > x2 ? x1 : x2);
+    const int32_t min_y = y0 < y1 ? (y0 < y2 ? y0 : y2) : (y1 < y2 ? y1 : y2);
+    const int32_t max_y = y0 > y1 ? (y0 > y2 ? y0 : y2) : (y1 > y2 ? y1 : y2);
+    mark_dirty_box(min_x, min_y, max_x, max_y);
+}
+
+/** @brief Record the box spanned by a circle or ellipse centred at `(cx, cy)`. */
+void mark_dirty_around(int32_t cx, int32_t cy, int32_t rx, int32_t ry)
+{
+    if (rx < 0 || ry < 0) {
+        return;
+    }
+    mark_dirty_box((int64_t)cx - rx, (int64_t)cy - ry, (int64_t)cx + rx, (int64_t)cy + ry);
+}
+
+/** @brief Record that the whole framebuffer changed (clear, mode switch, rotation). */
+void mark_dirty_all()
+{
+    if (g_draw == &g_epd) {
+        g_dirty.markAll(g_epd.width(), g_epd.height());
+    }
+}
+
+/** @brief Worker that runs panel refreshes while the WASM thread keeps going. */
+FastEpdRefreshWorker g_refresh;
+
+/** @brief Copy of the framebuffer as last pushed to the panel, enabled by the first `displayDiff()`. */
+FastEpdShadowBuffer g_shadow;
+
+/** @brief Refresh the shadow after a full-screen update (no-op until `displayDiff()` enabled it). */
+void shadow_capture_all()
+{
+    fastepd_native_utils::NativeLayout layout;
+    if (!g_shadow.enabled() || !fastepd_native_utils::describeNativeLayout(g_epd, &layout)) {
+        return;
+    }
+    (void)g_shadow.captureAll(layout, false);
+}
+
+/** @brief Refresh the shadow under a logical rect that was just pushed to the panel. */
+void shadow_capture_rect(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    fastepd_native_utils::NativeLayout layout;
+    if (!g_shadow.valid() || !fastepd_native_utils::describeNativeLayout(g_epd, &layout)) {
+        return;
+    }
+    g_shadow.captureRect(layout, x, y, w, h);
+}
+
 /** @brief Convert RGB888 into grayscale for FastEPD framebuffer operations. */
 uint8_t rgb888_to_gray8(int32_t rgb888)
 {
@@ -107,6 +234,25 @@ uint8_t gray8_to_epd_color(uint8_t gray, int32_t mode)
     return v;
 }
 
+/**
+ * @brief Gray8 -> raw native pixel value table for `mode`, rebuilt only when the mode changes.
+ *
+ * Equivalent to `gray8_to_epd_color()` followed by `fastepd_native_utils::nativePixelValue()`.
+ */
+const uint8_t *gray8_native_lut(int32_t mode)
+{
+    static uint8_t lut[256];
+    static int32_t lut_mode = -1;
+    if (lut_mode != mode) {
+        const int32_t bpp = fastepd_native_utils::bppForMode(mode);
+        for (int i = 0; i < 256; ++i) {
+            lut[i] = fastepd_native_utils::nativePixelValue(bpp, gray8_to_epd_color((uint8_t)i, mode));
+        }
+        lut_mode = mode;
+    }
+    return lut;
+}
+
 /** @brief Quantize a 4-bit grayscale value into the active FastEPD mode. */
 uint8_t gray4_to_epd_color(uint8_t v4, int32_t mode)
 {
@@ -120,6 +266,27 @@ uint8_t gray4_to_epd_color(uint8_t v4, int32_t mode)
     return v4;
 }
 
+/**
+ * @brief Gray8 -> raw native pixel value table quantizing through `gray4_to_epd_color()`.
+ *
+ * Indexed by `v4 * 0x11` (what `fastepd_pixel_kernels::unpackGray4()` produces) or by any gray8
+ * value whose top nibble is the 4-bit gray, as JPEGDEC's 8-bit output is used. Rebuilt only
+ * when the mode changes.
+ */
+const uint8_t *gray4_native_lut(int32_t mode)
+{
+    static uint8_t lut[256];
+    static int32_t lut_mode = -1;
+    if (lut_mode != mode) {
+        const int32_t bpp = fastepd_native_utils::bppForMode(mode);
+        for (int i = 0; i < 256; ++i) {
+            lut[i] = fastepd_native_utils::nativePixelValue(bpp, gray4_to_epd_color((uint8_t)(i >> 4), mode));
+        }
+        lut_mode = mode;
+    }
+    return lut;
+}
+
 /** @brief Validate the public text datum codes supported by the API. */
 bool is_valid_text_datum(int32_t datum)
 {
@@ -154,6 +321,8 @@ void fastepd_vlw_reset_all()
     g_vlw_runtime.active_font.reset();
     g_vlw_runtime.active_font_is_system = false;
     g_vlw_runtime.registry.Clear();
+    g_vlw_runtime.glyph_cache.Clear();
+    g_vlw_runtime.advances.Invalidate();
     reset_vlw_text_state();
 }
 
@@ -165,10 +334,12 @@ bool ensure_epd_ready(void)
             return true;
         }
         ESP_LOGW(kTag, "FastEPD marked inited but framebuffer missing; forcing reinit");
+        g_refresh.wait();
         g_epd.deInit();
         bbepDeinitBus();
         g_epd_inited = false;
         g_display_mode = 2;
+        g_shadow.invalidate();
     }
 
     if (!g_epd_inited) {
@@ -188,21 +359,82 @@ bool ensure_epd_ready(void)
             return false;
         }
         g_epd.backupPlane();
+        g_dirty.clear();
         g_epd_inited = true;
+        shadow_capture_all();
+        ESP_LOGI(kTag, "PIE pixel kernels %s", fastepd_pixel_kernels::selfTestPie() ? "enabled" : "disabled");
     }
     return g_epd.currentBuffer() != nullptr;
 }
 
-/** @brief Convert a missing-display condition into the standard WASM API error. */
+/**
+ * @brief Convert a missing-display condition into the standard WASM API error.
+ *
+ * On success the framebuffer is safe to touch: any refresh still reading it has finished.
+ */
 int32_t require_epd_ready_or_set_error(const char *context)
 {
     if (ensure_epd_ready()) {
+        g_refresh.wait();
         return kWasmOk;
     }
     wasm_api_set_last_error(kWasmErrNotReady, context);
     return kWasmErrNotReady;
 }
 
+/** @brief Like `require_epd_ready_or_set_error` for geometry queries, without waiting on a refresh. */
+int32_t require_epd_geometry_or_set_error(const char *context)
+{
+    if (g_epd_inited && g_epd.currentBuffer()) {
+        return kWasmOk;
+    }
+    return require_epd_ready_or_set_error(context);
+}
+
+/**
+ * @brief Hand a refresh of `count` logical rects (0 = whole panel) to the refresh worker.
+ *
+ * The caller must already have waited for the previous refresh; the framebuffer stays owned by
+ * the worker until the next `require_epd_ready_or_set_error()` or `waitDisplay()`.
+ */
+void submit_refresh(int clear_mode, const FastEpdDirtyRect *rects, int count)
+{
+    static_assert(FastEpdRefreshWorker::kMaxRects >= FastEpdDirtyTracker::kMaxRects, "refresh job too small");
+    static_assert(FastEpdRefreshWorker::kMaxRects >= FastEpdShadowBuffer::kMaxRects, "refresh job too small");
+    FastEpdRefreshWorker::Job job = {};
+    job.clear_mode = clear_mode;
+    job.rect_count = count;
+    for (int i = 0; i < count; ++i) {
+        job.rects[i] = BB_RECT{.x = rects[i].x, .y = rects[i].y, .w = rects[i].w, .h = rects[i].h};
+    }
+    (void)g_refresh.submit(&g_epd, job);
+}
+
+/**
+ * @brief Present a full-screen XTC blit through the refresh worker and settle dirty/shadow state.
+ *
+ * `fast` picks `smoothUpdate()` over a `CLEAR_EXTRA_WHITE` full update. A failed decode may
+ * have left a partial image in the framebuffer, so nothing is refreshed, the whole screen stays
+ * dirty and the shadow is dropped.
+ */
+void finish_xtx_draw(bool ok, bool fast)
+{
+    if (ok) {
+        if (fast) {
+            FastEpdRefreshWorker::Job job = {};
+            job.smooth = true;
+            (void)g_refresh.submit(&g_epd, job);
+        } else {
+            submit_refresh(CLEAR_EXTRA_WHITE, nullptr, 0);
+        }
+        g_dirty.clear();
+        shadow_capture_all();
+    } else {
+        g_dirty.markAll(g_epd.width(), g_epd.height());
+        g_shadow.invalidate();
+    }
+}
+
 } // namespace
 
 /** @brief Run a full-panel slow refresh through the shared FastEPD instance. */
@@ -212,11 +444,9 @@ int32_t display_fastepd_full_update_slow()
     if (ready_rc != kWasmOk) {
         return ready_rc;
     }
-    const int epd_rc = g_epd.fullUpdate(CLEAR_SLOW, true);
-    if (epd_rc != BBEP_SUCCESS) {
-        wasm_api_set_last_error(kWasmErrInternal, "full_update_slow: FastEPD fullUpdate failed");
-        return kWasmErrInternal;
-    }
+    submit_refresh(CLEAR_SLOW, nullptr, 0);
+    g_dirty.clear();
+    shadow_capture_all();
     return kWasmOk;
 }
 
@@ -224,19 +454,109 @@ int32_t display_fastepd_full_update_slow()
 void display_fastepd_reset_runtime_for_app()
 {
     fastepd_vlw_reset_all();
+    g_dither_mode = DisplayDitherMode::none;
+    g_draw = &g_epd;
+    g_canvases.clear();
+    g_legacy_text = FastEpdLegacyTextState{};
+    g_xtc_book.reset();
 }
 
 namespace {
 
+struct JpegResampleState;
+
 struct JpegDrawContext {
     FASTEPD *epd;
+    JpegResampleState *resample; ///< Set when decoder output is area-averaged down to the fit box.
+    int32_t origin_x; ///< Added to decoder block positions (images are decoded at 0,0).
+    int32_t origin_y;
     int32_t clip_x0;
     int32_t clip_y0;
     int32_t clip_x1;
     int32_t clip_y1;
     int32_t mode;
+    fastepd_native_utils::NativeLayout layout; ///< Valid when `native_lut` is set.
+    const uint8_t *native_lut; ///< `gray4_native_lut(mode)` for native blits, null to draw pixel by pixel.
+    int32_t crop_row; ///< First decoded row of the crop area set on the decoder, 0 without one.
+    int32_t row_offset; ///< Added to decoder block rows; see `epd_jpeg_draw()`.
+    bool row_offset_known;
+};
+
+/**
+ * @brief State of a resampled JPEG fit: one full-width strip of decoder output plus one output row.
+ *
+ * JPEGDEC hands out MCU rows, possibly split into several blocks when the image is wide, so
+ * blocks are gathered into `strip` and its rows are pushed through the resampler once the row
+ * is complete. Finished output rows are quantized (ordered dither if one is selected, error
+ * diffusion otherwise) and blitted at the fit origin.
+ */
+struct JpegResampleState {
+    FastEpdAreaResampler resampler;
+    FastEpdErrorDiffusion diffusion;
+    const FastEpdDither *ordered = nullptr;
+    fastepd_native_utils::NativeLayout layout = {};
+    bool native = false;
+    int32_t src_w = 0;
+    int32_t src_h = 0;
+    int32_t dst_w = 0;
+    int32_t strip_rows = 0;
+    uint8_t *strip = nullptr;
+    uint8_t *out_row = nullptr;
+
+    ~JpegResampleState()
+    {
+        free(strip);
+        free(out_row);
+    }
 };
 
+/** @brief Quantize and write output row `row` of a resampled JPEG. */
+void jpeg_resample_emit(const JpegDrawContext &ctx, JpegResampleState &rs, int32_t row)
+{
+    const int32_t y = ctx.origin_y + row;
+    if (!rs.native) {
+        for (int32_t i = 0; i < rs.dst_w; ++i) {
+            ctx.epd->drawPixel(ctx.origin_x + i, y, gray8_to_epd_color(rs.out_row[i], ctx.mode));
+        }
+        return;
+    }
+    if (rs.ordered) {
+        rs.ordered->orderedSpan(rs.out_row, rs.out_row, rs.dst_w, ctx.origin_x, y);
+    } else {
+        rs.diffusion.row(rs.out_row, rs.out_row);
+    }
+    (void)fastepd_native_utils::blitGray8(rs.layout, ctx.origin_x, y, rs.dst_w, 1, rs.out_row, rs.dst_w, FastEpdDither::levelLut());
+}
+
+/** @brief `epd_jpeg_draw()` body for resampled fits (8-bit grayscale decoder output). */
+int jpeg_resample_block(const JpegDrawContext &ctx, const JPEGDRAW *pDraw)
+{
+    JpegResampleState &rs = *ctx.resample;
+    const int32_t block_y = pDraw->y + ctx.row_offset;
+    if (pDraw->x < 0 || pDraw->x >= rs.src_w || block_y < 0) {
+        return 1;
+    }
+    int32_t used = pDraw->iWidthUsed > 0 ? pDraw->iWidthUsed : pDraw->iWidth;
+    if (used > rs.src_w - pDraw->x) {
+        used = rs.src_w - pDraw->x;
+    }
+    const int32_t rows = pDraw->iHeight < rs.strip_rows ? pDraw->iHeight : rs.strip_rows;
+    const uint8_t *src = (const uint8_t *)pDraw->pPixels;
+    for (int32_t r = 0; r < rows; ++r) {
+        memcpy(rs.strip + (size_t)r * (size_t)rs.src_w + pDraw->x, src + (size_t)r * (size_t)pDraw->iWidth, (size_t)used);
+    }
+    if (pDraw->x + used < rs.src_w) {
+        return 1;
+    }
+    for (int32_t r = 0; r < rows && block_y + r < rs.src_h; ++r) {
+        const int32_t row = rs.resampler.pushRow(block_y + r, rs.strip + (size_t)r * (size_t)rs.src_w, rs.out_row);
+        if (row >= 0) {
+            jpeg_resample_emit(ctx, rs, row);
+        }
+    }
+    return 1;
+}
+
 int epd_jpeg_draw(JPEGDRAW *pDraw)
 {
     if (!pDraw || !pDraw->pPixels) {
@@ -247,6 +567,15 @@ int epd_jpeg_draw(JPEGDRAW *pDraw)
     if (!ctx || !ctx->epd) {
         return 0;
     }
+    if (!ctx->row_offset_known) {
+        // Depending on the JPEGDEC version, blocks of a cropped decode are reported at image
+        // rows or relative to the crop area; the first block tells which.
+        ctx->row_offset = pDraw->y < ctx->crop_row ? ctx->crop_row - pDraw->y : 0;
+        ctx->row_offset_known = true;
+    }
+    if (ctx->resample) {
+        return jpeg_resample_block(*ctx, pDraw);
+    }
 
     const int epd_w = ctx->epd->width();
     const int epd_h = ctx->epd->height();
@@ -268,8 +597,8 @@ int epd_jpeg_draw(JPEGDRAW *pDraw)
         return 1;
     }
 
-    const int32_t dst_x0 = pDraw->x;
-    const int32_t dst_y0 = pDraw->y;
+    const int32_t dst_x0 = ctx->origin_x + pDraw->x;
+    const int32_t dst_y0 = ctx->origin_y + pDraw->y + ctx->row_offset;
 
     const int32_t dst_x1 = dst_x0 + src_block_w;
     const int32_t dst_y1 = dst_y0 + src_block_h;
@@ -287,6 +616,34 @@ int epd_jpeg_draw(JPEGDRAW *pDraw)
     const int32_t copy_w = draw_x1 - draw_x0;
     const int32_t copy_h = draw_y1 - draw_y0;
 
+    if (ctx->native_lut) {
+        const uint8_t *src = (const uint8_t *)pDraw->pPixels;
+        if (pDraw->iBpp != 4) {
+            (void)fastepd_native_utils::blitGray8(ctx->layout, draw_x0, draw_y0, copy_w, copy_h,
+                                                  src + (size_t)src_y0 * (size_t)pDraw->iWidth + src_x0, pDraw->iWidth,
+                                                  ctx->native_lut);
+            return 1;
+        }
+        // Unpack a tile at a time so rotated layouts still get whole native bytes per blit.
+        constexpr int32_t kTileW = fastepd_native_utils::kBlitChunkPixels;
+        constexpr int32_t kTileH = fastepd_native_utils::kBlitBandRows;
+        alignas(16) uint8_t tile[kTileW * kTileH];
+        const int src_pitch = (pDraw->iWidth + 1) / 2;
+        for (int32_t ty = 0; ty < copy_h; ty += kTileH) {
+            const int32_t th = copy_h - ty < kTileH ? copy_h - ty : kTileH;
+            for (int32_t tx = 0; tx < copy_w; tx += kTileW) {
+                const int32_t tw = copy_w - tx < kTileW ? copy_w - tx : kTileW;
+                for (int32_t r = 0; r < th; ++r) {
+                    fastepd_pixel_kernels::unpackGray4(src + (size_t)(src_y0 + ty + r) * (size_t)src_pitch,
+                                                       (size_t)(src_x0 + tx), (size_t)tw, tile + r * kTileW);
+                }
+                (void)fastepd_native_utils::blitGray8(ctx->layout, draw_x0 + tx, draw_y0 + ty, tw, th, tile, kTileW,
+                                                      ctx->native_lut);
+            }
+        }
+        return 1;
+    }
+
     if (pDraw->iBpp == 4) {
         const uint8_t *src = (const uint8_t *)pDraw->pPixels;
         const int src_pitch = (pDraw->iWidth + 1) / 2;
@@ -317,15 +674,439 @@ int epd_jpeg_draw(JPEGDRAW *pDraw)
     return 1;
 }
 
-	int32_t draw_jpg_internal(
-	    const uint8_t *ptr,
-	    size_t len,
-	    int32_t x,
-	    int32_t y,
-	    int32_t max_w,
-	    int32_t max_h,
-	    bool do_fit)
-	{
+// JPEGDEC file callbacks over `FastEpdFileStream`; the stream is the JPEGFILE handle.
+
+void *epd_jpeg_file_open(const char *path, int32_t *size)
+{
+    FastEpdFileStream *stream = new (std::nothrow) FastEpdFileStream();
+    if (!stream) {
+        return nullptr;
+    }
+    if (!stream->open(path)) {
+        delete stream;
+        return nullptr;
+    }
+    *size = stream->size();
+    return stream;
+}
+
+void epd_jpeg_file_close(void *handle)
+{
+    delete static_cast<FastEpdFileStream *>(handle);
+}
+
+int32_t epd_jpeg_file_read(JPEGFILE *file, uint8_t *buf, int32_t len)
+{
+    auto *stream = static_cast<FastEpdFileStream *>(file->fHandle);
+    const int32_t n = stream->read(buf, len);
+    file->iPos += n;
+    return n;
+}
+
+int32_t epd_jpeg_file_seek(JPEGFILE *file, int32_t pos)
+{
+    auto *stream = static_cast<FastEpdFileStream *>(file->fHandle);
+    if (!stream->seek(pos)) {
+        return -1;
+    }
+    file->iPos = pos;
+    return pos;
+}
+
+/**
+ * @brief Open `path` for streamed decoding; the file is read on a prefetch task as MCUs are decoded.
+ * @return Null if the decoder cannot be allocated or the file is not a readable JPEG.
+ */
+std::unique_ptr<JPEGDEC> open_jpeg_file(const char *path)
+{
+    std::unique_ptr<JPEGDEC> jpeg(new (std::nothrow) JPEGDEC());
+    if (!jpeg) {
+        return nullptr;
+    }
+    if (!jpeg->open(path, epd_jpeg_file_open, epd_jpeg_file_close, epd_jpeg_file_read, epd_jpeg_file_seek, epd_jpeg_draw)) {
+        // Also releases the stream when the header was rejected after the file opened.
+        jpeg->close();
+        return nullptr;
+    }
+    return jpeg;
+}
+
+/** @brief How a JPEG is decoded for a fit box: DCT reduction, decoder output size and final size. */
+struct JpegFitPlan {
+    int options = 0; ///< `JPEG_SCALE_*` flag, or 0.
+    int scale_shift = 0; ///< log2 of the DCT reduction.
+    int32_t decoded_w = 0;
+    int32_t decoded_h = 0;
+    int32_t out_w = 0; ///< Equal to `decoded_w` unless the output is resampled.
+    int32_t out_h = 0;
+
+    bool resampled() const { return out_w != decoded_w || out_h != decoded_h; }
+};
+
+/**
+ * @brief Plan a decode of an `img_w` x `img_h` JPEG.
+ *
+ * Without `do_fit`, or when the image already fits, it is decoded 1:1. Otherwise the output is
+ * the aspect-preserving size that touches the box on one side, and the decoder uses the
+ * largest DCT reduction (1/2, 1/4, 1/8) that still leaves at least that many pixels, so the
+ * area-averaging resampler only ever shrinks by less than 2x per axis on top of it.
+ */
+JpegFitPlan plan_jpeg_fit(int img_w, int img_h, int32_t max_w, int32_t max_h, bool do_fit)
+{
+    JpegFitPlan plan;
+    plan.decoded_w = plan.out_w = img_w;
+    plan.decoded_h = plan.out_h = img_h;
+    if (!do_fit || img_w <= 0 || img_h <= 0 || (img_w <= max_w && img_h <= max_h)) {
+        return plan;
+    }
+    if ((int64_t)img_w * max_h <= (int64_t)img_h * max_w) {
+        plan.out_h = max_h;
+        plan.out_w = (int32_t)(((int64_t)img_w * max_h + img_h / 2) / img_h);
+    } else {
+        plan.out_w = max_w;
+        plan.out_h = (int32_t)(((int64_t)img_h * max_w + img_w / 2) / img_w);
+    }
+    plan.out_w = plan.out_w < 1 ? 1 : (plan.out_w > max_w ? max_w : plan.out_w);
+    plan.out_h = plan.out_h < 1 ? 1 : (plan.out_h > max_h ? max_h : plan.out_h);
+
+    static constexpr int kScaleOptions[] = {0, JPEG_SCALE_HALF, JPEG_SCALE_QUARTER, JPEG_SCALE_EIGHTH};
+    for (int shift = 3; shift > 0; --shift) {
+        const int32_t w = (img_w + (1 << shift) - 1) >> shift;
+        const int32_t h = (img_h + (1 << shift) - 1) >> shift;
+        if (w >= plan.out_w && h >= plan.out_h) {
+            plan.options = kScaleOptions[shift];
+            plan.scale_shift = shift;
+            plan.decoded_w = w;
+            plan.decoded_h = h;
+            break;
+        }
+    }
+    return plan;
+}
+
+/** @brief Where a JPEG comes from, so a second decoder can be opened on it for a banded decode. */
+struct JpegSource {
+    const uint8_t *data = nullptr; ///< In-memory image, or null for `path`.
+    size_t len = 0;
+    const char *path = nullptr;
+};
+
+std::unique_ptr<JPEGDEC> open_jpeg_source(const JpegSource &source)
+{
+    if (!source.data) {
+        return open_jpeg_file(source.path);
+    }
+    std::unique_ptr<JPEGDEC> jpeg(new (std::nothrow) JPEGDEC());
+    if (!jpeg || !jpeg->openRAM((uint8_t *)source.data, (int)source.len, epd_jpeg_draw)) {
+        return nullptr;
+    }
+    return jpeg;
+}
+
+/** Decoded pixels below which a banded decode is not worth two extra tasks. */
+constexpr int64_t kJpegBandMinPixels = 128 * 1024;
+/** Stack of each band worker; JPEGDEC keeps its MCU buffers in the decoder object. */
+constexpr uint32_t kJpegBandTaskStack = 1024 * 8;
+
+/** @brief One decode pass over output rows `[row0, row1)` of a planned JPEG. */
+struct JpegBand {
+    JPEGDEC *jpeg = nullptr;
+    JpegDrawContext ctx = {};
+    std::unique_ptr<JpegResampleState> rs;
+    uint8_t *dither_buf = nullptr;
+    int options = 0;
+    int32_t crop_y = 0; ///< Crop area in source image rows; `crop_h == 0` decodes everything.
+    int32_t crop_h = 0;
+    bool ok = false;
+
+    ~JpegBand() { free(dither_buf); }
+
+    /** @brief Drop any buffers and start over as a whole-image decode with `jpeg` and `context`. */
+    void reset(JPEGDEC *decoder, const JpegDrawContext &context)
+    {
+        rs.reset();
+        free(dither_buf);
+        dither_buf = nullptr;
+        jpeg = decoder;
+        ctx = context;
+        crop_y = 0;
+        crop_h = 0;
+        ok = false;
+    }
+};
+
+/** @brief MCU size of `jpeg` in source pixels. */
+void jpeg_mcu_size(JPEGDEC &jpeg, int *mcu_w, int *mcu_h)
+{
+    const int subsample = jpeg.getSubSample();
+    *mcu_w = (subsample == 0x21 || subsample == 0x22) ? 16 : 8;
+    *mcu_h = (subsample == 0x12 || subsample == 0x22) ? 16 : 8;
+}
+
+/**
+ * @brief Allocate what `band` needs to decode output rows `[row0, row1)` of `plan`.
+ *
+ * A band covering every row falls back like a plain decode: a resampled fit whose buffers
+ * cannot be allocated is decoded at the DCT-scaled size and clipped, and the decoder's own
+ * dithering is skipped without its buffer. A partial band has no fallback, since both halves
+ * must agree on how the image is drawn.
+ */
+bool prepare_jpeg_band(JpegBand &band, const JpegFitPlan &plan, int32_t row0, int32_t row1)
+{
+    const bool whole = row0 == 0 && row1 >= plan.out_h;
+    int base_mcu_w = 8;
+    int base_mcu_h = 8;
+    jpeg_mcu_size(*band.jpeg, &base_mcu_w, &base_mcu_h);
+    const int mcu_w = base_mcu_w >> plan.scale_shift;
+    const int mcu_h = base_mcu_h >> plan.scale_shift;
+    const int img_w = band.jpeg->getWidth();
+    const int cx = (img_w + base_mcu_w - 1) / base_mcu_w;
+    const size_t dither_buf_len = (size_t)cx * (size_t)mcu_w * (size_t)mcu_h;
+    FASTEPD &target = *band.ctx.epd;
+
+    band.options = plan.options;
+    if (!whole) {
+        const int32_t band_y0 = band.ctx.origin_y + row0;
+        const int32_t band_y1 = band.ctx.origin_y + row1;
+        band.ctx.clip_y0 = band.ctx.clip_y0 > band_y0 ? band.ctx.clip_y0 : band_y0;
+        band.ctx.clip_y1 = band.ctx.clip_y1 < band_y1 ? band.ctx.clip_y1 : band_y1;
+    }
+
+    if (plan.resampled()) {
+        band.rs.reset(new (std::nothrow) JpegResampleState());
+    }
+    if (band.rs) {
+        JpegResampleState &rs = *band.rs;
+        rs.src_w = plan.decoded_w;
+        rs.src_h = plan.decoded_h;
+        rs.dst_w = plan.out_w;
+        rs.strip_rows = mcu_h;
+        rs.strip = (uint8_t *)malloc((size_t)plan.decoded_w * (size_t)mcu_h);
+        rs.out_row = (uint8_t *)malloc((size_t)plan.out_w);
+        rs.native = fastepd_native_utils::describeNativeLayout(target, &rs.layout);
+        bool ready = rs.strip && rs.out_row && rs.resampler.begin(plan.decoded_w, plan.decoded_h, plan.out_w, plan.out_h);
+        if (ready && rs.native) {
+            if (g_dither_mode == DisplayDitherMode::bayer || g_dither_mode == DisplayDitherMode::blueNoise) {
+                rs.ordered = &g_dither;
+            } else {
+                ready = rs.diffusion.begin(plan.out_w, 1 << rs.layout.bpp);
+            }
+        }
+        if (!ready) {
+            band.rs.reset();
+        } else {
+            rs.resampler.setRowWindow(row0, row1);
+            band.ctx.resample = band.rs.get();
+        }
+    }
+    if (plan.resampled() && !band.rs && !whole) {
+        return false;
+    }
+    if (!band.rs && dither_buf_len > 0) {
+        band.dither_buf = (uint8_t *)malloc(dither_buf_len);
+        if (!band.dither_buf && !whole) {
+            return false;
+        }
+    }
+
+    if (!whole) {
+        // Decoded rows feeding the band, widened to whole MCU rows.
+        int32_t first = row0;
+        int32_t end = row1;
+        if (band.rs) {
+            first = (int32_t)(((int64_t)row0 * plan.decoded_h) / plan.out_h);
+            end = (int32_t)(((int64_t)row1 * plan.decoded_h + plan.out_h - 1) / plan.out_h);
+        }
+        first -= first % mcu_h;
+        end = end + mcu_h - 1 - (end + mcu_h - 1) % mcu_h;
+        end = end < plan.decoded_h ? end : plan.decoded_h;
+        band.crop_y = first << plan.scale_shift;
+        band.crop_h = (end - first) << plan.scale_shift;
+        band.ctx.crop_row = first;
+    }
+    return true;
+}
+
+/** @brief `FastEpdCoreJob` decoding one `JpegBand`; touches nothing outside its band. */
+void run_jpeg_band(void *arg)
+{
+    JpegBand &band = *static_cast<JpegBand *>(arg);
+    JPEGDEC &jpeg = *band.jpeg;
+    if (band.crop_h > 0) {
+        jpeg.setCropArea(0, band.crop_y, jpeg.getWidth(), band.crop_h);
+    }
+    jpeg.setUserPointer(&band.ctx);
+    if (band.rs) {
+        jpeg.setPixelType(EIGHT_BIT_GRAYSCALE);
+        band.ok = jpeg.decode(0, 0, band.options) != 0;
+    } else if (band.dither_buf) {
+        jpeg.setPixelType(FOUR_BIT_DITHERED);
+        band.ok = jpeg.decodeDither(band.dither_buf, band.options) != 0;
+    } else {
+        jpeg.setPixelType(EIGHT_BIT_GRAYSCALE);
+        band.ok = jpeg.decode(0, 0, band.options) != 0;
+    }
+}
+
+/** @brief Whether logical rows `y - 1` and `y` of `layout` share no packed byte. */
+bool rows_split_cleanly(const fastepd_native_utils::NativeLayout &layout, int32_t y)
+{
+    int32_t ax = 0;
+    int32_t ay = 0;
+    int32_t bx = 0;
+    int32_t by = 0;
+    fastepd_native_utils::logicalToNative(layout, 0, y - 1, &ax, &ay);
+    fastepd_native_utils::logicalToNative(layout, 0, y, &bx, &by);
+    return ay != by || ((ax * layout.bpp) >> 3) != ((bx * layout.bpp) >> 3);
+}
+
+/**
+ * @brief Output row splitting a JPEG drawn at row `y` into two bands of about equal height.
+ *
+ * Only resampled fits under an ordered dither are split: error diffusion (ours, or the
+ * decoder's own for 1:1 decodes) would restart with zero error at the split row and leave a
+ * seam, so those stay on one core to match its output exactly. Each band resamples its own
+ * rows, and the split sits on a boundary where the two bands write disjoint framebuffer bytes,
+ * which on the portrait panel means a multiple of the pixels packed per byte.
+ * @return The split, or 0 if the image is too small, not position-independent, or no such row exists.
+ */
+int32_t jpeg_band_split(
+    const fastepd_native_utils::NativeLayout &layout,
+    const JpegFitPlan &plan,
+    int mcu_h,
+    int32_t y,
+    int32_t visible_h)
+{
+    const bool ordered = g_dither_mode == DisplayDitherMode::bayer || g_dither_mode == DisplayDitherMode::blueNoise;
+    if (!plan.resampled() || !ordered) {
+        return 0;
+    }
+    if ((int64_t)plan.decoded_w * plan.decoded_h < kJpegBandMinPixels || visible_h < 4 * mcu_h) {
+        return 0;
+    }
+    const int32_t mid = visible_h / 2;
+    for (int32_t d = 0; d <= visible_h / 4; ++d) {
+        const int32_t candidates[2] = {mid + d, mid - d};
+        for (int32_t split : candidates) {
+            if (split > 0 && split < visible_h && rows_split_cleanly(layout, y + split)) {
+                return split;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Decode an opened JPEG into the draw target at `(x, y)`, clipped to the fit box or target.
+ *
+ * Shared by the in-memory and streamed paths; the caller owns `jpeg` and closes it. Large
+ * resampled images under an ordered dither are decoded as two horizontal bands, one per core:
+ * a second decoder is opened on `source` and each decoder is cropped to the MCU rows its band
+ * needs, so the lower band only entropy-decodes the rows above it. Each band writes its own
+ * rows through its own clip, and the output matches a one-core decode. If the second decoder
+ * or band buffers cannot be had, one decoder does it all.
+ */
+int32_t draw_jpg_decoder(
+    JPEGDEC &jpeg,
+    const JpegSource &source,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h,
+    bool do_fit)
+{
+    const int32_t mode = g_draw->getMode();
+    if (mode != BB_MODE_1BPP && mode != BB_MODE_2BPP && mode != BB_MODE_4BPP) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_jpg: unsupported mode (expected 1-bpp, 2-bpp, or 4-bpp)");
+        return kWasmErrInvalidArgument;
+    }
+
+    JpegDrawContext ctx = {};
+    ctx.epd = g_draw;
+    ctx.mode = mode;
+    ctx.origin_x = x;
+    ctx.origin_y = y;
+    if (do_fit) {
+        ctx.clip_x0 = x;
+        ctx.clip_y0 = y;
+        ctx.clip_x1 = x + max_w;
+        ctx.clip_y1 = y + max_h;
+    } else {
+        ctx.clip_x0 = 0;
+        ctx.clip_y0 = 0;
+        ctx.clip_x1 = g_draw->width();
+        ctx.clip_y1 = g_draw->height();
+    }
+
+    const JpegFitPlan plan = plan_jpeg_fit(jpeg.getWidth(), jpeg.getHeight(), max_w, max_h, do_fit);
+    const int32_t out_w = plan.out_w;
+    const int32_t out_h = plan.out_h;
+    const int32_t visible_h = out_h < ctx.clip_y1 - y ? out_h : ctx.clip_y1 - y;
+
+    fastepd_native_utils::NativeLayout layout;
+    const bool native = fastepd_native_utils::describeNativeLayout(*g_draw, &layout);
+    if (native) {
+        ctx.layout = layout;
+        ctx.native_lut = gray4_native_lut(mode);
+    }
+    if (native && (g_dither_mode == DisplayDitherMode::bayer || g_dither_mode == DisplayDitherMode::blueNoise)) {
+        g_dither.configure(g_dither_mode, layout.bpp);
+    }
+
+    JpegBand bands[2];
+    bands[0].reset(&jpeg, ctx);
+    std::unique_ptr<JPEGDEC> second;
+    int32_t split = 0;
+    if (native && visible_h > 0) {
+        int base_mcu_w = 8;
+        int base_mcu_h = 8;
+        jpeg_mcu_size(jpeg, &base_mcu_w, &base_mcu_h);
+        split = jpeg_band_split(layout, plan, base_mcu_h >> plan.scale_shift, y, visible_h);
+    }
+    if (split > 0) {
+        second = open_jpeg_source(source);
+        bands[1].reset(second.get(), ctx);
+        if (!second || !prepare_jpeg_band(bands[0], plan, 0, split) || !prepare_jpeg_band(bands[1], plan, split, visible_h)) {
+            ESP_LOGW(kTag, "draw_jpg: banded decode unavailable; using one core");
+            split = 0;
+            bands[0].reset(&jpeg, ctx);
+        }
+    }
+
+    bool ok = false;
+    if (split > 0) {
+        void *const args[2] = {&bands[0], &bands[1]};
+        fastepd_run_on_both_cores(run_jpeg_band, args, kJpegBandTaskStack);
+        ok = bands[0].ok && bands[1].ok;
+    } else {
+        (void)prepare_jpeg_band(bands[0], plan, 0, out_h);
+        run_jpeg_band(&bands[0]);
+        ok = bands[0].ok;
+    }
+    if (second) {
+        second->close();
+    }
+
+    // Partial decodes still touched the framebuffer, so record the area either way.
+    const int32_t dirty_w = out_w < ctx.clip_x1 - x ? out_w : ctx.clip_x1 - x;
+    mark_dirty(x, y, dirty_w, visible_h);
+
+    if (!ok) {
+        wasm_api_set_last_error(kWasmErrInternal, "draw_jpg: decode failed");
+        return kWasmErrInternal;
+    }
+    return kWasmOk;
+}
+
+int32_t draw_jpg_internal(
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h,
+    bool do_fit)
+{
     if (x < 0 || y < 0) {
         wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_jpg: negative coordinates");
         return kWasmErrInvalidArgument;
@@ -353,138 +1134,21 @@ int epd_jpeg_draw(JPEGDRAW *pDraw)
         return ready_rc;
     }
 
-    const int32_t mode = g_epd.getMode();
-    if (mode != BB_MODE_1BPP && mode != BB_MODE_2BPP && mode != BB_MODE_4BPP) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_jpg: unsupported mode (expected 1-bpp, 2-bpp, or 4-bpp)");
-        return kWasmErrInvalidArgument;
-    }
-
-    JpegDrawContext ctx = {};
-    ctx.epd = &g_epd;
-    ctx.mode = mode;
-
-	    if (do_fit) {
-	        ctx.clip_x0 = x;
-	        ctx.clip_y0 = y;
-	        ctx.clip_x1 = x + max_w;
-	        ctx.clip_y1 = y + max_h;
-	    } else {
-	        ctx.clip_x0 = 0;
-	        ctx.clip_y0 = 0;
-	        ctx.clip_x1 = g_epd.width();
-	        ctx.clip_y1 = g_epd.height();
-	    }
-
-	    JPEGIMAGE *jpeg = (JPEGIMAGE *)calloc(1, sizeof(JPEGIMAGE));
-	    if (!jpeg) {
-	        wasm_api_set_last_error(kWasmErrInternal, "draw_jpg: out of memory");
-	        return kWasmErrInternal;
-	    }
-
-	    const int opened = JPEG_openRAM(jpeg, (uint8_t *)ptr, (int)len, epd_jpeg_draw);
-	    if (!opened) {
-	        wasm_api_set_last_error(kWasmErrInternal, "draw_jpg: JPEG openRAM failed");
-	        free(jpeg);
-	        return kWasmErrInternal;
-	    }
-	    jpeg->pUser = &ctx;
-
-	    int options = 0;
-	    if (do_fit) {
-	        const int img_w = JPEG_getWidth(jpeg);
-	        const int img_h = JPEG_getHeight(jpeg);
-	        int scale = 1;
-	        if (img_w > 0 && img_h > 0) {
-	            const int w2 = (img_w + 1) / 2;
-	            const int h2 = (img_h + 1) / 2;
-	            const int w4 = (img_w + 3) / 4;
-            const int h4 = (img_h + 3) / 4
-;
-            if (img_w <= max_w && img_h <= max_h) {
-                scale = 1;
-            } else if (w2 <= max_w && h2 <= max_h) {
-                scale = 2;
-            } else if (w4 <= max_w && h4 <= max_h) {
-                scale = 4;
-            } else {
-                scale = 8;
-            }
-        }
-        if (scale == 2) {
-            options |= JPEG_SCALE_HALF;
-        } else if (scale == 4) {
-            options |= JPEG_SCALE_QUARTER;
-        } else if (scale == 8) {
-            options |= JPEG_SCALE_EIGHTH;
-	        }
-	    }
-
-	    const int subsample = JPEG_getSubSample(jpeg);
-	    int base_mcu_w = 8;
-	    int base_mcu_h = 8;
-	    switch (subsample) {
-	        case 0x12:
-            base_mcu_w = 8;
-            base_mcu_h = 16;
-            break;
-        case 0x21:
-            base_mcu_w = 16;
-            base_mcu_h = 8;
-            break;
-        case 0x22:
-            base_mcu_w = 16;
-            base_mcu_h = 16;
-            break;
-        default:
-            base_mcu_w = 8;
-            base_mcu_h = 8;
-            break;
+    std::unique_ptr<JPEGDEC> jpeg(new (std::nothrow) JPEGDEC());
+    if (!jpeg) {
+        wasm_api_set_last_error(kWasmErrInternal, "draw_jpg: out of memory");
+        return kWasmErrInternal;
     }
-
-    int scale_shift = 0;
-    if (options & JPEG_SCALE_HALF) {
-        scale_shift = 1;
-    } else if (options & JPEG_SCALE_QUARTER) {
-        scale_shift = 2;
-    } else if (options & JPEG_SCALE_EIGHTH) {
-        scale_shift = 3;
-	    }
-	    const int mcu_w = base_mcu_w >> scale_shift;
-	    const int mcu_h = base_mcu_h >> scale_shift;
-
-	    const int img_w = JPEG_getWidth(jpeg);
-	    const int cx = base_mcu_w == 16 ? ((img_w + 15) >> 4) : ((img_w + 7) >> 3);
-	    const size_t aligned_w = (size_t)cx * (size_t)mcu_w;
-	    const size_t dither_buf_len = aligned_w * (size_t)mcu_h;
-
-	    bool ok = false;
-	    uint8_t *dither_buf = nullptr;
-	    if (dither_buf_len > 0) {
-	        dither_buf = (uint8_t *)malloc(dither_buf_len);
-	    }
-
-	    if (dither_buf) {
-	        JPEG_setPixelType(jpeg, FOUR_BIT_DITHERED);
-	        jpeg->iXOffset = x;
-	        jpeg->iYOffset = y;
-	        ok = JPEG_decodeDither(jpeg, dither_buf, options) != 0;
-	        free(dither_buf);
-	    } else {
-	        JPEG_setPixelType(jpeg, EIGHT_BIT_GRAYSCALE);
-	        ok = JPEG_decode(jpeg, x, y, options) != 0;
-	    }
-
-	    const int last_err = JPEG_getLastError(jpeg);
-	    JPEG_close(jpeg);
-	    free(jpeg);
-
-	    if (!ok) {
-	        (void)last_err;
-	        wasm_api_set_last_error(kWasmErrInternal, "draw_jpg: decode failed");
-	        return kWasmErrInternal;
+    if (!jpeg->openRAM((uint8_t *)ptr, (int)len, epd_jpeg_draw)) {
+        wasm_api_set_last_error(kWasmErrInternal, "draw_jpg: JPEG openRAM failed");
+        return kWasmErrInternal;
     }
-
-    return kWasmOk;
+    JpegSource source;
+    source.data = ptr;
+    source.len = len;
+    const int32_t rc = draw_jpg_decoder(*jpeg, source, x, y, max_w, max_h, do_fit);
+    jpeg->close();
+    return rc;
 }
 
 struct PngMemStream {
@@ -493,16 +1157,37 @@ struct PngMemStream {
     size_t pos;
 };
 
+/** Image rows quantized before they are written together (one `blitGray8()` band). */
+constexpr int32_t kPngStripRows = fastepd_native_utils::kBlitBandRows;
+
+/**
+ * @brief Row-at-a-time PNG writer: gray conversion, serpentine diffusion, packed strip blits.
+ *
+ * Grayscale and palette images come from `FastEpdPngDecoder` as whole gray8 rows and are
+ * diffused as they arrive. pngle hands out ARGB runs for the other types; a non-interlaced
+ * image arrives row by row, so the current row is gathered as gray8 and diffused once the
+ * next row starts. Adam7 passes revisit rows with gaps, so interlaced images are gathered
+ * into a gray frame of the clipped size and diffused at the end. Diffused rows collect in a
+ * strip of levels that goes through the per-bpp packer of `blitGray8()` every
+ * `kPngStripRows` rows.
+ */
 struct PngDitherState {
     FASTEPD *epd;
+    fastepd_native_utils::NativeLayout layout;
+    bool native;
     int32_t dst_x;
     int32_t dst_y;
     int32_t max_w;
     int32_t max_h;
-    int32_t current_y;
     int32_t mode;
-    int32_t *err_cur;
-    int32_t *err_next;
+    int32_t step; ///< Gray distance between levels, for targets without a native layout.
+    bool interlaced;
+    int32_t row_y; ///< Image row held in `gray` (non-interlaced), or -1.
+    uint8_t *gray; ///< One row, or `max_w` x `max_h` when interlaced.
+    uint8_t *strip; ///< `kPngStripRows` rows of levels.
+    int32_t strip_y0;
+    int32_t strip_rows;
+    FastEpdErrorDiffusion diffusion;
 };
 
 struct PngContext {
@@ -536,119 +1221,103 @@ uint32_t epd_png_read(void *user_data, uint8_t *buf, uint32_t len)
     return (uint32_t)n;
 }
 
-static inline int32_t dither_mul_div16(int32_t v, int32_t mul)
+/** @brief Whether the IHDR of a PNG in memory selects Adam7 interlacing. */
+bool png_is_interlaced(const uint8_t *data, size_t len)
 {
-    int32_t t = v * mul;
-    t += (t >= 0) ? 8 : -8;
-    return t >> 4;
+    // Signature (8), chunk length (4), "IHDR", width, height, depth, color, compression, filter.
+    return len > 28 && memcmp(data + 12, "IHDR", 4) == 0 && data[28] != 0;
 }
 
-void epd_png_draw(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t *argb)
+void png_flush_strip(PngDitherState &st)
 {
-    auto *ctx = (PngContext *)user_data;
-    if (!ctx) {
+    if (st.strip_rows == 0) {
         return;
     }
-
-    PngDitherState *st = &ctx->dither;
-    if (!st || !st->epd || !st->err_cur || !st->err_next || !argb) {
-        return;
+    if (st.native) {
+        (void)fastepd_native_utils::blitGray8(st.layout, st.dst_x, st.dst_y + st.strip_y0, st.max_w, st.strip_rows, st.strip,
+                                              st.max_w, FastEpdDither::levelLut());
+    } else {
+        for (int32_t r = 0; r < st.strip_rows; ++r) {
+            const uint8_t *levels = st.strip + (size_t)r * (size_t)st.max_w;
+            for (int32_t i = 0; i < st.max_w; ++i) {
+                st.epd->drawPixel(st.dst_x + i, st.dst_y + st.strip_y0 + r,
+                                  gray8_to_epd_color((uint8_t)(levels[i] * st.step), st.mode));
+            }
+        }
     }
-    if ((int32_t)y < 0 || (int32_t)y >= st->max_h) {
-        return;
+    st.strip_rows = 0;
+}
+
+/** @brief Diffuse image row `y` into the strip, writing the strip out when it is full. */
+void png_emit_row(PngDitherState &st, int32_t y, const uint8_t *gray)
+{
+    if (st.strip_rows > 0 && (st.strip_rows == kPngStripRows || y != st.strip_y0 + st.strip_rows)) {
+        png_flush_strip(st);
     }
-    if (div_x == 0) {
-        return;
+    if (st.strip_rows == 0) {
+        st.strip_y0 = y;
     }
+    st.diffusion.row(gray, st.strip + (size_t)st.strip_rows * (size_t)st.max_w);
+    ++st.strip_rows;
+}
 
-    if (st->current_y < 0) {
-        st->current_y = (int32_t)y;
-    }
-    if ((int32_t)y != st->current_y) {
-        if ((int32_t)y < st->current_y) {
-            memset(st->err_cur, 0, (size_t)(st->max_w + 3) * sizeof(int32_t));
-            memset(st->err_next, 0, (size_t)(st->max_w + 3) * sizeof(int32_t));
-            st->current_y = (int32_t)y;
-        } else {
-            while (st->current_y < (int32_t)y) {
-                int32_t *tmp = st->err_cur;
-                st->err_cur = st->err_next;
-                st->err_next = tmp;
-                memset(st->err_next, 0, (size_t)(st->max_w + 3) * sizeof(int32_t));
-                st->current_y++;
-            }
+/** @brief Diffuse and write whatever the decoder left pending. */
+void png_finish(PngDitherState &st)
+{
+    if (st.interlaced) {
+        for (int32_t y = 0; y < st.max_h; ++y) {
+            png_emit_row(st, y, st.gray + (size_t)y * (size_t)st.max_w);
         }
+    } else if (st.row_y >= 0) {
+        png_emit_row(st, st.row_y, st.gray);
     }
+    png_flush_strip(st);
+}
 
-    const int32_t epd_w = st->epd->width();
-    const int32_t epd_h = st->epd->height();
-    if (epd_w <= 0 || epd_h <= 0) {
+void epd_png_draw(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t *argb)
+{
+    auto *ctx = (PngContext *)user_data;
+    if (!ctx || !argb || div_x == 0) {
         return;
     }
 
-    uint32_t xi = x;
-    for (size_t i = 0; i < len; ++i) {
-        if ((int32_t)xi >= 0 && (int32_t)xi < st->max_w) {
-            uint8_t a = argb[0];
-            uint8_t r = argb[1];
-            uint8_t g = argb[2];
-            uint8_t b = argb[3];
-
-            if (a != 255) {
-                const uint16_t inv = (uint16_t)(255u - (uint16_t)a);
-                r = (uint8_t)(((uint16_t)r * a + inv * 255u + 127u) / 255u);
-                g = (uint8_t)(((uint16_t)g * a + inv * 255u + 127u) / 255u);
-                b = (uint8_t)(((uint16_t)b * a + inv * 255u + 127u) / 255u);
-            }
+    PngDitherState *st = &ctx->dither;
+    if (!st->gray || (int32_t)y < 0 || (int32_t)y >= st->max_h) {
+        return;
+    }
 
-            const int32_t gray = (int32_t)((r * 77u + g * 150u + b * 29u + 128u) >> 8);
-            const int idx = (int)xi + 1;
-
-            int32_t v = gray + st->err_cur[idx];
-            if (v < 0) v = 0;
-            if (v > 255) v = 255;
-
-            const int32_t dx = st->dst_x + (int32_t)xi;
-            const int32_t dy = st->dst_y + (int32_t)y;
-            if (dx >= 0 && dy >= 0 && dx < epd_w && dy < epd_h) {
-                if (st->mode == BB_MODE_1BPP) {
-                    const int32_t q = (v >= 128) ? 255 : 0;
-                    st->epd->drawPixelFast(dx, dy, (uint8_t)(q ? BBEP_WHITE : BBEP_BLACK));
-                    const int32_t err = v - q;
-                    st->err_cur[idx + 1] += dither_mul_div16(err, 7);
-                    st->err_next[idx - 1] += dither_mul_div16(err, 3);
-                    st->err_next[idx] += dither_mul_div16(err, 5);
-                    st->err_next[idx + 1] += dither_mul_div16(err, 1);
-                } else if (st->mode == BB_MODE_2BPP) {
-                    int32_t q = (v * 3 + 127) / 255;
-                    if (q < 0) q = 0;
-                    if (q > 3) q = 3;
-                    st->epd->drawPixelFast(dx, dy, (uint8_t)q);
-
-                    const int32_t recon = (q * 255 + 1) / 3;
-                    const int32_t err = v - recon;
-                    st->err_cur[idx + 1] += dither_mul_div16(err, 7);
-                    st->err_next[idx - 1] += dither_mul_div16(err, 3);
-                    st->err_next[idx] += dither_mul_div16(err, 5);
-                    st->err_next[idx + 1] += dither_mul_div16(err, 1);
-                } else {
-                    int32_t q = (v + 8) >> 4;
-                    if (q < 0) q = 0;
-                    if (q > 15) q = 15;
-                    st->epd->drawPixelFast(dx, dy, (uint8_t)q);
-
-                    const int32_t recon = q * 17;
-                    const int32_t err = v - recon;
-                    st->err_cur[idx + 1] += dither_mul_div16(err, 7);
-                    st->err_next[idx - 1] += dither_mul_div16(err, 3);
-                    st->err_next[idx] += dither_mul_div16(err, 5);
-                    st->err_next[idx + 1] += dither_mul_div16(err, 1);
-                }
-            }
+    uint8_t *row = st->gray;
+    if (st->interlaced) {
+        row += (size_t)y * (size_t)st->max_w;
+    } else if ((int32_t)y != st->row_y) {
+        if (st->row_y >= 0) {
+            png_emit_row(*st, st->row_y, st->gray);
         }
+        st->row_y = (int32_t)y;
+    }
 
-        argb += 4;
-        xi += (uint32_t)div_x;
+    if (x >= (uint32_t)st->max_w) {
+        return;
+    }
+    const size_t fit = ((uint32_t)st->max_w - x + div_x - 1u) / div_x;
+    fastepd_pixel_kernels::argbRowToGray8(argb, len < fit ? len : fit, row + x, (ptrdiff_t)div_x);
+}
+
+/** @brief `FastEpdPngDecoder` row callback: gray rows go straight to the strip or the interlace frame. */
+void epd_png_gray_row(void *user, int32_t y, int32_t x0, int32_t dx, const uint8_t *gray, int32_t n)
+{
+    auto *st = (PngDitherState *)user;
+    if (y >= st->max_h) {
+        return;
+    }
+    if (!st->interlaced) {
+        // Rows arrive complete and in order; the diffusion reads only the first `max_w` pixels.
+        png_emit_row(*st, y, gray);
+        return;
+    }
+    uint8_t *row = st->gray + (size_t)y * (size_t)st->max_w;
+    for (int32_t i = 0, xi = x0; i < n && xi < st->max_w; ++i, xi += dx) {
+        row[xi] = gray[i];
     }
 }
 
@@ -688,41 +1357,50 @@ int32_t draw_png_internal(
         return ready_rc;
     }
 
-    const int32_t mode = g_epd.getMode();
+    const int32_t mode = g_draw->getMode();
     if (mode != BB_MODE_1BPP && mode != BB_MODE_2BPP && mode != BB_MODE_4BPP) {
         wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_png: unsupported mode (expected 1-bpp, 2-bpp, or 4-bpp)");
         return kWasmErrInvalidArgument;
     }
 
-    pngle_t *pngle = lgfx_pngle_new();
-    if (!pngle) {
-        wasm_api_set_last_error(kWasmErrInternal, "draw_png: pngle alloc failed");
-        return kWasmErrInternal;
-    }
-
     PngContext ctx = {};
     ctx.stream.data = ptr;
     ctx.stream.len = len;
     ctx.stream.pos = 0;
 
-    if (lgfx_pngle_prepare(pngle, epd_png_read, &ctx) < 0) {
-        lgfx_pngle_destroy(pngle);
-        wasm_api_set_last_error(kWasmErrInternal, "draw_png: pngle prepare failed");
-        return kWasmErrInternal;
+    // Grayscale and palette images skip pngle and its ARGB rows; everything else goes through it.
+    FastEpdPngDecoder gray_png;
+    const bool direct = gray_png.open(ptr, len);
+    pngle_t *pngle = nullptr;
+    if (!direct) {
+        pngle = lgfx_pngle_new();
+        if (!pngle) {
+            wasm_api_set_last_error(kWasmErrInternal, "draw_png: pngle alloc failed");
+            return kWasmErrInternal;
+        }
+        if (lgfx_pngle_prepare(pngle, epd_png_read, &ctx) < 0) {
+            lgfx_pngle_destroy(pngle);
+            wasm_api_set_last_error(kWasmErrInternal, "draw_png: pngle prepare failed");
+            return kWasmErrInternal;
+        }
     }
 
-    const int32_t img_w = (int32_t)lgfx_pngle_get_width(pngle);
-    const int32_t img_h = (int32_t)lgfx_pngle_get_height(pngle);
+    const int32_t img_w = direct ? gray_png.width() : (int32_t)lgfx_pngle_get_width(pngle);
+    const int32_t img_h = direct ? gray_png.height() : (int32_t)lgfx_pngle_get_height(pngle);
     if (img_w <= 0 || img_h <= 0) {
-        lgfx_pngle_destroy(pngle);
+        if (pngle) {
+            lgfx_pngle_destroy(pngle);
+        }
         wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_png: invalid image dims");
         return kWasmErrInvalidArgument;
     }
 
-    const int32_t epd_w = g_epd.width();
-    const int32_t epd_h = g_epd.height();
+    const int32_t epd_w = g_draw->width();
+    const int32_t epd_h = g_draw->height();
     if (epd_w <= 0 || epd_h <= 0) {
-        lgfx_pngle_destroy(pngle);
+        if (pngle) {
+            lgfx_pngle_destroy(pngle);
+        }
         wasm_api_set_last_error(kWasmErrNotReady, "draw_png: display not initialized");
         return kWasmErrNotReady;
     }
@@ -738,34 +1416,53 @@ int32_t draw_png_internal(
     if (draw_w > avail_w) draw_w = avail_w;
     if (draw_h > avail_h) draw_h = avail_h;
     if (draw_w <= 0 || draw_h <= 0) {
-        lgfx_pngle_destroy(pngle);
+        if (pngle) {
+            lgfx_pngle_destroy(pngle);
+        }
         return kWasmOk;
     }
 
-    ctx.dither.epd = &g_epd;
-    ctx.dither.dst_x = x;
-    ctx.dither.dst_y = y;
-    ctx.dither.max_w = draw_w;
-    ctx.dither.max_h = draw_h;
-    ctx.dither.current_y = -1;
-    ctx.dither.mode = mode;
-    ctx.dither.err_cur = (int32_t *)calloc((size_t)(draw_w + 3), sizeof(int32_t));
-    ctx.dither.err_next = (int32_t *)calloc((size_t)(draw_w + 3), sizeof(int32_t));
-    if (!ctx.dither.err_cur || !ctx.dither.err_next) {
-        if (ctx.dither.err_cur) free(ctx.dither.err_cur);
-        if (ctx.dither.err_next) free(ctx.dither.err_next);
-        lgfx_pngle_destroy(pngle);
+    PngDitherState &st = ctx.dither;
+    const int32_t bpp = fastepd_native_utils::bppForMode(mode);
+    st.epd = g_draw;
+    st.native = fastepd_native_utils::describeNativeLayout(*g_draw, &st.layout);
+    st.dst_x = x;
+    st.dst_y = y;
+    st.max_w = draw_w;
+    st.max_h = draw_h;
+    st.mode = mode;
+    st.step = 255 / ((1 << bpp) - 1);
+    st.interlaced = direct ? gray_png.interlaced() : png_is_interlaced(ptr, len);
+    st.row_y = -1;
+    st.gray = (uint8_t *)malloc((size_t)draw_w * (size_t)(st.interlaced ? draw_h : 1));
+    st.strip = (uint8_t *)malloc((size_t)draw_w * (size_t)kPngStripRows);
+    if (!st.gray || !st.strip || !st.diffusion.begin(draw_w, 1 << bpp)) {
+        free(st.gray);
+        free(st.strip);
+        if (pngle) {
+            lgfx_pngle_destroy(pngle);
+        }
         wasm_api_set_last_error(kWasmErrInternal, "draw_png: dither buffers alloc failed");
         return kWasmErrInternal;
     }
+    if (st.interlaced) {
+        memset(st.gray, 0xFF, (size_t)draw_w * (size_t)draw_h);
+    }
 
-    const int png_rc = lgfx_pngle_decomp(pngle, epd_png_draw);
+    bool decoded;
+    if (direct) {
+        decoded = gray_png.decode(epd_png_gray_row, &st);
+    } else {
+        decoded = lgfx_pngle_decomp(pngle, epd_png_draw) >= 0;
+        lgfx_pngle_destroy(pngle);
+    }
+    png_finish(st);
+    mark_dirty(x, y, draw_w, draw_h);
 
-    free(ctx.dither.err_cur);
-    free(ctx.dither.err_next);
-    lgfx_pngle_destroy(pngle);
+    free(st.gray);
+    free(st.strip);
 
-    if (png_rc < 0) {
+    if (!decoded) {
         wasm_api_set_last_error(kWasmErrInternal, "draw_png: decode failed");
         return kWasmErrInternal;
     }
@@ -826,6 +1523,78 @@ void warn_unimplemented(const char *name)
     ESP_LOGW(kTag, "[unimplemented] %s called", name);
 }
 
+/**
+ * @brief Fill a logical rect with packed span writes straight into the native framebuffer.
+ *
+ * Falls back to FastEPD's `fillRect()` if the framebuffer layout cannot be described.
+ */
+void fill_rect_native(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t color)
+{
+    fastepd_native_utils::NativeLayout layout;
+    if (!fastepd_native_utils::describeNativeLayout(*g_draw, &layout)) {
+        g_draw->fillRect(x, y, w, h, color);
+        return;
+    }
+    (void)fastepd_native_utils::fillLogicalRect(layout, x, y, w, h, color);
+}
+
+/** @brief Fill color of a filled primitive: the quantized color and the gray8 it came from. */
+struct EpdPaint {
+    uint8_t color;
+    uint8_t gray;
+};
+
+/**
+ * @brief Dither tables for a fill in `layout`, or null when fills should use the plain color.
+ *
+ * Gray values that are exact levels of the mode are never dithered.
+ */
+const FastEpdDither *fill_dither(const fastepd_native_utils::NativeLayout *layout, const EpdPaint &paint)
+{
+    if (g_dither_mode == DisplayDitherMode::none || !layout) {
+        return nullptr;
+    }
+    g_dither.configure(g_dither_mode, layout->bpp);
+    const uint32_t step = 255u / (uint32_t)(g_dither.levels() - 1);
+    return (paint.gray % step) == 0 ? nullptr : &g_dither;
+}
+
+/** @brief `fill_rect_native()` for filled primitives, dithered when a dither mode is active. */
+void fill_rect_paint(int32_t x, int32_t y, int32_t w, int32_t h, const EpdPaint &paint)
+{
+    fastepd_native_utils::NativeLayout layout;
+    const bool native = fastepd_native_utils::describeNativeLayout(*g_draw, &layout);
+    const FastEpdDither *dither = fill_dither(native ? &layout : nullptr, paint);
+    if (dither) {
+        (void)dither->fillLogicalRect(layout, x, y, w, h, paint.gray);
+        return;
+    }
+    fill_rect_native(x, y, w, h, paint.color);
+}
+
+/** @brief Draw the horizontal span `[x0, x1]` on row `y` (either order) for scanline fills. */
+void hline_native(
+    const fastepd_native_utils::NativeLayout *layout,
+    const FastEpdDither *dither,
+    int32_t x0,
+    int32_t x1,
+    int32_t y,
+    const EpdPaint &paint)
+{
+    if (!layout) {
+        g_draw->drawLine(x0, y, x1, y, paint.color);
+        return;
+    }
+    const int32_t lo = x0 < x1 ? x0 : x1;
+    const int32_t hi = x0 < x1 ? x1 : x0;
+    const int32_t w = (int32_t)((int64_t)hi - lo + 1);
+    if (dither) {
+        (void)dither->fillLogicalRect(*layout, lo, y, w, 1, paint.gray);
+        return;
+    }
+    (void)fastepd_native_utils::fillLogicalRect(*layout, lo, y, w, 1, paint.color);
+}
+
 int32_t filled_triangle(
     int32_t x0,
     int32_t y0,
@@ -833,16 +1602,21 @@ int32_t filled_triangle(
     int32_t y1,
     int32_t x2,
     int32_t y2,
-    uint8_t color)
+    const EpdPaint &paint)
 {
     if (y0 > y1) { int32_t t; t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
     if (y1 > y2) { int32_t t; t = y1; y1 = y2; y2 = t; t = x1; x1 = x2; x2 = t; }
     if (y0 > y1) { int32_t t; t = y0; y0 = y1; y1 = t; t = x0; x0 = x1; x1 = t; }
 
+    fastepd_native_utils::NativeLayout layout;
+    const fastepd_native_utils::NativeLayout *native =
+        fastepd_native_utils::describeNativeLayout(*g_draw, &layout) ? &layout : nullptr;
+    const FastEpdDither *dither = fill_dither(native, paint);
+
     if (y0 == y2) {
         int32_t min_x = x0 < x1 ? (x0 < x2 ? x0 : x2) : (x1 < x2 ? x1 : x2);
         int32_t max_x = x0 > x1 ? (x0 > x2 ? x0 : x2) : (x1 > x2 ? x1 : x2);
-        g_epd.drawLine(min_x, y0, max_x, y0, color);
+        hline_native(native, dither, min_x, max_x, y0, paint);
         return kWasmOk;
     }
 
@@ -860,7 +1634,7 @@ int32_t filled_triangle(
             : (x0 + (int32_t)((x1 - x0) * beta));
         const int32_t x_start = ax < bx ? ax : bx;
         const int32_t x_end = ax > bx ? ax : bx;
-        g_epd.drawLine(x_start, ay, x_end, ay, color);
+        hline_native(native, dither, x_start, x_end, ay, paint);
     }
     return kWasmOk;
 }
@@ -879,10 +1653,10 @@ void draw_ellipse_outline(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint8_
     int64_t p = ry2 - (rx2 * y) + (rx2 / 4);
 
     auto plot4 = [&](int64_t px0, int64_t py0) {
-        g_epd.drawPixel(cx + (int32_t)px0, cy + (int32_t)py0, color);
-        g_epd.drawPixel(cx - (int32_t)px0, cy + (int32_t)py0, color);
-        g_epd.drawPixel(cx + (int32_t)px0, cy - (int32_t)py0, color);
-        g_epd.drawPixel(cx - (int32_t)px0, cy - (int32_t)py0, color);
+        g_draw->drawPixel(cx + (int32_t)px0, cy + (int32_t)py0, color);
+        g_draw->drawPixel(cx - (int32_t)px0, cy + (int32_t)py0, color);
+        g_draw->drawPixel(cx + (int32_t)px0, cy - (int32_t)py0, color);
+        g_draw->drawPixel(cx - (int32_t)px0, cy - (int32_t)py0, color);
     };
 
     plot4(x, y);
@@ -914,7 +1688,7 @@ void draw_ellipse_outline(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint8_
     }
 }
 
-void fill_ellipse_scanlines(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint8_t color)
+void fill_ellipse_scanlines(int32_t cx, int32_t cy, int32_t rx, int32_t ry, const EpdPaint &paint)
 {
     int64_t x = 0;
     int64_t y = ry;
@@ -927,10 +1701,15 @@ void fill_ellipse_scanlines(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint
     int64_t py = two_rx2 * y;
     int64_t p = ry2 - (rx2 * y) + (rx2 / 4);
 
+    fastepd_native_utils::NativeLayout layout;
+    const fastepd_native_utils::NativeLayout *native =
+        fastepd_native_utils::describeNativeLayout(*g_draw, &layout) ? &layout : nullptr;
+    const FastEpdDither *dither = fill_dither(native, paint);
+
     auto draw_pair = [&](int64_t px0, int64_t py0) {
-        g_epd.drawLine(cx - (int32_t)px0, cy + (int32_t)py0, cx + (int32_t)px0, cy + (int32_t)py0, color);
+        hline_native(native, dither, cx - (int32_t)px0, cx + (int32_t)px0, cy + (int32_t)py0, paint);
         if (py0 != 0) {
-            g_epd.drawLine(cx - (int32_t)px0, cy - (int32_t)py0, cx + (int32_t)px0, cy - (int32_t)py0, color);
+            hline_native(native, dither, cx - (int32_t)px0, cx + (int32_t)px0, cy - (int32_t)py0, paint);
         }
     };
 
@@ -963,6 +1742,98 @@ void fill_ellipse_scanlines(int32_t cx, int32_t cy, int32_t rx, int32_t ry, uint
     }
 }
 
+/** @brief Source rows converted per `blitGray8()` call by `push_converted_image()`. */
+constexpr int32_t kImageStripRows = 16;
+
+/**
+ * @brief Convert the on-screen part of a packed image to gray8 strip by strip and blit it.
+ *
+ * With a dither mode active each strip is quantized to native levels first (ordered tile or
+ * error diffusion) and blitted through the identity level table.
+ * The caller has validated `data` against `w * h` pixels of `conv`'s depth.
+ */
+int32_t push_converted_image(
+    const FastEpdImageConverter &conv,
+    const uint8_t *data,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    const char *oom_message)
+{
+    const int64_t x0 = x < 0 ? 0 : x;
+    const int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = (int64_t)x + w;
+    int64_t y1 = (int64_t)y + h;
+    if (x1 > g_draw->width()) {
+        x1 = g_draw->width();
+    }
+    if (y1 > g_draw->height()) {
+        y1 = g_draw->height();
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return kWasmOk;
+    }
+    const int32_t clip_w = (int32_t)(x1 - x0);
+    const int32_t clip_h = (int32_t)(y1 - y0);
+    const int32_t strip_rows = clip_h < kImageStripRows ? clip_h : kImageStripRows;
+    uint8_t *strip = (uint8_t *)malloc((size_t)clip_w * (size_t)strip_rows);
+    if (!strip) {
+        wasm_api_set_last_error(kWasmErrInternal, oom_message);
+        return kWasmErrInternal;
+    }
+
+    const int32_t mode = g_draw->getMode();
+    fastepd_native_utils::NativeLayout layout;
+    const bool native = fastepd_native_utils::describeNativeLayout(*g_draw, &layout);
+    const DisplayDitherMode dither_mode = native ? g_dither_mode : DisplayDitherMode::none;
+    FastEpdErrorDiffusion diffusion;
+    if (dither_mode != DisplayDitherMode::none) {
+        g_dither.configure(dither_mode, layout.bpp);
+        if (dither_mode == DisplayDitherMode::diffusion && !diffusion.begin(clip_w, g_dither.levels())) {
+            free(strip);
+            wasm_api_set_last_error(kWasmErrInternal, oom_message);
+            return kWasmErrInternal;
+        }
+    }
+    const uint8_t *lut = (dither_mode == DisplayDitherMode::none) ? gray8_native_lut(mode) : FastEpdDither::levelLut();
+    for (int32_t row = 0; row < clip_h; row += strip_rows) {
+        const int32_t rows = (clip_h - row) < strip_rows ? (clip_h - row) : strip_rows;
+        const int32_t dy = (int32_t)y0 + row;
+        for (int32_t r = 0; r < rows; ++r) {
+            const size_t first = (size_t)(y0 - y + row + r) * (size_t)w + (size_t)(x0 - x);
+            uint8_t *line = strip + (size_t)r * (size_t)clip_w;
+            conv.convert(data, first, (size_t)clip_w, line);
+            if (dither_mode == DisplayDitherMode::diffusion) {
+                diffusion.row(line, line);
+            } else if (dither_mode != DisplayDitherMode::none) {
+                g_dither.orderedSpan(line, line, clip_w, (int32_t)x0, dy + r);
+            }
+        }
+        if (native) {
+            (void)fastepd_native_utils::blitGray8(layout, (int32_t)x0, dy, clip_w, rows, strip, clip_w, lut);
+            continue;
+        }
+        for (int32_t r = 0; r < rows; ++r) {
+            const uint8_t *src = strip + (size_t)r * (size_t)clip_w;
+            for (int32_t xx = 0; xx < clip_w; ++xx) {
+                g_draw->drawPixelFast((int32_t)x0 + xx, dy + r, gray8_to_epd_color(src[xx], mode));
+            }
+        }
+    }
+    free(strip);
+    mark_dirty((int32_t)x0, (int32_t)y0, clip_w, clip_h);
+    return kWasmOk;
+}
+
+/** @brief Raw native pixel value -> little-endian RGB565 gray for `bpp`. */
+uint16_t native_value_to_rgb565(int32_t bpp, uint8_t value)
+{
+    const uint32_t max = (1u << bpp) - 1u;
+    const uint32_t gray = ((uint32_t)value * 255u + max / 2u) / max;
+    return (uint16_t)(((gray >> 3) << 11) | ((gray >> 2) << 5) | (gray >> 3));
+}
+
 } // namespace
 
 PaperDisplayDriver DisplayFastEpd::driver() {
@@ -993,7 +1864,16 @@ int32_t DisplayFastEpd::release(wasm_exec_env_t exec_env)
 {
     (void)exec_env;
     ESP_LOGI(kTag, "release: deinitializing FastEPD resources");
+    g_refresh.wait();
+    (void)g_refresh.takeResult();
     fastepd_vlw_reset_all();
+    g_draw = &g_epd;
+    g_canvases.clear();
+    g_image_cache.clear();
+    g_xtc_book.reset();
+    g_convert_writer.wait();
+    g_dirty.clear();
+    g_shadow.release();
     g_epd.deInit();
     bbepDeinitBus();
     g_epd_inited = false;
@@ -1005,7 +1885,7 @@ int32_t DisplayFastEpd::release(wasm_exec_env_t exec_env)
 int32_t DisplayFastEpd::width(wasm_exec_env_t exec_env)
 {
     (void)exec_env;
-    const int32_t rc = require_epd_ready_or_set_error("width: display not ready");
+    const int32_t rc = require_epd_geometry_or_set_error("width: display not ready");
     if (rc != kWasmOk) {
         return rc;
     }
@@ -1015,7 +1895,7 @@ int32_t DisplayFastEpd::width(wasm_exec_env_t exec_env)
 int32_t DisplayFastEpd::height(wasm_exec_env_t exec_env)
 {
     (void)exec_env;
-    const int32_t rc = require_epd_ready_or_set_error("height: display not ready");
+    const int32_t rc = require_epd_geometry_or_set_error("height: display not ready");
     if (rc != kWasmOk) {
         return rc;
     }
@@ -1025,7 +1905,7 @@ int32_t DisplayFastEpd::height(wasm_exec_env_t exec_env)
 int32_t DisplayFastEpd::getRotation(wasm_exec_env_t exec_env)
 {
     (void)exec_env;
-    const int32_t rc = require_epd_ready_or_set_error("getRotation: display not ready");
+    const int32_t rc = require_epd_geometry_or_set_error("getRotation: display not ready");
     if (rc != kWasmOk) {
         return rc;
     }
@@ -1066,6 +1946,10 @@ int32_t DisplayFastEpd::setRotation(wasm_exec_env_t exec_env, int32_t rot)
     // FastEPD defaults to 90deg while LGFX touch baseline is rot=0 on this board.
     const uint_fast8_t lgfx_rot = (uint_fast8_t)((rot + 3) & 0x3);
     paper_touch_set_rotation(lgfx_rot);
+    // Recorded rects are in the previous logical frame; refresh everything next time.
+    if (!g_dirty.empty()) {
+        g_dirty.markAll(g_epd.width(), g_epd.height());
+    }
     return kWasmOk;
 }
 
@@ -1110,6 +1994,8 @@ int32_t DisplayFastEpd::setDisplayMode(wasm_exec_env_t exec_env, int32_t mode)
 
     g_epd.backupPlane();
     g_display_mode = mode;
+    g_dirty.markAll(g_epd.width(), g_epd.height());
+    g_shadow.invalidate();
     return kWasmOk;
 }
 
@@ -1120,8 +2006,9 @@ int32_t DisplayFastEpd::clear(wasm_exec_env_t exec_env)
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
-    g_epd.fillScreen(epd_white_for_mode(mode));
+    const int32_t mode = g_draw->getMode();
+    g_draw->fillScreen(epd_white_for_mode(mode));
+    mark_dirty_all();
     return kWasmOk;
 }
 
@@ -1132,9 +2019,18 @@ int32_t DisplayFastEpd::fillScreen(wasm_exec_env_t exec_env, int32_t rgb888)
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
+    const int32_t mode = g_draw->getMode();
     const uint8_t gray = rgb888_to_gray8(rgb888);
-    g_epd.fillScreen(gray8_to_epd_color(gray, mode));
+    const EpdPaint paint{gray8_to_epd_color(gray, mode), gray};
+    fastepd_native_utils::NativeLayout layout;
+    const bool native = fastepd_native_utils::describeNativeLayout(*g_draw, &layout);
+    const FastEpdDither *dither = fill_dither(native ? &layout : nullptr, paint);
+    if (dither) {
+        (void)dither->fillLogicalRect(layout, 0, 0, layout.logical_w, layout.logical_h, gray);
+    } else {
+        g_draw->fillScreen(paint.color);
+    }
+    mark_dirty_all();
     return kWasmOk;
 }
 
@@ -1145,11 +2041,9 @@ int32_t DisplayFastEpd::display(wasm_exec_env_t exec_env)
     if (rc != kWasmOk) {
         return rc;
     }
-    const int epd_rc = g_epd.fullUpdate(CLEAR_SLOW, true);
-    if (epd_rc != BBEP_SUCCESS) {
-        wasm_api_set_last_error(kWasmErrInternal, "display: FastEPD fullUpdate failed");
-        return kWasmErrInternal;
-    }
+    submit_refresh(CLEAR_SLOW, nullptr, 0);
+    g_dirty.clear();
+    shadow_capture_all();
     return kWasmOk;
 }
 
@@ -1173,13 +2067,93 @@ int32_t DisplayFastEpd::displayRect(wasm_exec_env_t exec_env, int32_t x, int32_t
         return kWasmErrInvalidArgument;
     }
 
-    BB_RECT rect = {.x = x, .y = y, .w = w, .h = h};
-    const int epd_rc = g_epd.fullUpdate(CLEAR_NONE, true, &rect);
-    if (epd_rc != BBEP_SUCCESS) {
-        wasm_api_set_last_error(kWasmErrInternal, "displayRect: FastEPD fullUpdate failed");
+    const FastEpdDirtyRect rect = {x, y, w, h};
+    submit_refresh(CLEAR_NONE, &rect, 1);
+    g_dirty.clearCoveredBy(x, y, w, h);
+    shadow_capture_rect(x, y, w, h);
+    return kWasmOk;
+}
+
+int32_t DisplayFastEpd::displayDirty(wasm_exec_env_t exec_env)
+{
+    (void)exec_env;
+    const int32_t rc = require_epd_ready_or_set_error("displayDirty: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (g_dirty.empty()) {
+        return 0;
+    }
+
+    FastEpdDirtyRect rects[FastEpdDirtyTracker::kMaxRects];
+    int count = g_dirty.count();
+    for (int i = 0; i < count; ++i) {
+        rects[i] = g_dirty.rect(i);
+    }
+    // Every rect costs a full waveform pass, so prefer one pass over the union unless it
+    // would drive substantially more pixels than the rects themselves.
+    if (count > 1) {
+        const FastEpdDirtyRect united = g_dirty.bounds();
+        const int64_t united_area = (int64_t)united.w * (int64_t)united.h;
+        if (united_area * 2 <= g_dirty.area() * 3) {
+            rects[0] = united;
+            count = 1;
+        }
+    }
+
+    fastepd_native_utils::NativeLayout layout;
+    const bool have_shadow = g_shadow.valid() && fastepd_native_utils::describeNativeLayout(g_epd, &layout);
+    int refreshed = 0;
+    for (int i = 0; i < count; ++i) {
+        // Drawing the same content again leaves the pixels untouched; skip the waveform.
+        if (have_shadow && !g_shadow.rectChanged(layout, rects[i].x, rects[i].y, rects[i].w, rects[i].h)) {
+            continue;
+        }
+        if (have_shadow) {
+            g_shadow.captureRect(layout, rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+        }
+        rects[refreshed++] = rects[i];
+    }
+    if (refreshed > 0) {
+        submit_refresh(CLEAR_NONE, rects, refreshed);
+    }
+    g_dirty.clear();
+    return refreshed;
+}
+
+int32_t DisplayFastEpd::displayDiff(wasm_exec_env_t exec_env)
+{
+    (void)exec_env;
+    const int32_t rc = require_epd_ready_or_set_error("displayDiff: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    fastepd_native_utils::NativeLayout layout;
+    if (!fastepd_native_utils::describeNativeLayout(g_epd, &layout)) {
+        wasm_api_set_last_error(kWasmErrInternal, "displayDiff: unsupported framebuffer layout");
         return kWasmErrInternal;
     }
-    return kWasmOk;
+
+    FastEpdDirtyRect rects[FastEpdShadowBuffer::kMaxRects];
+    const int count = g_shadow.diff(layout, rects);
+    if (count < 0) {
+        // No baseline yet (first call, mode switch or allocation failure): refresh the whole
+        // panel once without the slow clear and start tracking from there.
+        submit_refresh(CLEAR_NONE, nullptr, 0);
+        g_dirty.clear();
+        (void)g_shadow.captureAll(layout, true);
+        return 1;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        g_shadow.captureRect(layout, rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+    }
+    if (count > 0) {
+        submit_refresh(CLEAR_NONE, rects, count);
+    }
+    // Everything that differs has been pushed, so nothing recorded is pending any more.
+    g_dirty.clear();
+    return count;
 }
 
 int32_t DisplayFastEpd::fullUpdateSlow(wasm_exec_env_t exec_env)
@@ -1191,8 +2165,22 @@ int32_t DisplayFastEpd::fullUpdateSlow(wasm_exec_env_t exec_env)
 int32_t DisplayFastEpd::waitDisplay(wasm_exec_env_t exec_env)
 {
     (void)exec_env;
-    // FastEPD updates are synchronous today.
-    warn_unimplemented("waitDisplay");
+    g_refresh.wait();
+    const int epd_rc = g_refresh.takeResult();
+    if (epd_rc != BBEP_SUCCESS) {
+        wasm_api_set_last_error(kWasmErrInternal, "waitDisplay: FastEPD fullUpdate failed");
+        return kWasmErrInternal;
+    }
+    return kWasmOk;
+}
+
+int32_t DisplayFastEpd::setDitherMode(wasm_exec_env_t exec_env, int32_t mode)
+{
+    const int32_t rc = Display::setDitherMode(exec_env, mode);
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    g_dither_mode = (DisplayDitherMode)mode;
     return kWasmOk;
 }
 
@@ -1251,7 +2239,7 @@ int32_t DisplayFastEpd::setCursor(wasm_exec_env_t exec_env, int32_t x, int32_t y
     if (rc != kWasmOk) {
         return rc;
     }
-    g_epd.setCursor(x, y);
+    g_draw->setCursor(x, y);
     return kWasmOk;
 }
 
@@ -1264,6 +2252,7 @@ int32_t DisplayFastEpd::setTextSize(wasm_exec_env_t exec_env, float sx, float sy
     }
     g_vlw_runtime.text_state.size_x = sx;
     g_vlw_runtime.text_state.size_y = sy;
+    g_vlw_runtime.advances.Invalidate();
     return kWasmOk;
 }
 
@@ -1278,6 +2267,64 @@ int32_t DisplayFastEpd::setTextDatum(wasm_exec_env_t exec_env, int32_t datum)
     return kWasmOk;
 }
 
+namespace {
+
+// Text bodies shared by the per-call API and `submitCommands()`; the caller checked readiness.
+
+/** @brief Set the legacy and VLW text colors. */
+void set_text_color_epd(int32_t fg_rgb888, int32_t bg_rgb888, int32_t use_bg)
+{
+    const int32_t mode = g_draw->getMode();
+    const uint8_t fg = gray8_to_epd_color(rgb888_to_gray8(fg_rgb888), mode);
+    const int bg = use_bg ? (int)gray8_to_epd_color(rgb888_to_gray8(bg_rgb888), mode) : BBEP_TRANSPARENT;
+    g_draw->setTextColor((int)fg, bg);
+    g_legacy_text.color_set = true;
+    g_vlw_runtime.text_state.fg_rgb888 = fg_rgb888;
+    g_vlw_runtime.text_state.bg_rgb888 = bg_rgb888;
+    g_vlw_runtime.text_state.use_bg = use_bg != 0;
+}
+
+/**
+ * @brief Draw `len` bytes of `s` at `(x, y)` with the active VLW or bitmap font.
+ *
+ * The VLW renderer reads the span in place. The bitmap font needs a C string, so `s` is copied
+ * into `scratch` first unless `scratch` is null, which means `s[len]` is already the NUL.
+ * @return Rendered width, or a negative error with the last error set.
+ */
+int32_t draw_string_epd(const char *s, size_t len, int32_t x, int32_t y, std::string *scratch)
+{
+    if (g_vlw_runtime.active_font) {
+        int32_t width = 0;
+        BB_RECT bounds = {};
+        const int32_t draw_rc = DrawString(*g_draw, *g_vlw_runtime.active_font, g_vlw_runtime.text_state, s, len, x, y,
+            &width, &bounds, &g_vlw_runtime.glyph_cache);
+        mark_dirty(bounds.x, bounds.y, bounds.w, bounds.h);
+        if (draw_rc != kWasmOk) {
+            wasm_api_set_last_error(draw_rc, "drawString: VLW renderer failed");
+            return draw_rc;
+        }
+        return width;
+    }
+
+    if (scratch) {
+        scratch->assign(s, len);
+        s = scratch->c_str();
+    }
+    BB_RECT rect;
+    g_draw->setCursor(0, 0);
+    const int box_rc = g_draw->getStringBox(s, &rect);
+    if (box_rc != BBEP_SUCCESS) {
+        wasm_api_set_last_error(kWasmErrInternal, "drawString: getStringBox failed");
+        return kWasmErrInternal;
+    }
+    y -= rect.y;
+    g_draw->drawString(s, x, y);
+    mark_dirty(x + rect.x, y + rect.y, rect.w, rect.h);
+    return rect.w;
+}
+
+} // namespace
+
 int32_t DisplayFastEpd::setTextColor(wasm_exec_env_t exec_env, int32_t fg_rgb888, int32_t bg_rgb888, int32_t use_bg)
 {
     (void)exec_env;
@@ -1285,13 +2332,7 @@ int32_t DisplayFastEpd::setTextColor(wasm_exec_env_t exec_env, int32_t fg_rgb888
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t fg = gray8_to_epd_color(rgb888_to_gray8(fg_rgb888), mode);
-    const int bg = use_bg ? (int)gray8_to_epd_color(rgb888_to_gray8(bg_rgb888), mode) : BBEP_TRANSPARENT;
-    g_epd.setTextColor((int)fg, bg);
-    g_vlw_runtime.text_state.fg_rgb888 = fg_rgb888;
-    g_vlw_runtime.text_state.bg_rgb888 = bg_rgb888;
-    g_vlw_runtime.text_state.use_bg = use_bg != 0;
+    set_text_color_epd(fg_rgb888, bg_rgb888, use_bg);
     return kWasmOk;
 }
 
@@ -1302,7 +2343,9 @@ int32_t DisplayFastEpd::setTextWrap(wasm_exec_env_t exec_env, int32_t wrap_x, in
     if (rc != kWasmOk) {
         return rc;
     }
-    g_epd.setTextWrap((wrap_x != 0) || (wrap_y != 0));
+    g_draw->setTextWrap((wrap_x != 0) || (wrap_y != 0));
+    g_legacy_text.wrap_set = true;
+    g_legacy_text.wrap = (wrap_x != 0) || (wrap_y != 0);
     g_vlw_runtime.text_state.wrap_x = wrap_x != 0;
     g_vlw_runtime.text_state.wrap_y = wrap_y != 0;
     return kWasmOk;
@@ -1326,7 +2369,8 @@ int32_t DisplayFastEpd::setTextFont(wasm_exec_env_t exec_env, int32_t font_id)
         wasm_api_set_last_error(kWasmErrInvalidArgument, "setTextFont: font_id out of range (expected 0..3)");
         return kWasmErrInvalidArgument;
     }
-    g_epd.setFont(font_id);
+    g_draw->setFont(font_id);
+    g_legacy_text.font_id = font_id;
     return kWasmOk;
 }
 
@@ -1349,33 +2393,14 @@ int32_t DisplayFastEpd::drawString(wasm_exec_env_t exec_env, const char *s, int3
         wasm_api_set_last_error(kWasmErrInvalidArgument, "drawString: s is null");
         return kWasmErrInvalidArgument;
     }
-
-    if (g_vlw_runtime.active_font) {
-        int32_t width = 0;
-        const int32_t draw_rc = DrawString(g_epd, *g_vlw_runtime.active_font, g_vlw_runtime.text_state, s, x, y, &width);
-        if (draw_rc != kWasmOk) {
-            wasm_api_set_last_error(draw_rc, "drawString: VLW renderer failed");
-            return draw_rc;
-        }
-        return width;
-    }
-
-    BB_RECT rect;
-    g_epd.setCursor(0, 0);
-    const int box_rc = g_epd.getStringBox(s, &rect);
-    if (box_rc != BBEP_SUCCESS) {
-        wasm_api_set_last_error(kWasmErrInternal, "drawString: getStringBox failed");
-        return kWasmErrInternal;
-    }
-    y -= rect.y;
-    g_epd.drawString(s, x, y);
-    return rect.w;
+    return draw_string_epd(s, strlen(s), x, y, nullptr);
 }
 
 int32_t DisplayFastEpd::textWidth(wasm_exec_env_t exec_env, const char *s)
 {
     (void)exec_env;
-    const int32_t rc = require_epd_ready_or_set_error("textWidth: display not ready");
+    // Measuring touches no pixels, so it need not wait for a refresh in flight.
+    const int32_t rc = require_epd_geometry_or_set_error("textWidth: display not ready");
     if (rc != kWasmOk) {
         return rc;
     }
@@ -1385,7 +2410,8 @@ int32_t DisplayFastEpd::textWidth(wasm_exec_env_t exec_env, const char *s)
     }
     if (g_vlw_runtime.active_font) {
         int32_t width = 0;
-        const int32_t measure_rc = MeasureTextWidth(*g_vlw_runtime.active_font, g_vlw_runtime.text_state, s, &width);
+        const int32_t measure_rc = MeasureTextWidth(
+            *g_vlw_runtime.active_font, g_vlw_runtime.text_state, s, &width, &g_vlw_runtime.advances);
         if (measure_rc != kWasmOk) {
             wasm_api_set_last_error(measure_rc, "textWidth: VLW renderer failed");
             return measure_rc;
@@ -1393,7 +2419,7 @@ int32_t DisplayFastEpd::textWidth(wasm_exec_env_t exec_env, const char *s)
         return width;
     }
     BB_RECT rect = {};
-    const int epd_rc = g_epd.getStringBox(s, &rect);
+    const int epd_rc = g_draw->getStringBox(s, &rect);
     if (epd_rc != BBEP_SUCCESS) {
         wasm_api_set_last_error(kWasmErrInternal, "textWidth: getStringBox failed");
         return kWasmErrInternal;
@@ -1401,10 +2427,77 @@ int32_t DisplayFastEpd::textWidth(wasm_exec_env_t exec_env, const char *s)
     return rect.w;
 }
 
+int32_t DisplayFastEpd::textWidths(
+    wasm_exec_env_t exec_env,
+    const uint8_t *texts,
+    size_t texts_len,
+    uint8_t *out,
+    size_t out_len)
+{
+    (void)exec_env;
+    // Measuring touches no pixels, so it need not wait for a refresh in flight.
+    const int32_t rc = require_epd_geometry_or_set_error("textWidths: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (!texts && texts_len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "textWidths: texts is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (!out && out_len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "textWidths: out is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (((uintptr_t)out & 3u) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "textWidths: out must be 4-byte aligned");
+        return kWasmErrInvalidArgument;
+    }
+
+    int32_t *const widths = (int32_t *)out;
+    const size_t cap = out_len / sizeof(int32_t);
+    if (g_vlw_runtime.active_font) {
+        size_t count = 0;
+        const int32_t measure_rc = MeasureTextWidths(*g_vlw_runtime.active_font, g_vlw_runtime.text_state,
+            (const char *)texts, texts_len, widths, cap, &count, &g_vlw_runtime.advances);
+        if (measure_rc != kWasmOk) {
+            wasm_api_set_last_error(measure_rc, "textWidths: VLW renderer failed");
+            return measure_rc;
+        }
+        return (int32_t)count;
+    }
+
+    // Bitmap fonts measure NUL-terminated strings, so copy out a last string that runs to the end.
+    const char *cursor = (const char *)texts;
+    const char *const end = cursor + texts_len;
+    size_t count = 0;
+    std::string last;
+    while (cursor < end && count < cap) {
+        const char *stop = (const char *)memchr(cursor, 0, (size_t)(end - cursor));
+        const char *s = cursor;
+        if (!stop) {
+            last.assign(cursor, (size_t)(end - cursor));
+            s = last.c_str();
+            stop = end;
+        }
+        BB_RECT rect = {};
+        if (g_draw->getStringBox(s, &rect) != BBEP_SUCCESS) {
+            wasm_api_set_last_error(kWasmErrInternal, "textWidths: getStringBox failed");
+            return kWasmErrInternal;
+        }
+        widths[count++] = rect.w;
+        if (stop == end) {
+            break;
+        }
+        cursor = stop + 1;
+    }
+    return (int32_t)count;
+}
+
 int32_t DisplayFastEpd::fontHeight(wasm_exec_env_t exec_env)
 {
     (void)exec_env;
-    const int32_t rc = require_epd_ready_or_set_error("fontHeight: display not ready");
+    // Measuring touches no pixels, so it need not wait for a refresh in flight.
+    const int32_t rc = require_epd_geometry_or_set_error("fontHeight: display not ready");
     if (rc != kWasmOk) {
         return rc;
     }
@@ -1418,7 +2511,7 @@ int32_t DisplayFastEpd::fontHeight(wasm_exec_env_t exec_env)
         return height;
     }
     BB_RECT rect = {};
-    const int epd_rc = g_epd.getStringBox("M", &rect);
+    const int epd_rc = g_draw->getStringBox("M", &rect);
     if (epd_rc != BBEP_SUCCESS) {
         wasm_api_set_last_error(kWasmErrInternal, "fontHeight: getStringBox failed");
         return kWasmErrInternal;
@@ -1522,29 +2615,136 @@ int32_t DisplayFastEpd::vlwClearAll(wasm_exec_env_t exec_env)
     g_vlw_runtime.active_font.reset();
     g_vlw_runtime.active_font_is_system = false;
     g_vlw_runtime.registry.Clear();
+    g_vlw_runtime.glyph_cache.Clear();
+    g_vlw_runtime.advances.Invalidate();
     ESP_LOGI(kTag, "vlwClearAll cleared registered VLW fonts");
     return kWasmOk;
 }
 
-int32_t DisplayFastEpd::pushImageRgb565(
+int32_t DisplayFastEpd::drawTextBox(
     wasm_exec_env_t exec_env,
+    const uint8_t *text,
+    size_t text_len,
     int32_t x,
     int32_t y,
     int32_t w,
     int32_t h,
-    const uint8_t *ptr,
-    size_t len)
+    int32_t align,
+    int32_t line_spacing,
+    int32_t flags,
+    uint8_t *breaks,
+    size_t breaks_len)
 {
     (void)exec_env;
-    (void)x;
-    (void)y;
-    (void)w;
-    (void)h;
-    (void)ptr;
-    (void)len;
-    warn_unimplemented("pushImageRgb565");
-    return kWasmOk;
-}
+    constexpr int32_t kFlagBreakAnywhere = 1;
+    constexpr int32_t kFlagMeasureOnly = 2;
+
+    // Measuring touches no pixels, so it need not wait for a refresh in flight.
+    const bool measure_only = (flags & kFlagMeasureOnly) != 0;
+    const int32_t rc = measure_only ? require_epd_geometry_or_set_error("drawTextBox: display not ready")
+                                    : require_epd_ready_or_set_error("drawTextBox: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (!g_vlw_runtime.active_font) {
+        wasm_api_set_last_error(kWasmErrNotReady, "drawTextBox: no VLW font selected");
+        return kWasmErrNotReady;
+    }
+    if (!text && text_len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawTextBox: text is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (text_len > (size_t)INT32_MAX) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawTextBox: text_len too large");
+        return kWasmErrInvalidArgument;
+    }
+    if (align < 0 || align > 2) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawTextBox: invalid align");
+        return kWasmErrInvalidArgument;
+    }
+    if ((flags & ~(kFlagBreakAnywhere | kFlagMeasureOnly)) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawTextBox: unknown flags");
+        return kWasmErrInvalidArgument;
+    }
+    if (!breaks && breaks_len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawTextBox: breaks is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (((uintptr_t)breaks & 3u) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawTextBox: breaks must be 4-byte aligned");
+        return kWasmErrInvalidArgument;
+    }
+
+    FastEpdVlwParagraph box;
+    box.x = x;
+    box.y = y;
+    box.w = w;
+    box.h = h;
+    box.align = align;
+    box.line_spacing = line_spacing;
+    box.break_anywhere = (flags & kFlagBreakAnywhere) != 0;
+    box.measure_only = measure_only;
+
+    int32_t lines = 0;
+    BB_RECT bounds = {};
+    const int32_t draw_rc = DrawParagraph(*g_draw, *g_vlw_runtime.active_font, g_vlw_runtime.text_state,
+        (const char *)text, text_len, box, (int32_t *)breaks, breaks_len / sizeof(int32_t), &lines, &bounds,
+        &g_vlw_runtime.glyph_cache);
+    if (!measure_only) {
+        mark_dirty(bounds.x, bounds.y, bounds.w, bounds.h);
+    }
+    if (draw_rc == kWasmErrInvalidArgument) {
+        wasm_api_set_last_error(draw_rc, "drawTextBox: line_spacing leaves no line advance");
+        return draw_rc;
+    }
+    if (draw_rc != kWasmOk) {
+        wasm_api_set_last_error(draw_rc, "drawTextBox: VLW renderer failed");
+        return draw_rc;
+    }
+    return lines;
+}
+
+int32_t DisplayFastEpd::pushImageRgb565(
+    wasm_exec_env_t exec_env,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    const uint8_t *ptr,
+    size_t len)
+{
+    (void)exec_env;
+    const int32_t rc = require_epd_ready_or_set_error("pushImageRgb565: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (x < 0 || y < 0 || w < 0 || h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImageRgb565: negative argument");
+        return kWasmErrInvalidArgument;
+    }
+    const uint64_t expected_len64 = (uint64_t)(uint32_t)w * (uint64_t)(uint32_t)h * 2u;
+    if (expected_len64 > (uint64_t)SIZE_MAX) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImageRgb565: size overflow");
+        return kWasmErrInvalidArgument;
+    }
+    const size_t expected_len = (size_t)expected_len64;
+    if ((!ptr && expected_len != 0) || len != expected_len) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImageRgb565: ptr/len mismatch");
+        return kWasmErrInvalidArgument;
+    }
+    if (expected_len == 0) {
+        return kWasmOk;
+    }
+    if (((uintptr_t)ptr & 1u) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImageRgb565: ptr must be 2-byte aligned");
+        return kWasmErrInvalidArgument;
+    }
+
+    // Same layout as LGFX's rgb565_t: native (little-endian) u16 per pixel.
+    FastEpdImageConverter conv;
+    (void)conv.init((int32_t)(16u | kImageDepthNonswapped));
+    return push_converted_image(conv, ptr, x, y, w, h, "pushImageRgb565: out of memory");
+}
 
 int32_t DisplayFastEpd::pushImage(
     wasm_exec_env_t exec_env,
@@ -1559,17 +2759,61 @@ int32_t DisplayFastEpd::pushImage(
     size_t palette_len)
 {
     (void)exec_env;
-    (void)x;
-    (void)y;
-    (void)w;
-    (void)h;
-    (void)data_ptr;
-    (void)data_len;
-    (void)depth_raw;
-    (void)palette_ptr;
-    (void)palette_len;
-    warn_unimplemented("pushImage");
-    return kWasmOk;
+    const int32_t rc = require_epd_ready_or_set_error("pushImage: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (x < 0 || y < 0 || w < 0 || h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: negative argument");
+        return kWasmErrInvalidArgument;
+    }
+
+    FastEpdImageConverter conv;
+    if (!conv.init(depth_raw)) {
+        return kWasmErrInvalidArgument;
+    }
+    const uint32_t bits = conv.bits();
+    const uint64_t pixels = (uint64_t)(uint32_t)w * (uint64_t)(uint32_t)h;
+    const uint64_t expected_len64 = (bits < 8) ? (pixels * bits + 7u) / 8u : pixels * (bits / 8u);
+    if (expected_len64 > (uint64_t)SIZE_MAX) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: size overflow");
+        return kWasmErrInvalidArgument;
+    }
+    const size_t expected_len = (size_t)expected_len64;
+    if ((!data_ptr && expected_len != 0) || data_len != expected_len) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: data ptr/len mismatch");
+        return kWasmErrInvalidArgument;
+    }
+    if (expected_len == 0) {
+        return kWasmOk;
+    }
+    if (bits == 16 && ((uintptr_t)data_ptr & 1u) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: data_ptr must be 2-byte aligned for 16bpp");
+        return kWasmErrInvalidArgument;
+    }
+    if (bits == 32 && ((uintptr_t)data_ptr & 3u) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: data_ptr must be 4-byte aligned for 32bpp");
+        return kWasmErrInvalidArgument;
+    }
+
+    // Palette is only used for indexed (<8bpp) and palette_* depths; otherwise it is ignored.
+    if (conv.paletteEntries() != 0) {
+        if (!palette_ptr) {
+            wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: palette_ptr is null (palette required)");
+            return kWasmErrInvalidArgument;
+        }
+        if (((uintptr_t)palette_ptr & 3u) != 0) {
+            wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: palette_ptr must be 4-byte aligned");
+            return kWasmErrInvalidArgument;
+        }
+        if (palette_len != (size_t)conv.paletteEntries() * 4u) {
+            wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: palette_len mismatch");
+            return kWasmErrInvalidArgument;
+        }
+        conv.setPalette(palette_ptr);
+    }
+
+    return push_converted_image(conv, data_ptr, x, y, w, h, "pushImage: out of memory");
 }
 
 int32_t DisplayFastEpd::pushImageGray8(
@@ -1605,23 +2849,35 @@ int32_t DisplayFastEpd::pushImageGray8(
         return kWasmErrInvalidArgument;
     }
 
-    const int32_t mode = g_epd.getMode();
-    const int32_t epd_w = g_epd.width();
-    const int32_t epd_h = g_epd.height();
-    for (int32_t yy = 0; yy < h; ++yy) {
-        const int32_t dy = y + yy;
-        if (dy < 0 || dy >= epd_h) {
-            continue;
-        }
-        const uint8_t *row = ptr + (size_t)yy * (size_t)w;
-        for (int32_t xx = 0; xx < w; ++xx) {
-            const int32_t dx = x + xx;
-            if (dx < 0 || dx >= epd_w) {
+    fastepd_native_utils::NativeLayout layout;
+    if (g_dither_mode != DisplayDitherMode::none) {
+        // Dithering needs a quantization pass per row; share the strip pipeline of pushImage().
+        FastEpdImageConverter conv;
+        (void)conv.init((int32_t)(8u | kImageDepthAlternate));
+        return push_converted_image(conv, ptr, x, y, w, h, "pushImageGray8: out of memory");
+    }
+    if (fastepd_native_utils::describeNativeLayout(*g_draw, &layout)) {
+        (void)fastepd_native_utils::blitGray8(layout, x, y, w, h, ptr, w, gray8_native_lut(g_draw->getMode()));
+    } else {
+        const int32_t mode = g_draw->getMode();
+        const int32_t epd_w = g_draw->width();
+        const int32_t epd_h = g_draw->height();
+        for (int32_t yy = 0; yy < h; ++yy) {
+            const int32_t dy = y + yy;
+            if (dy < 0 || dy >= epd_h) {
                 continue;
             }
-            g_epd.drawPixelFast(dx, dy, gray8_to_epd_color(row[xx], mode));
+            const uint8_t *row = ptr + (size_t)yy * (size_t)w;
+            for (int32_t xx = 0; xx < w; ++xx) {
+                const int32_t dx = x + xx;
+                if (dx < 0 || dx >= epd_w) {
+                    continue;
+                }
+                g_draw->drawPixelFast(dx, dy, gray8_to_epd_color(row[xx], mode));
+            }
         }
     }
+    mark_dirty(x, y, w, h);
     return kWasmOk;
 }
 
@@ -1635,15 +2891,58 @@ int32_t DisplayFastEpd::readRectRgb565(
     size_t out_len)
 {
     (void)exec_env;
-    (void)x;
-    (void)y;
-    (void)w;
-    (void)h;
-    (void)out;
-    (void)out_len;
-    warn_unimplemented("readRectRgb565");
-    wasm_api_set_last_error(kWasmErrInternal, "readRectRgb565: not supported by FastEPD");
-    return kWasmErrInternal;
+    const int32_t rc = require_epd_ready_or_set_error("readRectRgb565: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (x < 0 || y < 0 || w < 0 || h < 0 || (int64_t)x + w > g_draw->width() || (int64_t)y + h > g_draw->height()) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "readRectRgb565: rect out of bounds");
+        return kWasmErrInvalidArgument;
+    }
+    const int64_t expected_len64 = (int64_t)w * (int64_t)h * 2;
+    if (expected_len64 > (int64_t)INT32_MAX) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "readRectRgb565: output too large");
+        return kWasmErrInvalidArgument;
+    }
+    const size_t expected_len = (size_t)expected_len64;
+    if (!out && expected_len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "readRectRgb565: out is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (out_len < expected_len) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "readRectRgb565: out_len too small");
+        return kWasmErrInvalidArgument;
+    }
+    if (expected_len == 0) {
+        return 0;
+    }
+    if (((uintptr_t)out & 1u) != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "readRectRgb565: out must be 2-byte aligned");
+        return kWasmErrInvalidArgument;
+    }
+
+    fastepd_native_utils::NativeLayout layout;
+    if (!fastepd_native_utils::describeNativeLayout(*g_draw, &layout)) {
+        wasm_api_set_last_error(kWasmErrInternal, "readRectRgb565: framebuffer unavailable");
+        return kWasmErrInternal;
+    }
+
+    // Raw values are unpacked in place into the tail half of each output row, then expanded
+    // front to back; the 16-bit writes never overtake the bytes still to be read.
+    uint16_t palette[16];
+    for (uint32_t v = 0; v < (1u << layout.bpp); ++v) {
+        palette[v] = native_value_to_rgb565(layout.bpp, (uint8_t)v);
+    }
+    for (int32_t yy = 0; yy < h; ++yy) {
+        uint8_t *row = out + (size_t)yy * (size_t)w * 2u;
+        uint8_t *raw = row + (size_t)w;
+        fastepd_native_utils::readLogicalRow(layout, x, y + yy, w, raw);
+        uint16_t *dst = (uint16_t *)row;
+        for (int32_t xx = 0; xx < w; ++xx) {
+            dst[xx] = palette[raw[xx]];
+        }
+    }
+    return (int32_t)expected_len;
 }
 
 int32_t DisplayFastEpd::drawPng(wasm_exec_env_t exec_env, const uint8_t *ptr, size_t len, int32_t x, int32_t y)
@@ -1665,126 +2964,934 @@ int32_t DisplayFastEpd::drawXth(wasm_exec_env_t exec_env, const uint8_t *ptr, si
     if (ready_rc != kWasmOk) {
         return ready_rc;
     }
-    if (g_epd.getMode() != BB_MODE_2BPP) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xth: unsupported mode (expected 2-bpp)");
+    if (g_epd.getMode() != BB_MODE_2BPP) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xth: unsupported mode (expected 2-bpp)");
+        return kWasmErrInvalidArgument;
+    }
+    const bool ok = fastepd_xtc::drawXth(&g_epd, ptr, len);
+    finish_xtx_draw(ok, fast);
+    if (!ok) {
+        wasm_api_set_last_error(kWasmErrInternal, "draw_xth: decode failed");
+        return kWasmErrInternal;
+    }
+    return 0;
+}
+
+int32_t DisplayFastEpd::drawXtg(wasm_exec_env_t exec_env, const uint8_t *ptr, size_t len, bool fast)
+{
+    if (!ptr && len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xtg: ptr is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (len == 0 || len > kMaxXtgBytes) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xtg: invalid len");
+        return kWasmErrInvalidArgument;
+    }
+    const int32_t ready_rc = require_epd_ready_or_set_error("draw_xtg: framebuffer not ready");
+    if (ready_rc != kWasmOk) {
+        return ready_rc;
+    }
+    if (g_epd.getMode() != BB_MODE_1BPP) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xtg: unsupported mode (expected 1-bpp)");
+        return kWasmErrInvalidArgument;
+    }
+    const bool ok = fastepd_xtc::drawXtg(&g_epd, ptr, len);
+    finish_xtx_draw(ok, fast);
+    if (!ok) {
+        wasm_api_set_last_error(kWasmErrInternal, "draw_xtg: decode failed");
+        return kWasmErrInternal;
+    }
+    return 0;
+}
+
+namespace {
+
+int32_t xtx_file_read(void *user, uint8_t *buf, int32_t len)
+{
+    return static_cast<FastEpdFileStream *>(user)->read(buf, len);
+}
+
+/** @brief Shared body of `drawXthFile()`/`drawXtgFile()`: stream the file through the XTC blitters. */
+int32_t draw_xtx_file(const char *path, bool xth, bool fast)
+{
+    if (!path) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, xth ? "drawXthFile: path is null" : "drawXtgFile: path is null");
+        return kWasmErrInvalidArgument;
+    }
+    const int32_t ready_rc = require_epd_ready_or_set_error(
+        xth ? "drawXthFile: framebuffer not ready" : "drawXtgFile: framebuffer not ready");
+    if (ready_rc != kWasmOk) {
+        return ready_rc;
+    }
+    if (g_epd.getMode() != (xth ? BB_MODE_2BPP : BB_MODE_1BPP)) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, xth ? "drawXthFile: unsupported mode (expected 2-bpp)"
+                                                             : "drawXtgFile: unsupported mode (expected 1-bpp)");
+        return kWasmErrInvalidArgument;
+    }
+
+    // The stream embeds its read chunk, too large for the WASM native stack.
+    std::unique_ptr<FastEpdFileStream> stream(new (std::nothrow) FastEpdFileStream());
+    if (!stream) {
+        wasm_api_set_last_error(kWasmErrInternal, xth ? "drawXthFile: out of memory" : "drawXtgFile: out of memory");
+        return kWasmErrInternal;
+    }
+    if (!stream->open(path)) {
+        wasm_api_set_last_error(kWasmErrNotFound, xth ? "drawXthFile: failed to open file" : "drawXtgFile: failed to open file");
+        return kWasmErrNotFound;
+    }
+    const bool ok = xth ? fastepd_xtc::drawXthStream(&g_epd, xtx_file_read, stream.get())
+                        : fastepd_xtc::drawXtgStream(&g_epd, xtx_file_read, stream.get());
+    stream->close();
+    finish_xtx_draw(ok, fast);
+    if (!ok) {
+        wasm_api_set_last_error(kWasmErrInternal, xth ? "drawXthFile: decode failed" : "drawXtgFile: decode failed");
+        return kWasmErrInternal;
+    }
+    return kWasmOk;
+}
+
+/** @brief Body of `drawXtcPage()`: seek the (cached) book to `page` and stream it through the XTC blitters. */
+int32_t draw_xtc_page(const char *path, int32_t page, bool fast)
+{
+    if (!path) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawXtcPage: path is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (page < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawXtcPage: page out of range");
+        return kWasmErrInvalidArgument;
+    }
+    const int32_t ready_rc = require_epd_ready_or_set_error("drawXtcPage: framebuffer not ready");
+    if (ready_rc != kWasmOk) {
+        return ready_rc;
+    }
+
+    // The book embeds a file stream and its read chunk, too large for the WASM native stack.
+    if (!g_xtc_book) {
+        g_xtc_book.reset(new (std::nothrow) FastEpdXtcBook());
+        if (!g_xtc_book) {
+            wasm_api_set_last_error(kWasmErrInternal, "drawXtcPage: out of memory");
+            return kWasmErrInternal;
+        }
+    }
+    switch (g_xtc_book->open(path)) {
+    case FastEpdXtcBook::OpenResult::ok:
+        break;
+    case FastEpdXtcBook::OpenResult::not_found:
+        wasm_api_set_last_error(kWasmErrNotFound, "drawXtcPage: failed to open file");
+        return kWasmErrNotFound;
+    case FastEpdXtcBook::OpenResult::invalid:
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawXtcPage: not an XTC file");
+        return kWasmErrInvalidArgument;
+    case FastEpdXtcBook::OpenResult::no_memory:
+        wasm_api_set_last_error(kWasmErrInternal, "drawXtcPage: out of memory");
+        return kWasmErrInternal;
+    }
+
+    const bool xth = g_xtc_book->header().xth;
+    if (page >= g_xtc_book->header().page_count) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawXtcPage: page out of range");
+        return kWasmErrInvalidArgument;
+    }
+    if (g_epd.getMode() != (xth ? BB_MODE_2BPP : BB_MODE_1BPP)) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, xth ? "drawXtcPage: unsupported mode (XTH book needs 2-bpp)"
+                                                             : "drawXtcPage: unsupported mode (XTG book needs 1-bpp)");
+        return kWasmErrInvalidArgument;
+    }
+    fastepd_xtc_utils::XtcPageEntry entry = {};
+    if (!g_xtc_book->seekPage((uint16_t)page, &entry)) {
+        g_xtc_book->close();
+        wasm_api_set_last_error(kWasmErrInternal, "drawXtcPage: corrupt page index");
+        return kWasmErrInternal;
+    }
+    const bool ok = xth ? fastepd_xtc::drawXthStream(&g_epd, FastEpdXtcBook::readPage, g_xtc_book.get(), entry.md5_8)
+                        : fastepd_xtc::drawXtgStream(&g_epd, FastEpdXtcBook::readPage, g_xtc_book.get(), entry.md5_8);
+    finish_xtx_draw(ok, fast);
+    if (!ok) {
+        // Reopen on the next call in case the book was rewritten under us.
+        g_xtc_book->close();
+        wasm_api_set_last_error(kWasmErrInternal, "drawXtcPage: decode failed");
+        return kWasmErrInternal;
+    }
+    return kWasmOk;
+}
+
+} // namespace
+
+int32_t DisplayFastEpd::drawXtcPage(wasm_exec_env_t exec_env, const char *path, int32_t page, bool fast)
+{
+    (void)exec_env;
+    return draw_xtc_page(path, page, fast);
+}
+
+int32_t DisplayFastEpd::drawXthFile(wasm_exec_env_t exec_env, const char *path, bool fast)
+{
+    (void)exec_env;
+    return draw_xtx_file(path, true, fast);
+}
+
+int32_t DisplayFastEpd::drawXtgFile(wasm_exec_env_t exec_env, const char *path, bool fast)
+{
+    (void)exec_env;
+    return draw_xtx_file(path, false, fast);
+}
+
+namespace {
+
+/** @brief Shared body of `drawXthAt()`/`drawXtgAt()`: blit into the current draw target and mark it dirty. */
+int32_t draw_xtx_at(
+    const uint8_t *ptr,
+    size_t len,
+    bool xth,
+    int32_t x,
+    int32_t y,
+    int32_t src_x,
+    int32_t src_y,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t clip_x,
+    int32_t clip_y,
+    int32_t clip_w,
+    int32_t clip_h)
+{
+    if (!ptr) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, xth ? "drawXthAt: ptr is null" : "drawXtgAt: ptr is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (len == 0 || len > (xth ? kMaxXthBytes : kMaxXtgBytes)) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, xth ? "drawXthAt: invalid len" : "drawXtgAt: invalid len");
+        return kWasmErrInvalidArgument;
+    }
+    const int32_t ready_rc =
+        require_epd_ready_or_set_error(xth ? "drawXthAt: framebuffer not ready" : "drawXtgAt: framebuffer not ready");
+    if (ready_rc != kWasmOk) {
+        return ready_rc;
+    }
+    if (g_draw->getMode() != (xth ? BB_MODE_2BPP : BB_MODE_1BPP)) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, xth ? "drawXthAt: unsupported mode (expected 2-bpp)"
+                                                             : "drawXtgAt: unsupported mode (expected 1-bpp)");
+        return kWasmErrInvalidArgument;
+    }
+
+    // Non-positive sizes mean "to the image edge" for the source and "no clip" for the clip rect.
+    const fastepd_xtc::XtxRect src = {src_x, src_y, src_w > 0 ? src_w : INT32_MAX, src_h > 0 ? src_h : INT32_MAX};
+    const fastepd_xtc::XtxRect clip = {clip_x, clip_y, clip_w, clip_h};
+    const bool use_clip = clip_w > 0 && clip_h > 0;
+    fastepd_xtc::XtxRect drawn = {};
+    const bool ok = xth ? fastepd_xtc::drawXthAt(g_draw, ptr, len, x, y, &src, use_clip ? &clip : nullptr, &drawn)
+                        : fastepd_xtc::drawXtgAt(g_draw, ptr, len, x, y, &src, use_clip ? &clip : nullptr, &drawn);
+    if (!ok) {
+        wasm_api_set_last_error(kWasmErrInternal, xth ? "drawXthAt: decode failed" : "drawXtgAt: decode failed");
+        return kWasmErrInternal;
+    }
+    if (drawn.w > 0 && drawn.h > 0) {
+        mark_dirty(drawn.x, drawn.y, drawn.w, drawn.h);
+    }
+    return kWasmOk;
+}
+
+} // namespace
+
+int32_t DisplayFastEpd::drawXthAt(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t src_x,
+    int32_t src_y,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t clip_x,
+    int32_t clip_y,
+    int32_t clip_w,
+    int32_t clip_h)
+{
+    (void)exec_env;
+    return draw_xtx_at(ptr, len, true, x, y, src_x, src_y, src_w, src_h, clip_x, clip_y, clip_w, clip_h);
+}
+
+int32_t DisplayFastEpd::drawXtgAt(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t src_x,
+    int32_t src_y,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t clip_x,
+    int32_t clip_y,
+    int32_t clip_w,
+    int32_t clip_h)
+{
+    (void)exec_env;
+    return draw_xtx_at(ptr, len, false, x, y, src_x, src_y, src_w, src_h, clip_x, clip_y, clip_w, clip_h);
+}
+
+int32_t DisplayFastEpd::drawJpgFit(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    return draw_jpg_internal(ptr, len, x, y, max_w, max_h, true);
+}
+
+int32_t DisplayFastEpd::drawPngFit(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    return draw_png_internal(ptr, len, x, y, max_w, max_h, true);
+}
+
+namespace {
+
+/** @brief Decoder tags stored in `FastEpdImageCacheKey::kind`. */
+enum class CachedImageKind : int32_t {
+    jpeg = 1,
+    png = 2,
+};
+
+/** @brief Build the cache key of `path` for the current draw target; `false` if the file cannot be stat'ed. */
+bool image_cache_key(CachedImageKind kind, const char *path, int32_t max_w, int32_t max_h, FastEpdImageCacheKey *key)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return false;
+    }
+    key->path = path;
+    key->mtime = (int64_t)st.st_mtime;
+    key->size = (int64_t)st.st_size;
+    key->kind = (int32_t)kind;
+    key->mode = g_draw->getMode();
+    key->dither = (int32_t)g_dither_mode;
+    key->box_w = max_w;
+    key->box_h = max_h;
+    return true;
+}
+
+/** @brief Size of the region a JPEG decode fills with a `max_w` x `max_h` fit box. */
+void jpeg_fit_size(JPEGDEC &jpeg, int32_t max_w, int32_t max_h, int32_t *out_w, int32_t *out_h)
+{
+    const JpegFitPlan plan = plan_jpeg_fit(jpeg.getWidth(), jpeg.getHeight(), max_w, max_h, true);
+    *out_w = plan.out_w < max_w ? plan.out_w : max_w;
+    *out_h = plan.out_h < max_h ? plan.out_h : max_h;
+}
+
+/** @brief Size of the region `draw_png_internal()` fills with a `max_w` x `max_h` fit box. */
+bool png_fit_size(const uint8_t *buf, size_t len, int32_t max_w, int32_t max_h, int32_t *out_w, int32_t *out_h)
+{
+    pngle_t *pngle = lgfx_pngle_new();
+    if (!pngle) {
+        return false;
+    }
+    PngContext ctx = {};
+    ctx.stream.data = buf;
+    ctx.stream.len = len;
+    if (lgfx_pngle_prepare(pngle, epd_png_read, &ctx) < 0) {
+        lgfx_pngle_destroy(pngle);
+        return false;
+    }
+    const int32_t w = (int32_t)lgfx_pngle_get_width(pngle);
+    const int32_t h = (int32_t)lgfx_pngle_get_height(pngle);
+    lgfx_pngle_destroy(pngle);
+    *out_w = w < max_w ? w : max_w;
+    *out_h = h < max_h ? h : max_h;
+    return true;
+}
+
+/** @brief Composite a cached tile into the draw target at `(x, y)`. */
+void blit_cached_image(FASTEPD &tile, int32_t x, int32_t y)
+{
+    fastepd_native_utils::NativeLayout src;
+    fastepd_native_utils::NativeLayout dst;
+    if (!fastepd_native_utils::describeNativeLayout(tile, &src) ||
+        !fastepd_native_utils::describeNativeLayout(*g_draw, &dst)) {
+        return;
+    }
+    // Tiles are decoded in the target's mode, so raw values carry over unchanged.
+    if (fastepd_native_utils::compositeLayout(dst, src, x, y, 0, -1, FastEpdDither::levelLut())) {
+        mark_dirty(x, y, src.logical_w, src.logical_h);
+    }
+}
+
+/** @brief An image file opened for decoding: JPEGs stream from the file, PNGs are read whole. */
+struct ImageFileSource {
+    CachedImageKind kind = CachedImageKind::jpeg;
+    const char *path = nullptr;
+    std::unique_ptr<JPEGDEC> decoder;
+    uint8_t *buf = nullptr;
+    size_t len = 0;
+    int32_t fit_w = 0; ///< Region a decode with the fit box fills, valid if `sized`.
+    int32_t fit_h = 0;
+    bool sized = false;
+
+    ~ImageFileSource()
+    {
+        if (decoder) {
+            decoder->close();
+        }
+        free(buf);
+    }
+};
+
+/** @brief Open `path` and size its fit box; `false` if the file cannot be read as `kind`. */
+bool open_image_file(CachedImageKind kind, const char *path, int32_t max_w, int32_t max_h, ImageFileSource *src)
+{
+    src->kind = kind;
+    src->path = path;
+    if (kind == CachedImageKind::jpeg) {
+        src->decoder = open_jpeg_file(path);
+        if (!src->decoder) {
+            return false;
+        }
+        jpeg_fit_size(*src->decoder, max_w, max_h, &src->fit_w, &src->fit_h);
+        src->sized = true;
+        return true;
+    }
+    if (!read_file_all(path, &src->buf, &src->len, kMaxPngBytes)) {
+        return false;
+    }
+    src->sized = png_fit_size(src->buf, src->len, max_w, max_h, &src->fit_w, &src->fit_h);
+    return true;
+}
+
+/** @brief Decode `src` into `target` at `(x, y)` through the regular draw path and dither settings. */
+int32_t decode_image_file(
+    ImageFileSource &src,
+    FASTEPD *target,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h)
+{
+    FASTEPD *prev = g_draw;
+    g_draw = target;
+    JpegSource source;
+    source.path = src.path;
+    const int32_t rc = (src.kind == CachedImageKind::jpeg)
+        ? draw_jpg_decoder(*src.decoder, source, x, y, max_w, max_h, true)
+        : draw_png_internal(src.buf, src.len, x, y, max_w, max_h, true);
+    g_draw = prev;
+    return rc;
+}
+
+/**
+ * @brief Pre-dithered copy of `path` that `convertJpgFile()`/`convertPngFile()` write for FastEPD `mode`.
+ *
+ * The dither mode is part of the name, so a copy made under another mode is never picked up.
+ */
+std::string image_sidecar_path(const char *path, int32_t mode, DisplayDitherMode dither)
+{
+    const char *dither_name = "none";
+    switch (dither) {
+        case DisplayDitherMode::none:
+            break;
+        case DisplayDitherMode::bayer:
+            dither_name = "bayer";
+            break;
+        case DisplayDitherMode::blueNoise:
+            dither_name = "bluenoise";
+            break;
+        case DisplayDitherMode::diffusion:
+            dither_name = "diffusion";
+            break;
+    }
+    return std::string(path) + "." + dither_name + (mode == BB_MODE_2BPP ? ".xth" : ".xtg");
+}
+
+/** @brief Fit size of a PNG from its IHDR chunk alone; `false` if the file does not start like a PNG. */
+bool png_file_fit_size(const char *path, int32_t max_w, int32_t max_h, int32_t *out_w, int32_t *out_h)
+{
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t head[24];
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    const bool read = fread(head, 1, sizeof(head), f) == sizeof(head);
+    fclose(f);
+    if (!read || memcmp(head, kSignature, sizeof(kSignature)) != 0 || memcmp(head + 12, "IHDR", 4) != 0) {
+        return false;
+    }
+    const uint32_t w = ((uint32_t)head[16] << 24) | ((uint32_t)head[17] << 16) | ((uint32_t)head[18] << 8) | head[19];
+    const uint32_t h = ((uint32_t)head[20] << 24) | ((uint32_t)head[21] << 16) | ((uint32_t)head[22] << 8) | head[23];
+    *out_w = w < (uint32_t)max_w ? (int32_t)w : max_w;
+    *out_h = h < (uint32_t)max_h ? (int32_t)h : max_h;
+    return true;
+}
+
+/**
+ * @brief Draw the pre-dithered copy of `path` at `(x, y)` instead of decoding it, if there is a usable one.
+ *
+ * The copy must match the target's mode and the current dither mode, be at least as new as the source (`src_mtime`) and
+ * have exactly the size a decode into the `max_w` x `max_h` box would fill; only the source's
+ * header is read to check that. Returns `false` without touching the target otherwise.
+ */
+bool draw_image_sidecar(
+    CachedImageKind kind,
+    const char *path,
+    int64_t src_mtime,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h)
+{
+    const int32_t mode = g_draw->getMode();
+    if (mode != BB_MODE_1BPP && mode != BB_MODE_2BPP) {
+        return false;
+    }
+    const bool xth = (mode == BB_MODE_2BPP);
+    const std::string sidecar = image_sidecar_path(path, mode, g_dither_mode);
+    struct stat st;
+    if (stat(sidecar.c_str(), &st) != 0 || (int64_t)st.st_mtime < src_mtime) {
+        return false;
+    }
+
+    int32_t fit_w = 0;
+    int32_t fit_h = 0;
+    if (kind == CachedImageKind::jpeg) {
+        std::unique_ptr<JPEGDEC> jpeg = open_jpeg_file(path);
+        if (!jpeg) {
+            return false;
+        }
+        jpeg_fit_size(*jpeg, max_w, max_h, &fit_w, &fit_h);
+        jpeg->close();
+    } else if (!png_file_fit_size(path, max_w, max_h, &fit_w, &fit_h)) {
+        return false;
+    }
+
+    uint8_t *buf = nullptr;
+    size_t len = 0;
+    if (!read_file_all(sidecar.c_str(), &buf, &len, xth ? kMaxXthBytes : kMaxXtgBytes)) {
+        return false;
+    }
+    fastepd_xtc_utils::XtxImageHeader hdr = {};
+    const uint8_t *payload = nullptr;
+    const bool parsed = xth ? fastepd_xtc_utils::parseXthHeader(buf, len, &hdr, &payload)
+                            : fastepd_xtc_utils::parseXtgHeader(buf, len, &hdr, &payload);
+    fastepd_xtc::XtxRect drawn = {};
+    bool ok = parsed && hdr.width == fit_w && hdr.height == fit_h;
+    if (ok) {
+        ok = xth ? fastepd_xtc::drawXthAt(g_draw, buf, len, x, y, nullptr, nullptr, &drawn)
+                 : fastepd_xtc::drawXtgAt(g_draw, buf, len, x, y, nullptr, nullptr, &drawn);
+    }
+    free(buf);
+    if (ok && drawn.w > 0 && drawn.h > 0) {
+        mark_dirty(drawn.x, drawn.y, drawn.w, drawn.h);
+    }
+    return ok;
+}
+
+/**
+ * @brief Shared body of `drawJpgFile()`/`drawPngFile()`.
+ *
+ * A cache hit composites the stored tile, and a current pre-dithered copy from
+ * `convertJpgFile()`/`convertPngFile()` is blitted as is. Otherwise the image is decoded into a
+ * fresh sprite instead of the target, composited, and handed to `g_image_cache`; if the file
+ * cannot be stat'ed or no sprite fits in memory, it is decoded straight into the target as before.
+ */
+int32_t draw_image_file(CachedImageKind kind, const char *path, int32_t x, int32_t y, int32_t max_w, int32_t max_h)
+{
+    const bool jpeg = (kind == CachedImageKind::jpeg);
+    const int32_t ready_rc =
+        require_epd_ready_or_set_error(jpeg ? "drawJpgFile: display not ready" : "drawPngFile: display not ready");
+    if (ready_rc != kWasmOk) {
+        return ready_rc;
+    }
+
+    FastEpdImageCacheKey key;
+    const bool cacheable = image_cache_key(kind, path, max_w, max_h, &key);
+    if (cacheable) {
+        FASTEPD *tile = g_image_cache.find(key);
+        if (tile) {
+            blit_cached_image(*tile, x, y);
+            return kWasmOk;
+        }
+        if (draw_image_sidecar(kind, path, key.mtime, x, y, max_w, max_h)) {
+            return kWasmOk;
+        }
+    }
+
+    ImageFileSource src;
+    if (!open_image_file(kind, path, max_w, max_h, &src)) {
+        wasm_api_set_last_error(kWasmErrNotFound,
+            jpeg ? "drawJpgFile: failed to open file as JPEG" : "drawPngFile: failed to read file");
+        return kWasmErrNotFound;
+    }
+
+    std::unique_ptr<FASTEPD> tile;
+    if (cacheable && src.sized && src.fit_w > 0 && src.fit_h > 0) {
+        tile = fastepd_sprite_create(src.fit_w, src.fit_h, g_draw->getMode());
+    }
+    const int32_t rc = tile ? decode_image_file(src, tile.get(), 0, 0, max_w, max_h)
+                            : decode_image_file(src, g_draw, x, y, max_w, max_h);
+
+    if (tile) {
+        if (rc == kWasmOk) {
+            blit_cached_image(*tile, x, y);
+            (void)g_image_cache.insert(key, std::move(tile));
+        } else {
+            fastepd_sprite_destroy(tile);
+        }
+    }
+    return rc;
+}
+
+/**
+ * @brief Shared body of `convertJpgFile()`/`convertPngFile()`.
+ *
+ * Decodes `path` on the calling task through the regular pipeline (current dither mode) into a
+ * sprite of public mode `mode` (0 = 1-bpp, 1 = 2-bpp), encodes it as XTG/XTH and leaves the SD
+ * write to `g_convert_writer`. The decoder and dither state belong to the app task, so only
+ * the write runs in the background.
+ */
+int32_t convert_image_file(CachedImageKind kind, const char *path, int32_t mode, int32_t max_w, int32_t max_h)
+{
+    const bool jpeg = (kind == CachedImageKind::jpeg);
+    if (!path) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, jpeg ? "convertJpgFile: path is null" : "convertPngFile: path is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (mode != 0 && mode != 1) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument,
+            jpeg ? "convertJpgFile: mode must be 0 (1-bpp) or 1 (2-bpp)" : "convertPngFile: mode must be 0 (1-bpp) or 1 (2-bpp)");
+        return kWasmErrInvalidArgument;
+    }
+    if (max_w <= 0 || max_h <= 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument,
+            jpeg ? "convertJpgFile: max_w/max_h must be > 0" : "convertPngFile: max_w/max_h must be > 0");
+        return kWasmErrInvalidArgument;
+    }
+    const int32_t ready_rc =
+        require_epd_ready_or_set_error(jpeg ? "convertJpgFile: display not ready" : "convertPngFile: display not ready");
+    if (ready_rc != kWasmOk) {
+        return ready_rc;
+    }
+    if (g_convert_writer.status() == FastEpdFileWriter::kWriting) {
+        wasm_api_set_last_error(kWasmErrNotReady,
+            jpeg ? "convertJpgFile: previous conversion still writing" : "convertPngFile: previous conversion still writing");
+        return kWasmErrNotReady;
+    }
+
+    ImageFileSource src;
+    if (!open_image_file(kind, path, max_w, max_h, &src)) {
+        wasm_api_set_last_error(kWasmErrNotFound,
+            jpeg ? "convertJpgFile: failed to open file as JPEG" : "convertPngFile: failed to read file");
+        return kWasmErrNotFound;
+    }
+    if (!src.sized || src.fit_w <= 0 || src.fit_h <= 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument,
+            jpeg ? "convertJpgFile: invalid image" : "convertPngFile: invalid image");
+        return kWasmErrInvalidArgument;
+    }
+    const int32_t bb_mode = (mode == 0) ? BB_MODE_1BPP : BB_MODE_2BPP;
+    std::unique_ptr<FASTEPD> tile = fastepd_sprite_create(src.fit_w, src.fit_h, bb_mode);
+    if (!tile) {
+        wasm_api_set_last_error(kWasmErrInternal, jpeg ? "convertJpgFile: out of memory" : "convertPngFile: out of memory");
+        return kWasmErrInternal;
+    }
+    const int32_t rc = decode_image_file(src, tile.get(), 0, 0, max_w, max_h);
+    size_t size = 0;
+    uint8_t *file = (rc == kWasmOk) ? fastepd_xtc::encodeXtx(tile.get(), &size) : nullptr;
+    fastepd_sprite_destroy(tile);
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (!file) {
+        wasm_api_set_last_error(kWasmErrInternal, jpeg ? "convertJpgFile: encode failed" : "convertPngFile: encode failed");
+        return kWasmErrInternal;
+    }
+    if (!g_convert_writer.start(image_sidecar_path(path, bb_mode, g_dither_mode).c_str(), file, size)) {
+        free(file);
+        wasm_api_set_last_error(kWasmErrInternal,
+            jpeg ? "convertJpgFile: failed to start writer" : "convertPngFile: failed to start writer");
+        return kWasmErrInternal;
+    }
+    return kWasmOk;
+}
+
+} // namespace
+
+int32_t DisplayFastEpd::drawJpgFile(
+    wasm_exec_env_t exec_env,
+    const char *path,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    if (x < 0 || y < 0 || max_w < 0 || max_h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawJpgFile: negative coordinates/size");
+        return kWasmErrInvalidArgument;
+    }
+    if (!path) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawJpgFile: path is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (max_w == 0 || max_h == 0) {
+        return kWasmOk;
+    }
+    return draw_image_file(CachedImageKind::jpeg, path, x, y, max_w, max_h);
+}
+
+int32_t DisplayFastEpd::drawPngFile(
+    wasm_exec_env_t exec_env,
+    const char *path,
+    int32_t x,
+    int32_t y,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    if (x < 0 || y < 0 || max_w < 0 || max_h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawPngFile: negative coordinates/size");
+        return kWasmErrInvalidArgument;
+    }
+    if (!path) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawPngFile: path is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (max_w == 0 || max_h == 0) {
+        return kWasmOk;
+    }
+    return draw_image_file(CachedImageKind::png, path, x, y, max_w, max_h);
+}
+
+int32_t DisplayFastEpd::convertJpgFile(
+    wasm_exec_env_t exec_env,
+    const char *path,
+    int32_t mode,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    return convert_image_file(CachedImageKind::jpeg, path, mode, max_w, max_h);
+}
+
+int32_t DisplayFastEpd::convertPngFile(
+    wasm_exec_env_t exec_env,
+    const char *path,
+    int32_t mode,
+    int32_t max_w,
+    int32_t max_h)
+{
+    (void)exec_env;
+    return convert_image_file(CachedImageKind::png, path, mode, max_w, max_h);
+}
+
+int32_t DisplayFastEpd::convertStatus(wasm_exec_env_t exec_env)
+{
+    (void)exec_env;
+    return g_convert_writer.status();
+}
+
+namespace {
+
+/** @brief Quantize RGB888 to the active FastEPD mode. */
+uint8_t rgb888_to_epd_color(int32_t rgb888)
+{
+    return gray8_to_epd_color(rgb888_to_gray8(rgb888), g_draw->getMode());
+}
+
+/** @brief RGB888 as the fill of a filled primitive in the active FastEPD mode. */
+EpdPaint rgb888_to_epd_paint(int32_t rgb888)
+{
+    const uint8_t gray = rgb888_to_gray8(rgb888);
+    return EpdPaint{gray8_to_epd_color(gray, g_draw->getMode()), gray};
+}
+
+/** @brief Make `target` the drawing target and carry the app's bitmap-font attributes over to it. */
+void select_draw_target(FASTEPD *target)
+{
+    g_draw = target;
+    if (g_legacy_text.font_id >= 0) {
+        target->setFont(g_legacy_text.font_id);
+    }
+    if (g_legacy_text.color_set) {
+        const FastEpdVlwTextState &state = g_vlw_runtime.text_state;
+        const int32_t mode = target->getMode();
+        const int fg = (int)gray8_to_epd_color(rgb888_to_gray8(state.fg_rgb888), mode);
+        const int bg = state.use_bg ? (int)gray8_to_epd_color(rgb888_to_gray8(state.bg_rgb888), mode) : BBEP_TRANSPARENT;
+        target->setTextColor(fg, bg);
+    }
+    if (g_legacy_text.wrap_set) {
+        target->setTextWrap(g_legacy_text.wrap);
+    }
+}
+
+// Primitive bodies shared by the per-call API and `submitCommands()`. They assume the
+// framebuffer is ready and take a color already quantized for the active mode.
+
+int32_t draw_pixel_epd(int32_t x, int32_t y, uint8_t color)
+{
+    const int32_t w = (int32_t)g_draw->width();
+    const int32_t h = (int32_t)g_draw->height();
+    if (x < 0 || y < 0 || x >= w || y >= h) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawPixel: coordinates out of bounds");
+        return kWasmErrInvalidArgument;
+    }
+    g_draw->drawPixel(x, y, color);
+    mark_dirty(x, y, 1, 1);
+    return kWasmOk;
+}
+
+int32_t draw_line_epd(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t color)
+{
+    if (x0 == x1 || y0 == y1) {
+        // Axis-aligned: a one-pixel-thick rect, written as packed spans.
+        const int32_t lx = x0 < x1 ? x0 : x1;
+        const int32_t ly = y0 < y1 ? y0 : y1;
+        fill_rect_native(lx, ly, (int32_t)((int64_t)(x0 < x1 ? x1 : x0) - lx + 1),
+            (int32_t)((int64_t)(y0 < y1 ? y1 : y0) - ly + 1), color);
+        mark_dirty_points(x0, y0, x1, y1);
+        return kWasmOk;
+    }
+    g_draw->drawLine(x0, y0, x1, y1, (int)color);
+    mark_dirty_points(x0, y0, x1, y1);
+    return kWasmOk;
+}
+
+int32_t draw_rect_epd(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t color)
+{
+    if (w < 0 || h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawRect: negative size");
         return kWasmErrInvalidArgument;
     }
-    fastepd_xtc::drawXth(&g_epd, ptr, len, fast);
-    return 0;
+    if (w > 0 && h > 0) {
+        fill_rect_native(x, y, w, 1, color);
+        fill_rect_native(x, y + h - 1, w, 1, color);
+        fill_rect_native(x, y, 1, h, color);
+        fill_rect_native(x + w - 1, y, 1, h, color);
+    }
+    mark_dirty(x, y, w, h);
+    return kWasmOk;
 }
 
-int32_t DisplayFastEpd::drawXtg(wasm_exec_env_t exec_env, const uint8_t *ptr, size_t len, bool fast)
+int32_t fill_rect_epd(int32_t x, int32_t y, int32_t w, int32_t h, const EpdPaint &paint)
 {
-    if (!ptr && len != 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xtg: ptr is null");
+    if (w < 0 || h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillRect: negative size");
         return kWasmErrInvalidArgument;
     }
-    if (len == 0 || len > kMaxXtgBytes) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xtg: invalid len");
+    fill_rect_paint(x, y, w, h, paint);
+    mark_dirty(x, y, w, h);
+    return kWasmOk;
+}
+
+int32_t draw_round_rect_epd(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint8_t color)
+{
+    if (w < 0 || h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawRoundRect: negative size");
         return kWasmErrInvalidArgument;
     }
-    const int32_t ready_rc = require_epd_ready_or_set_error("draw_xtg: framebuffer not ready");
-    if (ready_rc != kWasmOk) {
-        return ready_rc;
-    }
-    if (g_epd.getMode() != BB_MODE_1BPP) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "draw_xtg: unsupported mode (expected 1-bpp)");
+    g_draw->drawRoundRect(x, y, w, h, r, color);
+    mark_dirty(x, y, w, h);
+    return kWasmOk;
+}
+
+int32_t fill_round_rect_epd(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint8_t color)
+{
+    if (w < 0 || h < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillRoundRect: negative size");
         return kWasmErrInvalidArgument;
     }
-    fastepd_xtc::drawXtg(&g_epd, ptr, len, fast);
-    return 0;
+    g_draw->fillRoundRect(x, y, w, h, r, color);
+    mark_dirty(x, y, w, h);
+    return kWasmOk;
 }
 
-int32_t DisplayFastEpd::drawJpgFit(
-    wasm_exec_env_t exec_env,
-    const uint8_t *ptr,
-    size_t len,
-    int32_t x,
-    int32_t y,
-    int32_t max_w,
-    int32_t max_h)
+int32_t draw_circle_epd(int32_t x, int32_t y, int32_t r, uint8_t color)
 {
-    (void)exec_env;
-    return draw_jpg_internal(ptr, len, x, y, max_w, max_h, true);
+    g_draw->drawCircle(x, y, r, (uint32_t)color);
+    mark_dirty_around(x, y, r, r);
+    return kWasmOk;
 }
 
-int32_t DisplayFastEpd::drawPngFit(
-    wasm_exec_env_t exec_env,
-    const uint8_t *ptr,
-    size_t len,
-    int32_t x,
-    int32_t y,
-    int32_t max_w,
-    int32_t max_h)
+int32_t fill_circle_epd(int32_t x, int32_t y, int32_t r, uint8_t color)
 {
-    (void)exec_env;
-    return draw_png_internal(ptr, len, x, y, max_w, max_h, true);
+    g_draw->fillCircle(x, y, r, (uint32_t)color);
+    mark_dirty_around(x, y, r, r);
+    return kWasmOk;
 }
 
-int32_t DisplayFastEpd::drawJpgFile(
-    wasm_exec_env_t exec_env,
-    const char *path,
-    int32_t x,
-    int32_t y,
-    int32_t max_w,
-    int32_t max_h)
+int32_t fill_arc_epd(int32_t x, int32_t y, int32_t r0, int32_t r1, float angle0, float angle1, uint8_t color)
 {
-    (void)exec_env;
-    if (x < 0 || y < 0 || max_w < 0 || max_h < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawJpgFile: negative coordinates/size");
+    if (r0 < 0 || r1 < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillArc: r0 < 0 or r1 < 0");
         return kWasmErrInvalidArgument;
     }
-    if (!path) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawJpgFile: path is null");
+    if (r1 > r0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillArc: r1 > r0");
         return kWasmErrInvalidArgument;
     }
-    if (max_w == 0 || max_h == 0) {
+    if (r0 == r1) {
         return kWasmOk;
     }
-
-    uint8_t *buf = nullptr;
-    size_t len = 0;
-    if (!read_file_all(path, &buf, &len, kMaxJpgBytes)) {
-        wasm_api_set_last_error(kWasmErrNotFound, "drawJpgFile: failed to read file");
-        return kWasmErrNotFound;
-    }
-    const int32_t rc = draw_jpg_internal(buf, len, x, y, max_w, max_h, true);
-    free(buf);
-    return rc;
+    display_fastepd_fill_arc(*g_draw, x, y, r0, r1, angle0, angle1, color);
+    mark_dirty_around(x, y, r0, r0);
+    return kWasmOk;
 }
 
-int32_t DisplayFastEpd::drawPngFile(
-    wasm_exec_env_t exec_env,
-    const char *path,
-    int32_t x,
-    int32_t y,
-    int32_t max_w,
-    int32_t max_h)
+int32_t draw_ellipse_epd(int32_t x, int32_t y, int32_t rx, int32_t ry, uint8_t color)
 {
-    (void)exec_env;
-    if (x < 0 || y < 0 || max_w < 0 || max_h < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawPngFile: negative coordinates/size");
+    if (rx < 0 || ry < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawEllipse: rx < 0 or ry < 0");
         return kWasmErrInvalidArgument;
     }
-    if (!path) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawPngFile: path is null");
+    draw_ellipse_outline(x, y, rx, ry, color);
+    mark_dirty_around(x, y, rx, ry);
+    return kWasmOk;
+}
+
+int32_t fill_ellipse_epd(int32_t x, int32_t y, int32_t rx, int32_t ry, const EpdPaint &paint)
+{
+    if (rx < 0 || ry < 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillEllipse: rx < 0 or ry < 0");
         return kWasmErrInvalidArgument;
     }
-    if (max_w == 0 || max_h == 0) {
-        return kWasmOk;
-    }
+    fill_ellipse_scanlines(x, y, rx, ry, paint);
+    mark_dirty_around(x, y, rx, ry);
+    return kWasmOk;
+}
 
-    uint8_t *buf = nullptr;
-    size_t len = 0;
-    if (!read_file_all(path, &buf, &len, kMaxPngBytes)) {
-        wasm_api_set_last_error(kWasmErrNotFound, "drawPngFile: failed to read file");
-        return kWasmErrNotFound;
-    }
-    const int32_t rc = draw_png_internal(buf, len, x, y, max_w, max_h, true);
-    free(buf);
-    return rc;
+int32_t draw_triangle_epd(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint8_t color)
+{
+    g_draw->drawLine(x0, y0, x1, y1, (int)color);
+    g_draw->drawLine(x1, y1, x2, y2, (int)color);
+    g_draw->drawLine(x2, y2, x0, y0, (int)color);
+    mark_dirty_points(x0, y0, x1, y1, x2, y2);
+    return kWasmOk;
+}
+
+int32_t fill_triangle_epd(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const EpdPaint &paint)
+{
+    mark_dirty_points(x0, y0, x1, y1, x2, y2);
+    return filled_triangle(x0, y0, x1, y1, x2, y2, paint);
+}
+
+float command_float(int32_t bits)
+{
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
 }
 
+} // namespace
+
 int32_t DisplayFastEpd::drawPixel(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t rgb888)
 {
     (void)exec_env;
@@ -1792,16 +3899,7 @@ int32_t DisplayFastEpd::drawPixel(wasm_exec_env_t exec_env, int32_t x, int32_t y
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t w = (int32_t)g_epd.width();
-    const int32_t h = (int32_t)g_epd.height();
-    if (x < 0 || y < 0 || x >= w || y >= h) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawPixel: coordinates out of bounds");
-        return kWasmErrInvalidArgument;
-    }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.drawPixel(x, y, color);
-    return kWasmOk;
+    return draw_pixel_epd(x, y, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::drawLine(wasm_exec_env_t exec_env, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t rgb888)
@@ -1811,10 +3909,7 @@ int32_t DisplayFastEpd::drawLine(wasm_exec_env_t exec_env, int32_t x0, int32_t y
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.drawLine(x0, y0, x1, y1, (int)color);
-    return kWasmOk;
+    return draw_line_epd(x0, y0, x1, y1, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::drawFastVline(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t h, int32_t rgb888)
@@ -1842,14 +3937,7 @@ int32_t DisplayFastEpd::drawRect(wasm_exec_env_t exec_env, int32_t x, int32_t y,
     if (rc != kWasmOk) {
         return rc;
     }
-    if (w < 0 || h < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawRect: negative size");
-        return kWasmErrInvalidArgument;
-    }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.drawRect(x, y, w, h, color);
-    return kWasmOk;
+    return draw_rect_epd(x, y, w, h, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::fillRect(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t w, int32_t h, int32_t rgb888)
@@ -1859,14 +3947,7 @@ int32_t DisplayFastEpd::fillRect(wasm_exec_env_t exec_env, int32_t x, int32_t y,
     if (rc != kWasmOk) {
         return rc;
     }
-    if (w < 0 || h < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillRect: negative size");
-        return kWasmErrInvalidArgument;
-    }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.fillRect(x, y, w, h, color);
-    return kWasmOk;
+    return fill_rect_epd(x, y, w, h, rgb888_to_epd_paint(rgb888));
 }
 
 int32_t DisplayFastEpd::drawRoundRect(
@@ -1883,14 +3964,7 @@ int32_t DisplayFastEpd::drawRoundRect(
     if (rc != kWasmOk) {
         return rc;
     }
-    if (w < 0 || h < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawRoundRect: negative size");
-        return kWasmErrInvalidArgument;
-    }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.drawRoundRect(x, y, w, h, r, color);
-    return kWasmOk;
+    return draw_round_rect_epd(x, y, w, h, r, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::fillRoundRect(
@@ -1907,14 +3981,7 @@ int32_t DisplayFastEpd::fillRoundRect(
     if (rc != kWasmOk) {
         return rc;
     }
-    if (w < 0 || h < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillRoundRect: negative size");
-        return kWasmErrInvalidArgument;
-    }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.fillRoundRect(x, y, w, h, r, color);
-    return kWasmOk;
+    return fill_round_rect_epd(x, y, w, h, r, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::drawCircle(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t r, int32_t rgb888)
@@ -1924,10 +3991,7 @@ int32_t DisplayFastEpd::drawCircle(wasm_exec_env_t exec_env, int32_t x, int32_t
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.drawCircle(x, y, r, (uint32_t)color);
-    return kWasmOk;
+    return draw_circle_epd(x, y, r, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::fillCircle(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t r, int32_t rgb888)
@@ -1937,10 +4001,7 @@ int32_t DisplayFastEpd::fillCircle(wasm_exec_env_t exec_env, int32_t x, int32_t
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.fillCircle(x, y, r, (uint32_t)color);
-    return kWasmOk;
+    return fill_circle_epd(x, y, r, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::fillArc(
@@ -1958,22 +4019,7 @@ int32_t DisplayFastEpd::fillArc(
     if (rc != kWasmOk) {
         return rc;
     }
-    if (r0 < 0 || r1 < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillArc: r0 < 0 or r1 < 0");
-        return kWasmErrInvalidArgument;
-    }
-    if (r1 > r0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillArc: r1 > r0");
-        return kWasmErrInvalidArgument;
-    }
-    if (r0 == r1) {
-        return kWasmOk;
-    }
-
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    display_fastepd_fill_arc(g_epd, x, y, r0, r1, angle0, angle1, color);
-    return kWasmOk;
+    return fill_arc_epd(x, y, r0, r1, angle0, angle1, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::drawEllipse(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t rx, int32_t ry, int32_t rgb888)
@@ -1983,14 +4029,7 @@ int32_t DisplayFastEpd::drawEllipse(wasm_exec_env_t exec_env, int32_t x, int32_t
     if (rc != kWasmOk) {
         return rc;
     }
-    if (rx < 0 || ry < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "drawEllipse: rx < 0 or ry < 0");
-        return kWasmErrInvalidArgument;
-    }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    draw_ellipse_outline(x, y, rx, ry, color);
-    return kWasmOk;
+    return draw_ellipse_epd(x, y, rx, ry, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::fillEllipse(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t rx, int32_t ry, int32_t rgb888)
@@ -2000,14 +4039,7 @@ int32_t DisplayFastEpd::fillEllipse(wasm_exec_env_t exec_env, int32_t x, int32_t
     if (rc != kWasmOk) {
         return rc;
     }
-    if (rx < 0 || ry < 0) {
-        wasm_api_set_last_error(kWasmErrInvalidArgument, "fillEllipse: rx < 0 or ry < 0");
-        return kWasmErrInvalidArgument;
-    }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    fill_ellipse_scanlines(x, y, rx, ry, color);
-    return kWasmOk;
+    return fill_ellipse_epd(x, y, rx, ry, rgb888_to_epd_paint(rgb888));
 }
 
 int32_t DisplayFastEpd::drawTriangle(
@@ -2025,12 +4057,7 @@ int32_t DisplayFastEpd::drawTriangle(
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    g_epd.drawLine(x0, y0, x1, y1, (int)color);
-    g_epd.drawLine(x1, y1, x2, y2, (int)color);
-    g_epd.drawLine(x2, y2, x0, y0, (int)color);
-    return kWasmOk;
+    return draw_triangle_epd(x0, y0, x1, y1, x2, y2, rgb888_to_epd_color(rgb888));
 }
 
 int32_t DisplayFastEpd::fillTriangle(
@@ -2048,7 +4075,209 @@ int32_t DisplayFastEpd::fillTriangle(
     if (rc != kWasmOk) {
         return rc;
     }
-    const int32_t mode = g_epd.getMode();
-    const uint8_t color = gray8_to_epd_color(rgb888_to_gray8(rgb888), mode);
-    return filled_triangle(x0, y0, x1, y1, x2, y2, color);
+    return fill_triangle_epd(x0, y0, x1, y1, x2, y2, rgb888_to_epd_paint(rgb888));
+}
+
+int32_t DisplayFastEpd::submitCommands(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    DisplayCommandRect *out_dirty,
+    int32_t *out_executed)
+{
+    (void)exec_env;
+    if (out_executed) {
+        *out_executed = 0;
+    }
+    uint32_t count = 0;
+    int32_t rc = display_commands_validate(ptr, len, &count);
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    rc = require_epd_ready_or_set_error("displaySubmitCommands: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+
+    // Every mark_dirty() below also grows the caller's rect.
+    g_batch_bounds = out_dirty;
+    int32_t last_rgb888 = 0;
+    EpdPaint paint = rgb888_to_epd_paint(0);
+    uint8_t color = paint.color;
+    std::string text;
+    DisplayCommandReader reader(ptr, len);
+    DisplayCommand cmd;
+    int32_t executed = 0;
+    while (reader.next(&cmd)) {
+        const int32_t *a = cmd.args;
+        const int color_index = display_commands_color_index(cmd.op);
+        if (color_index >= 0 && a[color_index] != last_rgb888) {
+            last_rgb888 = a[color_index];
+            paint = rgb888_to_epd_paint(last_rgb888);
+            color = paint.color;
+        }
+        switch (cmd.op) {
+            case DisplayCommandOp::pixel:
+                rc = draw_pixel_epd(a[0], a[1], color);
+                break;
+            case DisplayCommandOp::line:
+                rc = draw_line_epd(a[0], a[1], a[2], a[3], color);
+                break;
+            case DisplayCommandOp::fastVline:
+                rc = a[2] > 0 ? draw_line_epd(a[0], a[1], a[0], a[1] + a[2] - 1, color) : kWasmOk;
+                break;
+            case DisplayCommandOp::fastHline:
+                rc = a[2] > 0 ? draw_line_epd(a[0], a[1], a[0] + a[2] - 1, a[1], color) : kWasmOk;
+                break;
+            case DisplayCommandOp::rect:
+                rc = draw_rect_epd(a[0], a[1], a[2], a[3], color);
+                break;
+            case DisplayCommandOp::fillRect:
+                rc = fill_rect_epd(a[0], a[1], a[2], a[3], paint);
+                break;
+            case DisplayCommandOp::roundRect:
+                rc = draw_round_rect_epd(a[0], a[1], a[2], a[3], a[4], color);
+                break;
+            case DisplayCommandOp::fillRoundRect:
+                rc = fill_round_rect_epd(a[0], a[1], a[2], a[3], a[4], color);
+                break;
+            case DisplayCommandOp::circle:
+                rc = draw_circle_epd(a[0], a[1], a[2], color);
+                break;
+            case DisplayCommandOp::fillCircle:
+                rc = fill_circle_epd(a[0], a[1], a[2], color);
+                break;
+            case DisplayCommandOp::fillArc:
+                rc = fill_arc_epd(a[0], a[1], a[2], a[3], command_float(a[4]), command_float(a[5]), color);
+                break;
+            case DisplayCommandOp::ellipse:
+                rc = draw_ellipse_epd(a[0], a[1], a[2], a[3], color);
+                break;
+            case DisplayCommandOp::fillEllipse:
+                rc = fill_ellipse_epd(a[0], a[1], a[2], a[3], paint);
+                break;
+            case DisplayCommandOp::triangle:
+                rc = draw_triangle_epd(a[0], a[1], a[2], a[3], a[4], a[5], color);
+                break;
+            case DisplayCommandOp::fillTriangle:
+                rc = fill_triangle_epd(a[0], a[1], a[2], a[3], a[4], a[5], paint);
+                break;
+            case DisplayCommandOp::textColor:
+                set_text_color_epd(a[0], a[1], a[2]);
+                rc = kWasmOk;
+                break;
+            case DisplayCommandOp::text:
+                rc = draw_string_epd(cmd.text, cmd.text_len, a[0], a[1], &text);
+                break;
+        }
+        if (rc < 0) {
+            break;
+        }
+        ++executed;
+    }
+    g_batch_bounds = nullptr;
+    if (out_executed) {
+        *out_executed = executed;
+    }
+    return rc < 0 ? rc : executed;
+}
+
+int32_t DisplayFastEpd::canvasCreate(wasm_exec_env_t exec_env, int32_t w, int32_t h)
+{
+    (void)exec_env;
+    const int32_t rc = require_epd_ready_or_set_error("canvasCreate: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    return g_canvases.create(w, h, g_epd.getMode());
+}
+
+int32_t DisplayFastEpd::canvasDestroy(wasm_exec_env_t exec_env, int32_t handle)
+{
+    (void)exec_env;
+    FASTEPD *canvas = g_canvases.get(handle);
+    if (!canvas) {
+        wasm_api_set_last_error(kWasmErrNotFound, "canvasDestroy: unknown handle");
+        return kWasmErrNotFound;
+    }
+    if (g_draw == canvas) {
+        select_draw_target(&g_epd);
+    }
+    (void)g_canvases.destroy(handle);
+    return kWasmOk;
+}
+
+int32_t DisplayFastEpd::canvasSelect(wasm_exec_env_t exec_env, int32_t handle)
+{
+    (void)exec_env;
+    const int32_t rc = require_epd_ready_or_set_error("canvasSelect: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    FASTEPD *target = (handle == 0) ? &g_epd : g_canvases.get(handle);
+    if (!target) {
+        wasm_api_set_last_error(kWasmErrNotFound, "canvasSelect: unknown handle");
+        return kWasmErrNotFound;
+    }
+    if (target != g_draw) {
+        select_draw_target(target);
+    }
+    return kWasmOk;
+}
+
+int32_t DisplayFastEpd::canvasPush(
+    wasm_exec_env_t exec_env,
+    int32_t handle,
+    int32_t x,
+    int32_t y,
+    int32_t rotation,
+    int32_t transparent_rgb888,
+    int32_t use_transparent)
+{
+    (void)exec_env;
+    if (rotation < 0 || rotation > 3) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "canvasPush: rotation out of range (expected 0..3)");
+        return kWasmErrInvalidArgument;
+    }
+    const int32_t rc = require_epd_ready_or_set_error("canvasPush: display not ready");
+    if (rc != kWasmOk) {
+        return rc;
+    }
+    FASTEPD *canvas = g_canvases.get(handle);
+    if (!canvas) {
+        wasm_api_set_last_error(kWasmErrNotFound, "canvasPush: unknown handle");
+        return kWasmErrNotFound;
+    }
+    if (canvas == g_draw) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "canvasPush: canvas is the current draw target");
+        return kWasmErrInvalidArgument;
+    }
+    fastepd_native_utils::NativeLayout src;
+    fastepd_native_utils::NativeLayout dst;
+    if (!fastepd_native_utils::describeNativeLayout(*canvas, &src) ||
+        !fastepd_native_utils::describeNativeLayout(*g_draw, &dst)) {
+        wasm_api_set_last_error(kWasmErrInternal, "canvasPush: framebuffer layout unavailable");
+        return kWasmErrInternal;
+    }
+
+    // Quantize the key in the canvas mode first: `gray8_native_lut()` keeps one table at a time.
+    const int32_t key =
+        use_transparent ? (int32_t)gray8_native_lut(canvas->getMode())[rgb888_to_gray8(transparent_rgb888)] : -1;
+    // Canvas levels are rescaled to gray8 and requantized, so a canvas keeps working after a mode switch.
+    const uint8_t *to_dst = gray8_native_lut(g_draw->getMode());
+    const uint32_t src_max = (1u << src.bpp) - 1u;
+    uint8_t lut[16];
+    for (uint32_t v = 0; v <= src_max; ++v) {
+        lut[v] = to_dst[(v * 255u + src_max / 2u) / src_max];
+    }
+
+    if (!fastepd_native_utils::compositeLayout(dst, src, x, y, rotation, key, lut)) {
+        return kWasmOk;
+    }
+    const bool turned = (rotation & 1) != 0;
+    mark_dirty(x, y, turned ? src.logical_h : src.logical_w, turned ? src.logical_w : src.logical_h);
+    return kWasmOk;
 }
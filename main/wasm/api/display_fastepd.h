@@ -3,8 +3,9 @@
 #include "display.h"
 
 /**
- * @brief Perform a full FastEPD refresh using the slow clear waveform.
+ * @brief Queue a full FastEPD refresh using the slow clear waveform.
  * @note This helper is internal to the firmware and is not part of the WASM API surface.
+ *       The refresh runs on the refresh task; call `waitDisplay()` to block until it is done.
  */
 int32_t display_fastepd_full_update_slow();
 /**
@@ -29,8 +30,11 @@ public:
     int32_t fillScreen(wasm_exec_env_t exec_env, int32_t rgb888) override;
     int32_t display(wasm_exec_env_t exec_env) override;
     int32_t displayRect(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t w, int32_t h) override;
+    int32_t displayDirty(wasm_exec_env_t exec_env) override;
+    int32_t displayDiff(wasm_exec_env_t exec_env) override;
     int32_t fullUpdateSlow(wasm_exec_env_t exec_env) override;
     int32_t waitDisplay(wasm_exec_env_t exec_env) override;
+    int32_t setDitherMode(wasm_exec_env_t exec_env, int32_t mode) override;
     int32_t startWrite(wasm_exec_env_t exec_env) override;
     int32_t endWrite(wasm_exec_env_t exec_env) override;
     int32_t setBrightness(wasm_exec_env_t exec_env, int32_t v) override;
@@ -48,12 +52,31 @@ public:
     int32_t setTextEncoding(wasm_exec_env_t exec_env, int32_t utf8_enable, int32_t cp437_enable) override;
     int32_t drawString(wasm_exec_env_t exec_env, const char *s, int32_t x, int32_t y) override;
     int32_t textWidth(wasm_exec_env_t exec_env, const char *s) override;
+    int32_t textWidths(
+        wasm_exec_env_t exec_env,
+        const uint8_t *texts,
+        size_t texts_len,
+        uint8_t *out,
+        size_t out_len) override;
     int32_t fontHeight(wasm_exec_env_t exec_env) override;
     int32_t vlwRegister(wasm_exec_env_t exec_env, const uint8_t *ptr, size_t len) override;
     int32_t vlwUse(wasm_exec_env_t exec_env, int32_t handle) override;
     int32_t vlwUseSystem(wasm_exec_env_t exec_env, int32_t font_id, int32_t font_size) override;
     int32_t vlwUnload(wasm_exec_env_t exec_env) override;
     int32_t vlwClearAll(wasm_exec_env_t exec_env) override;
+    int32_t drawTextBox(
+        wasm_exec_env_t exec_env,
+        const uint8_t *text,
+        size_t text_len,
+        int32_t x,
+        int32_t y,
+        int32_t w,
+        int32_t h,
+        int32_t align,
+        int32_t line_spacing,
+        int32_t flags,
+        uint8_t *breaks,
+        size_t breaks_len) override;
 
     int32_t pushImageRgb565(
         wasm_exec_env_t exec_env,
@@ -123,6 +146,61 @@ public:
         int32_t y,
         int32_t max_w,
         int32_t max_h) override;
+    int32_t drawXthFile(wasm_exec_env_t exec_env, const char *path, bool fast) override;
+    int32_t drawXtgFile(wasm_exec_env_t exec_env, const char *path, bool fast) override;
+    int32_t convertJpgFile(
+        wasm_exec_env_t exec_env,
+        const char *path,
+        int32_t mode,
+        int32_t max_w,
+        int32_t max_h) override;
+    int32_t convertPngFile(
+        wasm_exec_env_t exec_env,
+        const char *path,
+        int32_t mode,
+        int32_t max_w,
+        int32_t max_h) override;
+    int32_t convertStatus(wasm_exec_env_t exec_env) override;
+    int32_t drawXtcPage(wasm_exec_env_t exec_env, const char *path, int32_t page, bool fast) override;
+    int32_t drawXthAt(
+        wasm_exec_env_t exec_env,
+        const uint8_t *ptr,
+        size_t len,
+        int32_t x,
+        int32_t y,
+        int32_t src_x,
+        int32_t src_y,
+        int32_t src_w,
+        int32_t src_h,
+        int32_t clip_x,
+        int32_t clip_y,
+        int32_t clip_w,
+        int32_t clip_h) override;
+    int32_t drawXtgAt(
+        wasm_exec_env_t exec_env,
+        const uint8_t *ptr,
+        size_t len,
+        int32_t x,
+        int32_t y,
+        int32_t src_x,
+        int32_t src_y,
+        int32_t src_w,
+        int32_t src_h,
+        int32_t clip_x,
+        int32_t clip_y,
+        int32_t clip_w,
+        int32_t clip_h) override;
+    int32_t canvasCreate(wasm_exec_env_t exec_env, int32_t w, int32_t h) override;
+    int32_t canvasDestroy(wasm_exec_env_t exec_env, int32_t handle) override;
+    int32_t canvasSelect(wasm_exec_env_t exec_env, int32_t handle) override;
+    int32_t canvasPush(
+        wasm_exec_env_t exec_env,
+        int32_t handle,
+        int32_t x,
+        int32_t y,
+        int32_t rotation,
+        int32_t transparent_rgb888,
+        int32_t use_transparent) override;
 
     int32_t drawPixel(wasm_exec_env_t exec_env, int32_t x, int32_t y, int32_t rgb888) override;
     int32_t drawLine(wasm_exec_env_t exec_env, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t rgb888) override;
@@ -177,4 +255,10 @@ public:
         int32_t x2,
         int32_t y2,
         int32_t rgb888) override;
+    int32_t submitCommands(
+        wasm_exec_env_t exec_env,
+        const uint8_t *ptr,
+        size_t len,
+        DisplayCommandRect *out_dirty,
+        int32_t *out_executed) override;
 };
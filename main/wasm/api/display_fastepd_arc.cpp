@@ -4,11 +4,19 @@
 
 #include <FastEPD.h>
 
+#include "other/fastepd_native_utils.h"
+
 namespace {
 
 constexpr float kDegToRad = 0.017453292519943295769236907684886f;
 
-void draw_hline_clipped(FASTEPD &epd, int32_t x, int32_t y, int32_t w, uint8_t color)
+void draw_hline_clipped(
+    FASTEPD &epd,
+    const fastepd_native_utils::NativeLayout *layout,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    uint8_t color)
 {
     if (w <= 0) {
         return;
@@ -35,6 +43,10 @@ void draw_hline_clipped(FASTEPD &epd, int32_t x, int32_t y, int32_t w, uint8_t c
         return;
     }
 
+    if (layout) {
+        fastepd_native_utils::fillLogicalRect(*layout, x0, y, x1 - x0 + 1, 1, color);
+        return;
+    }
     epd.drawLine((int)x0, (int)y, (int)x1, (int)y, (int)color);
 }
 
@@ -100,6 +112,9 @@ void fill_arc_helper(
         xright = max_x_exclusive;
     }
 
+    fastepd_native_utils::NativeLayout layout;
+    const bool have_layout = fastepd_native_utils::describeNativeLayout(epd, &layout);
+
     const int64_t iradius2_edge = (int64_t)iradius * (int64_t)(iradius - 1);
     const int64_t oradius2_edge = (int64_t)oradius * (int64_t)(oradius + 1);
 
@@ -140,7 +155,7 @@ void fill_arc_helper(
             }
 
             if (len) {
-                draw_hline_clipped(epd, cx + xx - len, cy + yy, len, color);
+                draw_hline_clipped(epd, have_layout ? &layout : nullptr, cx + xx - len, cy + yy, len, color);
                 len = 0;
             }
 
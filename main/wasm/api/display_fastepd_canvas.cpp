@@ -0,0 +1,102 @@
+#include "display_fastepd_canvas.h"
+
+#include <new>
+#include <string.h>
+
+#include "../../other/fastepd_native_utils.h"
+#include "errors.h"
+
+std::unique_ptr<FASTEPD> fastepd_sprite_create(int32_t w, int32_t h, int32_t mode)
+{
+    std::unique_ptr<FASTEPD> epd(new (std::nothrow) FASTEPD());
+    if (!epd || epd->initSprite(w, h) != BBEP_SUCCESS) {
+        return nullptr;
+    }
+    if (epd->getMode() != mode) {
+        (void)epd->setMode(mode);
+    }
+    fastepd_native_utils::NativeLayout layout;
+    if (!fastepd_native_utils::describeNativeLayout(*epd, &layout) || epd->getMode() != mode) {
+        fastepd_sprite_destroy(epd);
+        return nullptr;
+    }
+    const uint8_t white = (layout.bpp == 1) ? (uint8_t)BBEP_WHITE : (uint8_t)((1u << layout.bpp) - 1u);
+    memset(layout.buffer, fastepd_native_utils::packedPattern(layout.bpp, white), fastepd_native_utils::frameBytes(layout));
+    return epd;
+}
+
+void fastepd_sprite_destroy(std::unique_ptr<FASTEPD> &sprite)
+{
+    if (sprite) {
+        sprite->freeSprite();
+        sprite.reset();
+    }
+}
+
+int32_t FastEpdCanvasPool::create(int32_t w, int32_t h, int32_t mode)
+{
+    if (w <= 0 || h <= 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "canvasCreate: w/h must be > 0");
+        return kWasmErrInvalidArgument;
+    }
+    Slot *slot = nullptr;
+    for (Slot &candidate : slots_) {
+        if (candidate.handle == 0) {
+            slot = &candidate;
+            break;
+        }
+    }
+    if (!slot) {
+        wasm_api_set_last_error(kWasmErrInternal, "canvasCreate: too many canvases");
+        return kWasmErrInternal;
+    }
+
+    std::unique_ptr<FASTEPD> epd = fastepd_sprite_create(w, h, mode);
+    if (!epd) {
+        wasm_api_set_last_error(kWasmErrInternal, "canvasCreate: out of memory");
+        return kWasmErrInternal;
+    }
+
+    slot->handle = next_handle_++;
+    if (next_handle_ <= 0) {
+        next_handle_ = 1;
+    }
+    slot->epd = std::move(epd);
+    return slot->handle;
+}
+
+FASTEPD *FastEpdCanvasPool::get(int32_t handle) const
+{
+    if (handle <= 0) {
+        return nullptr;
+    }
+    for (const Slot &slot : slots_) {
+        if (slot.handle == handle) {
+            return slot.epd.get();
+        }
+    }
+    return nullptr;
+}
+
+bool FastEpdCanvasPool::destroy(int32_t handle)
+{
+    if (handle <= 0) {
+        return false;
+    }
+    for (Slot &slot : slots_) {
+        if (slot.handle == handle) {
+            fastepd_sprite_destroy(slot.epd);
+            slot.handle = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FastEpdCanvasPool::clear()
+{
+    for (Slot &slot : slots_) {
+        fastepd_sprite_destroy(slot.epd);
+        slot.handle = 0;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+
+#include <FastEPD.h>
+
+/**
+ * @brief Allocate a `w` x `h` FastEPD sprite in `mode`, filled with white.
+ * @return Null if the buffer could not be allocated or set up (no error is recorded).
+ */
+std::unique_ptr<FASTEPD> fastepd_sprite_create(int32_t w, int32_t h, int32_t mode);
+
+/** @brief Free a sprite from `fastepd_sprite_create()`; `sprite` is left empty. */
+void fastepd_sprite_destroy(std::unique_ptr<FASTEPD> &sprite);
+
+/**
+ * @brief Handle table of off-screen FastEPD canvases owned by the running app.
+ *
+ * Each canvas is a FastEPD sprite: its own `FASTEPD` instance whose buffer uses the panel's
+ * native packed format, so every primitive and the VLW renderer can draw into it unchanged and
+ * `fastepd_native_utils::compositeLayout()` can stamp it into the framebuffer. Sprite buffers
+ * are large, so FastEPD's allocator places them in PSRAM.
+ */
+class FastEpdCanvasPool {
+public:
+    /** Maximum number of live canvases per app. */
+    static constexpr int32_t kMaxCanvases = 16;
+
+    /**
+     * @brief Allocate a `w` x `h` canvas in FastEPD mode `mode`, filled with white.
+     * @return Handle (> 0), or a negative `wasm_error_code` with the last error set.
+     */
+    int32_t create(int32_t w, int32_t h, int32_t mode);
+    /** @brief Canvas for `handle`, or null if the handle is not live. */
+    FASTEPD *get(int32_t handle) const;
+    /** @return `false` if the handle is not live. */
+    bool destroy(int32_t handle);
+    /** @brief Free every canvas. */
+    void clear();
+
+private:
+    struct Slot {
+        int32_t handle = 0; ///< 0 marks a free slot.
+        std::unique_ptr<FASTEPD> epd;
+    };
+
+    Slot slots_[kMaxCanvases];
+    int32_t next_handle_ = 1;
+};
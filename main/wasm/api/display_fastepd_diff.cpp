@@ -0,0 +1,259 @@
+#include "display_fastepd_diff.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+using fastepd_native_utils::NativeLayout;
+
+namespace {
+
+constexpr const char *kTag = "display_fastepd_diff";
+
+/** @brief Changed bands separated by at most this many native rows are refreshed together. */
+constexpr int32_t kBandMergeGapRows = 32;
+
+/** @brief Native row band `[y0, y1)` whose changed pixels lie within `[x0, x1)`. */
+struct Band {
+    int32_t y0;
+    int32_t y1;
+    int32_t x0;
+    int32_t x1;
+};
+
+uint32_t load_u32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Find the first and last differing 32-bit words of one native row.
+ * @return `false` when the rows are identical.
+ */
+bool diff_row_words(const uint8_t *a, const uint8_t *b, int32_t pitch, int32_t *first_byte, int32_t *end_byte)
+{
+    const int32_t words = pitch >> 2;
+    int32_t first = -1;
+    for (int32_t i = 0; i < words; ++i) {
+        if (load_u32(a + i * 4) != load_u32(b + i * 4)) {
+            first = i * 4;
+            break;
+        }
+    }
+    if (first < 0) {
+        for (int32_t i = words * 4; i < pitch; ++i) {
+            if (a[i] != b[i]) {
+                first = i;
+                break;
+            }
+        }
+        if (first < 0) {
+            return false;
+        }
+    }
+
+    int32_t end = -1;
+    for (int32_t i = pitch - 1; i >= words * 4 && end < 0; --i) {
+        if (a[i] != b[i]) {
+            end = i + 1;
+        }
+    }
+    for (int32_t i = words - 1; i >= 0 && end < 0; --i) {
+        if (load_u32(a + i * 4) != load_u32(b + i * 4)) {
+            end = (i + 1) * 4;
+        }
+    }
+    *first_byte = first;
+    *end_byte = end;
+    return true;
+}
+
+/** @brief Clip a logical rect to the screen and convert it to a native byte-column span. */
+bool native_byte_span(
+    const NativeLayout &layout,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    int32_t *row0,
+    int32_t *row1,
+    int32_t *byte0,
+    int32_t *byte1)
+{
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = (int64_t)x + w;
+    int64_t y1 = (int64_t)y + h;
+    if (x1 > layout.logical_w) x1 = layout.logical_w;
+    if (y1 > layout.logical_h) y1 = layout.logical_h;
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+
+    int32_t nx = 0;
+    int32_t ny = 0;
+    int32_t nw = 0;
+    int32_t nh = 0;
+    fastepd_native_utils::logicalRectToNative(
+        layout, (int32_t)x0, (int32_t)y0, (int32_t)(x1 - x0), (int32_t)(y1 - y0), &nx, &ny, &nw, &nh);
+    *row0 = ny;
+    *row1 = ny + nh;
+    *byte0 = (nx * layout.bpp) >> 3;
+    *byte1 = ((nx + nw) * layout.bpp + 7) >> 3;
+    return true;
+}
+
+} // namespace
+
+FastEpdShadowBuffer::~FastEpdShadowBuffer()
+{
+    release();
+}
+
+void FastEpdShadowBuffer::release()
+{
+    if (data_) {
+        heap_caps_free(data_);
+    }
+    data_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    bpp_ = 0;
+    valid_ = false;
+}
+
+bool FastEpdShadowBuffer::matches(const NativeLayout &layout) const
+{
+    return valid_ && data_ && layout.bpp == bpp_ && fastepd_native_utils::frameBytes(layout) == size_;
+}
+
+bool FastEpdShadowBuffer::captureAll(const NativeLayout &layout, bool allocate)
+{
+    if (!data_ && !allocate) {
+        return false;
+    }
+    const size_t bytes = fastepd_native_utils::frameBytes(layout);
+    if (bytes > capacity_) {
+        if (data_) {
+            heap_caps_free(data_);
+        }
+        data_ = (uint8_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        capacity_ = data_ ? bytes : 0;
+        if (!data_) {
+            ESP_LOGW(kTag, "shadow buffer alloc failed (%u bytes)", (unsigned)bytes);
+            size_ = 0;
+            bpp_ = 0;
+            valid_ = false;
+            return false;
+        }
+    }
+    memcpy(data_, layout.buffer, bytes);
+    size_ = bytes;
+    bpp_ = layout.bpp;
+    valid_ = true;
+    return true;
+}
+
+void FastEpdShadowBuffer::captureRect(const NativeLayout &layout, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    if (!matches(layout)) {
+        return;
+    }
+    int32_t row0 = 0;
+    int32_t row1 = 0;
+    int32_t byte0 = 0;
+    int32_t byte1 = 0;
+    if (!native_byte_span(layout, x, y, w, h, &row0, &row1, &byte0, &byte1)) {
+        return;
+    }
+    for (int32_t row = row0; row < row1; ++row) {
+        const size_t offset = (size_t)row * (size_t)layout.pitch + (size_t)byte0;
+        memcpy(data_ + offset, layout.buffer + offset, (size_t)(byte1 - byte0));
+    }
+}
+
+bool FastEpdShadowBuffer::rectChanged(const NativeLayout &layout, int32_t x, int32_t y, int32_t w, int32_t h) const
+{
+    if (!matches(layout)) {
+        return true;
+    }
+    int32_t row0 = 0;
+    int32_t row1 = 0;
+    int32_t byte0 = 0;
+    int32_t byte1 = 0;
+    if (!native_byte_span(layout, x, y, w, h, &row0, &row1, &byte0, &byte1)) {
+        return false;
+    }
+    for (int32_t row = row0; row < row1; ++row) {
+        const size_t offset = (size_t)row * (size_t)layout.pitch + (size_t)byte0;
+        if (memcmp(data_ + offset, layout.buffer + offset, (size_t)(byte1 - byte0)) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int FastEpdShadowBuffer::diff(const NativeLayout &layout, FastEpdDirtyRect *out) const
+{
+    if (!matches(layout)) {
+        return -1;
+    }
+
+    Band bands[kMaxRects + 1];
+    int count = 0;
+    const int32_t pitch = layout.pitch;
+    const int32_t px_per_byte = 8 / layout.bpp;
+
+    for (int32_t row = 0; row < layout.native_h; ++row) {
+        const size_t offset = (size_t)row * (size_t)pitch;
+        int32_t first_byte = 0;
+        int32_t end_byte = 0;
+        if (!diff_row_words(layout.buffer + offset, data_ + offset, pitch, &first_byte, &end_byte)) {
+            continue;
+        }
+        const int32_t x0 = first_byte * px_per_byte;
+        int32_t x1 = end_byte * px_per_byte;
+        if (x1 > layout.native_w) {
+            x1 = layout.native_w;
+        }
+
+        if (count > 0 && row - bands[count - 1].y1 <= kBandMergeGapRows) {
+            Band &band = bands[count - 1];
+            band.y1 = row + 1;
+            band.x0 = x0 < band.x0 ? x0 : band.x0;
+            band.x1 = x1 > band.x1 ? x1 : band.x1;
+            continue;
+        }
+
+        bands[count++] = Band{row, row + 1, x0, x1};
+        if (count > kMaxRects) {
+            // Out of slots: fuse the two neighbours separated by the smallest gap.
+            int best = 0;
+            for (int i = 1; i < count - 1; ++i) {
+                if (bands[i + 1].y0 - bands[i].y1 < bands[best + 1].y0 - bands[best].y1) {
+                    best = i;
+                }
+            }
+            Band &a = bands[best];
+            const Band &b = bands[best + 1];
+            a.y1 = b.y1;
+            a.x0 = b.x0 < a.x0 ? b.x0 : a.x0;
+            a.x1 = b.x1 > a.x1 ? b.x1 : a.x1;
+            for (int i = best + 1; i < count - 1; ++i) {
+                bands[i] = bands[i + 1];
+            }
+            --count;
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const Band &band = bands[i];
+        fastepd_native_utils::nativeRectToLogical(
+            layout, band.x0, band.y0, band.x1 - band.x0, band.y1 - band.y0, &out[i].x, &out[i].y, &out[i].w, &out[i].h);
+    }
+    return count;
+}
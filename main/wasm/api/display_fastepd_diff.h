@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "display_fastepd_dirty.h"
+#include "other/fastepd_native_utils.h"
+
+/**
+ * @brief PSRAM copy of the framebuffer as it was last pushed to the panel.
+ *
+ * The copy is allocated lazily the first time an app asks for a diff refresh and is kept in
+ * sync after every refresh from then on. Comparing it with the live framebuffer at word
+ * granularity yields the native row bands that actually changed, so redundant redraws of an
+ * unchanged screen cost no waveform at all.
+ */
+class FastEpdShadowBuffer {
+public:
+    /** Upper bound on the number of bands returned by `diff()`. */
+    static constexpr int kMaxRects = FastEpdDirtyTracker::kMaxRects;
+
+    ~FastEpdShadowBuffer();
+
+    /** @brief True once a baseline matching the current mode has been captured. */
+    bool valid() const { return valid_; }
+    /** @brief Whether the shadow is being maintained (allocated) at all. */
+    bool enabled() const { return data_ != nullptr; }
+
+    /** @brief Forget the baseline (mode switch); the allocation is kept for reuse. */
+    void invalidate() { valid_ = false; }
+    /** @brief Free the shadow copy entirely. */
+    void release();
+
+    /**
+     * @brief Copy the whole framebuffer after a full-screen refresh.
+     * @param allocate Allocate the shadow if it is not enabled yet.
+     * @return `false` if the shadow is disabled (and `allocate` is false) or allocation failed.
+     */
+    bool captureAll(const fastepd_native_utils::NativeLayout &layout, bool allocate);
+    /** @brief Copy the native bytes under a logical rect after a rect refresh (no-op unless valid). */
+    void captureRect(const fastepd_native_utils::NativeLayout &layout, int32_t x, int32_t y, int32_t w, int32_t h);
+
+    /**
+     * @brief Compute the logical rects covering every native row band that differs.
+     * @param layout Current framebuffer geometry.
+     * @param out Output rects, at least `kMaxRects` entries.
+     * @return Number of rects (0 when the framebuffer is unchanged), or -1 without a valid baseline.
+     */
+    int diff(const fastepd_native_utils::NativeLayout &layout, FastEpdDirtyRect *out) const;
+    /** @brief True if any native byte under the logical rect differs from the baseline. */
+    bool rectChanged(const fastepd_native_utils::NativeLayout &layout, int32_t x, int32_t y, int32_t w, int32_t h) const;
+
+private:
+    bool matches(const fastepd_native_utils::NativeLayout &layout) const;
+
+    uint8_t *data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    int32_t bpp_ = 0;
+    bool valid_ = false;
+};
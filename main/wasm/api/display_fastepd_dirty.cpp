@@ -0,0 +1,177 @@
+#include "display_fastepd_dirty.h"
+
+namespace {
+
+int64_t rect_area(const FastEpdDirtyRect &r)
+{
+    return (int64_t)r.w * (int64_t)r.h;
+}
+
+FastEpdDirtyRect rect_union(const FastEpdDirtyRect &a, const FastEpdDirtyRect &b)
+{
+    const int32_t x0 = a.x < b.x ? a.x : b.x;
+    const int32_t y0 = a.y < b.y ? a.y : b.y;
+    const int32_t ax1 = a.x + a.w;
+    const int32_t ay1 = a.y + a.h;
+    const int32_t bx1 = b.x + b.w;
+    const int32_t by1 = b.y + b.h;
+    const int32_t x1 = ax1 > bx1 ? ax1 : bx1;
+    const int32_t y1 = ay1 > by1 ? ay1 : by1;
+    return FastEpdDirtyRect{x0, y0, x1 - x0, y1 - y0};
+}
+
+int64_t rect_overlap_area(const FastEpdDirtyRect &a, const FastEpdDirtyRect &b)
+{
+    const int32_t x0 = a.x > b.x ? a.x : b.x;
+    const int32_t y0 = a.y > b.y ? a.y : b.y;
+    const int32_t ax1 = a.x + a.w;
+    const int32_t ay1 = a.y + a.h;
+    const int32_t bx1 = b.x + b.w;
+    const int32_t by1 = b.y + b.h;
+    const int32_t x1 = ax1 < bx1 ? ax1 : bx1;
+    const int32_t y1 = ay1 < by1 ? ay1 : by1;
+    if (x1 <= x0 || y1 <= y0) {
+        return 0;
+    }
+    return (int64_t)(x1 - x0) * (int64_t)(y1 - y0);
+}
+
+/** @brief Pixels the union covers that neither input covers. */
+int64_t merge_waste(const FastEpdDirtyRect &a, const FastEpdDirtyRect &b)
+{
+    const int64_t covered = rect_area(a) + rect_area(b) - rect_overlap_area(a, b);
+    return rect_area(rect_union(a, b)) - covered;
+}
+
+/** @brief Merge eagerly when the union refreshes at most 25% more pixels than the inputs. */
+bool worth_merging(const FastEpdDirtyRect &a, const FastEpdDirtyRect &b)
+{
+    return merge_waste(a, b) * 4 <= rect_area(a) + rect_area(b);
+}
+
+bool rect_contains(const FastEpdDirtyRect &outer, const FastEpdDirtyRect &inner)
+{
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.w <= outer.x + outer.w
+        && inner.y + inner.h <= outer.y + outer.h;
+}
+
+} // namespace
+
+void FastEpdDirtyTracker::mark(int32_t x, int32_t y, int32_t w, int32_t h, int32_t bound_w, int32_t bound_h)
+{
+    if (w <= 0 || h <= 0 || bound_w <= 0 || bound_h <= 0) {
+        return;
+    }
+    int64_t x0 = x;
+    int64_t y0 = y;
+    int64_t x1 = (int64_t)x + w;
+    int64_t y1 = (int64_t)y + h;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > bound_w) x1 = bound_w;
+    if (y1 > bound_h) y1 = bound_h;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    add(FastEpdDirtyRect{(int32_t)x0, (int32_t)y0, (int32_t)(x1 - x0), (int32_t)(y1 - y0)});
+}
+
+void FastEpdDirtyTracker::markAll(int32_t bound_w, int32_t bound_h)
+{
+    clear();
+    if (bound_w <= 0 || bound_h <= 0) {
+        return;
+    }
+    rects_[0] = FastEpdDirtyRect{0, 0, bound_w, bound_h};
+    count_ = 1;
+}
+
+void FastEpdDirtyTracker::clear()
+{
+    count_ = 0;
+}
+
+void FastEpdDirtyTracker::clearCoveredBy(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    const FastEpdDirtyRect cover = {x, y, w, h};
+    int kept = 0;
+    for (int i = 0; i < count_; ++i) {
+        if (!rect_contains(cover, rects_[i])) {
+            rects_[kept++] = rects_[i];
+        }
+    }
+    count_ = kept;
+}
+
+FastEpdDirtyRect FastEpdDirtyTracker::bounds() const
+{
+    if (count_ == 0) {
+        return FastEpdDirtyRect{0, 0, 0, 0};
+    }
+    FastEpdDirtyRect out = rects_[0];
+    for (int i = 1; i < count_; ++i) {
+        out = rect_union(out, rects_[i]);
+    }
+    return out;
+}
+
+int64_t FastEpdDirtyTracker::area() const
+{
+    int64_t total = 0;
+    for (int i = 0; i < count_; ++i) {
+        total += rect_area(rects_[i]);
+    }
+    return total;
+}
+
+void FastEpdDirtyTracker::add(const FastEpdDirtyRect &rect)
+{
+    for (int i = 0; i < count_; ++i) {
+        if (rect_contains(rects_[i], rect)) {
+            return;
+        }
+        if (worth_merging(rects_[i], rect)) {
+            rects_[i] = rect_union(rects_[i], rect);
+            coalesce();
+            return;
+        }
+    }
+
+    if (count_ < kMaxRects) {
+        rects_[count_++] = rect;
+        return;
+    }
+
+    // Full: fold the new rect into whichever existing rect grows the least.
+    int best = 0;
+    int64_t best_waste = merge_waste(rects_[0], rect);
+    for (int i = 1; i < count_; ++i) {
+        const int64_t waste = merge_waste(rects_[i], rect);
+        if (waste < best_waste) {
+            best_waste = waste;
+            best = i;
+        }
+    }
+    rects_[best] = rect_union(rects_[best], rect);
+    coalesce();
+}
+
+void FastEpdDirtyTracker::coalesce()
+{
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < count_ && !merged; ++i) {
+            for (int j = i + 1; j < count_; ++j) {
+                if (!worth_merging(rects_[i], rects_[j])) {
+                    continue;
+                }
+                rects_[i] = rect_union(rects_[i], rects_[j]);
+                rects_[j] = rects_[count_ - 1];
+                --count_;
+                merged = true;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+/** @brief Axis-aligned rectangle in logical display coordinates. */
+struct FastEpdDirtyRect {
+    int32_t x;
+    int32_t y;
+    int32_t w;
+    int32_t h;
+};
+
+/**
+ * @brief Fixed-capacity set of framebuffer regions modified since the last panel refresh.
+ *
+ * Drawing entry points report the logical bounding box they touched; overlapping or nearly
+ * adjacent boxes are merged eagerly so the set stays small. When the capacity is exceeded the
+ * pair whose union wastes the fewest pixels is collapsed.
+ */
+class FastEpdDirtyTracker {
+public:
+    static constexpr int kMaxRects = 8;
+
+    /**
+     * @brief Record a modified region, clipped to the `[0, bound_w) x [0, bound_h)` screen.
+     * @param x Left edge in logical pixels.
+     * @param y Top edge in logical pixels.
+     * @param w Width in pixels; non-positive values are ignored.
+     * @param h Height in pixels; non-positive values are ignored.
+     * @param bound_w Current logical screen width.
+     * @param bound_h Current logical screen height.
+     */
+    void mark(int32_t x, int32_t y, int32_t w, int32_t h, int32_t bound_w, int32_t bound_h);
+    /** @brief Mark the entire `bound_w x bound_h` screen as modified. */
+    void markAll(int32_t bound_w, int32_t bound_h);
+    /** @brief Forget all recorded regions (after a full refresh). */
+    void clear();
+    /** @brief Drop regions fully contained in the given rectangle (after a rect refresh). */
+    void clearCoveredBy(int32_t x, int32_t y, int32_t w, int32_t h);
+
+    bool empty() const { return count_ == 0; }
+    int count() const { return count_; }
+    const FastEpdDirtyRect &rect(int index) const { return rects_[index]; }
+
+    /** @brief Return the union of all recorded regions (zero-sized when empty). */
+    FastEpdDirtyRect bounds() const;
+    /** @brief Sum of the areas of the recorded regions. */
+    int64_t area() const;
+
+private:
+    void add(const FastEpdDirtyRect &rect);
+    void coalesce();
+
+    FastEpdDirtyRect rects_[kMaxRects] = {};
+    int count_ = 0;
+};
@@ -0,0 +1,285 @@
+#include "display_fastepd_dither.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+constexpr uint8_t kBayer8[8][8] = {
+    {0, 32, 8, 40, 2, 34, 10, 42},
+    {48, 16, 56, 24, 50, 18, 58, 26},
+    {12, 44, 4, 36, 14, 46, 6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22},
+    {3, 35, 11, 43, 1, 33, 9, 41},
+    {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47, 7, 39, 13, 45, 5, 37},
+    {63, 31, 55, 23, 61, 29, 53, 21},
+};
+
+// Void-and-cluster ranks (Gaussian sigma 1.5, toroidal), one per pixel of the 16x16 tile.
+constexpr uint8_t kBlueNoise16[16][16] = {
+    {234, 50, 188, 19, 58, 171, 121, 47, 163, 1, 247, 104, 22, 132, 14, 65},
+    {209, 8, 118, 97, 240, 205, 23, 228, 138, 64, 123, 170, 72, 224, 99, 149},
+    {85, 139, 229, 165, 78, 146, 111, 84, 176, 216, 30, 231, 153, 201, 42, 180},
+    {25, 62, 195, 29, 43, 185, 7, 249, 41, 100, 191, 48, 87, 5, 128, 243},
+    {221, 152, 101, 253, 130, 220, 59, 200, 156, 12, 136, 112, 255, 174, 69, 109},
+    {46, 189, 0, 73, 172, 90, 142, 116, 80, 237, 210, 61, 147, 33, 206, 160},
+    {81, 124, 217, 113, 208, 15, 241, 27, 168, 45, 178, 20, 193, 96, 225, 18},
+    {242, 164, 60, 35, 157, 53, 181, 68, 223, 105, 125, 83, 236, 131, 55, 141},
+    {197, 10, 227, 134, 246, 95, 126, 198, 148, 3, 244, 161, 71, 9, 182, 106},
+    {40, 93, 179, 75, 192, 6, 218, 36, 91, 57, 202, 34, 215, 155, 233, 74},
+    {252, 120, 150, 24, 110, 63, 166, 119, 232, 183, 133, 103, 49, 117, 31, 167},
+    {16, 212, 51, 238, 207, 137, 254, 21, 76, 151, 13, 250, 190, 88, 203, 135},
+    {102, 184, 82, 169, 38, 89, 187, 52, 204, 98, 173, 67, 129, 4, 222, 56},
+    {230, 144, 2, 127, 226, 11, 154, 114, 239, 39, 219, 28, 235, 145, 175, 77},
+    {196, 37, 248, 70, 107, 199, 66, 177, 17, 143, 115, 159, 86, 44, 108, 26},
+    {122, 92, 158, 214, 140, 32, 245, 94, 213, 79, 194, 54, 211, 186, 251, 162},
+};
+
+constexpr int32_t kTileMask = FastEpdDither::kTileSize - 1;
+
+} // namespace
+
+void FastEpdDither::configure(DisplayDitherMode mode, int32_t bpp)
+{
+    if (mode == DisplayDitherMode::diffusion || mode == DisplayDitherMode::none) {
+        mode = DisplayDitherMode::bayer;
+    }
+    if (mode == mode_ && bpp == bpp_) {
+        return;
+    }
+    if (mode != mode_) {
+        for (int32_t y = 0; y < kTileSize; ++y) {
+            for (int32_t x = 0; x < kTileSize; ++x) {
+                // Thresholds sit at the centres of the rank intervals, so neither pure black nor
+                // pure white is ever dithered.
+                tile_[y * kTileSize + x] = (mode == DisplayDitherMode::blueNoise)
+                    ? (uint16_t)((kBlueNoise16[y][x] * 2u + 1u) * 128u)
+                    : (uint16_t)((kBayer8[y & 7][x & 7] * 2u + 1u) * 512u);
+            }
+        }
+        mode_ = mode;
+    }
+    if (bpp != bpp_) {
+        levels_ = 1 << bpp;
+        for (uint32_t g = 0; g < 256; ++g) {
+            scale_[g] = g * (uint32_t)(levels_ - 1) * 257u;
+        }
+        bpp_ = bpp;
+    }
+}
+
+void FastEpdDither::orderedSpan(const uint8_t *src, uint8_t *dst, int32_t n, int32_t x, int32_t y) const
+{
+    const uint16_t *thresholds = tile_ + (y & kTileMask) * kTileSize;
+    for (int32_t i = 0; i < n; ++i) {
+        dst[i] = level(src[i], thresholds[(x + i) & kTileMask]);
+    }
+}
+
+bool FastEpdDither::fillLogicalRect(
+    const fastepd_native_utils::NativeLayout &layout,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    uint8_t gray) const
+{
+    int64_t x0 = x < 0 ? 0 : x;
+    int64_t y0 = y < 0 ? 0 : y;
+    int64_t x1 = (int64_t)x + w;
+    int64_t y1 = (int64_t)y + h;
+    if (x1 > layout.logical_w) {
+        x1 = layout.logical_w;
+    }
+    if (y1 > layout.logical_h) {
+        y1 = layout.logical_h;
+    }
+    if (x0 >= x1 || y0 >= y1) {
+        return false;
+    }
+    int32_t nx = 0;
+    int32_t ny = 0;
+    int32_t nw = 0;
+    int32_t nh = 0;
+    fastepd_native_utils::logicalRectToNative(
+        layout, (int32_t)x0, (int32_t)y0, (int32_t)(x1 - x0), (int32_t)(y1 - y0), &nx, &ny, &nw, &nh);
+
+    const int32_t bpp = layout.bpp;
+    const int32_t per_byte = 8 / bpp;
+    const int32_t pattern_bytes = kTileSize / per_byte;
+    const int32_t b0 = nx / per_byte;
+    const int32_t b1 = (nx + nw - 1) / per_byte;
+    const uint8_t first_mask = (uint8_t)(0xFFu >> ((nx % per_byte) * bpp));
+    const uint8_t last_mask = (uint8_t)(0xFFu << (8 - ((nx + nw - 1) % per_byte + 1) * bpp));
+    const int32_t lw = layout.logical_w;
+    const int32_t lh = layout.logical_h;
+
+    for (int32_t r = ny; r < ny + nh; ++r) {
+        // One period of the row: native column k maps to a fixed logical row or column.
+        uint8_t pattern[kTileSize / 2] = {};
+        for (int32_t k = 0; k < kTileSize; ++k) {
+            int32_t lx = k;
+            int32_t ly = r;
+            switch (layout.rotation) {
+            case 90:
+                lx = lw - 1 - r;
+                ly = k;
+                break;
+            case 180:
+                lx = lw - 1 - k;
+                ly = lh - 1 - r;
+                break;
+            case 270:
+                lx = r;
+                ly = lh - 1 - k;
+                break;
+            default:
+                break;
+            }
+            const uint8_t v = level(gray, tile_[(ly & kTileMask) * kTileSize + (lx & kTileMask)]);
+            pattern[k / per_byte] |= (uint8_t)(v << (8 - bpp * (k % per_byte + 1)));
+        }
+
+        uint8_t *row = layout.buffer + (size_t)r * (size_t)layout.pitch;
+        for (int32_t b = b0; b <= b1; ++b) {
+            uint8_t mask = 0xFF;
+            if (b == b0) {
+                mask &= first_mask;
+            }
+            if (b == b1) {
+                mask &= last_mask;
+            }
+            const uint8_t value = pattern[b & (pattern_bytes - 1)];
+            row[b] = (mask == 0xFF) ? value : (uint8_t)((row[b] & ~mask) | (value & mask));
+        }
+    }
+    return true;
+}
+
+const uint8_t *FastEpdDither::levelLut()
+{
+    static uint8_t lut[256];
+    static bool built = false;
+    if (!built) {
+        for (int i = 0; i < 256; ++i) {
+            lut[i] = (uint8_t)i;
+        }
+        built = true;
+    }
+    return lut;
+}
+
+FastEpdErrorDiffusion::~FastEpdErrorDiffusion()
+{
+    free(cur_);
+    free(next_);
+}
+
+/**
+ * Corrected values stay within [-128, 383]: every error is at most half a level step (127.5)
+ * and a pixel receives at most 16/16 of one error, so tables span [-256, 512).
+ */
+struct FastEpdErrorDiffusion::Tables {
+    static constexpr int32_t kBias = 256;
+
+    uint8_t level[768];
+    int16_t share7[768]; ///< Quantization error * 7/16; likewise below.
+    int16_t share5[768];
+    int16_t share3[768];
+    int16_t share1[768];
+};
+
+namespace {
+
+/** @brief Tables for 2, 4 or 16 levels, built on first use (from the drawing task). */
+const FastEpdErrorDiffusion::Tables *diffusion_tables(int32_t levels)
+{
+    static FastEpdErrorDiffusion::Tables tables[3];
+    static bool built[3] = {false, false, false};
+    const int index = levels <= 2 ? 0 : (levels <= 4 ? 1 : 2);
+    FastEpdErrorDiffusion::Tables &t = tables[index];
+    if (!built[index]) {
+        const int32_t max_level = (index == 0) ? 1 : (index == 1 ? 3 : 15);
+        const int32_t step = 255 / max_level;
+        for (int32_t i = 0; i < 768; ++i) {
+            const int32_t raw = i - FastEpdErrorDiffusion::Tables::kBias;
+            const int32_t v = raw < 0 ? 0 : (raw > 255 ? 255 : raw);
+            const int32_t q = (v * max_level + 127) / 255;
+            const int32_t err = v - q * step;
+            t.level[i] = (uint8_t)q;
+            t.share7[i] = (int16_t)(err * 7 / 16);
+            t.share5[i] = (int16_t)(err * 5 / 16);
+            t.share3[i] = (int16_t)(err * 3 / 16);
+            t.share1[i] = (int16_t)(err / 16);
+        }
+        built[index] = true;
+    }
+    return &t;
+}
+
+} // namespace
+
+bool FastEpdErrorDiffusion::begin(int32_t width, int32_t levels)
+{
+    free(cur_);
+    free(next_);
+    width_ = width;
+    reverse_ = false;
+    tables_ = diffusion_tables(levels);
+    const size_t bytes = (size_t)(width + 2) * sizeof(int16_t);
+    cur_ = (int16_t *)calloc(1, bytes);
+    next_ = (int16_t *)calloc(1, bytes);
+    return cur_ && next_;
+}
+
+void FastEpdErrorDiffusion::reset()
+{
+    reverse_ = false;
+    if (cur_ && next_) {
+        memset(cur_, 0, (size_t)(width_ + 2) * sizeof(int16_t));
+    }
+}
+
+template <bool kReverse>
+void FastEpdErrorDiffusion::diffuseRow(const uint8_t *src, uint8_t *dst)
+{
+    // cur_/next_ are offset by one so the slot behind the first pixel is valid. `behind` and
+    // `below` collect the next-row shares of the slots behind and under the current pixel, so
+    // each next-row slot is stored once, when nothing more can reach it; `ahead` is the 7/16
+    // share for the following pixel.
+    constexpr int32_t kStep = kReverse ? -1 : 1;
+    const Tables &t = *tables_;
+    const int16_t *cur = cur_ + 1;
+    int16_t *next = next_ + 1;
+    int32_t ahead = 0;
+    int32_t behind = 0;
+    int32_t below = 0;
+    int32_t i = kReverse ? width_ - 1 : 0;
+    for (int32_t n = 0; n < width_; ++n, i += kStep) {
+        const int32_t v = (int32_t)src[i] + cur[i] + ahead + Tables::kBias;
+        dst[i] = t.level[v];
+        ahead = t.share7[v];
+        next[i - kStep] = (int16_t)(behind + t.share3[v]);
+        behind = below + t.share5[v];
+        below = t.share1[v];
+    }
+    next[i - kStep] = (int16_t)behind;
+    next[i] = (int16_t)below;
+}
+
+void FastEpdErrorDiffusion::row(const uint8_t *src, uint8_t *dst)
+{
+    if (!cur_ || !next_ || width_ <= 0) {
+        return;
+    }
+    if (reverse_) {
+        diffuseRow<true>(src, dst);
+    } else {
+        diffuseRow<false>(src, dst);
+    }
+    reverse_ = !reverse_;
+    int16_t *tmp = cur_;
+    cur_ = next_;
+    next_ = tmp;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "display.h"
+#include "../../other/fastepd_native_utils.h"
+
+/**
+ * @brief Table-driven quantization of gray8 values into the levels of a FastEPD mode.
+ *
+ * Ordered modes compare each pixel against a 16x16 threshold tile (Bayer 8x8 repeated, or a
+ * blue-noise tile) that depends only on the pixel's logical position. That makes them usable
+ * from the span writers: a solid fill repeats one packed byte pattern per native row, and an
+ * image strip is quantized span by span before the regular blit. Levels are the raw native
+ * pixel values (1bpp: 1 = white), so quantized spans are written through `levelLut()`.
+ */
+class FastEpdDither {
+public:
+    /** Side of the threshold tile in pixels. */
+    static constexpr int32_t kTileSize = 16;
+
+    /**
+     * @brief Select the threshold tile and output depth; tables are rebuilt only on change.
+     * @param mode `DisplayDitherMode::diffusion` uses the Bayer tile (for fills only).
+     * @param bpp Output bits per pixel: 1, 2 or 4.
+     */
+    void configure(DisplayDitherMode mode, int32_t bpp);
+
+    /** @brief Number of output levels (2, 4 or 16). */
+    int32_t levels() const { return levels_; }
+
+    /** @brief Quantize `n` gray pixels of logical row `y` starting at column `x` (in place is fine). */
+    void orderedSpan(const uint8_t *src, uint8_t *dst, int32_t n, int32_t x, int32_t y) const;
+
+    /**
+     * @brief Fill a logical rect with `gray`, writing each native row as a repeating byte pattern.
+     * @return `false` if the rect is entirely off-screen.
+     */
+    bool fillLogicalRect(
+        const fastepd_native_utils::NativeLayout &layout,
+        int32_t x,
+        int32_t y,
+        int32_t w,
+        int32_t h,
+        uint8_t gray) const;
+
+    /** @brief Identity table mapping a level to itself, for `blitGray8()` of quantized spans. */
+    static const uint8_t *levelLut();
+
+private:
+    uint8_t level(uint8_t gray, uint16_t threshold) const
+    {
+        const uint32_t v = (scale_[gray] + threshold) >> 16;
+        return (uint8_t)(v < (uint32_t)levels_ ? v : (uint32_t)levels_ - 1u);
+    }
+
+    DisplayDitherMode mode_ = DisplayDitherMode::none;
+    int32_t bpp_ = 0;
+    int32_t levels_ = 2;
+    uint32_t scale_[256] = {}; ///< `gray * (levels - 1) * 257`: level in the high half-word.
+    uint16_t tile_[kTileSize * kTileSize] = {}; ///< Thresholds in `[0, 65536)`, row-major by logical y.
+};
+
+/**
+ * @brief Serpentine Floyd-Steinberg error diffusion over consecutive gray8 rows of one image.
+ *
+ * Quantizes rows top to bottom into levels (see `FastEpdDither`), carrying the error of each
+ * row into the next. Rows alternate direction so the error does not drift one way and streak.
+ * Levels and the four error shares come from tables indexed by the uncorrected value, which
+ * also absorb the clamp, and the shares bound for the current and next row are carried in
+ * registers, so the inner loop has no divides, no branches and one store per pixel. Two error
+ * rows of `width + 2` entries are allocated by `begin()`.
+ */
+class FastEpdErrorDiffusion {
+public:
+    ~FastEpdErrorDiffusion();
+
+    /** @return `false` if the error rows could not be allocated. */
+    bool begin(int32_t width, int32_t levels);
+    /** @brief Quantize the next row of `width` pixels (in place is fine). */
+    void row(const uint8_t *src, uint8_t *dst);
+    /** @brief Drop the carried error and start the next row left to right again. */
+    void reset();
+
+    struct Tables;
+
+private:
+    template <bool kReverse>
+    void diffuseRow(const uint8_t *src, uint8_t *dst);
+
+    int32_t width_ = 0;
+    bool reverse_ = false;
+    const Tables *tables_ = nullptr;
+    int16_t *cur_ = nullptr;
+    int16_t *next_ = nullptr;
+};
@@ -0,0 +1,160 @@
+#include "display_fastepd_file_stream.h"
+
+#include <sys/stat.h>
+
+#include "esp_log.h"
+
+namespace {
+
+constexpr const char *kTag = "display_fastepd_stream";
+constexpr uint32_t kReaderTaskStack = 1024 * 3;
+constexpr UBaseType_t kReaderTaskPriority = 4;
+/** Upper bound on one blocking ring operation, so stop requests are noticed promptly. */
+constexpr TickType_t kRingWaitTicks = pdMS_TO_TICKS(20);
+
+} // namespace
+
+FastEpdFileStream::~FastEpdFileStream()
+{
+    close();
+}
+
+bool FastEpdFileStream::open(const char *path)
+{
+    close();
+    file_ = fopen(path, "rb");
+    if (!file_) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fileno(file_), &st) != 0 || st.st_size < 0 || st.st_size > INT32_MAX) {
+        close();
+        return false;
+    }
+    size_ = (int32_t)st.st_size;
+    pos_ = 0;
+
+    if (!done_) {
+        done_ = xSemaphoreCreateBinary();
+    }
+    if (!ring_) {
+        ring_ = xStreamBufferCreate(kRingBytes, 1);
+    }
+    if (!done_ || !ring_ || !startReader()) {
+        ESP_LOGW(kTag, "prefetch unavailable; reading synchronously");
+    }
+    return true;
+}
+
+void FastEpdFileStream::close()
+{
+    stopReader();
+    if (ring_) {
+        vStreamBufferDelete(ring_);
+        ring_ = nullptr;
+    }
+    if (done_) {
+        vSemaphoreDelete(done_);
+        done_ = nullptr;
+    }
+    if (file_) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+    size_ = 0;
+    pos_ = 0;
+}
+
+bool FastEpdFileStream::startReader()
+{
+    stop_ = false;
+    eof_ = false;
+    if (xTaskCreate(readerEntry, "epd_file_rd", kReaderTaskStack, this, kReaderTaskPriority, &reader_) != pdPASS) {
+        reader_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void FastEpdFileStream::stopReader()
+{
+    if (!reader_) {
+        return;
+    }
+    stop_ = true;
+    xSemaphoreTake(done_, portMAX_DELAY);
+    reader_ = nullptr;
+    (void)xStreamBufferReset(ring_);
+}
+
+void FastEpdFileStream::readerEntry(void *arg)
+{
+    FastEpdFileStream *self = static_cast<FastEpdFileStream *>(arg);
+    while (!self->stop_) {
+        const size_t n = fread(self->chunk_, 1, kChunkBytes, self->file_);
+        size_t sent = 0;
+        while (sent < n && !self->stop_) {
+            sent += xStreamBufferSend(self->ring_, self->chunk_ + sent, n - sent, kRingWaitTicks);
+        }
+        if (n < kChunkBytes) {
+            break;
+        }
+    }
+    self->eof_ = true;
+    xSemaphoreGive(self->done_);
+    vTaskDelete(nullptr);
+}
+
+int32_t FastEpdFileStream::read(uint8_t *buf, int32_t len)
+{
+    if (!file_ || len <= 0) {
+        return 0;
+    }
+    if (!reader_) {
+        const size_t n = fread(buf, 1, (size_t)len, file_);
+        pos_ += (int32_t)n;
+        return (int32_t)n;
+    }
+    int32_t got = 0;
+    while (got < len) {
+        // Sample `eof_` before receiving: once it is set, an empty ring means the file is done.
+        const bool eof = eof_;
+        const size_t n = xStreamBufferReceive(ring_, buf + got, (size_t)(len - got), kRingWaitTicks);
+        got += (int32_t)n;
+        if (n == 0 && eof) {
+            break;
+        }
+    }
+    pos_ += got;
+    return got;
+}
+
+bool FastEpdFileStream::seek(int32_t pos)
+{
+    if (!file_ || pos < 0 || pos > size_) {
+        return false;
+    }
+    if (pos == pos_) {
+        return true;
+    }
+    if (reader_ && pos > pos_ && (size_t)(pos - pos_) <= kRingBytes) {
+        uint8_t scratch[64];
+        while (pos_ < pos) {
+            const int32_t step = (pos - pos_) < (int32_t)sizeof(scratch) ? (pos - pos_) : (int32_t)sizeof(scratch);
+            if (read(scratch, step) != step) {
+                return false;
+            }
+        }
+        return true;
+    }
+    const bool prefetch = reader_ != nullptr;
+    stopReader();
+    if (fseek(file_, pos, SEEK_SET) != 0) {
+        return false;
+    }
+    pos_ = pos;
+    if (prefetch && !startReader()) {
+        ESP_LOGW(kTag, "prefetch restart failed; reading synchronously");
+    }
+    return true;
+}
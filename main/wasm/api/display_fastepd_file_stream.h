@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/stream_buffer.h"
+#include "freertos/task.h"
+
+/**
+ * @brief Sequential file reader that prefetches from the SD card on a background task.
+ *
+ * A reader task `fread()`s the file in `kChunkBytes` chunks into a `kRingBytes` stream buffer
+ * while the consumer (a decoder) pulls from the other end, so card I/O overlaps with decoding
+ * and only the ring is ever resident. Forward seeks within the ring are served by skipping;
+ * other seeks restart the reader at the new offset. If the task or ring cannot be created the
+ * stream falls back to plain blocking reads.
+ */
+class FastEpdFileStream {
+public:
+    static constexpr size_t kRingBytes = 16 * 1024;
+    static constexpr size_t kChunkBytes = 4 * 1024;
+
+    ~FastEpdFileStream();
+
+    /** @return `false` if the file cannot be opened. */
+    bool open(const char *path);
+    /** @brief Stop the reader and close the file (also done by the destructor). */
+    void close();
+
+    /** @brief File size in bytes, as seen at `open()`. */
+    int32_t size() const { return size_; }
+    /** @brief Copy up to `len` bytes at the current position; short only at end of file. */
+    int32_t read(uint8_t *buf, int32_t len);
+    /** @return `false` if `pos` is outside the file or the file could not be repositioned. */
+    bool seek(int32_t pos);
+
+private:
+    static void readerEntry(void *arg);
+    bool startReader();
+    void stopReader();
+
+    FILE *file_ = nullptr;
+    int32_t size_ = 0;
+    int32_t pos_ = 0; ///< Consumer position.
+    StreamBufferHandle_t ring_ = nullptr;
+    SemaphoreHandle_t done_ = nullptr; ///< Given by the reader task right before it exits.
+    TaskHandle_t reader_ = nullptr;
+    volatile bool stop_ = false;
+    volatile bool eof_ = false; ///< Reader has queued the last byte of the file.
+    uint8_t chunk_[kChunkBytes];
+};
@@ -0,0 +1,85 @@
+#include "display_fastepd_file_writer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "errors.h"
+
+namespace {
+
+constexpr const char *kTag = "display_fastepd_writer";
+constexpr uint32_t kWriterTaskStack = 1024 * 4;
+/** Below the app and the prefetch readers: the write only has to finish eventually. */
+constexpr UBaseType_t kWriterTaskPriority = 2;
+
+} // namespace
+
+FastEpdFileWriter::~FastEpdFileWriter()
+{
+    wait();
+}
+
+bool FastEpdFileWriter::start(const char *path, uint8_t *data, size_t size)
+{
+    if (!path || !data || status_.load() == kWriting) {
+        return false;
+    }
+    path_ = path;
+    data_ = data;
+    size_ = size;
+    status_.store(kWriting);
+    if (xTaskCreate(writerEntry, "epd_file_wr", kWriterTaskStack, this, kWriterTaskPriority, nullptr) != pdPASS) {
+        data_ = nullptr;
+        status_.store(kWasmErrInternal);
+        return false;
+    }
+    return true;
+}
+
+void FastEpdFileWriter::wait()
+{
+    while (status_.load() == kWriting) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+bool FastEpdFileWriter::writeAll()
+{
+    const std::string tmp = path_ + ".tmp";
+    FILE *file = fopen(tmp.c_str(), "wb");
+    if (!file) {
+        ESP_LOGE(kTag, "%s: open failed", tmp.c_str());
+        return false;
+    }
+    const bool written = fwrite(data_, 1, size_, file) == size_;
+    const bool closed = fclose(file) == 0;
+    if (!written || !closed) {
+        // Leave the previous file in place; only the partial copy goes.
+        ESP_LOGE(kTag, "%s: write failed", tmp.c_str());
+        (void)remove(tmp.c_str());
+        return false;
+    }
+    // FAT cannot rename over an existing file.
+    (void)remove(path_.c_str());
+    if (rename(tmp.c_str(), path_.c_str()) != 0) {
+        ESP_LOGE(kTag, "%s: rename failed", path_.c_str());
+        (void)remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+void FastEpdFileWriter::writerEntry(void *arg)
+{
+    FastEpdFileWriter *self = static_cast<FastEpdFileWriter *>(arg);
+    const bool ok = self->writeAll();
+    free(self->data_);
+    self->data_ = nullptr;
+    ESP_LOGI(kTag, "%s: %u bytes %s", self->path_.c_str(), (unsigned)self->size_, ok ? "written" : "failed");
+    self->status_.store(ok ? kWasmOk : kWasmErrInternal);
+    vTaskDelete(nullptr);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+/**
+ * @brief Writes one file at a time to the SD card on a background task.
+ *
+ * The bytes go to `<path>.tmp` first, which is then renamed over `path`, so readers only ever
+ * see the previous file or the complete new one. Used by `convertJpgFile()`/`convertPngFile()`
+ * to store pre-dithered images without holding up the app.
+ */
+class FastEpdFileWriter {
+public:
+    /** @brief `status()` while a write is in progress. */
+    static constexpr int32_t kWriting = 1;
+
+    ~FastEpdFileWriter();
+
+    /**
+     * @brief Start writing `size` bytes of `data` (from `malloc()`) to `path`.
+     * @return `false` if a write is still running or the task cannot be created; `data` then
+     *         stays with the caller. On success the writer frees it when done.
+     */
+    bool start(const char *path, uint8_t *data, size_t size);
+    /** @return `kWriting`, `kWasmOk` after the last write succeeded (or before any), or a negative error. */
+    int32_t status() const { return status_.load(); }
+    /** @brief Block until the write in progress, if any, has finished. */
+    void wait();
+
+private:
+    static void writerEntry(void *arg);
+    bool writeAll();
+
+    std::string path_;
+    uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    std::atomic<int32_t> status_{0};
+};
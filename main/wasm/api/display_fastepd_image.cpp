@@ -0,0 +1,188 @@
+#include "display_fastepd_image.h"
+
+#include "errors.h"
+#include "../../other/fastepd_pixel_kernels.h"
+
+namespace {
+
+using fastepd_pixel_kernels::lumaRgb8;
+
+inline uint32_t expand6(uint32_t v)
+{
+    return ((v & 0x3Fu) << 2) | ((v & 0x3Fu) >> 4);
+}
+
+const fastepd_pixel_kernels::Rgb565LumaTables &rgb565_luma_tables()
+{
+    static fastepd_pixel_kernels::Rgb565LumaTables tables;
+    static bool built = false;
+    if (!built) {
+        fastepd_pixel_kernels::buildRgb565LumaTables(&tables);
+        built = true;
+    }
+    return tables;
+}
+
+} // namespace
+
+bool FastEpdImageConverter::init(int32_t depth_raw)
+{
+    const uint32_t raw = (uint16_t)depth_raw;
+    const uint32_t bits = raw & kImageDepthBitMask;
+    const bool has_palette = (raw & kImageDepthHasPalette) != 0;
+    const bool nonswapped = (raw & kImageDepthNonswapped) != 0;
+    const bool alternate = (raw & kImageDepthAlternate) != 0;
+
+    palette_entries_ = 0;
+    switch (bits) {
+    case 1:
+        format_ = Format::index1;
+        palette_entries_ = 2;
+        break;
+    case 2:
+        format_ = Format::index2;
+        palette_entries_ = 4;
+        break;
+    case 4:
+        format_ = Format::index4;
+        palette_entries_ = 16;
+        break;
+    case 8:
+        if (has_palette) {
+            format_ = Format::index8;
+            palette_entries_ = 256;
+        } else if (alternate) {
+            format_ = Format::gray8;
+        } else {
+            format_ = Format::rgb332;
+            for (uint32_t v = 0; v < 256; ++v) {
+                const uint32_t r3 = v >> 5;
+                const uint32_t g3 = (v >> 2) & 7u;
+                const uint32_t b2 = v & 3u;
+                gray_lut_[v] = lumaRgb8((r3 * 0x49u) >> 1, (g3 * 0x49u) >> 1, b2 * 0x55u);
+            }
+        }
+        break;
+    case 16:
+        format_ = nonswapped ? Format::rgb565le : Format::rgb565be;
+        (void)rgb565_luma_tables();
+        break;
+    case 24:
+        if (alternate) {
+            format_ = nonswapped ? Format::bgr666 : Format::rgb666;
+        } else {
+            format_ = nonswapped ? Format::bgr888 : Format::rgb888;
+        }
+        break;
+    case 32:
+        format_ = nonswapped ? Format::bgra8888 : Format::argb8888;
+        break;
+    default:
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "pushImage: invalid color depth bit count");
+        return false;
+    }
+    bits_ = bits;
+    return true;
+}
+
+void FastEpdImageConverter::setPalette(const uint8_t *palette)
+{
+    for (uint32_t i = 0; i < palette_entries_; ++i) {
+        const uint8_t *entry = palette + (size_t)i * 4u;
+        gray_lut_[i] = lumaRgb8(entry[2], entry[1], entry[0]);
+    }
+}
+
+template <int BITS>
+void FastEpdImageConverter::convertIndexed(const uint8_t *data, size_t first, size_t n, uint8_t *out) const
+{
+    constexpr uint32_t kPerByte = 8 / BITS;
+    constexpr uint32_t kMask = (1u << BITS) - 1u;
+    const uint8_t *src = data + first / kPerByte;
+    uint32_t slot = (uint32_t)(first % kPerByte);
+
+    // Leading partial byte, then whole bytes unpacked in one go, then the tail.
+    if (slot != 0) {
+        const uint32_t byte = *src++;
+        for (; slot < kPerByte && n > 0; ++slot, --n) {
+            *out++ = gray_lut_[(byte >> (8 - BITS * (slot + 1))) & kMask];
+        }
+    }
+    for (; n >= kPerByte; n -= kPerByte) {
+        const uint32_t byte = *src++;
+        for (uint32_t s = 0; s < kPerByte; ++s) {
+            out[s] = gray_lut_[(byte >> (8 - BITS * (s + 1))) & kMask];
+        }
+        out += kPerByte;
+    }
+    if (n > 0) {
+        const uint32_t byte = *src;
+        for (uint32_t s = 0; s < n; ++s) {
+            *out++ = gray_lut_[(byte >> (8 - BITS * (s + 1))) & kMask];
+        }
+    }
+}
+
+void FastEpdImageConverter::convert(const uint8_t *data, size_t first, size_t n, uint8_t *out) const
+{
+    switch (format_) {
+    case Format::index1:
+        convertIndexed<1>(data, first, n, out);
+        return;
+    case Format::index2:
+        convertIndexed<2>(data, first, n, out);
+        return;
+    case Format::index4:
+        convertIndexed<4>(data, first, n, out);
+        return;
+    case Format::index8:
+    case Format::rgb332: {
+        const uint8_t *src = data + first;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = gray_lut_[src[i]];
+        }
+        return;
+    }
+    case Format::gray8: {
+        const uint8_t *src = data + first;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = src[i];
+        }
+        return;
+    }
+    case Format::rgb565be:
+    case Format::rgb565le:
+        fastepd_pixel_kernels::rgb565RowToGray8(rgb565_luma_tables(), data + first * 2u, n, format_ == Format::rgb565be, out);
+        return;
+    case Format::rgb888:
+    case Format::bgr888: {
+        const uint8_t *src = data + first * 3u;
+        const int r = (format_ == Format::rgb888) ? 0 : 2;
+        for (size_t i = 0; i < n; ++i, src += 3) {
+            out[i] = lumaRgb8(src[r], src[1], src[2 - r]);
+        }
+        return;
+    }
+    case Format::rgb666:
+    case Format::bgr666: {
+        const uint8_t *src = data + first * 3u;
+        const int r = (format_ == Format::rgb666) ? 0 : 2;
+        for (size_t i = 0; i < n; ++i, src += 3) {
+            out[i] = lumaRgb8(expand6(src[r]), expand6(src[1]), expand6(src[2 - r]));
+        }
+        return;
+    }
+    case Format::argb8888:
+    case Format::bgra8888: {
+        const uint8_t *src = data + first * 4u;
+        const bool argb = (format_ == Format::argb8888);
+        const int r = argb ? 1 : 2;
+        const int g = argb ? 2 : 1;
+        const int b = argb ? 3 : 0;
+        for (size_t i = 0; i < n; ++i, src += 4) {
+            out[i] = lumaRgb8(src[r], src[g], src[b]);
+        }
+        return;
+    }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Flag bits of the `depth` argument of `pushImage()`.
+ *
+ * The values mirror `lgfx::color_depth_t` so the same depth works on every display driver.
+ */
+constexpr uint32_t kImageDepthBitMask = 0x00FF;
+constexpr uint32_t kImageDepthNonswapped = 0x0100;
+constexpr uint32_t kImageDepthHasPalette = 0x0800;
+constexpr uint32_t kImageDepthAlternate = 0x1000;
+
+/**
+ * @brief Converts `pushImage()` source pixels of any supported depth into 8-bit grayscale.
+ *
+ * Source pixels are packed back to back (sub-byte depths MSB-first, rows not byte-aligned),
+ * exactly like the LGFX driver expects. Palettes and 8-bit RGB332 go through a 256-entry gray
+ * table; RGB565 is split into two per-byte tables whose sum is the exact luma of the expanded
+ * RGB888 color, so no per-pixel multiplies are needed. Alpha of 32-bit sources is ignored.
+ */
+class FastEpdImageConverter {
+public:
+    /**
+     * @brief Decode a `pushImage()` depth value.
+     * @return `false` (with the last error set) for unsupported bit counts.
+     */
+    bool init(int32_t depth_raw);
+
+    /** @brief Bits per source pixel. */
+    uint32_t bits() const { return bits_; }
+    /** @brief Palette entries required by this depth, or 0 for direct-color depths. */
+    uint32_t paletteEntries() const { return palette_entries_; }
+
+    /**
+     * @brief Load a palette of `paletteEntries()` u32 `0x00RRGGBB` values (little-endian).
+     */
+    void setPalette(const uint8_t *palette);
+
+    /**
+     * @brief Convert `n` pixels starting at pixel index `first` of `data` into `out`.
+     */
+    void convert(const uint8_t *data, size_t first, size_t n, uint8_t *out) const;
+
+private:
+    enum class Format : uint8_t {
+        index1,
+        index2,
+        index4,
+        index8,
+        rgb332,
+        gray8,
+        rgb565be,
+        rgb565le,
+        rgb888, ///< bytes R, G, B
+        bgr888, ///< bytes B, G, R
+        rgb666, ///< bytes R, G, B, 6 significant bits each
+        bgr666, ///< bytes B, G, R, 6 significant bits each
+        argb8888, ///< bytes A, R, G, B
+        bgra8888, ///< bytes B, G, R, A
+    };
+
+    template <int BITS>
+    void convertIndexed(const uint8_t *data, size_t first, size_t n, uint8_t *out) const;
+
+    Format format_ = Format::gray8;
+    uint32_t bits_ = 8;
+    uint32_t palette_entries_ = 0;
+    uint8_t gray_lut_[256] = {};
+};
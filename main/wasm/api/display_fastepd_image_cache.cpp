@@ -0,0 +1,89 @@
+#include "display_fastepd_image_cache.h"
+
+#include "display_fastepd_canvas.h"
+#include "../../other/fastepd_native_utils.h"
+
+FASTEPD *FastEpdImageCache::find(const FastEpdImageCacheKey &key)
+{
+    for (Entry &entry : entries_) {
+        if (entry.tile && entry.key == key) {
+            entry.last_use = ++clock_;
+            return entry.tile.get();
+        }
+    }
+    return nullptr;
+}
+
+FASTEPD *FastEpdImageCache::insert(const FastEpdImageCacheKey &key, std::unique_ptr<FASTEPD> tile)
+{
+    fastepd_native_utils::NativeLayout layout;
+    if (!tile || !fastepd_native_utils::describeNativeLayout(*tile, &layout)) {
+        fastepd_sprite_destroy(tile);
+        return nullptr;
+    }
+    const size_t tile_bytes = fastepd_native_utils::frameBytes(layout);
+    if (tile_bytes > kBudgetBytes) {
+        fastepd_sprite_destroy(tile);
+        return nullptr;
+    }
+
+    // Older revisions of the same image for the same target will never hit again.
+    for (Entry &entry : entries_) {
+        if (entry.tile && entry.key.path == key.path && entry.key.kind == key.kind && entry.key.mode == key.mode &&
+            entry.key.dither == key.dither && entry.key.box_w == key.box_w && entry.key.box_h == key.box_h) {
+            evict(entry);
+        }
+    }
+
+    Entry *slot = nullptr;
+    while (true) {
+        Entry *free_slot = nullptr;
+        Entry *oldest = nullptr;
+        for (Entry &entry : entries_) {
+            if (!entry.tile) {
+                if (!free_slot) {
+                    free_slot = &entry;
+                }
+            } else if (!oldest || entry.last_use < oldest->last_use) {
+                oldest = &entry;
+            }
+        }
+        if (free_slot && bytes_ + tile_bytes <= kBudgetBytes) {
+            slot = free_slot;
+            break;
+        }
+        if (!oldest) {
+            break;
+        }
+        evict(*oldest);
+    }
+    if (!slot) {
+        fastepd_sprite_destroy(tile);
+        return nullptr;
+    }
+
+    slot->key = key;
+    slot->tile = std::move(tile);
+    slot->bytes = tile_bytes;
+    slot->last_use = ++clock_;
+    bytes_ += tile_bytes;
+    return slot->tile.get();
+}
+
+void FastEpdImageCache::clear()
+{
+    for (Entry &entry : entries_) {
+        if (entry.tile) {
+            evict(entry);
+        }
+    }
+    clock_ = 0;
+}
+
+void FastEpdImageCache::evict(Entry &entry)
+{
+    fastepd_sprite_destroy(entry.tile);
+    bytes_ -= entry.bytes;
+    entry.bytes = 0;
+    entry.key = FastEpdImageCacheKey{};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include <FastEPD.h>
+
+/** @brief Identity of a decoded image file: what was decoded, from which revision, for which target. */
+struct FastEpdImageCacheKey {
+    std::string path;
+    int64_t mtime = 0; ///< `st_mtime` of the file when it was decoded.
+    int64_t size = 0; ///< `st_size` of the file when it was decoded.
+    int32_t kind = 0; ///< Decoder tag chosen by the caller (JPEG, PNG, ...).
+    int32_t mode = 0; ///< FastEPD mode of the tile.
+    int32_t dither = 0; ///< `DisplayDitherMode` the tile was quantized with.
+    int32_t box_w = 0; ///< Fit box the image was decoded for.
+    int32_t box_h = 0;
+
+    bool operator==(const FastEpdImageCacheKey &other) const
+    {
+        return mtime == other.mtime && size == other.size && kind == other.kind && mode == other.mode &&
+               dither == other.dither && box_w == other.box_w && box_h == other.box_h && path == other.path;
+    }
+};
+
+/**
+ * @brief LRU of decoded, already-quantized images kept as FastEPD sprites.
+ *
+ * Each tile holds an image exactly as the decoder drew it (native packed format, mode of the
+ * target, dither mode of the time), so a hit is a straight `fastepd_native_utils::compositeLayout()`
+ * into the framebuffer. Tiles are charged by their packed buffer size against a byte budget; the least
+ * recently used ones are dropped first. A file that changes on disk gets a new key through its
+ * mtime/size, and its stale tiles are replaced on the next insert.
+ */
+class FastEpdImageCache {
+public:
+    /** Byte budget: four full 960x540 frames at 4bpp. */
+    static constexpr size_t kBudgetBytes = 1024 * 1024;
+    static constexpr int kMaxEntries = 32;
+
+    /** @brief Tile for `key`, marked most recently used, or null on a miss. */
+    FASTEPD *find(const FastEpdImageCacheKey &key);
+    /**
+     * @brief Take ownership of `tile` (a sprite from `fastepd_sprite_create()`) under `key`.
+     * @return The cached tile, or null if it does not fit the budget (the tile is then freed).
+     */
+    FASTEPD *insert(const FastEpdImageCacheKey &key, std::unique_ptr<FASTEPD> tile);
+    /** @brief Free every tile. */
+    void clear();
+
+    /** @brief Packed bytes currently held by tiles. */
+    size_t bytes() const { return bytes_; }
+
+private:
+    struct Entry {
+        FastEpdImageCacheKey key;
+        std::unique_ptr<FASTEPD> tile;
+        size_t bytes = 0;
+        uint32_t last_use = 0;
+    };
+
+    void evict(Entry &entry);
+
+    Entry entries_[kMaxEntries];
+    size_t bytes_ = 0;
+    uint32_t clock_ = 0;
+};
@@ -0,0 +1,55 @@
+#include "display_fastepd_parallel.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+namespace {
+
+struct CoreWorker {
+    FastEpdCoreJob job;
+    void *arg;
+    SemaphoreHandle_t done;
+};
+
+void core_worker_entry(void *param)
+{
+    auto *worker = static_cast<CoreWorker *>(param);
+    worker->job(worker->arg);
+    xSemaphoreGive(worker->done);
+    vTaskDelete(nullptr);
+}
+
+} // namespace
+
+void fastepd_run_on_both_cores(FastEpdCoreJob job, void *const args[2], uint32_t stack_bytes)
+{
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(2, 0);
+    if (!done) {
+        job(args[0]);
+        job(args[1]);
+        return;
+    }
+
+    CoreWorker workers[2] = {{job, args[0], done}, {job, args[1], done}};
+    const UBaseType_t priority = uxTaskPriorityGet(nullptr);
+    int started = 0;
+    bool inline_half[2] = {false, false};
+    for (int core = 0; core < 2; ++core) {
+        if (xTaskCreatePinnedToCore(core_worker_entry, "epd_core_job", stack_bytes, &workers[core], priority, nullptr, core) ==
+            pdPASS) {
+            ++started;
+        } else {
+            inline_half[core] = true;
+        }
+    }
+    for (int core = 0; core < 2; ++core) {
+        if (inline_half[core]) {
+            job(args[core]);
+        }
+    }
+    for (int i = 0; i < started; ++i) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done);
+}
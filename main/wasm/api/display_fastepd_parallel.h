@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+/** @brief One half of a job split across both cores. */
+typedef void (*FastEpdCoreJob)(void *arg);
+
+/**
+ * @brief Run `job(args[0])` on core 0 and `job(args[1])` on core 1, returning once both are done.
+ *
+ * Each half runs on a short-lived task pinned to its core at the caller's priority; the caller
+ * blocks until both have finished. A half whose task cannot be created runs on the calling task
+ * instead, so every half always runs exactly once. Halves must not touch shared state without
+ * their own synchronisation.
+ */
+void fastepd_run_on_both_cores(FastEpdCoreJob job, void *const args[2], uint32_t stack_bytes);
@@ -0,0 +1,375 @@
+#include "display_fastepd_png.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp32s3/rom/miniz.h"
+
+namespace {
+
+constexpr uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+constexpr int32_t kColorGray = 0;
+constexpr int32_t kColorPalette = 3;
+constexpr int32_t kColorGrayAlpha = 4;
+
+// Adam7 pass origins and steps; a non-interlaced image is the single pass 6 (every pixel).
+constexpr int32_t kPassX0[7] = {0, 4, 0, 2, 0, 1, 0};
+constexpr int32_t kPassY0[7] = {0, 0, 4, 0, 2, 0, 1};
+constexpr int32_t kPassDx[7] = {8, 8, 4, 4, 2, 2, 1};
+constexpr int32_t kPassDy[7] = {8, 8, 8, 4, 4, 2, 2};
+
+inline uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/** @brief Rounded `(gray * a + 255 * (255 - a)) / 255`: gray composited over white. */
+inline uint8_t over_white(uint32_t gray, uint32_t a)
+{
+    const uint32_t t = gray * a + 255u * (255u - a) + 128u;
+    return (uint8_t)((t + (t >> 8)) >> 8);
+}
+
+inline uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    const int32_t p = (int32_t)a + b - c;
+    const int32_t pa = p > a ? p - a : a - p;
+    const int32_t pb = p > b ? p - b : b - p;
+    const int32_t pc = p > c ? p - c : c - p;
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+/** @brief Undo PNG filter `type` on `row` (`n` bytes) in place, given the previous unfiltered row. */
+bool unfilter(uint8_t type, uint8_t *row, const uint8_t *prev, size_t n, size_t bpp)
+{
+    switch (type) {
+    case 0:
+        return true;
+    case 1:
+        for (size_t i = bpp; i < n; ++i) {
+            row[i] = (uint8_t)(row[i] + row[i - bpp]);
+        }
+        return true;
+    case 2:
+        for (size_t i = 0; i < n; ++i) {
+            row[i] = (uint8_t)(row[i] + prev[i]);
+        }
+        return true;
+    case 3:
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t left = i >= bpp ? row[i - bpp] : 0u;
+            row[i] = (uint8_t)(row[i] + ((left + prev[i]) >> 1));
+        }
+        return true;
+    case 4:
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t left = i >= bpp ? row[i - bpp] : 0;
+            const uint8_t up_left = i >= bpp ? prev[i - bpp] : 0;
+            row[i] = (uint8_t)(row[i] + paeth(left, prev[i], up_left));
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+FastEpdPngDecoder::~FastEpdPngDecoder()
+{
+    release();
+}
+
+void FastEpdPngDecoder::release()
+{
+    free(inflator_);
+    free(window_);
+    free(cur_);
+    free(prev_);
+    free(gray_);
+    inflator_ = nullptr;
+    window_ = nullptr;
+    cur_ = nullptr;
+    prev_ = nullptr;
+    gray_ = nullptr;
+}
+
+bool FastEpdPngDecoder::open(const uint8_t *data, size_t len)
+{
+    release();
+    data_ = nullptr;
+    first_idat_ = 0;
+    if (!data || len < 8 + 25 || memcmp(data, kSignature, sizeof(kSignature)) != 0) {
+        return false;
+    }
+
+    const uint8_t *palette = nullptr;
+    size_t palette_len = 0;
+    const uint8_t *trns = nullptr;
+    size_t trns_len = 0;
+    bool have_header = false;
+    size_t pos = 8;
+    while (pos + 12 <= len) {
+        const uint32_t chunk_len = read_be32(data + pos);
+        const uint8_t *type = data + pos + 4;
+        const uint8_t *body = data + pos + 8;
+        if (chunk_len > len - pos - 12) {
+            return false;
+        }
+        if (!have_header) {
+            if (memcmp(type, "IHDR", 4) != 0 || chunk_len != 13) {
+                return false;
+            }
+            const uint32_t w = read_be32(body);
+            const uint32_t h = read_be32(body + 4);
+            if (w == 0 || h == 0 || w > 0x7FFF || h > 0x7FFF || body[10] != 0 || body[11] != 0 || body[12] > 1) {
+                return false;
+            }
+            width_ = (int32_t)w;
+            height_ = (int32_t)h;
+            depth_ = body[8];
+            color_type_ = body[9];
+            interlaced_ = body[12] == 1;
+            have_header = true;
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            palette = body;
+            palette_len = chunk_len;
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            trns = body;
+            trns_len = chunk_len;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            if (first_idat_ == 0) {
+                first_idat_ = pos;
+            }
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + chunk_len;
+    }
+    if (!have_header || first_idat_ == 0) {
+        return false;
+    }
+
+    int32_t channels = 1;
+    trns_key_ = -1;
+    switch (color_type_) {
+    case kColorGray: {
+        if (depth_ != 1 && depth_ != 2 && depth_ != 4 && depth_ != 8 && depth_ != 16) {
+            return false;
+        }
+        const int32_t key = (trns && trns_len >= 2) ? (int32_t)((trns[0] << 8) | trns[1]) : -1;
+        if (depth_ == 16) {
+            for (int32_t v = 0; v < 256; ++v) {
+                lut_[v] = (uint8_t)v;
+            }
+            trns_key_ = key;
+        } else {
+            const int32_t max_sample = (1 << depth_) - 1;
+            for (int32_t v = 0; v <= max_sample; ++v) {
+                lut_[v] = (uint8_t)((v * 255 + max_sample / 2) / max_sample);
+            }
+            if (key >= 0 && key <= max_sample) {
+                lut_[key] = 255;
+            }
+        }
+        break;
+    }
+    case kColorPalette: {
+        if ((depth_ != 1 && depth_ != 2 && depth_ != 4 && depth_ != 8) || !palette || palette_len % 3 != 0) {
+            return false;
+        }
+        memset(lut_, 0, sizeof(lut_));
+        const size_t entries = palette_len / 3 < 256 ? palette_len / 3 : 256;
+        for (size_t i = 0; i < entries; ++i) {
+            const uint8_t *rgb = palette + i * 3;
+            const uint32_t gray = (rgb[0] * 77u + rgb[1] * 150u + rgb[2] * 29u + 128u) >> 8;
+            const uint32_t a = (trns && i < trns_len) ? trns[i] : 255u;
+            lut_[i] = a == 255u ? (uint8_t)gray : over_white(gray, a);
+        }
+        break;
+    }
+    case kColorGrayAlpha:
+        if (depth_ != 8 && depth_ != 16) {
+            return false;
+        }
+        channels = 2;
+        break;
+    default:
+        return false;
+    }
+    const int32_t bits = depth_ * channels;
+    pixel_bytes_ = bits < 8 ? 1 : bits / 8;
+    data_ = data;
+    len_ = len;
+    return true;
+}
+
+bool FastEpdPngDecoder::startPass()
+{
+    // Passes with no pixels have no rows in the data stream.
+    while (pass_ < 7) {
+        const int32_t x0 = interlaced_ ? kPassX0[pass_] : 0;
+        const int32_t y0 = interlaced_ ? kPassY0[pass_] : 0;
+        const int32_t dx = interlaced_ ? kPassDx[pass_] : 1;
+        const int32_t dy = interlaced_ ? kPassDy[pass_] : 1;
+        pass_w_ = width_ > x0 ? (width_ - x0 + dx - 1) / dx : 0;
+        pass_h_ = height_ > y0 ? (height_ - y0 + dy - 1) / dy : 0;
+        if (pass_w_ > 0 && pass_h_ > 0) {
+            const int32_t channels = color_type_ == kColorGrayAlpha ? 2 : 1;
+            row_bytes_ = ((size_t)pass_w_ * (size_t)(depth_ * channels) + 7u) / 8u;
+            memset(prev_, 0, row_bytes_);
+            pass_row_ = 0;
+            fill_ = 0;
+            return true;
+        }
+        if (!interlaced_) {
+            break;
+        }
+        ++pass_;
+    }
+    done_ = true;
+    return false;
+}
+
+void FastEpdPngDecoder::emitRow()
+{
+    const uint8_t *src = cur_ + 1;
+    uint8_t *gray = gray_;
+    const int32_t n = pass_w_;
+    if (color_type_ == kColorGrayAlpha) {
+        const int32_t stride = depth_ == 16 ? 4 : 2;
+        const int32_t alpha = depth_ == 16 ? 2 : 1;
+        for (int32_t i = 0; i < n; ++i, src += stride) {
+            const uint8_t a = src[alpha];
+            gray[i] = a == 255 ? src[0] : over_white(src[0], a);
+        }
+    } else if (depth_ == 16) {
+        for (int32_t i = 0; i < n; ++i, src += 2) {
+            gray[i] = ((int32_t)((src[0] << 8) | src[1]) == trns_key_) ? 255 : src[0];
+        }
+    } else if (depth_ == 8) {
+        for (int32_t i = 0; i < n; ++i) {
+            gray[i] = lut_[src[i]];
+        }
+    } else {
+        // Packed samples, most significant first.
+        const int32_t per_byte = 8 / depth_;
+        const uint32_t mask = (1u << depth_) - 1u;
+        for (int32_t i = 0; i < n; ++i) {
+            const int32_t shift = 8 - depth_ * (i % per_byte + 1);
+            gray[i] = lut_[(src[i / per_byte] >> shift) & mask];
+        }
+    }
+
+    const int32_t y = interlaced_ ? kPassY0[pass_] + pass_row_ * kPassDy[pass_] : pass_row_;
+    const int32_t x0 = interlaced_ ? kPassX0[pass_] : 0;
+    const int32_t dx = interlaced_ ? kPassDx[pass_] : 1;
+    row_cb_(user_, y, x0, dx, gray, n);
+}
+
+bool FastEpdPngDecoder::consume(const uint8_t *data, size_t len)
+{
+    while (len > 0 && !done_) {
+        const size_t need = row_bytes_ + 1 - fill_;
+        const size_t n = len < need ? len : need;
+        memcpy(cur_ + fill_, data, n);
+        fill_ += n;
+        data += n;
+        len -= n;
+        if (fill_ < row_bytes_ + 1) {
+            break;
+        }
+        if (!unfilter(cur_[0], cur_ + 1, prev_, row_bytes_, (size_t)pixel_bytes_)) {
+            return false;
+        }
+        emitRow();
+        memcpy(prev_, cur_ + 1, row_bytes_);
+        fill_ = 0;
+        if (++pass_row_ == pass_h_) {
+            if (!interlaced_) {
+                done_ = true;
+            } else {
+                ++pass_;
+                startPass();
+            }
+        }
+    }
+    return true;
+}
+
+bool FastEpdPngDecoder::decode(RowCallback row, void *user)
+{
+    if (!data_ || !row) {
+        return false;
+    }
+    release();
+    row_cb_ = row;
+    user_ = user;
+    const int32_t channels = color_type_ == kColorGrayAlpha ? 2 : 1;
+    const size_t max_row = ((size_t)width_ * (size_t)(depth_ * channels) + 7u) / 8u;
+    inflator_ = (tinfl_decompressor_tag *)malloc(sizeof(tinfl_decompressor));
+    window_ = (uint8_t *)malloc(TINFL_LZ_DICT_SIZE);
+    cur_ = (uint8_t *)malloc(max_row + 1);
+    prev_ = (uint8_t *)malloc(max_row);
+    gray_ = (uint8_t *)malloc((size_t)width_);
+    if (!inflator_ || !window_ || !cur_ || !prev_ || !gray_) {
+        release();
+        return false;
+    }
+    tinfl_init(inflator_);
+    pass_ = 0;
+    done_ = false;
+    startPass();
+
+    // IDAT chunks are consecutive; their payloads form one zlib stream.
+    size_t window_pos = 0;
+    bool ok = true;
+    bool stream_end = false;
+    size_t pos = first_idat_;
+    while (ok && !stream_end && !done_ && pos + 12 <= len_ && memcmp(data_ + pos + 4, "IDAT", 4) == 0) {
+        const uint32_t chunk_len = read_be32(data_ + pos);
+        if (chunk_len > len_ - pos - 12) {
+            ok = false;
+            break;
+        }
+        const uint8_t *in = data_ + pos + 8;
+        size_t in_left = chunk_len;
+        pos += 12 + chunk_len;
+        for (;;) {
+            size_t in_bytes = in_left;
+            size_t out_bytes = TINFL_LZ_DICT_SIZE - window_pos;
+            const tinfl_status status =
+                tinfl_decompress(inflator_, in, &in_bytes, window_, window_ + window_pos, &out_bytes,
+                                 TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+            in += in_bytes;
+            in_left -= in_bytes;
+            if (out_bytes > 0 && !consume(window_ + window_pos, out_bytes)) {
+                ok = false;
+                break;
+            }
+            window_pos = (window_pos + out_bytes) & (TINFL_LZ_DICT_SIZE - 1);
+            if (status < TINFL_STATUS_DONE) {
+                ok = false;
+                break;
+            }
+            if (status == TINFL_STATUS_DONE) {
+                stream_end = true;
+                break;
+            }
+            if (done_ || (status == TINFL_STATUS_NEEDS_MORE_INPUT && in_left == 0)) {
+                break;
+            }
+            if (in_bytes == 0 && out_bytes == 0) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    ok = ok && done_;
+    release();
+    return ok;
+}
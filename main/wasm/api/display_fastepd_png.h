@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct tinfl_decompressor_tag;
+
+/**
+ * @brief PNG decoder for grayscale and palette images that yields gray8 rows directly.
+ *
+ * Handles grayscale (1..16 bits, optional tRNS key), grayscale + alpha (8/16 bits) and palette
+ * (1..8 bits, optional tRNS alphas) images, interlaced or not. Samples are mapped to gray
+ * composited over white through a 256-entry table built per image from the bit depth, palette
+ * and transparency, so rows never pass through a 4-byte ARGB form. IDAT data is inflated with
+ * the ROM `tinfl` into a 32 KiB window and unfiltered one row at a time; only the window, two
+ * filtered rows and one gray row are resident. Other color types are left to the generic
+ * decoder (`open()` returns `false`).
+ */
+class FastEpdPngDecoder {
+public:
+    /**
+     * @brief Receives `n` gray pixels of image row `y`, for columns `x0`, `x0 + dx`, ...
+     *
+     * `dx` is 1 except for the passes of an interlaced image, whose rows arrive pass by pass.
+     */
+    typedef void (*RowCallback)(void *user, int32_t y, int32_t x0, int32_t dx, const uint8_t *gray, int32_t n);
+
+    ~FastEpdPngDecoder();
+
+    /**
+     * @brief Parse the chunks of the in-memory PNG `data` (kept by reference until `decode()`).
+     * @return `false` if it is malformed or not a type this decoder handles.
+     */
+    bool open(const uint8_t *data, size_t len);
+
+    int32_t width() const { return width_; }
+    int32_t height() const { return height_; }
+    bool interlaced() const { return interlaced_; }
+
+    /**
+     * @brief Inflate the image and pass every row of every pass to `row`.
+     * @return `false` on corrupt data, truncated data, or if the buffers cannot be allocated.
+     */
+    bool decode(RowCallback row, void *user);
+
+private:
+    bool startPass();
+    bool consume(const uint8_t *data, size_t len);
+    void emitRow();
+    void release();
+
+    const uint8_t *data_ = nullptr;
+    size_t len_ = 0;
+    size_t first_idat_ = 0; ///< Offset of the first IDAT chunk header.
+    int32_t width_ = 0;
+    int32_t height_ = 0;
+    int32_t depth_ = 0;
+    int32_t color_type_ = 0;
+    bool interlaced_ = false;
+    int32_t pixel_bytes_ = 1; ///< Filter distance: bytes per pixel, at least 1.
+    int32_t trns_key_ = -1; ///< Transparent sample of a 16-bit grayscale image, or -1.
+    uint8_t lut_[256] = {}; ///< Sample or palette index -> gray over white (up to 8 bits).
+
+    RowCallback row_cb_ = nullptr;
+    void *user_ = nullptr;
+    tinfl_decompressor_tag *inflator_ = nullptr;
+    uint8_t *window_ = nullptr;
+    uint8_t *cur_ = nullptr; ///< Filter type byte plus the row being filled.
+    uint8_t *prev_ = nullptr; ///< Previous unfiltered row of the pass (zeros at pass start).
+    uint8_t *gray_ = nullptr;
+    int32_t pass_ = 0;
+    int32_t pass_w_ = 0;
+    int32_t pass_h_ = 0;
+    int32_t pass_row_ = 0;
+    size_t row_bytes_ = 0; ///< Filtered bytes of a row of the current pass, without the filter byte.
+    size_t fill_ = 0; ///< Bytes of `cur_` filled so far.
+    bool done_ = false;
+};
@@ -0,0 +1,103 @@
+#include "display_fastepd_refresh.h"
+
+#include "esp_log.h"
+
+namespace {
+
+constexpr const char *kTag = "display_fastepd_refresh";
+constexpr uint32_t kRefreshTaskStack = 1024 * 4;
+constexpr UBaseType_t kRefreshTaskPriority = 5;
+
+} // namespace
+
+bool FastEpdRefreshWorker::ensureTask()
+{
+    if (task_) {
+        return true;
+    }
+    if (!start_) {
+        start_ = xSemaphoreCreateBinary();
+    }
+    if (!idle_) {
+        idle_ = xSemaphoreCreateBinary();
+        if (idle_) {
+            xSemaphoreGive(idle_);
+        }
+    }
+    if (!start_ || !idle_) {
+        ESP_LOGW(kTag, "failed to create refresh semaphores");
+        return false;
+    }
+    BaseType_t ok = xTaskCreate(taskEntry, "epd_refresh", kRefreshTaskStack, this, kRefreshTaskPriority, &task_);
+    if (ok != pdPASS) {
+        ESP_LOGW(kTag, "failed to create refresh task");
+        task_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void FastEpdRefreshWorker::taskEntry(void *arg)
+{
+    FastEpdRefreshWorker *self = static_cast<FastEpdRefreshWorker *>(arg);
+    for (;;) {
+        if (xSemaphoreTake(self->start_, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        self->run(self->job_);
+        self->busy_ = false;
+        xSemaphoreGive(self->idle_);
+    }
+}
+
+void FastEpdRefreshWorker::run(const Job &job)
+{
+    int rc = BBEP_SUCCESS;
+    if (job.smooth) {
+        rc = epd_->smoothUpdate(true, BBEP_WHITE);
+    } else if (job.rect_count <= 0) {
+        rc = epd_->fullUpdate(job.clear_mode, true);
+    } else {
+        for (int i = 0; i < job.rect_count && rc == BBEP_SUCCESS; ++i) {
+            BB_RECT rect = job.rects[i];
+            rc = epd_->fullUpdate(job.clear_mode, true, &rect);
+        }
+    }
+    if (rc != BBEP_SUCCESS) {
+        ESP_LOGW(kTag, "FastEPD %s failed (%d)", job.smooth ? "smoothUpdate" : "fullUpdate", rc);
+        if (result_ == BBEP_SUCCESS) {
+            result_ = rc;
+        }
+    }
+}
+
+bool FastEpdRefreshWorker::submit(FASTEPD *epd, const Job &job)
+{
+    wait();
+    epd_ = epd;
+    if (!ensureTask()) {
+        run(job);
+        return false;
+    }
+    xSemaphoreTake(idle_, portMAX_DELAY);
+    job_ = job;
+    busy_ = true;
+    xSemaphoreGive(start_);
+    return true;
+}
+
+void FastEpdRefreshWorker::wait()
+{
+    if (!idle_ || !busy_) {
+        return;
+    }
+    xSemaphoreTake(idle_, portMAX_DELAY);
+    xSemaphoreGive(idle_);
+}
+
+int FastEpdRefreshWorker::takeResult()
+{
+    const int rc = result_;
+    result_ = BBEP_SUCCESS;
+    return rc;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <FastEPD.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+/**
+ * @brief Background task that drives FastEPD panel refreshes off the WASM thread.
+ *
+ * FastEPD reads the live framebuffer for the whole waveform, so a submitted refresh owns the
+ * framebuffer until it completes: callers must `wait()` before touching pixels again. Work that
+ * does not draw (touch, microtasks, networking) keeps running while the panel updates.
+ */
+class FastEpdRefreshWorker {
+public:
+    /** Maximum number of rects a single job can refresh. */
+    static constexpr int kMaxRects = 8;
+
+    /** @brief One refresh request: the whole panel, or up to `kMaxRects` logical rects. */
+    struct Job {
+        int clear_mode; ///< FastEPD `CLEAR_*` waveform selector.
+        int rect_count; ///< 0 refreshes the whole panel.
+        bool smooth; ///< Whole-panel `smoothUpdate()` instead of `fullUpdate()`; ignores the other fields.
+        BB_RECT rects[kMaxRects];
+    };
+
+    /**
+     * @brief Queue a refresh, waiting for any job still in flight first.
+     * @return `false` if the task could not be created; the job then runs synchronously.
+     */
+    bool submit(FASTEPD *epd, const Job &job);
+    /** @brief Block until no refresh is in flight. */
+    void wait();
+    /** @brief True while a submitted refresh has not finished. */
+    bool busy() const { return busy_; }
+    /**
+     * @brief Return the FastEPD result of the first failed refresh since the last call.
+     * @return `BBEP_SUCCESS` when every refresh succeeded.
+     */
+    int takeResult();
+
+private:
+    bool ensureTask();
+    static void taskEntry(void *arg);
+    void run(const Job &job);
+
+    TaskHandle_t task_ = nullptr;
+    SemaphoreHandle_t start_ = nullptr;
+    SemaphoreHandle_t idle_ = nullptr;
+    FASTEPD *epd_ = nullptr;
+    Job job_ = {};
+    volatile bool busy_ = false;
+    volatile int result_ = BBEP_SUCCESS;
+};
@@ -0,0 +1,112 @@
+#include "display_fastepd_resample.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+FastEpdAreaResampler::~FastEpdAreaResampler()
+{
+    release();
+}
+
+void FastEpdAreaResampler::release()
+{
+    free(col_index_);
+    free(col_weight_);
+    free(row_sum_);
+    free(acc_);
+    col_index_ = nullptr;
+    col_weight_ = nullptr;
+    row_sum_ = nullptr;
+    acc_ = nullptr;
+}
+
+bool FastEpdAreaResampler::begin(int32_t src_w, int32_t src_h, int32_t dst_w, int32_t dst_h)
+{
+    release();
+    if (dst_w <= 0 || dst_h <= 0 || dst_w > src_w || dst_h > src_h || src_w > 65535 || src_h > 65535) {
+        return false;
+    }
+    src_w_ = src_w;
+    src_h_ = src_h;
+    dst_w_ = dst_w;
+    dst_h_ = dst_h;
+    first_row_ = 0;
+    end_row_ = dst_h;
+    col_index_ = (uint16_t *)malloc((size_t)src_w * sizeof(uint16_t));
+    col_weight_ = (uint16_t *)malloc((size_t)src_w * sizeof(uint16_t));
+    row_sum_ = (uint32_t *)malloc((size_t)dst_w * sizeof(uint32_t));
+    acc_ = (uint32_t *)calloc((size_t)dst_w, sizeof(uint32_t));
+    if (!col_index_ || !col_weight_ || !row_sum_ || !acc_) {
+        release();
+        return false;
+    }
+    for (int32_t j = 0; j < src_w; ++j) {
+        const uint32_t start = (uint32_t)j * (uint32_t)dst_w;
+        const uint32_t i = start / (uint32_t)src_w;
+        const uint32_t room = (i + 1u) * (uint32_t)src_w - start;
+        col_index_[j] = (uint16_t)i;
+        col_weight_[j] = (uint16_t)(room < (uint32_t)dst_w ? room : (uint32_t)dst_w);
+    }
+    return true;
+}
+
+void FastEpdAreaResampler::setRowWindow(int32_t first_row, int32_t end_row)
+{
+    first_row_ = first_row < 0 ? 0 : first_row;
+    end_row_ = end_row > dst_h_ ? dst_h_ : end_row;
+}
+
+int32_t FastEpdAreaResampler::pushRow(int32_t src_y, const uint8_t *src, uint8_t *out)
+{
+    if (!acc_ || src_y < 0 || src_y >= src_h_) {
+        return -1;
+    }
+    const uint32_t start = (uint32_t)src_y * (uint32_t)dst_h_;
+    const uint32_t row = start / (uint32_t)src_h_;
+    // A source row feeds `row` and possibly `row + 1`; skip it if neither is in the window.
+    if ((int32_t)row + 1 < first_row_ || (int32_t)row >= end_row_) {
+        return -1;
+    }
+
+    // Horizontal pass: sum of value * coverage, then normalised to gray * 256.
+    memset(row_sum_, 0, (size_t)dst_w_ * sizeof(uint32_t));
+    const uint32_t span = (uint32_t)dst_w_;
+    for (int32_t j = 0; j < src_w_; ++j) {
+        const uint32_t v = src[j];
+        const uint32_t i = col_index_[j];
+        const uint32_t w = col_weight_[j];
+        row_sum_[i] += v * w;
+        if (w < span) {
+            row_sum_[i + 1] += v * (span - w);
+        }
+    }
+    const uint32_t half_w = (uint32_t)src_w_ / 2u;
+    for (int32_t i = 0; i < dst_w_; ++i) {
+        row_sum_[i] = ((row_sum_[i] << 8) + half_w) / (uint32_t)src_w_;
+    }
+
+    // Vertical pass: the same split between the current output row and the next one.
+    const uint32_t room = (row + 1u) * (uint32_t)src_h_ - start;
+    const uint32_t w = room < (uint32_t)dst_h_ ? room : (uint32_t)dst_h_;
+    const uint32_t rest = (uint32_t)dst_h_ - w;
+    if ((int32_t)row < first_row_) {
+        // Only the spill into the first window row counts.
+        for (int32_t i = 0; i < dst_w_; ++i) {
+            acc_[i] = row_sum_[i] * rest;
+        }
+        return -1;
+    }
+    for (int32_t i = 0; i < dst_w_; ++i) {
+        acc_[i] += row_sum_[i] * w;
+    }
+    if (room > (uint32_t)dst_h_) {
+        return -1;
+    }
+
+    const uint32_t area = (uint32_t)src_h_ << 8;
+    for (int32_t i = 0; i < dst_w_; ++i) {
+        out[i] = (uint8_t)((acc_[i] + area / 2u) / area);
+        acc_[i] = row_sum_[i] * rest;
+    }
+    return (int32_t)row;
+}
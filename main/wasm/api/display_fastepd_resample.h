@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Streaming area-averaging downscaler for gray8 rows.
+ *
+ * Every output pixel is the exact average of the source area it covers, with fractional edge
+ * coverage. Weights are integers: along each axis a source pixel is `dst` units wide and an
+ * output pixel `src` units wide, so a source pixel feeds at most two output pixels. Rows are
+ * pushed top to bottom and each completed output row is returned as soon as its last source
+ * row arrives, so only one accumulator row is resident.
+ */
+class FastEpdAreaResampler {
+public:
+    ~FastEpdAreaResampler();
+
+    /**
+     * @brief Prepare for a `src_w` x `src_h` -> `dst_w` x `dst_h` reduction (no upscaling).
+     * @return `false` on invalid sizes (anything above 65535) or if the tables cannot be allocated.
+     */
+    bool begin(int32_t src_w, int32_t src_h, int32_t dst_w, int32_t dst_h);
+
+    /**
+     * @brief Only produce output rows `[first_row, end_row)`; the default is every row.
+     *
+     * Source rows that feed nothing in the window are ignored, so a band of the output can be
+     * built from any run of source rows that covers it. Call after `begin()`.
+     */
+    void setRowWindow(int32_t first_row, int32_t end_row);
+
+    /**
+     * @brief Accumulate source row `src_y` (`src_w` pixels); rows must arrive in increasing order.
+     * @return Index of the output row written to `out` (`dst_w` pixels), or -1 if none completed.
+     */
+    int32_t pushRow(int32_t src_y, const uint8_t *src, uint8_t *out);
+
+private:
+    void release();
+
+    int32_t src_w_ = 0;
+    int32_t src_h_ = 0;
+    int32_t dst_w_ = 0;
+    int32_t dst_h_ = 0;
+    int32_t first_row_ = 0;
+    int32_t end_row_ = 0;
+    uint16_t *col_index_ = nullptr; ///< First output column fed by each source column.
+    uint16_t *col_weight_ = nullptr; ///< Its share; the rest of `dst_w_` goes to the next column.
+    uint32_t *row_sum_ = nullptr; ///< Current source row, reduced horizontally (gray * 256).
+    uint32_t *acc_ = nullptr; ///< Output row being accumulated (gray * 256 * vertical weight).
+};
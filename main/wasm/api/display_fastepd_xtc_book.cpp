@@ -0,0 +1,99 @@
+#include "display_fastepd_xtc_book.h"
+
+#include <new>
+
+#include "esp_log.h"
+
+namespace {
+
+constexpr const char *kTag = "display_fastepd_xtc";
+
+} // namespace
+
+FastEpdXtcBook::OpenResult FastEpdXtcBook::open(const char *path)
+{
+    if (index_ && path_ == path) {
+        return OpenResult::ok;
+    }
+    close();
+    if (!stream_.open(path)) {
+        return OpenResult::not_found;
+    }
+
+    uint8_t head[fastepd_xtc_utils::kXtcHeaderSize];
+    fastepd_xtc_utils::XtcHeader header = {};
+    if (stream_.read(head, sizeof(head)) != (int32_t)sizeof(head) ||
+        !fastepd_xtc_utils::parseXtcHeader(head, sizeof(head), &header)) {
+        ESP_LOGE(kTag, "%s: not an XTC container", path);
+        close();
+        return OpenResult::invalid;
+    }
+    const uint32_t index_bytes = (uint32_t)header.page_count * fastepd_xtc_utils::kXtcIndexEntrySize;
+    if (header.index_offset < sizeof(head) || header.index_offset > (uint32_t)stream_.size() ||
+        index_bytes > (uint32_t)stream_.size() - header.index_offset) {
+        ESP_LOGE(kTag, "%s: index (%u pages at %u) outside file of %d bytes", path, (unsigned)header.page_count,
+            (unsigned)header.index_offset, (int)stream_.size());
+        close();
+        return OpenResult::invalid;
+    }
+    // Keep a non-null index for empty books so `open()` still recognizes them as loaded.
+    index_.reset(new (std::nothrow) uint8_t[index_bytes > 0 ? index_bytes : 1]);
+    if (!index_) {
+        close();
+        return OpenResult::no_memory;
+    }
+    if (!stream_.seek((int32_t)header.index_offset) ||
+        stream_.read(index_.get(), (int32_t)index_bytes) != (int32_t)index_bytes) {
+        ESP_LOGE(kTag, "%s: failed to read page index", path);
+        close();
+        return OpenResult::invalid;
+    }
+    header_ = header;
+    path_ = path;
+    return OpenResult::ok;
+}
+
+void FastEpdXtcBook::close()
+{
+    stream_.close();
+    index_.reset();
+    path_.clear();
+    header_ = {};
+    page_left_ = 0;
+}
+
+bool FastEpdXtcBook::seekPage(uint16_t page, fastepd_xtc_utils::XtcPageEntry *entry)
+{
+    if (!index_ || page >= header_.page_count) {
+        return false;
+    }
+    fastepd_xtc_utils::parseXtcPageEntry(index_.get() + (size_t)page * fastepd_xtc_utils::kXtcIndexEntrySize, entry);
+    const uint32_t file_size = (uint32_t)stream_.size();
+    if (entry->size < fastepd_xtc_utils::kXtxHeaderSize || entry->offset > file_size ||
+        entry->size > file_size - entry->offset) {
+        ESP_LOGE(kTag, "%s: page %u (%u bytes at %u) outside file", path_.c_str(), (unsigned)page,
+            (unsigned)entry->size, (unsigned)entry->offset);
+        return false;
+    }
+    if (!stream_.seek((int32_t)entry->offset)) {
+        return false;
+    }
+    page_left_ = entry->size;
+    return true;
+}
+
+int32_t FastEpdXtcBook::readPage(void *user, uint8_t *buf, int32_t len)
+{
+    FastEpdXtcBook *book = static_cast<FastEpdXtcBook *>(user);
+    if (len <= 0 || book->page_left_ == 0) {
+        return 0;
+    }
+    if ((uint32_t)len > book->page_left_) {
+        len = (int32_t)book->page_left_;
+    }
+    const int32_t n = book->stream_.read(buf, len);
+    if (n > 0) {
+        book->page_left_ -= (uint32_t)n;
+    }
+    return n;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "display_fastepd_file_stream.h"
+#include "../../other/fastepd_xtc_utils.h"
+
+/**
+ * @brief An XTC book kept open between page draws.
+ *
+ * The container file stays open and its page index resident, so turning a page is one seek
+ * in an open file rather than a directory lookup and `fopen()` per page. The prefetching
+ * stream keeps reading past the page just drawn, which usually puts the next page in its ring
+ * before it is asked for.
+ */
+class FastEpdXtcBook {
+public:
+    enum class OpenResult {
+        ok,
+        not_found, ///< The file cannot be opened.
+        invalid, ///< Not an XTC container, or its index lies outside the file.
+        no_memory,
+    };
+
+    /** @brief Open `path`, or keep the current book if it already is `path`. */
+    OpenResult open(const char *path);
+    /** @brief Close the file and drop the index. */
+    void close();
+
+    /** @brief Header of the open book. */
+    const fastepd_xtc_utils::XtcHeader &header() const { return header_; }
+
+    /**
+     * @brief Position the stream at the start of `page` and limit `readPage()` to it.
+     * @return `false` if `page` is out of range, its entry points outside the file, or the seek fails.
+     */
+    bool seekPage(uint16_t page, fastepd_xtc_utils::XtcPageEntry *entry);
+
+    /** @brief `fastepd_xtc::XtxReadFn` over the page chosen by `seekPage()`; `user` is the book. */
+    static int32_t readPage(void *user, uint8_t *buf, int32_t len);
+
+private:
+    std::string path_;
+    FastEpdFileStream stream_;
+    fastepd_xtc_utils::XtcHeader header_ = {};
+    std::unique_ptr<uint8_t[]> index_; ///< `page_count` raw index entries.
+    uint32_t page_left_ = 0; ///< Bytes of the current page not yet read.
+};
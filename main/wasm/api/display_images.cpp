@@ -149,6 +149,101 @@ int32_t drawPngFile(wasm_exec_env_t exec_env, const char *path, int32_t x, int32
     return Display::current()->drawPngFile(exec_env, path, x, y, max_w, max_h);
 }
 
+int32_t drawXthFile(wasm_exec_env_t exec_env, const char *path, bool fast)
+{
+    return Display::current()->drawXthFile(exec_env, path, fast);
+}
+
+int32_t drawXtgFile(wasm_exec_env_t exec_env, const char *path, bool fast)
+{
+    return Display::current()->drawXtgFile(exec_env, path, fast);
+}
+
+int32_t convertJpgFile(wasm_exec_env_t exec_env, const char *path, int32_t mode, int32_t max_w, int32_t max_h)
+{
+    return Display::current()->convertJpgFile(exec_env, path, mode, max_w, max_h);
+}
+
+int32_t convertPngFile(wasm_exec_env_t exec_env, const char *path, int32_t mode, int32_t max_w, int32_t max_h)
+{
+    return Display::current()->convertPngFile(exec_env, path, mode, max_w, max_h);
+}
+
+int32_t convertStatus(wasm_exec_env_t exec_env)
+{
+    return Display::current()->convertStatus(exec_env);
+}
+
+int32_t drawXtcPage(wasm_exec_env_t exec_env, const char *path, int32_t page, bool fast)
+{
+    return Display::current()->drawXtcPage(exec_env, path, page, fast);
+}
+
+int32_t drawXthAt(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t src_x,
+    int32_t src_y,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t clip_x,
+    int32_t clip_y,
+    int32_t clip_w,
+    int32_t clip_h)
+{
+    return Display::current()->drawXthAt(
+        exec_env, ptr, len, x, y, src_x, src_y, src_w, src_h, clip_x, clip_y, clip_w, clip_h);
+}
+
+int32_t drawXtgAt(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    int32_t x,
+    int32_t y,
+    int32_t src_x,
+    int32_t src_y,
+    int32_t src_w,
+    int32_t src_h,
+    int32_t clip_x,
+    int32_t clip_y,
+    int32_t clip_w,
+    int32_t clip_h)
+{
+    return Display::current()->drawXtgAt(
+        exec_env, ptr, len, x, y, src_x, src_y, src_w, src_h, clip_x, clip_y, clip_w, clip_h);
+}
+
+int32_t canvasCreate(wasm_exec_env_t exec_env, int32_t w, int32_t h)
+{
+    return Display::current()->canvasCreate(exec_env, w, h);
+}
+
+int32_t canvasDestroy(wasm_exec_env_t exec_env, int32_t handle)
+{
+    return Display::current()->canvasDestroy(exec_env, handle);
+}
+
+int32_t canvasSelect(wasm_exec_env_t exec_env, int32_t handle)
+{
+    return Display::current()->canvasSelect(exec_env, handle);
+}
+
+int32_t canvasPush(
+    wasm_exec_env_t exec_env,
+    int32_t handle,
+    int32_t x,
+    int32_t y,
+    int32_t rotation,
+    int32_t transparent_rgb888,
+    int32_t use_transparent)
+{
+    return Display::current()->canvasPush(exec_env, handle, x, y, rotation, transparent_rgb888, use_transparent);
+}
+
 #define REG_NATIVE_FUNC(funcName, signature)  { #funcName, (void *)funcName, signature, NULL }
 
 static NativeSymbol g_display_images_native_symbols[] = {
@@ -164,6 +259,18 @@ static NativeSymbol g_display_images_native_symbols[] = {
     REG_NATIVE_FUNC(drawPngFit, "(*~iiii)i"),
     REG_NATIVE_FUNC(drawJpgFile, "(*iiii)i"),
     REG_NATIVE_FUNC(drawPngFile, "(*iiii)i"),
+    REG_NATIVE_FUNC(drawXthFile, "(*i)i"),
+    REG_NATIVE_FUNC(drawXtgFile, "(*i)i"),
+    REG_NATIVE_FUNC(drawXtcPage, "(*ii)i"),
+    REG_NATIVE_FUNC(convertJpgFile, "(*iii)i"),
+    REG_NATIVE_FUNC(convertPngFile, "(*iii)i"),
+    REG_NATIVE_FUNC(convertStatus, "()i"),
+    REG_NATIVE_FUNC(drawXthAt, "(*~iiiiiiiiii)i"),
+    REG_NATIVE_FUNC(drawXtgAt, "(*~iiiiiiiiii)i"),
+    REG_NATIVE_FUNC(canvasCreate, "(ii)i"),
+    REG_NATIVE_FUNC(canvasDestroy, "(i)i"),
+    REG_NATIVE_FUNC(canvasSelect, "(i)i"),
+    REG_NATIVE_FUNC(canvasPush, "(iiiiii)i"),
 };
 
 } // namespace
@@ -1,5 +1,6 @@
 #include <inttypes.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "esp_log.h"
 #include "wasm_export.h"
@@ -125,6 +126,36 @@ int32_t fillTriangle(
     return Display::current()->fillTriangle(exec_env, x0, y0, x1, y1, x2, y2, rgb888);
 }
 
+int32_t displaySubmitCommands(
+    wasm_exec_env_t exec_env,
+    const uint8_t *ptr,
+    size_t len,
+    uint8_t *out_rect,
+    size_t out_rect_len)
+{
+    if (!out_rect && out_rect_len != 0) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: out_rect is null");
+        return kWasmErrInvalidArgument;
+    }
+    if (out_rect && out_rect_len < sizeof(DisplayCommandRect)) {
+        wasm_api_set_last_error(kWasmErrInvalidArgument, "displaySubmitCommands: out_rect too small (need 16 bytes)");
+        return kWasmErrInvalidArgument;
+    }
+    DisplayCommandRect dirty = {0, 0, 0, 0};
+    int32_t executed = 0;
+    const int32_t rc = Display::current()->submitCommands(exec_env, ptr, len, &dirty, &executed);
+    if (out_rect) {
+        // x, y, w, h as little-endian int32; an empty rect means nothing was drawn.
+        memcpy(out_rect, &dirty, sizeof(dirty));
+        // A 20-byte out_rect also gets the number of commands that completed, which tells how
+        // far a failed list got.
+        if (out_rect_len >= sizeof(dirty) + sizeof(executed)) {
+            memcpy(out_rect + sizeof(dirty), &executed, sizeof(executed));
+        }
+    }
+    return rc;
+}
+
 /* clang-format off */
 #define REG_NATIVE_FUNC(funcName, signature) \
     { #funcName, (void *)funcName, signature, NULL }
@@ -145,6 +176,7 @@ static NativeSymbol g_display_primitives_native_symbols[] = {
     REG_NATIVE_FUNC(fillEllipse, "(iiiii)i"),
     REG_NATIVE_FUNC(drawTriangle, "(iiiiiii)i"),
     REG_NATIVE_FUNC(fillTriangle, "(iiiiiii)i"),
+    REG_NATIVE_FUNC(displaySubmitCommands, "(*~*~)i"),
 };
 /* clang-format on */
 
@@ -63,6 +63,11 @@ int32_t textWidth(wasm_exec_env_t exec_env, const char *s)
     return Display::current()->textWidth(exec_env, s);
 }
 
+int32_t textWidths(wasm_exec_env_t exec_env, const uint8_t *texts, size_t texts_len, uint8_t *out, size_t out_len)
+{
+    return Display::current()->textWidths(exec_env, texts, texts_len, out, out_len);
+}
+
 int32_t fontHeight(wasm_exec_env_t exec_env)
 {
     return Display::current()->fontHeight(exec_env);
@@ -93,6 +98,24 @@ int32_t vlwClearAll(wasm_exec_env_t exec_env)
     return Display::current()->vlwClearAll(exec_env);
 }
 
+int32_t drawTextBox(
+    wasm_exec_env_t exec_env,
+    const uint8_t *text,
+    size_t text_len,
+    int32_t x,
+    int32_t y,
+    int32_t w,
+    int32_t h,
+    int32_t align,
+    int32_t line_spacing,
+    int32_t flags,
+    uint8_t *breaks,
+    size_t breaks_len)
+{
+    return Display::current()->drawTextBox(
+        exec_env, text, text_len, x, y, w, h, align, line_spacing, flags, breaks, breaks_len);
+}
+
 /* clang-format off */
 #define REG_NATIVE_FUNC(funcName, signature) \
     { #funcName, (void *)funcName, signature, NULL }
@@ -108,12 +131,14 @@ static NativeSymbol g_display_text_native_symbols[] = {
     REG_NATIVE_FUNC(setTextEncoding, "(ii)i"),
     REG_NATIVE_FUNC(drawString, "(*ii)i"),
     REG_NATIVE_FUNC(textWidth, "(*)i"),
+    REG_NATIVE_FUNC(textWidths, "(*~*~)i"),
     REG_NATIVE_FUNC(fontHeight, "()i"),
     REG_NATIVE_FUNC(vlwRegister, "(*~)i"),
     REG_NATIVE_FUNC(vlwUse, "(i)i"),
     REG_NATIVE_FUNC(vlwUseSystem, "(ii)i"),
     REG_NATIVE_FUNC(vlwUnload, "()i"),
     REG_NATIVE_FUNC(vlwClearAll, "()i"),
+    REG_NATIVE_FUNC(drawTextBox, "(*~iiiiiii*~)i"),
 };
 /* clang-format on */
 
@@ -22,6 +22,7 @@
 #include "services/power_service.h"
 
 #include "../api.h"
+#include "display.h"
 #include "errors.h"
 
 namespace {
@@ -218,9 +219,19 @@ int32_t powerSetBatteryCharge(wasm_exec_env_t exec_env, int32_t enable)
     return kWasmOk;
 }
 
+/** @brief Let an in-flight panel refresh finish before the chip restarts or sleeps. */
+void wait_display_idle()
+{
+    auto *display = Display::current();
+    if (display && display->driver() != PaperDisplayDriver::none) {
+        (void)display->waitDisplay(nullptr);
+    }
+}
+
 int32_t powerRestart(wasm_exec_env_t exec_env)
 {
     (void)exec_env;
+    wait_display_idle();
     esp_restart();
     return kWasmOk;
 }
@@ -237,6 +248,7 @@ int32_t powerLightSleepUs(wasm_exec_env_t exec_env, int64_t us)
     } else {
         esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
     }
+    wait_display_idle();
     esp_light_sleep_start();
     return kWasmOk;
 }
@@ -253,6 +265,7 @@ int32_t powerDeepSleepUs(wasm_exec_env_t exec_env, int64_t us)
     } else {
         esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
     }
+    wait_display_idle();
     esp_deep_sleep_start();
     return kWasmOk;
 }
@@ -0,0 +1,180 @@
+/**
+ * @file area_resampler_test.cpp
+ * @brief Checks `FastEpdAreaResampler` against a reference box filter and against itself in bands.
+ *
+ * The reference averages every source pixel over the exact fraction of each output pixel it
+ * covers, in floating point. The resampler rounds its horizontal sums once, so each output may
+ * differ from the rounded reference by at most one level; equal sizes must be the identity.
+ * A run restricted by `setRowWindow()` must return exactly the window's rows of a full run,
+ * both when fed every source row and when fed only the rows that cover the window.
+ */
+#include "check.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "wasm/api/display_fastepd_resample.h"
+
+namespace {
+
+struct Image {
+    int32_t w = 0;
+    int32_t h = 0;
+    std::vector<uint8_t> px;
+};
+
+Image random_image(std::mt19937 &rng, int32_t w, int32_t h)
+{
+    Image img;
+    img.w = w;
+    img.h = h;
+    img.px.resize((size_t)w * (size_t)h);
+    // Smooth areas plus noise, so both flat and busy inputs are covered.
+    for (int32_t y = 0; y < h; ++y) {
+        for (int32_t x = 0; x < w; ++x) {
+            const int base = (x * 255) / (w > 1 ? w - 1 : 1);
+            img.px[(size_t)y * (size_t)w + (size_t)x] = (rng() % 3 == 0) ? (uint8_t)rng() : (uint8_t)base;
+        }
+    }
+    return img;
+}
+
+/** @brief Length of the overlap of `[a0, a1)` and `[b0, b1)`. */
+int64_t overlap(int64_t a0, int64_t a1, int64_t b0, int64_t b1)
+{
+    const int64_t lo = a0 > b0 ? a0 : b0;
+    const int64_t hi = a1 < b1 ? a1 : b1;
+    return hi > lo ? hi - lo : 0;
+}
+
+/** @brief Exact area average: source pixel `j` spans `[j * dst, (j + 1) * dst)`, output `i` spans `[i * src, (i + 1) * src)`. */
+std::vector<double> reference(const Image &src, int32_t dst_w, int32_t dst_h)
+{
+    std::vector<double> out((size_t)dst_w * (size_t)dst_h, 0.0);
+    const double area = (double)src.w * (double)src.h;
+    for (int32_t oy = 0; oy < dst_h; ++oy) {
+        for (int32_t sy = 0; sy < src.h; ++sy) {
+            const int64_t cy = overlap((int64_t)oy * src.h, (int64_t)(oy + 1) * src.h, (int64_t)sy * dst_h,
+                (int64_t)(sy + 1) * dst_h);
+            if (cy == 0) {
+                continue;
+            }
+            for (int32_t ox = 0; ox < dst_w; ++ox) {
+                double sum = 0.0;
+                for (int32_t sx = 0; sx < src.w; ++sx) {
+                    const int64_t cx = overlap((int64_t)ox * src.w, (int64_t)(ox + 1) * src.w, (int64_t)sx * dst_w,
+                        (int64_t)(sx + 1) * dst_w);
+                    sum += (double)cx * src.px[(size_t)sy * (size_t)src.w + (size_t)sx];
+                }
+                out[(size_t)oy * (size_t)dst_w + (size_t)ox] += sum * (double)cy / area;
+            }
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Run the resampler over source rows `[first_src, end_src)`, optionally windowed.
+ * @return Output rows by index (empty where none was returned); `*returned` counts the rows.
+ */
+std::vector<std::vector<uint8_t>> run(const Image &src, int32_t dst_w, int32_t dst_h, int32_t first_row,
+    int32_t end_row, bool windowed, int32_t first_src, int32_t end_src, int *returned)
+{
+    std::vector<std::vector<uint8_t>> rows((size_t)dst_h);
+    *returned = 0;
+    FastEpdAreaResampler rs;
+    if (!rs.begin(src.w, src.h, dst_w, dst_h)) {
+        return rows;
+    }
+    if (windowed) {
+        rs.setRowWindow(first_row, end_row);
+    }
+    std::vector<uint8_t> out((size_t)dst_w);
+    for (int32_t sy = first_src; sy < end_src; ++sy) {
+        const int32_t row = rs.pushRow(sy, &src.px[(size_t)sy * (size_t)src.w], out.data());
+        if (row >= 0) {
+            CHECK_EQ_AT(rows[(size_t)row].empty(), true, "row returned once", row);
+            rows[(size_t)row] = out;
+            ++*returned;
+        }
+    }
+    return rows;
+}
+
+void check_size(std::mt19937 &rng, int32_t src_w, int32_t src_h, int32_t dst_w, int32_t dst_h)
+{
+    const long label = ((long)src_w * 1000 + src_h) * 1000000L + (long)dst_w * 1000 + dst_h;
+    const Image src = random_image(rng, src_w, src_h);
+    int returned = 0;
+    const std::vector<std::vector<uint8_t>> full = run(src, dst_w, dst_h, 0, dst_h, false, 0, src_h, &returned);
+    CHECK_EQ_AT(returned, dst_h, "full run rows", label);
+    if (returned != dst_h) {
+        return;
+    }
+
+    const std::vector<double> want = reference(src, dst_w, dst_h);
+    const bool identity = src_w == dst_w && src_h == dst_h;
+    int worst = 0;
+    for (int32_t oy = 0; oy < dst_h; ++oy) {
+        for (int32_t ox = 0; ox < dst_w; ++ox) {
+            const double ref = want[(size_t)oy * (size_t)dst_w + (size_t)ox];
+            const int got = full[(size_t)oy][(size_t)ox];
+            const int diff = std::abs(got - (int)std::lround(ref));
+            worst = diff > worst ? diff : worst;
+            if (identity) {
+                CHECK_EQ_AT(got, src.px[(size_t)oy * (size_t)src_w + (size_t)ox], "identity", label);
+            }
+        }
+    }
+    CHECK_EQ_AT(worst <= 1, true, "max error vs box filter", label);
+
+    // Bands: every window must reproduce the full run's rows exactly.
+    for (int trial = 0; trial < 6; ++trial) {
+        const int32_t a = (int32_t)(rng() % (uint32_t)dst_h);
+        const int32_t b = a + 1 + (int32_t)(rng() % (uint32_t)(dst_h - a));
+        // Source rows feeding `[a, b)`, as the banded JPEG decode computes them.
+        const int32_t first_src = (int32_t)(((int64_t)a * src_h) / dst_h);
+        const int32_t end_src = (int32_t)(((int64_t)b * src_h + dst_h - 1) / dst_h);
+        for (bool all_rows : {true, false}) {
+            const std::vector<std::vector<uint8_t>> band = run(src, dst_w, dst_h, a, b, true,
+                all_rows ? 0 : first_src, all_rows ? src_h : end_src, &returned);
+            const long band_label = label * 100 + trial * 2 + (all_rows ? 1 : 0);
+            CHECK_EQ_AT(returned, b - a, "window rows", band_label);
+            for (int32_t oy = 0; oy < dst_h; ++oy) {
+                const bool inside = oy >= a && oy < b;
+                if (!inside) {
+                    CHECK_EQ_AT(band[(size_t)oy].empty(), true, "row outside window", band_label * 10000 + oy);
+                } else {
+                    CHECK_EQ_AT(band[(size_t)oy] == full[(size_t)oy], true, "window row", band_label * 10000 + oy);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(12);
+    FastEpdAreaResampler rs;
+    CHECK(!rs.begin(10, 10, 11, 10));
+    CHECK(!rs.begin(10, 10, 10, 0));
+    CHECK(!rs.begin(70000, 10, 10, 10));
+
+    check_size(rng, 17, 13, 17, 13);
+    check_size(rng, 64, 48, 32, 24);
+    check_size(rng, 100, 75, 37, 29);
+    check_size(rng, 97, 211, 96, 53);
+    check_size(rng, 300, 7, 1, 7);
+    check_size(rng, 5, 240, 5, 1);
+    check_size(rng, 257, 191, 200, 150);
+    for (int i = 0; i < 20; ++i) {
+        const int32_t sw = 1 + (int32_t)(rng() % 160);
+        const int32_t sh = 1 + (int32_t)(rng() % 160);
+        check_size(rng, sw, sh, 1 + (int32_t)(rng() % (uint32_t)sw), 1 + (int32_t)(rng() % (uint32_t)sh));
+    }
+    return check_result();
+}
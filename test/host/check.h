@@ -0,0 +1,43 @@
+/**
+ * @file check.h
+ * @brief Minimal assertion helpers shared by the host tests.
+ *
+ * A failed check prints its location and is counted; `main()` returns `check_result()`, so
+ * every failure in a run is reported instead of just the first one.
+ */
+#pragma once
+
+#include <cstdio>
+
+/** Checks failed so far in this test binary. */
+inline int g_check_failures = 0;
+
+#define CHECK(cond)                                                                        \
+    do {                                                                                   \
+        if (!(cond)) {                                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);  \
+            ++g_check_failures;                                                            \
+        }                                                                                  \
+    } while (0)
+
+/** @brief Like `CHECK(a == b)` for integers, printing both values and a context label on failure. */
+#define CHECK_EQ_AT(a, b, what, index)                                                                          \
+    do {                                                                                                        \
+        const long long check_a_ = (long long)(a);                                                              \
+        const long long check_b_ = (long long)(b);                                                              \
+        if (check_a_ != check_b_) {                                                                             \
+            std::fprintf(stderr, "%s:%d: %s[%lld]: %s = %lld, %s = %lld\n", __FILE__, __LINE__, what,           \
+                (long long)(index), #a, check_a_, #b, check_b_);                                                \
+            ++g_check_failures;                                                                                 \
+        }                                                                                                       \
+    } while (0)
+
+/** @brief Exit status for `main()`: 0 if every check passed. */
+inline int check_result()
+{
+    if (g_check_failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_check_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file display_commands_test.cpp
+ * @brief Checks `display_commands_validate()` and `DisplayCommandReader` on good and bad buffers.
+ *
+ * A buffer holding every opcode must validate and decode back to the same arguments and text.
+ * Every word-aligned prefix of it must validate exactly when it ends on a command boundary, and
+ * unknown opcodes, misaligned lengths, oversized or overrunning text, null pointers and
+ * oversized buffers must be rejected with the matching error message and no count.
+ */
+#include "check.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "wasm/api/display_commands.h"
+#include "wasm/api/errors.h"
+
+namespace {
+
+std::string g_last_error;
+
+/** @brief Little-endian command buffer under construction. */
+struct Buffer {
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> boundaries{0}; ///< Offset after each command.
+
+    void word(uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i) {
+            bytes.push_back((uint8_t)(v >> (8 * i)));
+        }
+    }
+
+    void command(DisplayCommandOp op, std::vector<int32_t> args)
+    {
+        word((uint32_t)op);
+        for (int32_t a : args) {
+            word((uint32_t)a);
+        }
+        boundaries.push_back(bytes.size());
+    }
+
+    void text(int32_t x, int32_t y, const std::string &s)
+    {
+        word((uint32_t)DisplayCommandOp::text);
+        word((uint32_t)x);
+        word((uint32_t)y);
+        word((uint32_t)s.size());
+        bytes.insert(bytes.end(), s.begin(), s.end());
+        while (bytes.size() % 4 != 0) {
+            bytes.push_back(0);
+        }
+        boundaries.push_back(bytes.size());
+    }
+};
+
+/** @brief Validate `len` bytes of `ptr`; returns the result and leaves the count (or 0xDEAD) in `*count`. */
+int32_t validate(const uint8_t *ptr, size_t len, uint32_t *count)
+{
+    g_last_error.clear();
+    *count = 0xDEAD;
+    return display_commands_validate(ptr, len, count);
+}
+
+void check_rejected(const uint8_t *ptr, size_t len, const char *message, long label)
+{
+    uint32_t count = 0;
+    CHECK_EQ_AT(validate(ptr, len, &count), kWasmErrInvalidArgument, message, label);
+    CHECK_EQ_AT(count, 0xDEAD, "count untouched", label);
+    CHECK_EQ_AT(g_last_error == std::string("displaySubmitCommands: ") + message, true, message, label);
+}
+
+Buffer every_opcode()
+{
+    Buffer b;
+    b.command(DisplayCommandOp::pixel, {1, 2, 0x112233});
+    b.command(DisplayCommandOp::line, {1, 2, 3, 4, 5});
+    b.command(DisplayCommandOp::fastVline, {1, 2, 3, 4});
+    b.command(DisplayCommandOp::fastHline, {1, 2, 3, 4});
+    b.command(DisplayCommandOp::rect, {1, 2, 3, 4, 5});
+    b.command(DisplayCommandOp::fillRect, {1, 2, 3, 4, 5});
+    b.command(DisplayCommandOp::roundRect, {1, 2, 3, 4, 5, 6});
+    b.command(DisplayCommandOp::fillRoundRect, {1, 2, 3, 4, 5, 6});
+    b.command(DisplayCommandOp::circle, {1, 2, 3, 4});
+    b.command(DisplayCommandOp::fillCircle, {1, 2, 3, 4});
+    b.command(DisplayCommandOp::fillArc, {1, 2, 3, 4, 5, 6, 7});
+    b.text(10, 20, "hello");
+    b.command(DisplayCommandOp::ellipse, {1, 2, 3, 4, 5});
+    b.command(DisplayCommandOp::fillEllipse, {1, 2, 3, 4, 5});
+    b.text(-3, 7, "");
+    b.command(DisplayCommandOp::triangle, {1, 2, 3, 4, 5, 6, 7});
+    b.command(DisplayCommandOp::fillTriangle, {-1, -2, -3, -4, -5, -6, -7});
+    b.command(DisplayCommandOp::textColor, {0xFFFFFF, 0, 1});
+    b.text(0, 0, "four");
+    return b;
+}
+
+void check_valid_and_decoded()
+{
+    const Buffer b = every_opcode();
+    uint32_t count = 0;
+    CHECK_EQ_AT(validate(b.bytes.data(), b.bytes.size(), &count), kWasmOk, "every opcode", 0);
+    CHECK_EQ_AT(count, b.boundaries.size() - 1, "count", 0);
+
+    DisplayCommandReader reader(b.bytes.data(), b.bytes.size());
+    DisplayCommand cmd;
+    std::vector<std::string> texts;
+    uint32_t decoded = 0;
+    while (reader.next(&cmd)) {
+        if (cmd.op == DisplayCommandOp::text) {
+            texts.emplace_back(cmd.text, cmd.text_len);
+        } else if (cmd.op == DisplayCommandOp::fillTriangle) {
+            CHECK_EQ_AT(cmd.args[6], -7, "fillTriangle color", decoded);
+        } else if (cmd.op == DisplayCommandOp::fillArc) {
+            CHECK_EQ_AT(cmd.args[6], 7, "fillArc color", decoded);
+        }
+        ++decoded;
+    }
+    CHECK_EQ_AT(decoded, count, "decoded", 0);
+    CHECK(texts.size() == 3 && texts[0] == "hello" && texts[1].empty() && texts[2] == "four");
+
+    // The empty buffer is a valid, empty list, with or without a pointer.
+    CHECK_EQ_AT(validate(nullptr, 0, &count), kWasmOk, "empty", 0);
+    CHECK_EQ_AT(count, 0, "empty count", 0);
+}
+
+void check_truncation()
+{
+    const Buffer b = every_opcode();
+    size_t next_boundary = 0;
+    for (size_t len = 0; len <= b.bytes.size(); len += 4) {
+        while (b.boundaries[next_boundary] < len) {
+            ++next_boundary;
+        }
+        // Copy so a read past `len` would run off the end of the vector.
+        const std::vector<uint8_t> prefix(b.bytes.begin(), b.bytes.begin() + (ptrdiff_t)len);
+        uint32_t count = 0;
+        const int32_t rc = validate(prefix.data(), prefix.size(), &count);
+        if (b.boundaries[next_boundary] == len) {
+            CHECK_EQ_AT(rc, kWasmOk, "prefix on a boundary", (long)len);
+            CHECK_EQ_AT(count, next_boundary, "prefix count", (long)len);
+        } else {
+            CHECK_EQ_AT(rc, kWasmErrInvalidArgument, "prefix inside a command", (long)len);
+            CHECK(g_last_error == "displaySubmitCommands: truncated command" ||
+                  g_last_error == "displaySubmitCommands: truncated text");
+        }
+    }
+}
+
+void check_rejections()
+{
+    Buffer b;
+    b.command(DisplayCommandOp::pixel, {1, 2, 3});
+    for (uint32_t op : {0u, 18u, 0x80000001u, 0xFFFFFFFFu}) {
+        Buffer bad = b;
+        bad.word(op);
+        bad.word(0);
+        bad.word(0);
+        bad.word(0);
+        check_rejected(bad.bytes.data(), bad.bytes.size(), "unknown opcode", (long)op);
+    }
+
+    for (size_t extra = 1; extra < 4; ++extra) {
+        Buffer bad = b;
+        bad.bytes.resize(bad.bytes.size() + extra, 0);
+        check_rejected(bad.bytes.data(), bad.bytes.size(), "len must be a multiple of 4", (long)extra);
+    }
+
+    // A text of exactly the limit is fine; one byte more is not.
+    Buffer limit;
+    limit.text(0, 0, std::string(kDisplayCommandMaxTextBytes, 'x'));
+    uint32_t count = 0;
+    CHECK_EQ_AT(validate(limit.bytes.data(), limit.bytes.size(), &count), kWasmOk, "text at the limit", 0);
+    Buffer over;
+    over.text(0, 0, std::string(kDisplayCommandMaxTextBytes + 1, 'x'));
+    check_rejected(over.bytes.data(), over.bytes.size(), "text too long", 0);
+    Buffer huge;
+    huge.word((uint32_t)DisplayCommandOp::text);
+    huge.word(0);
+    huge.word(0);
+    huge.word(0xFFFFFFFFu);
+    check_rejected(huge.bytes.data(), huge.bytes.size(), "text too long", 1);
+
+    // A text length that runs past the buffer, including into the padding of the last word.
+    Buffer overrun;
+    overrun.text(0, 0, "abcd");
+    overrun.bytes[12] = 5;
+    check_rejected(overrun.bytes.data(), overrun.bytes.size(), "truncated text", 0);
+
+    check_rejected(nullptr, 4, "ptr is null", 0);
+    std::vector<uint8_t> too_big(kDisplayCommandMaxBytes + 4, 0);
+    check_rejected(too_big.data(), too_big.size(), "buffer too large", 0);
+}
+
+} // namespace
+
+void wasm_api_set_last_error(int32_t code, const char *message)
+{
+    (void)code;
+    g_last_error = message ? message : "";
+}
+
+int main()
+{
+    check_valid_and_decoded();
+    check_truncation();
+    check_rejections();
+    return check_result();
+}
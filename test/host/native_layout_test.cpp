@@ -0,0 +1,203 @@
+/**
+ * @file native_layout_test.cpp
+ * @brief Checks the native span writers in fastepd_native_utils.h against the `read_epd_pixel` decoder.
+ *
+ * `reference_read_pixel()` is the per-pixel framebuffer reader the VLW renderer used before it
+ * switched to these helpers, copied unchanged apart from its name. Random rectangles are filled
+ * with `fillLogicalRect()` in every mode and rotation, and every logical pixel read back through
+ * it has to match a plain logical-space copy of the same fills.
+ */
+#include "check.h"
+#include "other/fastepd_native_utils.h"
+
+#include <random>
+#include <vector>
+
+using namespace fastepd_native_utils;
+
+namespace {
+
+int32_t logical_rotation(FASTEPD &epd)
+{
+    const int rotation = epd.getRotation();
+    switch (rotation) {
+    case 0:
+    case 90:
+    case 180:
+    case 270:
+        return rotation;
+    default:
+        return 0;
+    }
+}
+
+uint8_t reference_read_pixel(FASTEPD &epd, int32_t x, int32_t y)
+{
+    if (x < 0 || y < 0 || x >= epd.width() || y >= epd.height()) {
+        return 0;
+    }
+
+    uint8_t *buffer = epd.currentBuffer();
+    if (!buffer) {
+        return 0;
+    }
+
+    const int32_t mode = epd.getMode();
+    const int32_t rotation = logical_rotation(epd);
+    const int32_t logical_width = epd.width();
+    const int32_t logical_height = epd.height();
+    const int32_t native_width = (rotation == 0 || rotation == 180) ? logical_width : logical_height;
+
+    if (mode == BB_MODE_1BPP) {
+        const int32_t pitch = (native_width + 7) >> 3;
+        int32_t index = 0;
+        uint8_t mask = 0;
+        switch (rotation) {
+        case 0:
+            index = (x >> 3) + (y * pitch);
+            mask = (uint8_t)(0x80u >> (x & 7));
+            break;
+        case 90:
+            index = (y >> 3) + ((logical_width - 1 - x) * pitch);
+            mask = (uint8_t)(0x80u >> (y & 7));
+            break;
+        case 180:
+            index = ((logical_width - 1 - x) >> 3) + ((logical_height - 1 - y) * pitch);
+            mask = (uint8_t)(1u << (x & 7));
+            break;
+        default:
+            index = ((logical_height - 1 - y) >> 3) + (x * pitch);
+            mask = (uint8_t)(1u << (y & 7));
+            break;
+        }
+        return (buffer[index] & mask) ? (uint8_t)BBEP_WHITE : (uint8_t)BBEP_BLACK;
+    }
+
+    if (mode == BB_MODE_2BPP) {
+        const int32_t pitch = native_width >> 2;
+        int32_t index = 0;
+        int shift = 0;
+        switch (rotation) {
+        case 0:
+            index = (x >> 2) + (y * pitch);
+            shift = (3 - (x & 3)) * 2;
+            break;
+        case 90:
+            index = (y >> 2) + ((logical_width - 1 - x) * pitch);
+            shift = (3 - (y & 3)) * 2;
+            break;
+        case 180:
+            index = ((logical_width - 1 - x) >> 2) + ((logical_height - 1 - y) * pitch);
+            shift = (x & 3) * 2;
+            break;
+        default:
+            index = ((logical_height - 1 - y) >> 2) + (x * pitch);
+            shift = (y & 3) * 2;
+            break;
+        }
+        return (uint8_t)((buffer[index] >> shift) & 0x03u);
+    }
+
+    const int32_t pitch = native_width >> 1;
+    int32_t index = 0;
+    bool low_nibble = false;
+    switch (rotation) {
+    case 0:
+        index = (x >> 1) + (y * pitch);
+        low_nibble = (x & 1) != 0;
+        break;
+    case 90:
+        index = (y >> 1) + ((logical_width - 1 - x) * pitch);
+        low_nibble = (y & 1) != 0;
+        break;
+    case 180:
+        index = ((logical_width - 1 - x) >> 1) + ((logical_height - 1 - y) * pitch);
+        low_nibble = (x & 1) == 0;
+        break;
+    default:
+        index = ((logical_height - 1 - y) >> 1) + (x * pitch);
+        low_nibble = (y & 1) == 0;
+        break;
+    }
+
+    const uint8_t value = buffer[index];
+    return low_nibble ? (uint8_t)(value & 0x0Fu) : (uint8_t)((value >> 4) & 0x0Fu);
+}
+
+void check_config(int native_w, int native_h, int mode, int rotation)
+{
+    FASTEPD epd;
+    epd.setPanelSize(native_w, native_h);
+    epd.setMode(mode);
+    epd.setRotation(rotation);
+    NativeLayout layout;
+    CHECK(describeNativeLayout(epd, &layout));
+
+    const int32_t w = layout.logical_w;
+    const int32_t h = layout.logical_h;
+    const int32_t max_color = (1 << layout.bpp) - 1;
+    const long label = (long)native_w * 100000 + mode * 1000 + rotation;
+    std::vector<uint8_t> expect((size_t)w * (size_t)h, 0);
+    std::vector<uint8_t> row((size_t)w);
+    std::mt19937 rng((uint32_t)label);
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 16; ++i) {
+            // Rectangles of all sizes, some hanging off an edge or entirely outside.
+            const int32_t rx = (int32_t)(rng() % (uint32_t)(w + 40)) - 20;
+            const int32_t ry = (int32_t)(rng() % (uint32_t)(h + 40)) - 20;
+            const int32_t rw = (int32_t)(rng() % (uint32_t)(i < 8 ? 19 : w)) + 1;
+            const int32_t rh = (int32_t)(rng() % (uint32_t)(i < 8 ? 19 : h)) + 1;
+            const uint8_t color = (uint8_t)(rng() % (uint32_t)(max_color + 1));
+            fillLogicalRect(layout, rx, ry, rw, rh, color);
+            for (int32_t y = ry < 0 ? 0 : ry; y < ry + rh && y < h; ++y) {
+                for (int32_t x = rx < 0 ? 0 : rx; x < rx + rw && x < w; ++x) {
+                    expect[(size_t)y * (size_t)w + (size_t)x] = color;
+                }
+            }
+        }
+        for (int32_t y = 0; y < h; ++y) {
+            readLogicalRow(layout, 0, y, w, row.data());
+            for (int32_t x = 0; x < w; ++x) {
+                const uint8_t want = expect[(size_t)y * (size_t)w + (size_t)x];
+                const uint8_t got = reference_read_pixel(epd, x, y);
+                if (got != want || row[(size_t)x] != want) {
+                    CHECK_EQ_AT(got, want, "read_epd_pixel", label);
+                    CHECK_EQ_AT(row[(size_t)x], want, "readLogicalRow", label);
+                    return;
+                }
+
+                // logicalToNative/nativeToLogical agree with the same mapping.
+                int32_t nx = 0;
+                int32_t ny = 0;
+                int32_t lx = 0;
+                int32_t ly = 0;
+                logicalToNative(layout, x, y, &nx, &ny);
+                nativeToLogical(layout, nx, ny, &lx, &ly);
+                const int shift = 8 - layout.bpp * (nx % (8 / layout.bpp) + 1);
+                const uint8_t raw = (uint8_t)((layout.buffer[(size_t)ny * (size_t)layout.pitch + (size_t)(nx / (8 / layout.bpp))] >> shift) & max_color);
+                if (raw != want || lx != x || ly != y) {
+                    CHECK_EQ_AT(raw, want, "logicalToNative", label);
+                    CHECK_EQ_AT(lx * 100000 + ly, x * 100000 + y, "nativeToLogical", label);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    // The panel (960x540, whose native height is not a multiple of 8) and a small odd-sized one.
+    const int sizes[][2] = {{960, 540}, {64, 21}};
+    for (const auto &size : sizes) {
+        for (int mode : {BB_MODE_1BPP, BB_MODE_2BPP, BB_MODE_4BPP}) {
+            for (int rotation : {0, 90, 180, 270}) {
+                check_config(size[0], size[1], mode, rotation);
+            }
+        }
+    }
+    return check_result();
+}
@@ -0,0 +1,168 @@
+/**
+ * @file pixel_kernels_test.cpp
+ * @brief Checks the row kernels in fastepd_pixel_kernels.h against the per-pixel formulas they replaced.
+ *
+ * Small domains (RGB565, the pack LUT inputs, nibble pairs) are covered exhaustively; ARGB rows use
+ * a fixed-seed random mix of opaque runs and translucent pixels so both branches are taken.
+ */
+#include "check.h"
+#include "other/fastepd_pixel_kernels.h"
+
+#include <random>
+#include <vector>
+
+using namespace fastepd_pixel_kernels;
+
+namespace {
+
+uint8_t ref_luma(uint32_t r, uint32_t g, uint32_t b)
+{
+    return (uint8_t)((r * 77 + g * 150 + b * 29 + 128) >> 8);
+}
+
+uint8_t ref_unpack4(const uint8_t *src, size_t i)
+{
+    const uint8_t packed = src[i >> 1];
+    return (uint8_t)(((i & 1) ? (packed & 0x0F) : (packed >> 4)) * 0x11);
+}
+
+uint8_t ref_argb(const uint8_t *p)
+{
+    const uint32_t gray = ref_luma(p[1], p[2], p[3]);
+    const uint32_t a = p[0];
+    if (a == 255) {
+        return (uint8_t)gray;
+    }
+    // Rounded (gray * a + 255 * (255 - a)) / 255, computed with a real division.
+    return (uint8_t)((gray * a + 255 * (255 - a) + 127) / 255);
+}
+
+uint8_t ref_rgb565(uint16_t v)
+{
+    const uint32_t r5 = v >> 11;
+    const uint32_t g6 = (v >> 5) & 63;
+    const uint32_t b5 = v & 31;
+    return ref_luma((r5 << 3) | (r5 >> 2), (g6 << 2) | (g6 >> 4), (b5 << 3) | (b5 >> 2));
+}
+
+void test_unpack_gray4()
+{
+    // Every byte value, at every start offset and length up to a few vector widths, with padded
+    // output so overruns show up as a changed guard byte.
+    std::vector<uint8_t> src(256 + 64);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = (uint8_t)(i * 7 + 3);
+    }
+    std::vector<uint8_t> out(600);
+    for (size_t first = 0; first < 40; ++first) {
+        for (size_t n : {0, 1, 2, 3, 4, 5, 7, 31, 32, 33, 63, 64, 65, 96, 511}) {
+            std::fill(out.begin(), out.end(), 0xA5);
+            unpackGray4(src.data(), first, n, out.data());
+            for (size_t i = 0; i < n; ++i) {
+                CHECK_EQ_AT(out[i], ref_unpack4(src.data(), first + i), "unpackGray4", first * 1000 + i);
+            }
+            CHECK_EQ_AT(out[n], 0xA5, "unpackGray4 guard", first * 1000 + n);
+        }
+    }
+}
+
+void test_argb_row()
+{
+    std::mt19937 rng(20);
+    const size_t n = 4099;
+    std::vector<uint8_t> argb(n * 4);
+    for (size_t i = 0; i < n; ++i) {
+        // Mostly opaque runs with translucent pixels sprinkled in, so both branches of the
+        // four-pixel fast path are exercised.
+        const uint32_t r = rng();
+        argb[4 * i] = (r & 7) == 0 ? (uint8_t)(rng() & 0xFF) : 255;
+        argb[4 * i + 1] = (uint8_t)(r >> 8);
+        argb[4 * i + 2] = (uint8_t)(r >> 16);
+        argb[4 * i + 3] = (uint8_t)(r >> 24);
+    }
+    for (ptrdiff_t step : {1, 3, -2}) {
+        const size_t span = n * (size_t)(step < 0 ? -step : step);
+        std::vector<uint8_t> out(span + 1, 0);
+        uint8_t *base = step < 0 ? out.data() + span - 1 : out.data();
+        argbRowToGray8(argb.data(), n, base, step);
+        for (size_t i = 0; i < n; ++i) {
+            CHECK_EQ_AT(base[(ptrdiff_t)i * step], ref_argb(&argb[4 * i]), "argbRowToGray8", i);
+        }
+    }
+
+    // argbToGray8() over every alpha for a spread of colours, including the extremes.
+    for (uint32_t a = 0; a < 256; ++a) {
+        for (uint32_t c : {0u, 1u, 127u, 128u, 254u, 255u}) {
+            const uint8_t px[4] = {(uint8_t)a, (uint8_t)c, (uint8_t)(255 - c), (uint8_t)c};
+            CHECK_EQ_AT(argbToGray8(px), ref_argb(px), "argbToGray8", a * 256 + c);
+        }
+    }
+}
+
+void test_rgb565()
+{
+    Rgb565LumaTables tables;
+    buildRgb565LumaTables(&tables);
+    std::vector<uint8_t> le(65536 * 2), be(65536 * 2);
+    for (uint32_t v = 0; v < 65536; ++v) {
+        le[2 * v] = (uint8_t)v;
+        le[2 * v + 1] = (uint8_t)(v >> 8);
+        be[2 * v] = (uint8_t)(v >> 8);
+        be[2 * v + 1] = (uint8_t)v;
+    }
+    std::vector<uint8_t> out_le(65536), out_be(65536);
+    rgb565RowToGray8(tables, le.data(), 65536, false, out_le.data());
+    rgb565RowToGray8(tables, be.data(), 65536, true, out_be.data());
+    for (uint32_t v = 0; v < 65536; ++v) {
+        CHECK_EQ_AT(out_le[v], ref_rgb565((uint16_t)v), "rgb565 little-endian", v);
+        CHECK_EQ_AT(out_be[v], ref_rgb565((uint16_t)v), "rgb565 big-endian", v);
+    }
+
+    // Odd lengths take the single-pixel tail.
+    uint8_t tail[3] = {0, 0, 0};
+    rgb565RowToGray8(tables, le.data() + 2 * 0x1234, 3, false, tail);
+    for (uint32_t i = 0; i < 3; ++i) {
+        CHECK_EQ_AT(tail[i], ref_rgb565((uint16_t)(0x1234 + i)), "rgb565 tail", i);
+    }
+}
+
+template <int BPP>
+void test_pack()
+{
+    constexpr int kPerByte = 8 / BPP;
+    uint8_t lut[256];
+    for (int g = 0; g < 256; ++g) {
+        lut[g] = (uint8_t)((g * 37 + 11) & ((1 << BPP) - 1));
+    }
+    // Every gray value in every position of the output byte.
+    const size_t nbytes = 256 * kPerByte + 3;
+    std::vector<uint8_t> src(nbytes * kPerByte);
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = (uint8_t)(i / kPerByte + i % kPerByte * 97);
+    }
+    std::vector<uint8_t> dst(nbytes + 1, 0x5A);
+    packGray8Bytes<BPP>(dst.data(), src.data(), nbytes, lut);
+    for (size_t i = 0; i < nbytes; ++i) {
+        uint8_t expect = 0;
+        for (int k = 0; k < kPerByte; ++k) {
+            expect |= (uint8_t)(lut[src[i * kPerByte + k]] << (8 - BPP * (k + 1)));
+        }
+        CHECK_EQ_AT(dst[i], expect, BPP == 1 ? "packGray8Bytes<1>" : BPP == 2 ? "packGray8Bytes<2>" : "packGray8Bytes<4>", i);
+    }
+    CHECK_EQ_AT(dst[nbytes], 0x5A, "packGray8Bytes guard", BPP);
+}
+
+} // namespace
+
+int main()
+{
+    // No-op on the host; on an ESP32-S3 build of this file it would exercise the PIE path too.
+    (void)selfTestPie();
+    test_unpack_gray4();
+    test_argb_row();
+    test_rgb565();
+    test_pack<1>();
+    test_pack<2>();
+    test_pack<4>();
+    return check_result();
+}
@@ -0,0 +1,347 @@
+/**
+ * @file png_dither_bench.cpp
+ * @brief Checks and times the PNG dither-and-write stage of `draw_png` on the bundled sleepimage.png.
+ *
+ * `FastEpdErrorDiffusion` has to match a plain serpentine Floyd-Steinberg loop level for level.
+ * The timing compares the per-pixel `epd_png_draw()` callback it replaced (copied from before the
+ * change, writing through `drawPixelFast()`) with today's row path: ARGB to gray8, diffusion into
+ * an 8-row strip and `blitGray8()`. Both run in 4bpp at rotation 90, as the launcher draws the
+ * sleep image. Timings are printed only; the test fails on mismatches, not on speed.
+ *
+ * The PNG is inflated with the host zlib; the firmware uses its own decoder.
+ */
+#include "check.h"
+#include "other/fastepd_native_utils.h"
+#include "wasm/api/display_fastepd_dither.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <zlib.h>
+
+namespace {
+
+uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+uint8_t paeth(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = p > a ? p - a : a - p;
+    const int pb = p > b ? p - b : b - p;
+    const int pc = p > c ? p - c : c - p;
+    return (uint8_t)((pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c));
+}
+
+/** @brief Load a non-interlaced grayscale PNG (any bit depth up to 8) as gray8 rows. */
+bool load_gray_png(const char *path, std::vector<uint8_t> *gray, int32_t *width, int32_t *height)
+{
+    FILE *f = std::fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    std::vector<uint8_t> file;
+    uint8_t chunk[4096];
+    size_t got = 0;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        file.insert(file.end(), chunk, chunk + got);
+    }
+    std::fclose(f);
+    if (file.size() < 33 || std::memcmp(file.data() + 12, "IHDR", 4) != 0) {
+        return false;
+    }
+    const int32_t w = (int32_t)read_be32(&file[16]);
+    const int32_t h = (int32_t)read_be32(&file[20]);
+    const int depth = file[24];
+    if (file[25] != 0 || file[28] != 0 || depth > 8) {
+        return false;
+    }
+    std::vector<uint8_t> idat;
+    for (size_t pos = 8; pos + 12 <= file.size();) {
+        const uint32_t len = read_be32(&file[pos]);
+        if (std::memcmp(&file[pos + 4], "IDAT", 4) == 0) {
+            idat.insert(idat.end(), &file[pos + 8], &file[pos + 8] + len);
+        }
+        pos += 12 + len;
+    }
+    const size_t stride = ((size_t)w * (size_t)depth + 7) / 8;
+    std::vector<uint8_t> raw((stride + 1) * (size_t)h);
+    uLongf raw_len = (uLongf)raw.size();
+    if (uncompress(raw.data(), &raw_len, idat.data(), (uLong)idat.size()) != Z_OK || raw_len != raw.size()) {
+        return false;
+    }
+    std::vector<uint8_t> prev(stride, 0);
+    std::vector<uint8_t> cur(stride);
+    gray->resize((size_t)w * (size_t)h);
+    const int bpp_bytes = 1;
+    for (int32_t y = 0; y < h; ++y) {
+        const uint8_t *in = &raw[(size_t)y * (stride + 1)];
+        for (size_t i = 0; i < stride; ++i) {
+            const int a = i >= (size_t)bpp_bytes ? cur[i - bpp_bytes] : 0;
+            const int b = prev[i];
+            const int c = i >= (size_t)bpp_bytes ? prev[i - bpp_bytes] : 0;
+            int pred = 0;
+            switch (in[0]) {
+            case 1: pred = a; break;
+            case 2: pred = b; break;
+            case 3: pred = (a + b) >> 1; break;
+            case 4: pred = paeth(a, b, c); break;
+            default: break;
+            }
+            cur[i] = (uint8_t)(in[1 + i] + pred);
+        }
+        const int per_byte = 8 / depth;
+        const int max = (1 << depth) - 1;
+        for (int32_t x = 0; x < w; ++x) {
+            const int shift = 8 - depth * (x % per_byte + 1);
+            (*gray)[(size_t)y * (size_t)w + (size_t)x] = (uint8_t)(((cur[(size_t)x / per_byte] >> shift) & max) * 255 / max);
+        }
+        prev.swap(cur);
+    }
+    *width = w;
+    *height = h;
+    return true;
+}
+
+/** @brief Serpentine Floyd-Steinberg written out directly, the reference for `FastEpdErrorDiffusion`. */
+std::vector<uint8_t> reference_diffusion(const std::vector<uint8_t> &gray, int32_t w, int32_t h, int32_t levels)
+{
+    const int32_t max_level = levels - 1;
+    const int32_t step = 255 / max_level;
+    std::vector<int32_t> cur((size_t)w + 2, 0);
+    std::vector<int32_t> next((size_t)w + 2, 0);
+    std::vector<uint8_t> out(gray.size());
+    for (int32_t y = 0; y < h; ++y) {
+        const bool reverse = (y & 1) != 0;
+        const int32_t d = reverse ? -1 : 1;
+        std::fill(next.begin(), next.end(), 0);
+        for (int32_t n = 0; n < w; ++n) {
+            const int32_t x = reverse ? w - 1 - n : n;
+            int32_t v = gray[(size_t)y * (size_t)w + (size_t)x] + cur[(size_t)(x + 1)];
+            v = v < 0 ? 0 : (v > 255 ? 255 : v);
+            const int32_t q = (v * max_level + 127) / 255;
+            out[(size_t)y * (size_t)w + (size_t)x] = (uint8_t)q;
+            const int32_t err = v - q * step;
+            cur[(size_t)(x + 1 + d)] += err * 7 / 16;
+            next[(size_t)(x + 1 - d)] += err * 3 / 16;
+            next[(size_t)(x + 1)] += err * 5 / 16;
+            next[(size_t)(x + 1 + d)] += err / 16;
+        }
+        cur.swap(next);
+    }
+    return out;
+}
+
+void check_diffusion(const std::vector<uint8_t> &gray, int32_t w, int32_t h, const char *what)
+{
+    for (int32_t levels : {2, 4, 16}) {
+        const std::vector<uint8_t> want = reference_diffusion(gray, w, h, levels);
+        FastEpdErrorDiffusion diffusion;
+        CHECK(diffusion.begin(w, levels));
+        std::vector<uint8_t> got(gray.size());
+        for (int32_t y = 0; y < h; ++y) {
+            diffusion.row(&gray[(size_t)y * (size_t)w], &got[(size_t)y * (size_t)w]);
+        }
+        for (size_t i = 0; i < got.size(); ++i) {
+            if (got[i] != want[i]) {
+                CHECK_EQ_AT(got[i], want[i], what, (long long)levels * 10000000 + (long long)i);
+                break;
+            }
+        }
+    }
+}
+
+// ---- The per-pixel callback replaced by the row path, as it was before the change. ----
+
+struct OldDitherState {
+    FASTEPD *epd;
+    int32_t dst_x;
+    int32_t dst_y;
+    int32_t max_w;
+    int32_t max_h;
+    int32_t current_y;
+    int32_t mode;
+    int32_t *err_cur;
+    int32_t *err_next;
+};
+
+inline int32_t dither_mul_div16(int32_t v, int32_t mul)
+{
+    int32_t t = v * mul;
+    t += (t >= 0) ? 8 : -8;
+    return t >> 4;
+}
+
+void old_png_draw(OldDitherState *st, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t *argb)
+{
+    if ((int32_t)y < 0 || (int32_t)y >= st->max_h || div_x == 0) {
+        return;
+    }
+    if (st->current_y < 0) {
+        st->current_y = (int32_t)y;
+    }
+    if ((int32_t)y != st->current_y) {
+        while (st->current_y < (int32_t)y) {
+            int32_t *tmp = st->err_cur;
+            st->err_cur = st->err_next;
+            st->err_next = tmp;
+            std::memset(st->err_next, 0, (size_t)(st->max_w + 3) * sizeof(int32_t));
+            st->current_y++;
+        }
+    }
+    const int32_t epd_w = st->epd->width();
+    const int32_t epd_h = st->epd->height();
+    uint32_t xi = x;
+    for (size_t i = 0; i < len; ++i) {
+        if ((int32_t)xi >= 0 && (int32_t)xi < st->max_w) {
+            uint8_t a = argb[0];
+            uint8_t r = argb[1];
+            uint8_t g = argb[2];
+            uint8_t b = argb[3];
+            if (a != 255) {
+                const uint16_t inv = (uint16_t)(255u - (uint16_t)a);
+                r = (uint8_t)(((uint16_t)r * a + inv * 255u + 127u) / 255u);
+                g = (uint8_t)(((uint16_t)g * a + inv * 255u + 127u) / 255u);
+                b = (uint8_t)(((uint16_t)b * a + inv * 255u + 127u) / 255u);
+            }
+            const int32_t gray = (int32_t)((r * 77u + g * 150u + b * 29u + 128u) >> 8);
+            const int idx = (int)xi + 1;
+            int32_t v = gray + st->err_cur[idx];
+            if (v < 0) v = 0;
+            if (v > 255) v = 255;
+            const int32_t dx = st->dst_x + (int32_t)xi;
+            const int32_t dy = st->dst_y + (int32_t)y;
+            if (dx >= 0 && dy >= 0 && dx < epd_w && dy < epd_h) {
+                if (st->mode == BB_MODE_1BPP) {
+                    const int32_t q = (v >= 128) ? 255 : 0;
+                    st->epd->drawPixelFast(dx, dy, (uint8_t)(q ? BBEP_WHITE : BBEP_BLACK));
+                    const int32_t err = v - q;
+                    st->err_cur[idx + 1] += dither_mul_div16(err, 7);
+                    st->err_next[idx - 1] += dither_mul_div16(err, 3);
+                    st->err_next[idx] += dither_mul_div16(err, 5);
+                    st->err_next[idx + 1] += dither_mul_div16(err, 1);
+                } else if (st->mode == BB_MODE_2BPP) {
+                    int32_t q = (v * 3 + 127) / 255;
+                    if (q < 0) q = 0;
+                    if (q > 3) q = 3;
+                    st->epd->drawPixelFast(dx, dy, (uint8_t)q);
+                    const int32_t recon = (q * 255 + 1) / 3;
+                    const int32_t err = v - recon;
+                    st->err_cur[idx + 1] += dither_mul_div16(err, 7);
+                    st->err_next[idx - 1] += dither_mul_div16(err, 3);
+                    st->err_next[idx] += dither_mul_div16(err, 5);
+                    st->err_next[idx + 1] += dither_mul_div16(err, 1);
+                } else {
+                    int32_t q = (v + 8) >> 4;
+                    if (q < 0) q = 0;
+                    if (q > 15) q = 15;
+                    st->epd->drawPixelFast(dx, dy, (uint8_t)q);
+                    const int32_t recon = q * 17;
+                    const int32_t err = v - recon;
+                    st->err_cur[idx + 1] += dither_mul_div16(err, 7);
+                    st->err_next[idx - 1] += dither_mul_div16(err, 3);
+                    st->err_next[idx] += dither_mul_div16(err, 5);
+                    st->err_next[idx + 1] += dither_mul_div16(err, 1);
+                }
+            }
+        }
+        argb += 4;
+        xi += (uint32_t)div_x;
+    }
+}
+
+// ---- The current row path (epd_png_draw + png_emit_row + png_flush_strip). ----
+
+void new_png_frame(const fastepd_native_utils::NativeLayout &layout, const std::vector<uint8_t> &argb, int32_t w, int32_t h)
+{
+    constexpr int32_t kStripRows = fastepd_native_utils::kBlitBandRows;
+    std::vector<uint8_t> row((size_t)w);
+    std::vector<uint8_t> strip((size_t)w * kStripRows);
+    FastEpdErrorDiffusion diffusion;
+    diffusion.begin(w, 1 << layout.bpp);
+    int32_t strip_y0 = 0;
+    int32_t strip_rows = 0;
+    for (int32_t y = 0; y < h; ++y) {
+        fastepd_pixel_kernels::argbRowToGray8(&argb[(size_t)y * (size_t)w * 4], (size_t)w, row.data(), 1);
+        if (strip_rows == 0) {
+            strip_y0 = y;
+        }
+        diffusion.row(row.data(), &strip[(size_t)strip_rows * (size_t)w]);
+        if (++strip_rows == kStripRows || y == h - 1) {
+            fastepd_native_utils::blitGray8(layout, 0, strip_y0, w, strip_rows, strip.data(), w, FastEpdDither::levelLut());
+            strip_rows = 0;
+        }
+    }
+}
+
+template <typename Fn>
+double best_ms(int runs, Fn fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        fn();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        best = ms < best ? ms : best;
+    }
+    return best;
+}
+
+} // namespace
+
+int main()
+{
+    std::vector<uint8_t> gray;
+    int32_t w = 0;
+    int32_t h = 0;
+    if (!load_gray_png(PORTAL_ASSETS_DIR "/sleepimage.png", &gray, &w, &h)) {
+        std::fprintf(stderr, "cannot load sleepimage.png\n");
+        return 1;
+    }
+    check_diffusion(gray, w, h, "diffusion sleepimage");
+
+    // Smooth gradients with noise exercise the clamp and long error runs a bilevel image does not.
+    std::mt19937 rng(14);
+    std::vector<uint8_t> noise(gray.size());
+    for (int32_t y = 0; y < h; ++y) {
+        for (int32_t x = 0; x < w; ++x) {
+            const int32_t v = (x * 255) / w + (int32_t)(rng() % 61) - 30;
+            noise[(size_t)y * (size_t)w + (size_t)x] = (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+        }
+    }
+    check_diffusion(noise, w, h, "diffusion gradient");
+
+    // Opaque ARGB rows, as pngle hands them to epd_png_draw().
+    std::vector<uint8_t> argb(gray.size() * 4);
+    for (size_t i = 0; i < gray.size(); ++i) {
+        argb[4 * i] = 255;
+        argb[4 * i + 1] = argb[4 * i + 2] = argb[4 * i + 3] = gray[i];
+    }
+
+    FASTEPD epd;
+    epd.setPanelSize(960, 540);
+    epd.setMode(BB_MODE_4BPP);
+    epd.setRotation(90);
+    std::vector<int32_t> err_a((size_t)w + 3);
+    std::vector<int32_t> err_b((size_t)w + 3);
+    const double old_ms = best_ms(20, [&] {
+        OldDitherState st = {&epd, 0, 0, w, h, -1, BB_MODE_4BPP, err_a.data(), err_b.data()};
+        std::fill(err_a.begin(), err_a.end(), 0);
+        std::fill(err_b.begin(), err_b.end(), 0);
+        for (int32_t y = 0; y < h; ++y) {
+            old_png_draw(&st, 0, (uint32_t)y, 1, (size_t)w, &argb[(size_t)y * (size_t)w * 4]);
+        }
+    });
+
+    fastepd_native_utils::NativeLayout layout;
+    CHECK(fastepd_native_utils::describeNativeLayout(epd, &layout));
+    const double new_ms = best_ms(20, [&] { new_png_frame(layout, argb, w, h); });
+
+    std::printf("sleepimage.png %dx%d, 4bpp, rotation 90: per-pixel callback %.2f ms, row path %.2f ms (%.2fx)\n", (int)w,
+        (int)h, old_ms, new_ms, old_ms / new_ms);
+    return check_result();
+}
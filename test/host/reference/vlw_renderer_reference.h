@@ -0,0 +1,22 @@
+/**
+ * @file vlw_renderer_reference.h
+ * @brief Entry point of the reference VLW renderer (see vlw_renderer_reference.cpp).
+ */
+#pragma once
+
+#include "fonts/vlw_renderer_fastepd.h"
+
+namespace vlw_reference {
+
+/** @brief `DrawString()` of the per-pixel renderer; same contract as the one in vlw_renderer_fastepd.h. */
+int32_t DrawString(
+    FASTEPD &epd,
+    const VlwFont &font,
+    const FastEpdVlwTextState &state,
+    const char *text,
+    int32_t x,
+    int32_t y,
+    int32_t *out_width,
+    BB_RECT *out_bounds = nullptr);
+
+} // namespace vlw_reference
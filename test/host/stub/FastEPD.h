@@ -0,0 +1,126 @@
+/**
+ * @file FastEPD.h
+ * @brief Host stand-in for the parts of the FastEPD library used by the code under test.
+ *
+ * The framebuffer is an in-memory native buffer with FastEPD's layout (rows along the long
+ * edge, pixels packed MSB-first); `setPanelSize()` sizes it. Updates only count calls.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum { BB_MODE_NONE = 0, BB_MODE_1BPP, BB_MODE_2BPP, BB_MODE_4BPP };
+
+#define BBEP_BLACK 0
+#define BBEP_WHITE 1
+#define CLEAR_NONE 0
+#define CLEAR_FAST 1
+#define CLEAR_SLOW 2
+#define CLEAR_WHITE 3
+#define CLEAR_EXTRA_WHITE 4
+
+typedef struct {
+    int x;
+    int y;
+    int w;
+    int h;
+} BB_RECT;
+
+class FASTEPD {
+public:
+    /** @brief Allocate a cleared native buffer of `native_w x native_h` pixels (rotation 0 size). */
+    void setPanelSize(int native_w, int native_h)
+    {
+        _native_w = native_w;
+        _native_h = native_h;
+        resize();
+    }
+    int setMode(int mode)
+    {
+        _mode = mode;
+        resize();
+        return 0;
+    }
+    int getMode() { return _mode; }
+    int setRotation(int rotation)
+    {
+        _rotation = rotation;
+        return 0;
+    }
+    int getRotation() { return _rotation; }
+    int width() { return (_rotation == 90 || _rotation == 270) ? _native_h : _native_w; }
+    int height() { return (_rotation == 90 || _rotation == 270) ? _native_w : _native_h; }
+    uint8_t *currentBuffer() { return _buffer.empty() ? nullptr : _buffer.data(); }
+    int bufferPitch() const { return (_native_w * bpp() + 7) >> 3; }
+
+    /** @brief Logical pixel write through the rotation table in fastepd_native_utils.h. */
+    void drawPixelFast(int x, int y, uint8_t color)
+    {
+        const int w = width();
+        const int h = height();
+        if (x < 0 || y < 0 || x >= w || y >= h) {
+            return;
+        }
+        int nx = x;
+        int ny = y;
+        switch (_rotation) {
+        case 90:
+            nx = y;
+            ny = w - 1 - x;
+            break;
+        case 180:
+            nx = w - 1 - x;
+            ny = h - 1 - y;
+            break;
+        case 270:
+            nx = h - 1 - y;
+            ny = x;
+            break;
+        default:
+            break;
+        }
+        const int b = bpp();
+        const int shift = 8 - b * (nx % (8 / b) + 1);
+        const uint8_t mask = (uint8_t)(((1 << b) - 1) << shift);
+        uint8_t &byte = _buffer[(size_t)ny * (size_t)bufferPitch() + (size_t)(nx / (8 / b))];
+        byte = (uint8_t)((byte & ~mask) | ((color << shift) & mask));
+    }
+    void fillRect(int x, int y, int w, int h, uint8_t color)
+    {
+        for (int j = y; j < y + h; ++j) {
+            for (int i = x; i < x + w; ++i) {
+                drawPixelFast(i, j, color);
+            }
+        }
+    }
+    int fullUpdate(int clear_mode = CLEAR_FAST, bool keep_on = false, BB_RECT *rect = nullptr)
+    {
+        (void)clear_mode;
+        (void)keep_on;
+        (void)rect;
+        ++full_updates;
+        return 0;
+    }
+    int smoothUpdate(bool keep_on = false, uint8_t color = BBEP_WHITE)
+    {
+        (void)keep_on;
+        (void)color;
+        ++smooth_updates;
+        return 0;
+    }
+
+    int full_updates = 0;
+    int smooth_updates = 0;
+
+private:
+    int bpp() const { return _mode == BB_MODE_1BPP ? 1 : _mode == BB_MODE_2BPP ? 2 : 4; }
+    void resize() { _buffer.assign((size_t)bufferPitch() * (size_t)_native_h, 0); }
+
+    int _mode = BB_MODE_1BPP;
+    int _rotation = 0;
+    int _native_w = 0;
+    int _native_h = 0;
+    std::vector<uint8_t> _buffer;
+};
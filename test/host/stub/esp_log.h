@@ -0,0 +1,14 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in for ESP-IDF logging: messages are compiled but discarded.
+ */
+#pragma once
+
+#include <stdio.h>
+
+#define PORTAL_HOST_LOG(tag, fmt, ...) ((void)(tag), (void)sizeof(printf(fmt, ##__VA_ARGS__)))
+#define ESP_LOGE(tag, fmt, ...) PORTAL_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) PORTAL_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) PORTAL_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) PORTAL_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) PORTAL_HOST_LOG(tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,37 @@
+/**
+ * @file esp_rom_md5.h
+ * @brief Host stand-in for the ROM MD5 API.
+ *
+ * Not MD5: a byte-wise FNV-1a spread over the 16 digest bytes. Enough for code that only
+ * compares digests it computed itself; do not use it to check real files' checksums.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    uint64_t state[2];
+} md5_context_t;
+
+#define ESP_ROM_MD5_DIGEST_LEN 16
+
+static inline void esp_rom_md5_init(md5_context_t *context)
+{
+    context->state[0] = 0xcbf29ce484222325ull;
+    context->state[1] = 0x84222325cbf29ce4ull;
+}
+
+static inline void esp_rom_md5_update(md5_context_t *context, const void *buf, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    for (uint32_t i = 0; i < len; ++i) {
+        context->state[0] = (context->state[0] ^ p[i]) * 0x100000001b3ull;
+        context->state[1] = (context->state[1] ^ context->state[0]) * 0x100000001b3ull;
+    }
+}
+
+static inline void esp_rom_md5_final(uint8_t *digest, md5_context_t *context)
+{
+    memcpy(digest, context->state, 16);
+}
@@ -0,0 +1,14 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for the ESP-IDF microsecond timer.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+
+static inline int64_t esp_timer_get_time(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
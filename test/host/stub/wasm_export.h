@@ -0,0 +1,11 @@
+/**
+ * @file wasm_export.h
+ * @brief Host stand-in for the WAMR types named in the display headers.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct WASMExecEnv *wasm_exec_env_t;
+typedef struct WASMModuleInstanceCommon *wasm_module_inst_t;
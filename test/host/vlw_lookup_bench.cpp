@@ -0,0 +1,183 @@
+/**
+ * @file vlw_lookup_bench.cpp
+ * @brief Checks `VlwFont::FindGlyph()` against the hash map it replaced, and times both.
+ *
+ * The reference is built the way the old parser did: `std::unordered_map<uint16_t, size_t>`
+ * from codepoint to glyph record, written in file order so a duplicate codepoint resolves to
+ * its last record. Every BMP codepoint has to resolve to the same record (compared through its
+ * bitmap offset and metrics) or to none in both. Besides the bundled fonts, a synthetic font
+ * with unsorted and duplicated codepoints exercises the ordering rules.
+ *
+ * The timing replays a mostly-ASCII text with some Latin-1 and punctuation above U+2000 on
+ * inter_medium_32; it is printed only.
+ */
+#include "check.h"
+#include "fonts/vlw_font.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+void put_be32(std::vector<uint8_t> &v, uint32_t x)
+{
+    v.push_back((uint8_t)(x >> 24));
+    v.push_back((uint8_t)(x >> 16));
+    v.push_back((uint8_t)(x >> 8));
+    v.push_back((uint8_t)x);
+}
+
+std::vector<uint8_t> read_file(const std::string &path)
+{
+    std::vector<uint8_t> bytes;
+    FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        return bytes;
+    }
+    uint8_t chunk[4096];
+    size_t got = 0;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + got);
+    }
+    std::fclose(f);
+    return bytes;
+}
+
+/** @brief Glyph records as the old parser saw them: file order, with their bitmap offsets. */
+struct ReferenceFont {
+    std::vector<VlwGlyph> records;
+    std::unordered_map<uint16_t, size_t> lookup;
+};
+
+ReferenceFont reference_font(const std::vector<uint8_t> &bytes)
+{
+    ReferenceFont ref;
+    const uint32_t count = read_be32(bytes.data());
+    uint32_t bitmap_offset = 24u + count * 28u;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t *entry = bytes.data() + 24u + i * 28u;
+        VlwGlyph glyph = {};
+        glyph.codepoint = (uint16_t)read_be32(entry);
+        glyph.height = (uint16_t)read_be32(entry + 4);
+        glyph.width = (uint16_t)read_be32(entry + 8);
+        glyph.x_advance = (uint16_t)read_be32(entry + 12);
+        glyph.y_delta = (int16_t)(int32_t)read_be32(entry + 16);
+        glyph.x_delta = (int8_t)(int32_t)read_be32(entry + 20);
+        glyph.bitmap_offset = bitmap_offset;
+        bitmap_offset += (uint32_t)glyph.width * glyph.height;
+        ref.lookup[glyph.codepoint] = ref.records.size();
+        ref.records.push_back(glyph);
+    }
+    return ref;
+}
+
+void check_font(const std::vector<uint8_t> &bytes, const char *name)
+{
+    std::shared_ptr<VlwFont> font = VlwFont::CreateCopy(bytes.data(), bytes.size(), name);
+    CHECK(font != nullptr);
+    if (!font) {
+        return;
+    }
+    const ReferenceFont ref = reference_font(bytes);
+    int found = 0;
+    for (uint32_t cp = 0; cp <= 0xFFFF; ++cp) {
+        const VlwGlyph *got = font->FindGlyph((uint16_t)cp);
+        const auto it = ref.lookup.find((uint16_t)cp);
+        if ((got != nullptr) != (it != ref.lookup.end())) {
+            CHECK_EQ_AT(got != nullptr, it != ref.lookup.end(), name, cp);
+            continue;
+        }
+        if (!got) {
+            continue;
+        }
+        ++found;
+        const VlwGlyph &want = ref.records[it->second];
+        const bool same = got->codepoint == want.codepoint && got->width == want.width && got->height == want.height &&
+            got->x_advance == want.x_advance && got->y_delta == want.y_delta && got->x_delta == want.x_delta &&
+            got->bitmap_offset == want.bitmap_offset;
+        CHECK_EQ_AT(same, 1, name, cp);
+        CHECK(font->GlyphBitmap(*got) != nullptr);
+    }
+    CHECK_EQ_AT(found, (long long)ref.lookup.size(), name, -1);
+}
+
+/** @brief Glyphs out of codepoint order, with repeats inside and outside Latin-1, and U+0000/U+FFFF. */
+std::vector<uint8_t> synthetic_font()
+{
+    const uint32_t codepoints[] = {0x41, 0x2014, 0x20, 0x41, 0xFFFF, 0x00, 0xE9, 0x2014, 0x100, 0xFF, 0x4E2D, 0x2014, 0x7F};
+    const uint32_t count = sizeof(codepoints) / sizeof(codepoints[0]);
+    std::vector<uint8_t> file;
+    for (uint32_t field : {count, 11u, 20u, 0u, 14u, 4u}) {
+        put_be32(file, field);
+    }
+    uint32_t bitmap_bytes = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t w = 1 + i % 4;
+        const uint32_t h = 2 + i % 3;
+        for (uint32_t field : {codepoints[i], h, w, w + i, h, i % 3, 0u}) {
+            put_be32(file, field);
+        }
+        bitmap_bytes += w * h;
+    }
+    file.resize(file.size() + bitmap_bytes, 0x80);
+    return file;
+}
+
+void bench(const std::vector<uint8_t> &bytes)
+{
+    std::shared_ptr<VlwFont> font = VlwFont::CreateCopy(bytes.data(), bytes.size(), "bench");
+    if (!font) {
+        return;
+    }
+    const ReferenceFont ref = reference_font(bytes);
+    std::vector<uint16_t> text;
+    for (int i = 0; i < 1000000; ++i) {
+        const int r = (int)((long long)i * 7919 % 100);
+        text.push_back((uint16_t)(r < 85 ? 32 + (i * 31) % 95 : (r < 95 ? 0xC0 + i % 60 : 0x2000 + i % 64)));
+    }
+    constexpr int kReps = 20;
+    size_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < kReps; ++rep) {
+        for (uint16_t c : text) {
+            const auto it = ref.lookup.find(c);
+            sink += it == ref.lookup.end() ? 0 : ref.records[it->second].width;
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < kReps; ++rep) {
+        for (uint16_t c : text) {
+            const VlwGlyph *glyph = font->FindGlyph(c);
+            sink += glyph ? glyph->width : 0;
+        }
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+    const double lookups = (double)kReps * (double)text.size();
+    std::printf("inter_medium_32 lookups: unordered_map %.2f ns, FindGlyph %.2f ns (checksum %zu)\n",
+        std::chrono::duration<double, std::nano>(t1 - t0).count() / lookups,
+        std::chrono::duration<double, std::nano>(t2 - t1).count() / lookups, sink);
+}
+
+} // namespace
+
+int main()
+{
+    for (const char *name : {"inter_medium_32.vlw", "montserrat_light_20.vlw"}) {
+        const std::vector<uint8_t> bytes = read_file(std::string(PORTAL_ASSETS_DIR) + "/" + name);
+        CHECK(!bytes.empty());
+        if (!bytes.empty()) {
+            check_font(bytes, name);
+        }
+    }
+    check_font(synthetic_font(), "synthetic");
+    bench(read_file(std::string(PORTAL_ASSETS_DIR) + "/inter_medium_32.vlw"));
+    return check_result();
+}
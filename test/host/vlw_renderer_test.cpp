@@ -0,0 +1,173 @@
+/**
+ * @file vlw_renderer_test.cpp
+ * @brief Checks that `DrawString()` writes exactly what the per-pixel renderer it replaced wrote.
+ *
+ * Both renderers draw the same strings onto copies of a random framebuffer, and the buffers,
+ * widths and reported bounds have to be identical. Cases cover the bundled VLW fonts and a
+ * small synthetic one with odd glyph sizes and offsets, 1/2/4 bpp, all rotations, fractional
+ * and integer scales, both datums axes, background fills, off-screen positions, and drawing
+ * with and without a (shared, so partly warm) glyph cache.
+ */
+#include "check.h"
+#include "fonts/vlw_renderer_fastepd.h"
+#include "reference/vlw_renderer_reference.h"
+#include "wasm/api/errors.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int kPanelW = 240;
+constexpr int kPanelH = 120;
+
+std::vector<uint8_t> read_file(const char *path)
+{
+    std::vector<uint8_t> bytes;
+    FILE *f = std::fopen(path, "rb");
+    if (!f) {
+        return bytes;
+    }
+    uint8_t chunk[4096];
+    size_t got = 0;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + got);
+    }
+    std::fclose(f);
+    return bytes;
+}
+
+void put_be32(std::vector<uint8_t> &v, uint32_t x)
+{
+    v.push_back((uint8_t)(x >> 24));
+    v.push_back((uint8_t)(x >> 16));
+    v.push_back((uint8_t)(x >> 8));
+    v.push_back((uint8_t)x);
+}
+
+/** @brief VLW font with glyphs 'A'..'J' of random size, offsets and mostly 0/255 coverage. */
+std::vector<uint8_t> synthetic_font(std::mt19937 &rng)
+{
+    const int count = 10;
+    std::vector<uint8_t> file;
+    for (uint32_t field : {(uint32_t)count, 11u, 20u, 0u, 14u, 4u}) {
+        put_be32(file, field);
+    }
+    std::vector<uint8_t> bitmaps;
+    for (int i = 0; i < count; ++i) {
+        const uint32_t w = 1 + rng() % 9;
+        const uint32_t h = 1 + rng() % 13;
+        for (uint32_t field : {(uint32_t)('A' + i), h, w, w + 1, h - (uint32_t)(rng() % 3), (uint32_t)((int32_t)(rng() % 5) - 2), 0u}) {
+            put_be32(file, field);
+        }
+        for (uint32_t k = 0; k < w * h; ++k) {
+            const uint32_t r = rng() % 4;
+            bitmaps.push_back(r == 0 ? 0 : (r == 1 ? 255 : (uint8_t)rng()));
+        }
+    }
+    file.insert(file.end(), bitmaps.begin(), bitmaps.end());
+    return file;
+}
+
+void setup_panel(FASTEPD &epd, int mode, int rotation)
+{
+    epd.setPanelSize(kPanelW, kPanelH);
+    epd.setMode(mode);
+    epd.setRotation(rotation);
+}
+
+bool same_rect(const BB_RECT &a, const BB_RECT &b)
+{
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+void check_font(const VlwFont &font, const char *const *texts, size_t text_count, std::mt19937 &rng, int font_index)
+{
+    static const float kScales[] = {1.0f, 2.0f, 1.5f, 0.5f, 3.0f, 0.75f, 1.25f};
+    static const int32_t kDatums[] = {0, 1, 2, 4, 5, 6, 8, 9, 10, 16, 17, 18};
+    VlwGlyphCache cache;
+    int case_index = 0;
+    for (int mode : {BB_MODE_1BPP, BB_MODE_2BPP, BB_MODE_4BPP}) {
+        for (int rotation : {0, 90, 180, 270}) {
+            for (int i = 0; i < 60; ++i, ++case_index) {
+                FASTEPD want;
+                FASTEPD got;
+                setup_panel(want, mode, rotation);
+                setup_panel(got, mode, rotation);
+                for (int k = 0, n = want.bufferPitch() * kPanelH; k < n; ++k) {
+                    want.currentBuffer()[k] = got.currentBuffer()[k] = (uint8_t)rng();
+                }
+
+                FastEpdVlwTextState state;
+                state.size_x = kScales[rng() % 7];
+                state.size_y = kScales[rng() % 7];
+                state.datum = kDatums[rng() % 12];
+                state.utf8_enabled = rng() % 2;
+                state.use_bg = rng() % 2;
+                state.fg_rgb888 = (int32_t)(rng() & 0xFFFFFF);
+                state.bg_rgb888 = (int32_t)(rng() & 0xFFFFFF);
+                const bool use_cache = rng() % 4 != 0;
+
+                // Two overlapping strings, so the second blends over the first's ink.
+                for (int pass = 0; pass < 2; ++pass) {
+                    const char *text = texts[rng() % text_count];
+                    const int32_t x = (int32_t)(rng() % (uint32_t)(got.width() + 60)) - 30;
+                    const int32_t y = (int32_t)(rng() % (uint32_t)(got.height() + 60)) - 30;
+                    int32_t want_w = -1;
+                    int32_t got_w = -1;
+                    BB_RECT want_bounds = {};
+                    BB_RECT got_bounds = {};
+                    CHECK(vlw_reference::DrawString(want, font, state, text, x, y, &want_w, &want_bounds) == kWasmOk);
+                    CHECK(DrawString(got, font, state, text, x, y, &got_w, &got_bounds, use_cache ? &cache : nullptr) ==
+                        kWasmOk);
+                    const long long label = (long long)font_index * 1000000 + case_index * 10 + pass;
+                    CHECK_EQ_AT(got_w, want_w, "DrawString width", label);
+                    CHECK_EQ_AT(same_rect(got_bounds, want_bounds), 1, "DrawString bounds", label);
+                }
+                const size_t bytes = (size_t)want.bufferPitch() * kPanelH;
+                CHECK_EQ_AT(std::memcmp(got.currentBuffer(), want.currentBuffer(), bytes) == 0, 1, "DrawString pixels",
+                    (long long)font_index * 1000000 + case_index * 10 + mode);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    static const char *const kTexts[] = {
+        "Hello, World!",
+        "The quick brown fox jumps over the lazy dog",
+        "g j p q y | {[()]}",
+        "Caf\xc3\xa9 na\xc3\xafve \xe2\x82\xac 12.50",
+        "   spaced   out   ",
+        "x",
+    };
+    static const char *const kSyntheticTexts[] = {"ABCDEFGHIJ", "JIHG FED", "AAAA", "B C", "AZ?"};
+
+    std::mt19937 rng(21);
+    int font_index = 0;
+    for (const char *name : {"inter_medium_32.vlw", "montserrat_light_20.vlw"}) {
+        const std::string path = std::string(PORTAL_ASSETS_DIR) + "/" + name;
+        const std::vector<uint8_t> bytes = read_file(path.c_str());
+        std::shared_ptr<VlwFont> font = VlwFont::CreateCopy(bytes.data(), bytes.size(), name);
+        CHECK(font != nullptr);
+        if (font) {
+            check_font(*font, kTexts, sizeof(kTexts) / sizeof(kTexts[0]), rng, font_index);
+        }
+        ++font_index;
+    }
+
+    for (int i = 0; i < 8; ++i, ++font_index) {
+        const std::vector<uint8_t> bytes = synthetic_font(rng);
+        std::shared_ptr<VlwFont> font = VlwFont::CreateCopy(bytes.data(), bytes.size(), "synthetic");
+        CHECK(font != nullptr);
+        if (font) {
+            check_font(*font, kSyntheticTexts, sizeof(kSyntheticTexts) / sizeof(kSyntheticTexts[0]), rng, font_index);
+        }
+    }
+    return check_result();
+}
@@ -0,0 +1,99 @@
+/**
+ * @file xtc_encode_test.cpp
+ * @brief Round-trips sprites through `encodeXtx()` and the streamed XTG/XTH draws.
+ *
+ * A rotation-0 1bpp or 2bpp sprite is filled either with large flat areas (which the PackBits
+ * writer must compress) or with random pixels (which it must store raw), encoded, and streamed
+ * back onto a panel in every rotation. Every logical pixel of the image has to come back as the
+ * sprite held it.
+ */
+#include "check.h"
+#include "xtc_fixtures.h"
+
+#include <cstdlib>
+#include <random>
+
+using namespace xtc_fixtures;
+
+namespace {
+
+/** @brief A `w x h` rotation-0 sprite, filled flat (`compressible`) or with random pixels. */
+void fill_sprite(FASTEPD &sprite, std::mt19937 &rng, bool xth, int w, int h, bool compressible)
+{
+    sprite.setPanelSize(w, h);
+    sprite.setMode(xth ? BB_MODE_2BPP : BB_MODE_1BPP);
+    sprite.setRotation(0);
+    const int levels = xth ? 4 : 2;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const int v = compressible ? ((x / 64 + y / 48) % levels) : (int)(rng() % (uint32_t)levels);
+            sprite.drawPixelFast(x, y, (uint8_t)v);
+        }
+    }
+}
+
+void check_round_trip(std::mt19937 &rng, bool xth, int w, int h, bool compressible)
+{
+    FASTEPD sprite;
+    fill_sprite(sprite, rng, xth, w, h, compressible);
+
+    size_t size = 0;
+    uint8_t *raw = fastepd_xtc::encodeXtx(&sprite, &size);
+    CHECK(raw != nullptr);
+    if (!raw) {
+        return;
+    }
+    const std::vector<uint8_t> file(raw, raw + size);
+    free(raw);
+
+    const long label = (long)w * 10000 + h * 10 + (xth ? 1 : 0);
+    fastepd_xtc_utils::XtxImageHeader hdr = {};
+    const uint8_t *payload = nullptr;
+    const bool parsed = xth ? fastepd_xtc_utils::parseXthHeader(file.data(), file.size(), &hdr, &payload)
+                            : fastepd_xtc_utils::parseXtgHeader(file.data(), file.size(), &hdr, &payload);
+    CHECK(parsed);
+    CHECK_EQ_AT((int)hdr.width, w, "width", label);
+    CHECK_EQ_AT((int)hdr.height, h, "height", label);
+    CHECK_EQ_AT((int)hdr.compression,
+        compressible ? (int)fastepd_xtc_utils::kXtxCompressionRle : (int)fastepd_xtc_utils::kXtxCompressionNone,
+        "compression", label);
+
+    for (int rotation : {0, 90, 180, 270}) {
+        FASTEPD panel;
+        panel.setPanelSize(960, 540);
+        panel.setMode(xth ? BB_MODE_2BPP : BB_MODE_1BPP);
+        panel.setRotation(rotation);
+        ChunkedSource src = {&file, 0, 37};
+        const uint8_t *md5_8 = file.data() + 14;
+        const bool drawn = xth ? fastepd_xtc::drawXthStream(&panel, chunkedRead, &src, md5_8)
+                               : fastepd_xtc::drawXtgStream(&panel, chunkedRead, &src, md5_8);
+        CHECK_EQ_AT(drawn, true, "drawn", label * 1000 + rotation);
+        if (!drawn) {
+            continue;
+        }
+        int mismatches = 0;
+        for (int y = 0; y < h && y < panel.height(); ++y) {
+            for (int x = 0; x < w && x < panel.width(); ++x) {
+                mismatches += pixelAt(panel, x, y) != pixelAt(sprite, x, y);
+            }
+        }
+        CHECK_EQ_AT(mismatches, 0, "pixels", label * 1000 + rotation);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(20261016);
+    for (bool xth : {false, true}) {
+        for (bool compressible : {true, false}) {
+            check_round_trip(rng, xth, 16, 16, compressible);
+            check_round_trip(rng, xth, 37, 40, compressible);
+            check_round_trip(rng, xth, 200, 150, compressible);
+            check_round_trip(rng, xth, 131, 300, compressible);
+            check_round_trip(rng, xth, 540, 540, compressible);
+        }
+    }
+    return check_result();
+}
@@ -0,0 +1,160 @@
+/**
+ * @file xtc_fixtures.h
+ * @brief Builders for XTG/XTH test files and readers shared by the XTC host tests.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <FastEPD.h>
+
+#include "other/fastepd_xtc.h"
+#include "other/fastepd_xtc_utils.h"
+
+namespace xtc_fixtures {
+
+/** @brief PackBits-encode `in`: runs of 3..128 equal bytes become repeats, the rest literals of up to 128 bytes. */
+inline std::vector<uint8_t> packbits(const std::vector<uint8_t> &in)
+{
+    std::vector<uint8_t> out;
+    size_t i = 0;
+    while (i < in.size()) {
+        size_t run = 1;
+        while (i + run < in.size() && run < 128 && in[i + run] == in[i]) {
+            ++run;
+        }
+        if (run >= 3) {
+            out.push_back((uint8_t)(257 - run));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+        size_t j = i;
+        while (j < in.size() && j - i < 128) {
+            if (j + 2 < in.size() && in[j] == in[j + 1] && in[j] == in[j + 2]) {
+                break;
+            }
+            ++j;
+        }
+        out.push_back((uint8_t)(j - i - 1));
+        out.insert(out.end(), in.begin() + (ptrdiff_t)i, in.begin() + (ptrdiff_t)j);
+        i = j;
+    }
+    return out;
+}
+
+/** @brief 22-byte XTG/XTH header (little-endian fields, no checksum). */
+inline std::vector<uint8_t> header(bool xth, int w, int h, uint8_t compression, uint32_t data_size)
+{
+    const uint32_t magic = xth ? fastepd_xtc_utils::kXthMagic : fastepd_xtc_utils::kXtgMagic;
+    std::vector<uint8_t> v(fastepd_xtc_utils::kXtxHeaderSize, 0);
+    for (int k = 0; k < 4; ++k) {
+        v[(size_t)k] = (uint8_t)(magic >> (8 * k));
+        v[(size_t)(10 + k)] = (uint8_t)(data_size >> (8 * k));
+    }
+    v[4] = (uint8_t)w;
+    v[5] = (uint8_t)(w >> 8);
+    v[6] = (uint8_t)h;
+    v[7] = (uint8_t)(h >> 8);
+    v[9] = compression;
+    return v;
+}
+
+/** @brief Stored payload size of a `w x h` image: XTH is two column-major planes, XTG packed rows. */
+inline size_t payloadBytes(bool xth, int w, int h)
+{
+    return xth ? (size_t)w * (size_t)((h + 7) / 8) * 2u : (size_t)((w + 7) / 8) * (size_t)h;
+}
+
+/** @brief `header()` followed by `payload`. */
+inline std::vector<uint8_t> file(bool xth, int w, int h, uint8_t compression, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> out = header(xth, w, h, compression, (uint32_t)payload.size());
+    out.resize(fastepd_xtc_utils::kXtxHeaderSize + payload.size());
+    if (!payload.empty()) {
+        std::memcpy(out.data() + fastepd_xtc_utils::kXtxHeaderSize, payload.data(), payload.size());
+    }
+    return out;
+}
+
+/** @brief A complete file with the stored payload `payload`. */
+inline std::vector<uint8_t> storedFile(bool xth, int w, int h, const std::vector<uint8_t> &payload)
+{
+    return file(xth, w, h, fastepd_xtc_utils::kXtxCompressionNone, payload);
+}
+
+/**
+ * @brief Payload bytes in encoded order: XTH planes interleaved column by column, XTG unchanged.
+ */
+inline std::vector<uint8_t> encodedOrder(bool xth, int w, int h, const std::vector<uint8_t> &payload)
+{
+    if (!xth) {
+        return payload;
+    }
+    const size_t col = (size_t)((h + 7) / 8);
+    const size_t plane = (size_t)w * col;
+    std::vector<uint8_t> out;
+    out.reserve(payload.size());
+    for (size_t c = 0; c < (size_t)w; ++c) {
+        out.insert(out.end(), payload.begin() + (ptrdiff_t)(c * col), payload.begin() + (ptrdiff_t)((c + 1) * col));
+        out.insert(out.end(), payload.begin() + (ptrdiff_t)(plane + c * col), payload.begin() + (ptrdiff_t)(plane + (c + 1) * col));
+    }
+    return out;
+}
+
+/** @brief A complete file holding `payload` run-length encoded. */
+inline std::vector<uint8_t> rleFile(bool xth, int w, int h, const std::vector<uint8_t> &payload)
+{
+    return file(xth, w, h, fastepd_xtc_utils::kXtxCompressionRle, packbits(encodedOrder(xth, w, h, payload)));
+}
+
+/** @brief `XtxReadFn` source that hands out at most `chunk` bytes per call. */
+struct ChunkedSource {
+    const std::vector<uint8_t> *data;
+    size_t pos;
+    size_t chunk;
+};
+
+inline int32_t chunkedRead(void *user, uint8_t *buf, int32_t len)
+{
+    auto *src = static_cast<ChunkedSource *>(user);
+    size_t n = src->data->size() - src->pos;
+    n = n < (size_t)len ? n : (size_t)len;
+    n = n < src->chunk ? n : src->chunk;
+    std::memcpy(buf, src->data->data() + src->pos, n);
+    src->pos += n;
+    return (int32_t)n;
+}
+
+/** @brief Raw native pixel value at logical `(x, y)`, decoded through the rotation table. */
+inline int pixelAt(FASTEPD &epd, int x, int y)
+{
+    const int w = epd.width();
+    const int h = epd.height();
+    int nx = x;
+    int ny = y;
+    switch (epd.getRotation()) {
+    case 90:
+        nx = y;
+        ny = w - 1 - x;
+        break;
+    case 180:
+        nx = w - 1 - x;
+        ny = h - 1 - y;
+        break;
+    case 270:
+        nx = h - 1 - y;
+        ny = x;
+        break;
+    default:
+        break;
+    }
+    const int bpp = epd.getMode() == BB_MODE_2BPP ? 2 : 1;
+    const uint8_t byte = epd.currentBuffer()[(size_t)ny * (size_t)epd.bufferPitch() + (size_t)(nx * bpp / 8)];
+    return (byte >> (8 - bpp * (nx % (8 / bpp) + 1))) & ((1 << bpp) - 1);
+}
+
+} // namespace xtc_fixtures
@@ -0,0 +1,137 @@
+/**
+ * @file xtc_payload_test.cpp
+ * @brief Checks that run-length encoded and streamed XTG/XTH payloads draw like stored ones.
+ *
+ * The reference is `drawXth()`/`drawXtg()` of the stored file, which blits the whole payload in
+ * one call. The same image is then drawn from an in-memory RLE file and streamed (RLE and
+ * stored) in small, odd-sized reads, in every rotation and for sizes that are clipped by the
+ * panel, not multiples of the band size, or a single block.
+ */
+#include "check.h"
+#include "xtc_fixtures.h"
+
+#include <random>
+
+using namespace xtc_fixtures;
+
+namespace {
+
+/** @brief A freshly cleared 960x540 panel in the mode XTG/XTH needs. */
+void reset_panel(FASTEPD &epd, bool xth, int rotation)
+{
+    epd.setPanelSize(960, 540);
+    epd.setMode(xth ? BB_MODE_2BPP : BB_MODE_1BPP);
+    epd.setRotation(rotation);
+    for (int i = 0, n = epd.bufferPitch() * 540; i < n; ++i) {
+        epd.currentBuffer()[i] = 0x5A;
+    }
+}
+
+bool draw_memory(FASTEPD &epd, bool xth, const std::vector<uint8_t> &file)
+{
+    return xth ? fastepd_xtc::drawXth(&epd, file.data(), file.size())
+               : fastepd_xtc::drawXtg(&epd, file.data(), file.size());
+}
+
+bool draw_stream(FASTEPD &epd, bool xth, const std::vector<uint8_t> &file, size_t chunk)
+{
+    ChunkedSource src = {&file, 0, chunk};
+    return xth ? fastepd_xtc::drawXthStream(&epd, chunkedRead, &src)
+               : fastepd_xtc::drawXtgStream(&epd, chunkedRead, &src);
+}
+
+bool same_buffer(FASTEPD &a, FASTEPD &b)
+{
+    const size_t n = (size_t)a.bufferPitch() * 540u;
+    return std::memcmp(a.currentBuffer(), b.currentBuffer(), n) == 0;
+}
+
+void check_image(std::mt19937 &rng, int w, int h, bool xth, int rotation)
+{
+    // Sparse payloads so the encoder produces long repeats as well as literals.
+    std::vector<uint8_t> payload(payloadBytes(xth, w, h));
+    for (auto &b : payload) {
+        b = (rng() % 4 == 0) ? (uint8_t)rng() : (xth ? 0x00 : 0xFF);
+    }
+    const std::vector<uint8_t> stored = storedFile(xth, w, h, payload);
+    const std::vector<uint8_t> rle = rleFile(xth, w, h, payload);
+    const long label = (long)w * 100000 + h * 10 + rotation / 90 + (xth ? 5 : 0);
+
+    FASTEPD want;
+    reset_panel(want, xth, rotation);
+    CHECK(draw_memory(want, xth, stored));
+
+    FASTEPD got;
+    reset_panel(got, xth, rotation);
+    CHECK(draw_memory(got, xth, rle));
+    CHECK_EQ_AT(same_buffer(got, want), 1, "in-memory RLE", label);
+
+    for (size_t chunk : {1u, 37u, 100u, 4096u}) {
+        reset_panel(got, xth, rotation);
+        CHECK(draw_stream(got, xth, rle, chunk));
+        CHECK_EQ_AT(same_buffer(got, want), 1, "streamed RLE", label * 10000 + (long)chunk);
+
+        reset_panel(got, xth, rotation);
+        CHECK(draw_stream(got, xth, stored, chunk));
+        CHECK_EQ_AT(same_buffer(got, want), 1, "streamed stored", label * 10000 + (long)chunk);
+    }
+
+    // Truncated payloads are rejected, not read past. XTG streaming stops after the last visible
+    // row, so only images that fit on the panel are expected to notice a cut.
+    if (w > want.width() || h > want.height()) {
+        return;
+    }
+    for (size_t cut : {rle.size() - 1, rle.size() - rle.size() / 3, fastepd_xtc_utils::kXtxHeaderSize + 1}) {
+        std::vector<uint8_t> truncated(rle.begin(), rle.begin() + (ptrdiff_t)cut);
+        const uint32_t size = (uint32_t)(cut - fastepd_xtc_utils::kXtxHeaderSize);
+        for (int k = 0; k < 4; ++k) {
+            truncated[(size_t)(10 + k)] = (uint8_t)(size >> (8 * k));
+        }
+        reset_panel(got, xth, rotation);
+        CHECK_EQ_AT(draw_memory(got, xth, truncated), 0, "truncated RLE", label);
+    }
+}
+
+/** @brief PackBits corner cases the encoder above never emits: no-op 0x80 bytes and maximal runs. */
+void check_rle_controls()
+{
+    const int w = 64;
+    const int h = 16;
+    std::vector<uint8_t> payload(payloadBytes(false, w, h));
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = i < 128 ? 0x00 : (uint8_t)(i * 13);
+    }
+    // 128-byte repeat, a no-op, then 128-byte literals split by no-ops.
+    std::vector<uint8_t> encoded = {0x81, 0x00, 0x80};
+    for (size_t i = 128; i < payload.size(); i += 128) {
+        encoded.push_back(0x7F);
+        encoded.insert(encoded.end(), payload.begin() + (ptrdiff_t)i, payload.begin() + (ptrdiff_t)(i + 128));
+        encoded.push_back(0x80);
+    }
+    const std::vector<uint8_t> rle = file(false, w, h, fastepd_xtc_utils::kXtxCompressionRle, encoded);
+
+    FASTEPD want;
+    FASTEPD got;
+    reset_panel(want, false, 0);
+    reset_panel(got, false, 0);
+    CHECK(draw_memory(want, false, storedFile(false, w, h, payload)));
+    CHECK(draw_memory(got, false, rle));
+    CHECK(same_buffer(got, want));
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(16);
+    const int sizes[][2] = {{540, 960}, {960, 540}, {300, 200}, {37, 51}, {600, 1000}, {8, 8}, {33, 17}, {1, 1}};
+    for (const auto &size : sizes) {
+        for (int rotation : {0, 90, 180, 270}) {
+            for (bool xth : {false, true}) {
+                check_image(rng, size[0], size[1], xth, rotation);
+            }
+        }
+    }
+    check_rle_controls();
+    return check_result();
+}